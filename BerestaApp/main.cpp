@@ -4,6 +4,7 @@
 #include <string>
 #include <filesystem>
 #include "../BerestaCore/interpreter/Interpreter.h"
+#include "../BerestaCore/runtime/jit/NumericJit.h"
 
 std::string read_file(const std::string& filepath)
 {
@@ -17,9 +18,23 @@ std::string read_file(const std::string& filepath)
 
 int main(int argc, char* argv[])
 {
-    if(argc < 2) {std::cerr << "Using : BerestaApp <entry_file.beresta>" << std::endl; return 1;}
+    if(argc < 2) {std::cerr << "Using : BerestaApp <entry_file.beresta> [--closures] [--jit] [--aot]" << std::endl; return 1;}
 
     std::filesystem::path entry_path = argv[1];
+    ExecutionMode mode = ExecutionMode::TREE_WALKING;
+    for(int i = 2; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if(flag == "--closures") {mode = ExecutionMode::CLOSURES;}
+        else if(flag == "--aot") {mode = ExecutionMode::AOT;}
+        else if(flag == "--jit")
+        {
+            if(!NumericJit::available()) {std::cerr << "JIT is not available in this build (configure with -DBERESTA_JIT=ON)" << std::endl;}
+            NumericJit::instance().set_enabled(true);
+        }
+        else                     {std::cerr << "Unknown option: " << flag << std::endl; return 1;}
+    }
+
     if(!std::filesystem::exists(entry_path)) {std::cerr << "Entry file not found: " << entry_path.string() << std::endl; return 1;}
 
     std::filesystem::path root_dir = entry_path.parent_path();
@@ -28,6 +43,7 @@ int main(int argc, char* argv[])
     Environment env(&diag);
     FunctionIndex index;
     Interpreter interpreter(env, index, diag);
+    interpreter.set_default_execution_mode(mode);
 
     for(const auto& p : std::filesystem::directory_iterator(root_dir))
     {
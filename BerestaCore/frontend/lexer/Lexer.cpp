@@ -91,8 +91,10 @@ Token Lexer::next_token()
         if(ident == "public")   {return make(TokenType::PUBLIC);}
         if(ident == "private")  {return make(TokenType::PRIVATE);}
         if(ident == "function") {return make(TokenType::FUNCTION);}
+        if(ident == "pure")     {return make(TokenType::PURE);}
         if(ident == "enum")     {return make(TokenType::ENUM);}
         if(ident == "return")   {return make(TokenType::RETURN);}
+        if(ident == "yield")    {return make(TokenType::YIELD);}
         if(ident == "continue") {return make(TokenType::CONTINUE);}
         if(ident == "break")    {return make(TokenType::BREAK);}
         if(ident == "switch")   {return make(TokenType::SWITCH);}
@@ -6,6 +6,24 @@
 #include "Visitors.h"
 #include "frontend/parser/ExpressionFactory.h"
 
+BinaryOp binary_op_from_string(const std::string& op)
+{
+    if(op == "+")                 {return BinaryOp::ADD;}
+    if(op == "-")                 {return BinaryOp::SUB;}
+    if(op == "*")                 {return BinaryOp::MUL;}
+    if(op == "/")                 {return BinaryOp::DIV;}
+    if(op == "%")                 {return BinaryOp::MOD;}
+    if(op == "==")                {return BinaryOp::EQUAL;}
+    if(op == "!=")                {return BinaryOp::NOT_EQUAL;}
+    if(op == "<")                 {return BinaryOp::LESS;}
+    if(op == "<=")                {return BinaryOp::LESS_EQUAL;}
+    if(op == ">")                 {return BinaryOp::GREATER;}
+    if(op == ">=")                {return BinaryOp::GREATER_EQUAL;}
+    if(op == "and" || op == "&&") {return BinaryOp::AND;}
+    if(op == "or"  || op == "||") {return BinaryOp::OR;}
+    return BinaryOp::UNKNOWN;
+}
+
 Expression::Expression(ExpressionType type, int line, int column)
     : type(type), line(line), column(column) {}
 
@@ -16,7 +34,7 @@ NumberExpr::NumberExpr(double number, int line, int column)
     : Expression(ExpressionType::NUMBER, line, column), value(number) {}
 
 BinaryExpr::BinaryExpr(std::string op, std::unique_ptr<Expression> left, std::unique_ptr<Expression> right, int line, int column)
-    : Expression(ExpressionType::BINARY, line, column), op(std::move(op)), left(std::move(left)), right(std::move(right)) {}
+    : Expression(ExpressionType::BINARY, line, column), op(std::move(op)), opcode(binary_op_from_string(this->op)), left(std::move(left)), right(std::move(right)) {}
 
 VariableExpr::VariableExpr(std::string name, int line, int column)
     : Expression(ExpressionType::VARIABLE, line, column), name(std::move(name)) {}
@@ -79,7 +97,9 @@ char StringExpr::get_operator_char() const {return value.empty() ? '?' : value[0
     {
         if(args.size() != 3) {return nullptr;}
         std::string op = args[1] ? args[1]->get_operator_value() : "";
-        return std::make_unique<BinaryExpr>(op, std::move(args[0]), std::move(args[2]), 0, 0);
+        int line = args[1] ? args[1]->line : 0;
+        int column = args[1] ? args[1]->column : 0;
+        return std::make_unique<BinaryExpr>(op, std::move(args[0]), std::move(args[2]), line, column);
     });
     return true;
 }();
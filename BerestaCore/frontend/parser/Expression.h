@@ -13,6 +13,9 @@
 #include <vector>
 
 struct Statement;
+struct StructDefinition;
+struct StructShape;
+class FusedArrayExpr;
 
 enum class ExpressionType
 {
@@ -30,6 +33,26 @@ enum class ExpressionType
     MEMBER_ACCESS
 };
 
+enum class BinaryOp
+{
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    MOD,
+    EQUAL,
+    NOT_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    AND,
+    OR,
+    UNKNOWN
+};
+
+BERESTA_API BinaryOp binary_op_from_string(const std::string& op);
+
 struct ExprVisitor;
 
 struct BERESTA_API Expression
@@ -62,8 +85,10 @@ struct BERESTA_API NumberExpr : public Expression
 struct BERESTA_API BinaryExpr : public Expression
 {
     std::string op;
+    BinaryOp opcode;
     std::unique_ptr<Expression> left;
     std::unique_ptr<Expression> right;
+    std::shared_ptr<FusedArrayExpr> fused;          // плоская программа цепочки операторов, строится при первом вычислении
 
     BinaryExpr(std::string op, std::unique_ptr<Expression> left, std::unique_ptr<Expression> right, int line = -1, int column = -1);
     Value accept(ExprVisitor& val) override;
@@ -135,6 +160,8 @@ struct BERESTA_API MemberAccessExpr : public Expression
 {
     std::unique_ptr<Expression> object;
     std::string member;
+    const StructShape* cached_shape = nullptr;      // форма и слот последнего доступа: пока форма та же, имя не ищется
+    int cached_slot = -1;
 
     MemberAccessExpr(std::unique_ptr<Expression> obj, std::string mem, int line = -1, int column = -1);
     Value accept(ExprVisitor& val) override;
@@ -151,6 +178,7 @@ struct BERESTA_API DictionaryLiteralExpr : public Expression
 struct BERESTA_API StructLiteralExpr : public Expression
 {
     std::vector<std::pair<std::string, std::unique_ptr<Expression>>> fields;
+    std::shared_ptr<StructDefinition> definition;   // одно определение на литерал, строится при первом вычислении
 
     explicit StructLiteralExpr(std::vector<std::pair<std::string, std::unique_ptr<Expression>>> fields, int line = -1, int column = -1);
     Value accept(ExprVisitor& val) override;
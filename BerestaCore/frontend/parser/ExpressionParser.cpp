@@ -162,10 +162,10 @@ std::unique_ptr<Expression> ExpressionParser::parse_primary()
         if(!match(TokenType::RIGHT_BRACKET)) {_diag.error("Expected ']' after array literal", current_file(), lb.line); return nullptr;}
         return std::make_unique<ArrayLiteralExpr>(std::move(elems), lb.line, lb.column);
     }
-    /*
-    if(match(TokenType::LEFT_BRACE))
+    // {"key": value, ...} - словарь, {a, b} и пустые {} остаются шаблоном структуры
+    if(peek().type == TokenType::LEFT_BRACE && position + 1 < tokens.size() && tokens[position + 1].type == TokenType::STRING)
     {
-        Token lb = tokens[position - 1];
+        Token lb = advance();
         std::vector<std::pair<std::unique_ptr<Expression>, std::unique_ptr<Expression>>> entries;
 
         if(peek().type != TokenType::RIGHT_BRACE)
@@ -185,7 +185,6 @@ std::unique_ptr<Expression> ExpressionParser::parse_primary()
         if(!match(TokenType::RIGHT_BRACE)) {_diag.error("Expected '}' after dictionary literal", current_file(), lb.line); return nullptr;}
         return std::make_unique<DictionaryLiteralExpr>(std::move(entries), lb.line, lb.column);
     }
-    */
     if(match(TokenType::LEFT_BRACE))
     {
         Token lb = tokens[position - 1];
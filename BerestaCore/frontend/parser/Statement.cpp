@@ -43,6 +43,9 @@ BlockStatement::BlockStatement(std::vector<std::unique_ptr<Statement>> stmt, int
 ReturnStatement::ReturnStatement(std::unique_ptr<Expression> val, int line, int column)
     : Statement(StatementType::RETURN, line, column), value(std::move(val)) {}
 
+YieldStatement::YieldStatement(std::unique_ptr<Expression> val, int line, int column)
+    : Statement(StatementType::YIELD, line, column), value(std::move(val)) {}
+
 IndexAssignment::IndexAssignment(std::unique_ptr<Expression> t, std::unique_ptr<Expression> v, int line, int column)
     : Statement(StatementType::INDEX_ASSIGNMENT, line, column), target(std::move(t)), value(std::move(v)) {}
 
@@ -72,6 +75,7 @@ Value ForeachStatement::accept(StmtVisitor& val)    {return val.visit_foreach(*t
 Value BlockStatement::accept(StmtVisitor& val)      {return val.visit_block(*this);}
 Value FunctionStatement::accept(StmtVisitor& val)   {return val.visit_function(*this);}
 Value ReturnStatement::accept(StmtVisitor& val)     {return val.visit_return(*this);}
+Value YieldStatement::accept(StmtVisitor& val)      {return val.visit_yield(*this);}
 Value IndexAssignment::accept(StmtVisitor& val)     {return val.visit_index_assignment(*this);}
 Value EnumStatement::accept(StmtVisitor& val)       {return val.visit_enum(*this);}
 Value MacrosStatement::accept(StmtVisitor& val)     {return val.visit_macros(*this);}
@@ -34,7 +34,8 @@ enum class StatementType
     CASE,
     BREAK,
     CONTINUE,
-    RETURN
+    RETURN,
+    YIELD
 };
 
 enum class FunctionVisibility
@@ -140,12 +141,19 @@ struct BERESTA_API BlockStatement : public Statement
     Value accept(StmtVisitor& val) override;
 };
 
+struct JitFunctionCache;
+class MemoCache;
+
 struct BERESTA_API FunctionStatement : public Statement
 {
     FunctionVisibility visibility;
     std::string name;
     std::vector<std::string> parameters;
     std::unique_ptr<Statement> body;
+    std::shared_ptr<JitFunctionCache> jit_cache;    // нативный код NumericJit, живёт вместе с узлом
+    bool is_pure = false;                           // модификатор pure, снимается, если проверка чистоты не прошла
+    std::shared_ptr<MemoCache> memo_cache;          // результаты pure-функции, создаётся после проверки
+    bool is_generator = false;                      // в теле есть yield: вызов возвращает генератор, а не выполняет тело
 
     FunctionStatement(FunctionVisibility vis, std::string name, std::vector<std::string> params, std::unique_ptr<Statement> body, int line = -1, int column = -1);
     Value accept(StmtVisitor& val) override;
@@ -159,6 +167,14 @@ struct BERESTA_API ReturnStatement : public Statement
     Value accept(StmtVisitor& val) override;
 };
 
+struct BERESTA_API YieldStatement : public Statement
+{
+    std::unique_ptr<Expression> value;
+
+    explicit YieldStatement(std::unique_ptr<Expression> val, int line = -1, int column = -1);
+    Value accept(StmtVisitor& val) override;
+};
+
 struct BERESTA_API IndexAssignment : public Statement
 {
     std::unique_ptr<Expression> target;
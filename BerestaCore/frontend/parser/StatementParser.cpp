@@ -83,8 +83,9 @@ std::unique_ptr<Statement> StatementParser::parse_statement()
         return std::make_unique<AssignmentStatement>(std::move(a), id.line, id.column);
     }
     if(peek().type == TokenType::PUBLIC || peek().type == TokenType::PRIVATE) {return parse_function_statement();}
-    if(peek().type == TokenType::FUNCTION) {return parse_function_statement();}
+    if(peek().type == TokenType::FUNCTION || peek().type == TokenType::PURE) {return parse_function_statement();}
     if(peek().type == TokenType::RETURN) {return parse_return_statement();}
+    if(peek().type == TokenType::YIELD) {return parse_yield_statement();}
     if(peek().type == TokenType::MACROS) {return parse_macros_statement();}
     if(peek().type == TokenType::BREAK)
     {
@@ -312,6 +313,8 @@ std::unique_ptr<Statement> StatementParser::parse_function_statement()
     if(match(TokenType::PUBLIC)) {visibility = FunctionVisibility::PUBLIC;}
     else if(match(TokenType::PRIVATE)) {visibility = FunctionVisibility::PRIVATE;}
 
+    bool is_pure = match(TokenType::PURE);
+
     Token func_token = advance();
 
     if(peek().type != TokenType::IDENTIFIER) {_diag.error("Expected function name", current_file(), func_token.line); return nullptr;}
@@ -333,8 +336,15 @@ std::unique_ptr<Statement> StatementParser::parse_function_statement()
 
     if(!match(TokenType::RIGHT_PAREN)) {_diag.error("Expected ')'", current_file(), func_token.line); return nullptr;}
 
+    _generator_stack.push_back(false);
     auto body = parse_block();
-    return std::make_unique<FunctionStatement>(visibility, name, std::move(params), std::move(body), func_token.line, func_token.column);
+    bool is_generator = _generator_stack.back();
+    _generator_stack.pop_back();
+
+    auto fn = std::make_unique<FunctionStatement>(visibility, name, std::move(params), std::move(body), func_token.line, func_token.column);
+    fn->is_pure = is_pure;
+    fn->is_generator = is_generator;
+    return fn;
 }
 
 std::unique_ptr<Statement> StatementParser::parse_return_statement()
@@ -353,6 +363,23 @@ std::unique_ptr<Statement> StatementParser::parse_return_statement()
     return std::make_unique<ReturnStatement>(std::move(val), ret_token.line, ret_token.column);
 }
 
+std::unique_ptr<Statement> StatementParser::parse_yield_statement()
+{
+    Token yield_token = advance();
+    if(_generator_stack.empty()) {_diag.error("yield outside of function", current_file(), yield_token.line);}
+    else                         {_generator_stack.back() = true;}
+
+    ExpressionParser expr_parser(tokens, position, _current_file, _diag);
+    auto val = expr_parser.parse_expression();
+    position = expr_parser.get_position();
+
+    if(!val) {_diag.error("Expected value after yield", current_file(), yield_token.line); return nullptr;}
+
+    if(!match(TokenType::SEMICOLON)) {_diag.error("Missing ';' after yield", current_file(), yield_token.line);}
+
+    return std::make_unique<YieldStatement>(std::move(val), yield_token.line, yield_token.column);
+}
+
 std::unique_ptr<Statement> StatementParser::parse_index_assignment()
 {
     Token name_token = advance();
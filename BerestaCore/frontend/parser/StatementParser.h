@@ -33,6 +33,7 @@ class BERESTA_API StatementParser : public BaseContext
         std::unique_ptr<Statement> parse_block();
         std::unique_ptr<Statement> parse_function_statement();
         std::unique_ptr<Statement> parse_return_statement();
+        std::unique_ptr<Statement> parse_yield_statement();
         std::unique_ptr<Statement> parse_index_assignment();
         std::unique_ptr<Statement> parse_index_assignment_expression();
         std::unique_ptr<Statement> parse_enum_statement();
@@ -47,6 +48,7 @@ class BERESTA_API StatementParser : public BaseContext
         size_t position = 0;
 
         std::vector<std::string> _file_stack;
+        std::vector<bool> _generator_stack;     // по одному флагу на разбираемую функцию: встретился ли в ней yield
 };
 
 
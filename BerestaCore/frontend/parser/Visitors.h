@@ -18,7 +18,7 @@ struct IfStatement; struct WhileStatement; struct RepeatStatement;
 struct ForStatement; struct ForeachStatement; struct BlockStatement;
 struct FunctionStatement; struct ReturnStatement; struct IndexAssignment;
 struct EnumStatement; struct MacrosStatement; struct BreakStatement;
-struct ContinueStatement; struct SwitchStatement;
+struct ContinueStatement; struct SwitchStatement; struct YieldStatement;
 
 struct ExprVisitor
 {
@@ -51,6 +51,7 @@ struct StmtVisitor
     virtual Value visit_block(BlockStatement& stmt) = 0;
     virtual Value visit_function(FunctionStatement& stmt) = 0;
     virtual Value visit_return(ReturnStatement& stmt) = 0;
+    virtual Value visit_yield(YieldStatement& stmt) = 0;
     virtual Value visit_index_assignment(IndexAssignment& stmt) = 0;
     virtual Value visit_enum(EnumStatement& stmt) = 0;
     virtual Value visit_macros(MacrosStatement& stmt) = 0;
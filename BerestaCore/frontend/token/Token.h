@@ -53,7 +53,9 @@ enum class TokenType
     PUBLIC,
     PRIVATE,
     FUNCTION,
+    PURE,
     RETURN,
+    YIELD,
     MACROS,
     CONTINUE,
     BREAK,
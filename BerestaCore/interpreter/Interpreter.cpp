@@ -6,6 +6,7 @@
 #include "../frontend/lexer/Lexer.h"
 #include "../runtime/builtin/core/BuiltinRegistry.h"
 #include "../runtime/evaluator/Evaluator.h"
+#include "../runtime/compiler/ClosureCompiler.h"
 
 Interpreter::Interpreter(Environment& env, FunctionIndex& index, Diagnostics& diag) : BaseContext(diag), _env(env), _index(index), _modules(_diag)
 {
@@ -22,10 +23,20 @@ void Interpreter::register_file(const std::string& filename, const std::string&
 
     Module& module = _modules.register_module(filename, _env, _index);
     module.set_ast(std::move(statements));
+    module.set_execution_mode(_default_mode);
 
     _index.reindex_file(filename, module.get_ast());
 }
 
+void Interpreter::set_default_execution_mode(ExecutionMode mode) {_default_mode = mode;}
+
+void Interpreter::set_execution_mode(const std::string& filename, ExecutionMode mode)
+{
+    Module* mod = _modules.get_module(filename);
+    if(!mod) {_diag.error("File not registered: " + filename, filename); return;}
+    mod->set_execution_mode(mode);
+}
+
 void Interpreter::run_project(const std::string& entry_file)
 {
     Module* entry = _modules.get_module(entry_file);
@@ -39,32 +50,44 @@ void Interpreter::run_project(const std::string& entry_file)
         Module* mod = _modules.get_module(filename);
         if(!mod) {continue;}
 
-        set_current_file(filename);
-
-        Environment& env = mod->environment();
-        env.push_scope();
+        run_module(*mod, filename);
+    }
 
-        Evaluator eval(env, mod->index(), filename, _diag);
-        for(const auto& stmt : mod->get_ast())
-        {
-            if(stmt->type != StatementType::FUNCTION) {eval.eval_statement(stmt.get());}
-        }
+    run_module(*entry, entry_file);
 
-        env.pop_scope();
-    }
+    if(_diag.has_error()) {_diag.print_all();}
+}
 
-    set_current_file(entry_file);
+void Interpreter::run_module(Module& module, const std::string& filename)
+{
+    set_current_file(filename);
 
-    Environment& env = entry->environment();
+    Environment& env = module.environment();
     env.push_scope();
 
-    Evaluator eval(env, entry->index(), entry_file, _diag);
-    for(const auto& stmt : entry->get_ast())
+    // AOT откатывается на Evaluator, если модуль не удалось собрать или загрузить
+    if(module.execution_mode() == ExecutionMode::AOT && _aot.run_module(module.get_ast(), env, module.index(), filename, _diag))
     {
-        if(stmt->type != StatementType::FUNCTION) {eval.eval_statement(stmt.get());}
+        env.pop_scope();
+        return;
     }
 
-    env.pop_scope();
+    if(module.execution_mode() == ExecutionMode::CLOSURES)
+    {
+        ClosureCompiler compiler(env, module.index(), filename, _diag);
+        for(const auto& stmt : module.get_ast())
+        {
+            if(stmt->type != StatementType::FUNCTION) {compiler.run_statement(stmt.get());}
+        }
+    }
+    else
+    {
+        Evaluator eval(env, module.index(), filename, _diag);
+        for(const auto& stmt : module.get_ast())
+        {
+            if(stmt->type != StatementType::FUNCTION) {eval.eval_statement(stmt.get());}
+        }
+    }
 
-    if(_diag.has_error()) {_diag.print_all();}
+    env.pop_scope();
 }
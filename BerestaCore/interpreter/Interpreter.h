@@ -12,6 +12,7 @@
 #include "../runtime/environment/Environment.h"
 #include "../frontend/diagnostics/Diagnostics.h"
 #include "../frontend/diagnostics/BaseContext.h"
+#include "../runtime/aot/AotEngine.h"
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -24,10 +25,20 @@ class BERESTA_API Interpreter : public BaseContext
         void register_file(const std::string& filename, const std::string& code);
         void run_project(const std::string& entry_file);
 
+        // режим по умолчанию для новых модулей и переключение для уже зарегистрированного
+        void set_default_execution_mode(ExecutionMode mode);
+        void set_execution_mode(const std::string& filename, ExecutionMode mode);
+
+        AotEngine& aot() {return _aot;}
+
     private:
         Environment& _env;
         FunctionIndex& _index;
         ModuleManager _modules;
+        ExecutionMode _default_mode = ExecutionMode::TREE_WALKING;
+        AotEngine _aot;
+
+        void run_module(Module& module, const std::string& filename);
 };
 
 #endif //BERESTALANGUAGE_INTERPRETER_H
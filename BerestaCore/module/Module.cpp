@@ -14,3 +14,7 @@ const std::vector<std::unique_ptr<Statement>>& Module::get_ast() const {return _
 Environment& Module::environment() {return *_env;}
 
 FunctionIndex& Module::index() {return _index;}
+
+void Module::set_execution_mode(ExecutionMode mode) {_mode = mode;}
+
+ExecutionMode Module::execution_mode() const {return _mode;}
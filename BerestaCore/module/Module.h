@@ -12,6 +12,13 @@
 #include <memory>
 #include <string>
 
+enum class ExecutionMode
+{
+    TREE_WALKING,
+    CLOSURES,
+    AOT
+};
+
 class Module : BaseContext
 {
     public:
@@ -22,11 +29,15 @@ class Module : BaseContext
         [[nodiscard]] Environment& environment();
         [[nodiscard]] FunctionIndex& index();
 
+        void set_execution_mode(ExecutionMode mode);
+        [[nodiscard]] ExecutionMode execution_mode() const;
+
     private:
         std::string _filename;
         Environment* _env;
         FunctionIndex& _index;
         std::vector<std::unique_ptr<Statement>> _ast;
+        ExecutionMode _mode = ExecutionMode::TREE_WALKING;
 };
 
 
@@ -0,0 +1,226 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "AotEngine.h"
+#include "AotTranspiler.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#if !defined(_WIN32)
+    #include <dlfcn.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    using AotEntry = int(*)(AotRuntime*);
+
+    std::string env_or(const char* name, const std::string& fallback)
+    {
+        const char* v = std::getenv(name);
+        return (v && *v) ? std::string(v) : fallback;
+    }
+
+    std::string fnv1a_hex(const std::string& data)
+    {
+        uint64_t h = 1469598103934665603ull;
+        for(unsigned char c : data)
+        {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+        return buf;
+    }
+
+    // кеш свой у каждого пользователя: $XDG_CACHE_HOME/beresta_aot, иначе ~/.cache/beresta_aot
+    std::string default_cache_dir()
+    {
+        std::filesystem::path base = env_or("XDG_CACHE_HOME", "");
+        if(base.empty() && std::getenv("HOME") && *std::getenv("HOME")) {base = std::filesystem::path(std::getenv("HOME")) / ".cache";}
+        if(!base.empty()) {return (base / "beresta_aot").string();}
+
+        std::error_code ec;
+        std::filesystem::path tmp = std::filesystem::temp_directory_path(ec);
+#if !defined(_WIN32)
+        std::string name = "beresta_aot-" + std::to_string(geteuid());
+#else
+        std::string name = "beresta_aot";
+#endif
+        return ec ? name : (tmp / name).string();
+    }
+
+    // каталог кеша и библиотеки в нём должны принадлежать текущему пользователю и не быть открыты на запись
+    // группе и остальным: иначе чужой .so с угаданным именем был бы загружен и исполнен от нашего имени
+    bool owned_private(const std::filesystem::path& path, bool directory)
+    {
+#if defined(_WIN32)
+        return true;
+#else
+        struct stat st{};
+        if(lstat(path.c_str(), &st) != 0) {return false;}
+        if(directory ? !S_ISDIR(st.st_mode) : !S_ISREG(st.st_mode)) {return false;}
+        return st.st_uid == geteuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#endif
+    }
+
+    // каталог создаётся с правами 0700; уже существующий принимается, только если он наш и закрыт от записи
+    bool prepare_cache_dir(const std::filesystem::path& dir)
+    {
+        std::error_code ec;
+        if(!std::filesystem::exists(dir, ec))
+        {
+            if(dir.has_parent_path()) {std::filesystem::create_directories(dir.parent_path(), ec);}
+#if !defined(_WIN32)
+            mkdir(dir.c_str(), 0700);
+#else
+            std::filesystem::create_directory(dir, ec);
+#endif
+        }
+        return owned_private(dir, true);
+    }
+
+    // хеш заголовков рантайма на момент сборки, его считает CMake
+    std::string runtime_hash()
+    {
+#if defined(BERESTA_RUNTIME_HASH)
+        return BERESTA_RUNTIME_HASH;
+#else
+        return "";
+#endif
+    }
+
+    std::string include_dir()
+    {
+#if defined(BERESTA_SOURCE_DIR)
+        return env_or("BERESTA_AOT_INCLUDE", BERESTA_SOURCE_DIR);
+#else
+        return env_or("BERESTA_AOT_INCLUDE", "");
+#endif
+    }
+}
+
+AotEngine::AotEngine()
+{
+    _cache_dir = env_or("BERESTA_AOT_CACHE", default_cache_dir());
+}
+
+AotEngine::~AotEngine()
+{
+    // таблица и рантаймы указывают в код библиотек, поэтому закрываем их последними
+    _table.clear();
+    _runtimes.clear();
+#if !defined(_WIN32)
+    for(void* lib : _libraries) {dlclose(lib);}
+#endif
+}
+
+bool AotEngine::available()
+{
+#if defined(_WIN32)
+    return false;
+#else
+    return true;
+#endif
+}
+
+void AotEngine::set_cache_dir(std::string dir) {_cache_dir = std::move(dir);}
+
+std::string AotEngine::build(const std::string& source, const std::string& file, Diagnostics& diag)
+{
+    std::string include = include_dir();
+    if(include.empty()) {diag.warn("AOT: runtime headers not found (set BERESTA_AOT_INCLUDE)", file); return "";}
+
+    std::string flags = "-std=c++20 -O2 -shared -fPIC -I\"" + include + "\"";
+#if defined(__APPLE__)
+    flags += " -undefined dynamic_lookup";
+#endif
+    std::string compiler = env_or("BERESTA_AOT_CXX", "c++");
+
+    std::filesystem::path dir = _cache_dir;
+    std::string key = fnv1a_hex(compiler + " " + flags + "\n" + runtime_hash() + "\n" + source);
+    std::filesystem::path lib = dir / (key + ".so");
+
+    if(!prepare_cache_dir(dir)) {diag.warn("AOT: cache directory " + dir.string() + " must be owned by the current user and not writable by others", file); return "";}
+
+    std::error_code ec;
+    if(std::filesystem::exists(lib, ec))
+    {
+        if(owned_private(lib, false)) {return lib.string();}
+        diag.warn("AOT: ignoring " + lib.string() + ": not owned by the current user or writable by others", file);
+        return "";
+    }
+
+    std::filesystem::path src = dir / (key + ".cpp");
+    std::filesystem::path log = dir / (key + ".log");
+    {
+        std::ofstream out(src, std::ios::binary);
+        if(!out) {diag.warn("AOT: cannot write " + src.string(), file); return "";}
+        out << source;
+    }
+
+    // собираем во временный файл и переименовываем, чтобы параллельный запуск не подхватил недописанную библиотеку
+#if !defined(_WIN32)
+    std::filesystem::path tmp = dir / (key + ".so." + std::to_string(getpid()));
+#else
+    std::filesystem::path tmp = dir / (key + ".so.tmp");
+#endif
+    std::string cmd = compiler + " " + flags + " -o \"" + tmp.string() + "\" \"" + src.string() + "\" > \"" + log.string() + "\" 2>&1";
+    if(std::system(cmd.c_str()) != 0)
+    {
+        std::filesystem::remove(tmp, ec);
+        diag.warn("AOT: compilation failed, see " + log.string(), file);
+        return "";
+    }
+
+    std::filesystem::rename(tmp, lib, ec);
+    if(ec) {diag.warn("AOT: cannot store " + lib.string(), file); return "";}
+
+    ++_compiled;
+    return lib.string();
+}
+
+bool AotEngine::run_module(const std::vector<std::unique_ptr<Statement>>& ast, Environment& env, FunctionIndex& index, const std::string& file, Diagnostics& diag)
+{
+#if defined(_WIN32)
+    diag.warn("AOT mode is not supported on this platform, running with the interpreter", file);
+    return false;
+#else
+    AotTranspiler transpiler(index, file);
+    AotUnit unit = transpiler.translate(ast);
+
+    std::string lib_path = build(unit.source, file, diag);
+    if(lib_path.empty()) {return false;}
+
+    // между сборкой и загрузкой проверяем ещё раз: загружается только своя библиотека в своём каталоге
+    if(!owned_private(std::filesystem::path(lib_path).parent_path(), true) || !owned_private(lib_path, false))
+    {
+        diag.warn("AOT: refusing to load " + lib_path + ": not owned by the current user or writable by others", file);
+        return false;
+    }
+
+    void* lib = dlopen(lib_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if(!lib) {diag.warn(std::string("AOT: ") + dlerror(), file); return false;}
+
+    auto entry = reinterpret_cast<AotEntry>(dlsym(lib, "beresta_aot_main"));
+    if(!entry) {diag.warn("AOT: entry point not found in " + lib_path, file); dlclose(lib); return false;}
+    _libraries.push_back(lib);
+
+    auto runtime = std::make_unique<AotRuntime>(env, index, file, diag, _table);
+    runtime->functions = std::move(unit.functions);
+    runtime->expressions = std::move(unit.expressions);
+    runtime->statements = std::move(unit.statements);
+
+    AotRuntime* rt = runtime.get();
+    _runtimes.push_back(std::move(runtime));
+    entry(rt);
+    return true;
+#endif
+}
@@ -0,0 +1,56 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_AOTENGINE_H
+#define BERESTALANGUAGE_AOTENGINE_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "frontend/parser/Statement.h"
+#include "runtime/aot/AotRuntime.h"
+#include "runtime/environment/Environment.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class FunctionIndex;
+
+// AOT-режим: модуль переводится в C++, собирается системным компилятором в .so и грузится через dlopen.
+// Собранные библиотеки кешируются по хешу сгенерированного исходника и команды сборки
+class BERESTA_API AotEngine
+{
+    public:
+        AotEngine();
+        ~AotEngine();
+
+        AotEngine(const AotEngine&) = delete;
+        AotEngine& operator=(const AotEngine&) = delete;
+
+        // dlopen и системный компилятор есть только вне Windows
+        [[nodiscard]] static bool available();
+
+        // по умолчанию BERESTA_AOT_CACHE, иначе личный каталог пользователя ($XDG_CACHE_HOME или ~/.cache)/beresta_aot;
+        // каталог и библиотеки в нём должны принадлежать пользователю и быть закрыты на запись для остальных
+        void set_cache_dir(std::string dir);
+        [[nodiscard]] const std::string& cache_dir() const {return _cache_dir;}
+
+        // true - модуль исполнен нативным кодом; false - собрать или загрузить не удалось, исполнять интерпретатором
+        bool run_module(const std::vector<std::unique_ptr<Statement>>& ast, Environment& env, FunctionIndex& index, const std::string& file, Diagnostics& diag);
+
+        [[nodiscard]] size_t compiled_count() const {return _compiled;}
+        [[nodiscard]] size_t loaded_count() const {return _libraries.size();}
+
+    private:
+        std::string _cache_dir;
+        std::vector<void*> _libraries;
+        std::vector<std::unique_ptr<AotRuntime>> _runtimes;
+        AotFunctionTable _table;
+        size_t _compiled = 0;
+
+        std::string build(const std::string& source, const std::string& file, Diagnostics& diag);
+};
+
+
+#endif //BERESTALANGUAGE_AOTENGINE_H
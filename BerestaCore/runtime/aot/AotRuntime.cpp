@@ -0,0 +1,95 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "AotRuntime.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/evaluator/Evaluator.h"
+#include "runtime/evaluator/Memoization.h"
+#include <iostream>
+
+AotRuntime::AotRuntime(Environment& env, FunctionIndex& index, std::string file, Diagnostics& diag, AotFunctionTable& table)
+    : _env(env), _index(index), _file(std::move(file)), _diag(diag), _table(table) {}
+
+AotRuntime::~AotRuntime() = default;
+
+Evaluator& AotRuntime::fallback()
+{
+    if(!_fallback) {_fallback = std::make_unique<Evaluator>(_env, _index, _file, _diag);}
+    return *_fallback;
+}
+
+IBuiltinFunction* AotRuntime::builtin(const char* name) {return BuiltinRegistry::instance().get(name);}
+
+Value AotRuntime::call_builtin(IBuiltinFunction* fn, const std::vector<Value>& args, int line)
+{
+    ActiveEvaluator active(fn->calls_back() ? &fallback() : get_active_evaluator());
+    try                             {return fn->invoke(args, _diag, _file, line);}
+    catch(const std::exception& ex) {_diag.error(std::string("Builtin error: ") + ex.what(), _file, line); return {};}
+    catch(...)                      {_diag.error("Builtin error: exception", _file, line); return {};}
+}
+
+Value AotRuntime::call_function(const std::string& name, std::vector<Value>& args, int line)
+{
+    const FunctionRef* ref = _index.find_function(name, _file);
+    if(!ref) {_diag.error("Callee is not a function or struct template", _file, line); return {};}
+
+    auto it = _table.find(ref->func);
+    if(it != _table.end()) {return it->second.fn(*it->second.runtime, args);}
+
+    // модуль с этой функцией ещё не загружен или исполняется интерпретатором
+    return fallback().call_function(*ref, args);
+}
+
+Value AotRuntime::call_pure(size_t function, AotFunction body, std::vector<Value>& args)
+{
+    MemoCache* memo = function < functions.size() ? Memoization::instance().cache_for(*functions[function], _index, _file, _diag) : nullptr;
+    if(!memo || !std::all_of(args.begin(), args.end(), is_hashable)) {return body(*this, args);}
+    if(const Value* hit = memo->find(args)) {return *hit;}
+
+    // тело может переписать args хвостовым вызовом самой себя, ключом остаются исходные аргументы
+    std::vector<Value> key = args;
+    Value result = body(*this, args);
+    memo->insert(key, result);
+    return result;
+}
+
+Value AotRuntime::call_struct(const Value& callee, const std::vector<Value>& args, int line)
+{
+    if(callee.type != ValueType::STRUCT) {_diag.error("Callee is not a function or struct template", _file, line); return {};}
+    return construct_struct(callee, args);
+}
+
+Value AotRuntime::arity_error(const char* name, size_t expected, size_t got)
+{
+    std::cerr << "[ERROR] Function " << name << " expects " << expected << " args, got " << got << "\n";
+    return {};
+}
+
+int AotRuntime::repeat_count(const Value& count, int line)
+{
+    if(count.type == ValueType::INTEGER) {return std::get<int>(count.data);}
+    if(count.type == ValueType::DOUBLE)  {return static_cast<int>(std::get<double>(count.data));}
+    _diag.error("repeat() count must be numeric", _file, line);
+    return 0;
+}
+
+Value AotRuntime::index_assign(const std::string& name, std::vector<Value>& indices, const Value& new_val, int line)
+{
+    Value container = _env.take(name, _file, line);
+    std::reverse(indices.begin(), indices.end());
+
+    bool stored = assign_indexed(container, indices, new_val, _diag, _file, line);
+    if(container.type != ValueType::NONE) {_env.assign(name, std::move(container), _file, line);}
+    return stored ? new_val : Value();
+}
+
+void AotRuntime::add_function(size_t function, AotFunction fn)
+{
+    if(function < functions.size()) {_table[functions[function]] = {fn, this};}
+}
+
+Value AotRuntime::eval_expression(size_t node) {return fallback().eval_expression(expressions[node]);}
+
+Value AotRuntime::eval_statement(size_t node) {return fallback().eval_statement(statements[node]);}
@@ -0,0 +1,96 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_AOTRUNTIME_H
+#define BERESTALANGUAGE_AOTRUNTIME_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "runtime/builtin/core/IBuiltinFunction.h"
+#include "runtime/environment/Environment.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/value/Value.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Evaluator;
+class FunctionIndex;
+struct Expression;
+struct Statement;
+struct FunctionStatement;
+
+// этот заголовок включает сгенерированный код, при изменении интерфейса нужно поднять версию, она входит в ключ кеша
+inline constexpr int AOT_ABI_VERSION = 15;
+
+class AotRuntime;
+using AotFunction = Value(*)(AotRuntime& rt, std::vector<Value>& args);
+
+// уже загруженные функции всех AOT-модулей, через неё идут вызовы между модулями
+struct AotBinding
+{
+    AotFunction fn = nullptr;
+    AotRuntime* runtime = nullptr;
+};
+using AotFunctionTable = std::unordered_map<const FunctionStatement*, AotBinding>;
+
+// скоуп окружения на время C++ блока, снимается и при выходе через return/goto/исключение
+struct AotScope
+{
+    Environment& env;
+    explicit AotScope(Environment& e) : env(e) {env.push_scope();}
+    ~AotScope() {env.pop_scope();}
+    AotScope(const AotScope&) = delete;
+    AotScope& operator=(const AotScope&) = delete;
+};
+
+// всё, что видит сгенерированный модуль: окружение, builtin'ы, чужие функции и откат в Evaluator для редких узлов
+class BERESTA_API AotRuntime
+{
+    public:
+        AotRuntime(Environment& env, FunctionIndex& index, std::string file, Diagnostics& diag, AotFunctionTable& table);
+        ~AotRuntime();
+
+        [[nodiscard]] int abi_version() const {return AOT_ABI_VERSION;}
+        Environment& env() {return _env;}
+        Diagnostics& diag() {return _diag;}
+        [[nodiscard]] const std::string& file() const {return _file;}
+
+        IBuiltinFunction* builtin(const char* name);
+        Value call_builtin(IBuiltinFunction* fn, const std::vector<Value>& args, int line);
+        Value call_function(const std::string& name, std::vector<Value>& args, int line);
+        Value call_struct(const Value& callee, const std::vector<Value>& args, int line);
+        // тело pure-функции function за кешем Memoization; если модификатор снят проверкой, тело зовётся напрямую
+        Value call_pure(size_t function, AotFunction body, std::vector<Value>& args);
+
+        Value arity_error(const char* name, size_t expected, size_t got);
+        int repeat_count(const Value& count, int line);
+        Value index_assign(const std::string& name, std::vector<Value>& indices, const Value& new_val, int line);
+
+        // function - порядковый номер функции модуля, node - номер узла в таблицах ниже
+        void add_function(size_t function, AotFunction fn);
+        Value eval_expression(size_t node);
+        Value eval_statement(size_t node);
+
+        // заполняет AotTranspiler в том же порядке, в каком раздавал номера
+        std::vector<FunctionStatement*> functions;
+        std::vector<Expression*> expressions;
+        std::vector<Statement*> statements;
+
+    private:
+        Environment& _env;
+        FunctionIndex& _index;
+        std::string _file;
+        Diagnostics& _diag;
+        AotFunctionTable& _table;
+        std::unique_ptr<Evaluator> _fallback;
+
+        Evaluator& fallback();
+};
+
+
+#endif //BERESTALANGUAGE_AOTRUNTIME_H
@@ -0,0 +1,800 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "AotTranspiler.h"
+#include "AotRuntime.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/evaluator/SwitchTable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    std::string cpp_string(const std::string& s)
+    {
+        std::string out = "\"";
+        for(unsigned char c : s)
+        {
+            if(c == '"' || c == '\\')  {out += '\\'; out += static_cast<char>(c);}
+            else if(c >= 32 && c < 127) {out += static_cast<char>(c);}
+            else
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\%03o", c);
+                out += buf;
+            }
+        }
+        return out + "\"";
+    }
+
+    std::string cpp_value(const Value& v)
+    {
+        switch(v.type)
+        {
+            case ValueType::INTEGER:
+            {
+                int i = std::get<int>(v.data);
+                if(i == INT32_MIN) {return "Value(-2147483647 - 1)";}
+                return "Value(" + std::to_string(i) + ")";
+            }
+
+            case ValueType::DOUBLE:
+            {
+                double d = std::get<double>(v.data);
+                if(std::isnan(d)) {return "Value(NAN)";}
+                if(std::isinf(d)) {return d > 0 ? "Value(HUGE_VAL)" : "Value(-HUGE_VAL)";}
+
+                // hexfloat переносит double без потери точности
+                char buf[64];
+                std::snprintf(buf, sizeof(buf), "%a", d);
+                return std::string("Value(") + buf + ")";
+            }
+
+            case ValueType::BOOLEAN: {return std::get<bool>(v.data) ? "Value(true)" : "Value(false)";}
+            case ValueType::STRING:
+            {
+                const auto& s = std::get<std::string>(v.data);
+                return "Value(std::string(" + cpp_string(s) + ", " + std::to_string(s.size()) + "))";
+            }
+
+            default: {return "Value()";}
+        }
+    }
+
+    const char* binary_op_name(BinaryOp op)
+    {
+        switch(op)
+        {
+            case BinaryOp::ADD:           {return "BinaryOp::ADD";}
+            case BinaryOp::SUB:           {return "BinaryOp::SUB";}
+            case BinaryOp::MUL:           {return "BinaryOp::MUL";}
+            case BinaryOp::DIV:           {return "BinaryOp::DIV";}
+            case BinaryOp::MOD:           {return "BinaryOp::MOD";}
+            case BinaryOp::EQUAL:         {return "BinaryOp::EQUAL";}
+            case BinaryOp::NOT_EQUAL:     {return "BinaryOp::NOT_EQUAL";}
+            case BinaryOp::LESS:          {return "BinaryOp::LESS";}
+            case BinaryOp::LESS_EQUAL:    {return "BinaryOp::LESS_EQUAL";}
+            case BinaryOp::GREATER:       {return "BinaryOp::GREATER";}
+            case BinaryOp::GREATER_EQUAL: {return "BinaryOp::GREATER_EQUAL";}
+            case BinaryOp::AND:           {return "BinaryOp::AND";}
+            case BinaryOp::OR:            {return "BinaryOp::OR";}
+            default:                      {return "BinaryOp::UNKNOWN";}
+        }
+    }
+
+    std::string join(const std::vector<std::string>& items)
+    {
+        std::string out;
+        for(size_t i = 0; i < items.size(); ++i)
+        {
+            if(i) {out += ", ";}
+            out += items[i];
+        }
+        return out;
+    }
+}
+
+AotTranspiler::AotTranspiler(FunctionIndex& index, std::string file) : _index(index), _file(std::move(file)), _tail_calls(index) {}
+
+void AotTranspiler::line(const std::string& text)
+{
+    if(!text.empty()) {_out << std::string(_indent * 4, ' ') << text;}
+    _out << "\n";
+}
+
+void AotTranspiler::open()  {line("{"); ++_indent;}
+void AotTranspiler::close() {--_indent; line("}");}
+
+std::string AotTranspiler::temp(const std::string& prefix) {return prefix + std::to_string(_temps++);}
+std::string AotTranspiler::label(const std::string& prefix) {return prefix + std::to_string(_labels++);}
+
+std::string AotTranspiler::name_ref(const std::string& name)
+{
+    auto [it, inserted] = _name_ids.emplace(name, _names.size());
+    if(inserted) {_names.push_back(name);}
+    return "N[" + std::to_string(it->second) + "]";
+}
+
+std::string AotTranspiler::constant_ref(const Value& value)
+{
+    std::string init = cpp_value(value);
+    auto [it, inserted] = _constant_ids.emplace(init, _constants.size());
+    if(inserted) {_constants.push_back(init);}
+    return "K[" + std::to_string(it->second) + "]";
+}
+
+std::string AotTranspiler::builtin_ref(const std::string& name)
+{
+    auto [it, inserted] = _builtin_ids.emplace(name, _builtins.size());
+    if(inserted) {_builtins.push_back(name);}
+    return "B[" + std::to_string(it->second) + "]";
+}
+
+std::string AotTranspiler::fallback_expression(Expression* expr)
+{
+    std::string t = temp();
+    line("Value " + t + " = rt.eval_expression(" + std::to_string(_unit.expressions.size()) + ");");
+    _unit.expressions.push_back(expr);
+    return t;
+}
+
+void AotTranspiler::fallback_statement(Statement* stmt, const std::string& result)
+{
+    std::string call = "rt.eval_statement(" + std::to_string(_unit.statements.size()) + ");";
+    _unit.statements.push_back(stmt);
+    line(result.empty() ? call : result + " = " + call);
+}
+
+AotUnit AotTranspiler::translate(const std::vector<std::unique_ptr<Statement>>& ast)
+{
+    _unit = AotUnit();
+
+    std::vector<FunctionStatement*> functions;
+    for(const auto& st : ast)
+    {
+        if(st && st->type == StatementType::FUNCTION)
+        {
+            // генераторы исполняет Evaluator: вызов пойдёт через rt.call_function и его откат
+            auto* fn = static_cast<FunctionStatement*>(st.get());
+            if(fn->is_generator) {continue;}
+            _function_ids[fn] = functions.size();
+            functions.push_back(fn);
+        }
+    }
+    _unit.functions = functions;
+
+    _indent = 1;
+    for(size_t i = 0; i < functions.size(); ++i) {emit_function(*functions[i], i);}
+    std::string function_code = _out.str();
+    _out.str("");
+
+    _indent = 1;
+    for(const auto& st : ast)
+    {
+        if(st && st->type != StatementType::FUNCTION) {emit_statement(st.get(), "");}
+    }
+    std::string main_code = _out.str();
+    _out.str("");
+
+    std::ostringstream src;
+    src << "// " << _file << ", сгенерировано AotTranspiler (abi " << AOT_ABI_VERSION << ")\n";
+    src << "#include \"runtime/aot/AotRuntime.h\"\n";
+    src << "#include \"runtime/evaluator/SwitchTable.h\"\n";
+    src << "#include <cmath>\n\n";
+    src << "namespace\n{\n";
+
+    std::vector<std::string> names;
+    for(const auto& n : _names) {names.push_back(cpp_string(n));}
+    names.emplace_back("\"\"");
+    src << "    const std::string N[] = {" << join(names) << "};\n";
+
+    std::vector<std::string> constants = _constants;
+    constants.emplace_back("Value()");
+    src << "    const Value K[] = {" << join(constants) << "};\n";
+    src << "    IBuiltinFunction* B[" << std::max<size_t>(_builtins.size(), 1) << "] = {};\n\n";
+
+    for(size_t i = 0; i < functions.size(); ++i)
+    {
+        src << "    Value f" << i << "(AotRuntime& rt, std::vector<Value>& args);\n";
+    }
+    if(!functions.empty()) {src << "\n";}
+
+    src << function_code << "}\n\n";
+
+    src << "extern \"C\" int beresta_aot_main(AotRuntime* runtime)\n{\n";
+    src << "    AotRuntime& rt = *runtime;\n";
+    for(size_t i = 0; i < _builtins.size(); ++i)
+    {
+        src << "    B[" << i << "] = rt.builtin(" << cpp_string(_builtins[i]) << ");\n";
+    }
+    for(size_t i = 0; i < functions.size(); ++i)
+    {
+        src << "    rt.add_function(" << i << ", &f" << i << ");\n";
+    }
+    src << "\n" << main_code << "    return 1;\n}\n";
+
+    _unit.source = src.str();
+    return std::move(_unit);
+}
+
+void AotTranspiler::emit_function(FunctionStatement& fn, size_t id)
+{
+    _in_function = true;
+    _function = &fn;
+    _tail_used = false;
+    _break_labels.clear();
+    _continue_labels.clear();
+
+    // pure-функцию оборачивает rt.call_pure: кеш и проверка чистоты те же, что у Evaluator
+    std::string name = "f" + std::to_string(id) + (fn.is_pure ? "_body" : "");
+    std::string params = std::to_string(fn.parameters.size());
+    line("Value " + name + "(AotRuntime& rt, std::vector<Value>& args)");
+    open();
+    line("if(args.size() != " + params + ") {return rt.arity_error(" + cpp_string(fn.name) + ", " + params + ", args.size());}");
+
+    // тело пишется отдельно: метка для хвостовых вызовов самой себя нужна, только если на неё есть goto
+    std::string head = _out.str();
+    _out.str("");
+    open();
+    line("AotScope scope(rt.env());");
+    for(size_t i = 0; i < fn.parameters.size(); ++i)
+    {
+        line("rt.env().define(" + name_ref(fn.parameters[i]) + ", args[" + std::to_string(i) + "]);");
+    }
+
+    // функция без return возвращает значение последнего оператора тела, как в Evaluator
+    line("Value result;");
+    emit_statement(fn.body.get(), "result");
+    line("return result;");
+    close();
+    std::string body = _out.str();
+
+    _out.str("");
+    _out << head;
+    if(_tail_used) {line("tail:");}
+    _out << body;
+    close();
+    line("");
+
+    if(fn.is_pure)
+    {
+        line("Value f" + std::to_string(id) + "(AotRuntime& rt, std::vector<Value>& args) {return rt.call_pure(" + std::to_string(id) + ", &" + name + ", args);}");
+        line("");
+    }
+
+    _in_function = false;
+    _function = nullptr;
+}
+
+// return f(...) самой себя, если TailCallAnalysis разрешает переиспользовать кадр: новые аргументы и goto в начало.
+// Хвостовые вызовы других функций остаются обычными вызовами C++
+bool AotTranspiler::emit_tail_call(ReturnStatement& stmt)
+{
+    if(!_function || !stmt.value || stmt.value->type != ExpressionType::FUNCTION_CALL) {return false;}
+
+    auto& call = static_cast<FunctionCallExpr&>(*stmt.value);
+    auto* var = dynamic_cast<VariableExpr*>(call.callee.get());
+    if(!var || BuiltinRegistry::instance().get(var->name)) {return false;}
+
+    const FunctionRef* ref = _index.find_function(var->name, _file);
+    if(!ref || ref->func != _function || call.arguments.size() != _function->parameters.size()) {return false;}
+    if(!_tail_calls.can_reuse_frame(*_function, _file, *ref)) {return false;}
+
+    open();
+    std::string args = emit_arguments(call);
+    line("args = std::move(" + args + ");");
+    line("goto tail;");
+    close();
+    _tail_used = true;
+    return true;
+}
+
+std::string AotTranspiler::emit_condition(Expression* expr)
+{
+    std::string t = temp();
+    if(!is_fused_condition(expr))
+    {
+        std::string v = emit_expression(expr);
+        line("bool " + t + " = condition_truthy(" + v + ", rt.diag(), rt.file(), " + std::to_string(expr->line) + ");");
+        return t;
+    }
+
+    auto& bin = *static_cast<BinaryExpr*>(expr);
+    if(bin.opcode == BinaryOp::AND || bin.opcode == BinaryOp::OR)
+    {
+        std::string l = emit_condition(bin.left.get());
+        line("bool " + t + " = " + l + ";");
+        line(std::string(bin.opcode == BinaryOp::AND ? "if(" : "if(!") + t + ")");
+        open();
+        std::string r = emit_condition(bin.right.get());
+        line(t + " = " + r + ";");
+        close();
+        return t;
+    }
+
+    std::string l = emit_expression(bin.left.get());
+    std::string r = emit_expression(bin.right.get());
+    line("bool " + t + " = apply_condition(" + binary_op_name(bin.opcode) + ", " + l + ", " + r + ", rt.diag(), rt.file(), " + std::to_string(bin.line) + ");");
+    return t;
+}
+
+std::string AotTranspiler::emit_expression(Expression* expr)
+{
+    if(!expr) {return constant_ref(Value());}
+
+    std::string at = ", rt.diag(), rt.file(), " + std::to_string(expr->line) + ");";
+
+    switch(expr->type)
+    {
+        case ExpressionType::NUMBER:  {return constant_ref(static_cast<NumberExpr*>(expr)->value);}
+        case ExpressionType::STRING:  {return constant_ref(Value(static_cast<StringExpr*>(expr)->value));}
+        case ExpressionType::BOOLEAN: {return constant_ref(Value(static_cast<BoolExpr*>(expr)->value));}
+
+        case ExpressionType::VARIABLE:
+        {
+            std::string t = temp();
+            line("Value " + t + " = rt.env().get(" + name_ref(static_cast<VariableExpr*>(expr)->name) + ", rt.file(), " + std::to_string(expr->line) + ");");
+            return t;
+        }
+
+        case ExpressionType::UNARY:
+        {
+            auto& un = *static_cast<UnaryExpr*>(expr);
+            std::string r = emit_expression(un.right.get());
+            std::string t = temp();
+            line("Value " + t + " = apply_unary(static_cast<char>(" + std::to_string(static_cast<int>(un.op)) + "), " + r + at);
+            return t;
+        }
+
+        case ExpressionType::BINARY:
+        {
+            auto& bin = *static_cast<BinaryExpr*>(expr);
+            std::string l = emit_expression(bin.left.get());
+            std::string t = temp();
+            if(bin.opcode == BinaryOp::AND || bin.opcode == BinaryOp::OR)
+            {
+                // правый операнд вычисляется, только если левый не решил результат
+                std::string op = binary_op_name(bin.opcode);
+                line("Value " + t + " = " + l + ";");
+                line("if(!short_circuits(" + op + ", " + t + "))");
+                open();
+                std::string r = emit_expression(bin.right.get());
+                line(t + " = apply_binary(" + op + ", " + t + ", " + r + at);
+                close();
+                return t;
+            }
+
+            std::string r = emit_expression(bin.right.get());
+            line("Value " + t + " = apply_binary_fast<" + binary_op_name(bin.opcode) + ">(" + l + ", " + r + at);
+            return t;
+        }
+
+        case ExpressionType::FUNCTION_CALL: {return emit_call(*static_cast<FunctionCallExpr*>(expr));}
+
+        case ExpressionType::ARRAY_LITERAL:
+        {
+            std::vector<std::string> elements;
+            for(auto& e : static_cast<ArrayLiteralExpr*>(expr)->elements) {elements.push_back(emit_expression(e.get()));}
+            std::string t = temp();
+            line("Value " + t + " = Value(std::vector<Value>{" + join(elements) + "});");
+            return t;
+        }
+
+        case ExpressionType::INDEX:
+        {
+            auto& ix = *static_cast<IndexExpr*>(expr);
+            std::string c = emit_expression(ix.array.get());
+            std::string i = emit_expression(ix.index.get());
+            std::string t = temp();
+            line("Value " + t + " = index_value(" + c + ", " + i + at);
+            return t;
+        }
+
+        // словари, структуры и доступ к членам исполняет Evaluator, как и в ClosureCompiler
+        default: {return fallback_expression(expr);}
+    }
+}
+
+std::string AotTranspiler::emit_arguments(FunctionCallExpr& expr)
+{
+    std::vector<std::string> args;
+    for(auto& a : expr.arguments) {args.push_back(emit_expression(a.get()));}
+
+    std::string vec = temp("a");
+    line("std::vector<Value> " + vec + "{" + join(args) + "};");
+    return vec;
+}
+
+std::string AotTranspiler::emit_call(FunctionCallExpr& expr)
+{
+    std::string at = std::to_string(expr.line);
+
+    if(auto* var = dynamic_cast<VariableExpr*>(expr.callee.get()))
+    {
+        if(BuiltinRegistry::instance().get(var->name))
+        {
+            std::string args = emit_arguments(expr);
+            std::string t = temp();
+            line("Value " + t + " = rt.call_builtin(" + builtin_ref(var->name) + ", " + args + ", " + at + ");");
+            return t;
+        }
+
+        if(const FunctionRef* ref = _index.find_function(var->name, _file))
+        {
+            std::string args = emit_arguments(expr);
+            std::string t = temp();
+
+            // функции своего модуля зовём напрямую, чужие - через таблицу AotRuntime
+            auto it = _function_ids.find(ref->func);
+            if(it != _function_ids.end()) {line("Value " + t + " = f" + std::to_string(it->second) + "(rt, " + args + ");");}
+            else                          {line("Value " + t + " = rt.call_function(" + name_ref(var->name) + ", " + args + ", " + at + ");");}
+            return t;
+        }
+    }
+
+    // шаблон структуры: аргументов вычисляется не больше, чем в нём полей
+    std::string callee = emit_expression(expr.callee.get());
+    std::string args = temp("a");
+    std::string count = temp("n");
+    line("std::vector<Value> " + args + ";");
+    line("size_t " + count + " = " + callee + ".type == ValueType::STRUCT ? std::min<size_t>(struct_field_count(" + callee + "), " + std::to_string(expr.arguments.size()) + ") : 0;");
+    for(size_t i = 0; i < expr.arguments.size(); ++i)
+    {
+        line("if(" + count + " > " + std::to_string(i) + ")");
+        open();
+        std::string a = emit_expression(expr.arguments[i].get());
+        line(args + ".push_back(" + a + ");");
+        close();
+    }
+
+    std::string t = temp();
+    line("Value " + t + " = rt.call_struct(" + callee + ", " + args + ", " + at + ");");
+    return t;
+}
+
+void AotTranspiler::emit_statement(Statement* stmt, const std::string& result)
+{
+    if(!stmt)
+    {
+        if(!result.empty()) {line(result + " = Value();");}
+        return;
+    }
+
+    switch(stmt->type)
+    {
+        case StatementType::ASSIGNMENT:
+        {
+            auto& as = *static_cast<Assignment*>(stmt);
+            open();
+            std::string v = emit_expression(as.value.get());
+            if(as.is_let) {line("rt.env().define(" + name_ref(as.name) + ", " + v + ");");}
+            else          {line("rt.env().assign(" + name_ref(as.name) + ", " + v + ", rt.file(), " + std::to_string(as.line) + ");");}
+            if(!result.empty()) {line(result + " = " + v + ";");}
+            close();
+            return;
+        }
+
+        case StatementType::ASSIGNMENT_STATEMENT: {emit_statement(static_cast<AssignmentStatement*>(stmt)->assignment.get(), result); return;}
+
+        case StatementType::EXPRESSION:
+        {
+            open();
+            std::string v = emit_expression(static_cast<ExpressionStatement*>(stmt)->expression.get());
+            if(!result.empty()) {line(result + " = " + v + ";");}
+            close();
+            return;
+        }
+
+        case StatementType::IF:
+        {
+            auto& st = *static_cast<IfStatement*>(stmt);
+            open();
+            std::string c = emit_condition(st.condition.get());
+            line("if(" + c + ")");
+            open();
+            emit_statement(st.then_branch.get(), result);
+            close();
+            if(st.else_branch || !result.empty())
+            {
+                line("else");
+                open();
+                if(st.else_branch) {emit_statement(st.else_branch.get(), result);}
+                else               {line(result + " = Value();");}
+                close();
+            }
+            close();
+            return;
+        }
+
+        case StatementType::WHILE:            {emit_while(*static_cast<WhileStatement*>(stmt), result); return;}
+        case StatementType::REPEAT:           {emit_repeat(*static_cast<RepeatStatement*>(stmt), result); return;}
+        case StatementType::FOR:              {emit_for(*static_cast<ForStatement*>(stmt), result); return;}
+        case StatementType::FOREACH:          {emit_foreach(*static_cast<ForeachStatement*>(stmt), result); return;}
+        case StatementType::BLOCK:            {emit_block(*static_cast<BlockStatement*>(stmt), result); return;}
+        case StatementType::INDEX_ASSIGNMENT: {emit_index_assignment(*static_cast<IndexAssignment*>(stmt), result); return;}
+        case StatementType::SWITCH:           {emit_switch(*static_cast<SwitchStatement*>(stmt), result); return;}
+
+        // функции уже проиндексированы и собраны отдельно
+        case StatementType::FUNCTION:
+        {
+            if(!result.empty()) {line(result + " = Value();");}
+            return;
+        }
+
+        case StatementType::RETURN:
+        {
+            // return вне функции Evaluator бросает наружу, оставляем ему это поведение
+            if(!_in_function) {fallback_statement(stmt, result); return;}
+            if(emit_tail_call(*static_cast<ReturnStatement*>(stmt))) {return;}
+
+            open();
+            std::string v = emit_expression(static_cast<ReturnStatement*>(stmt)->value.get());
+            line("return " + v + ";");
+            close();
+            return;
+        }
+
+        case StatementType::BREAK:
+        {
+            if(_break_labels.empty()) {fallback_statement(stmt, result); return;}
+            line("goto " + _break_labels.back() + ";");
+            return;
+        }
+
+        case StatementType::CONTINUE:
+        {
+            if(_continue_labels.empty()) {fallback_statement(stmt, result); return;}
+            line("goto " + _continue_labels.back() + ";");
+            return;
+        }
+
+        // enum и #macros исполняются один раз, их переводить нет смысла
+        default: {fallback_statement(stmt, result); return;}
+    }
+}
+
+// тело цикла пишет результат только при обычном завершении, break/continue уходят goto мимо присваивания
+void AotTranspiler::emit_loop_body(Statement* body, const std::string& result, const std::string& continue_label)
+{
+    open();
+    if(result.empty()) {emit_statement(body, "");}
+    else
+    {
+        std::string b = temp("b");
+        line("Value " + b + ";");
+        emit_statement(body, b);
+        line(result + " = " + b + ";");
+    }
+    close();
+    line(continue_label + ":;");
+}
+
+void AotTranspiler::emit_while(WhileStatement& stmt, const std::string& result)
+{
+    std::string brk = label("brk");
+    std::string cont = label("cont");
+
+    open();
+    if(!result.empty()) {line(result + " = Value();");}
+    line("while(true)");
+    open();
+    open();
+    std::string c = emit_condition(stmt.condition.get());
+    line("if(!" + c + ") {goto " + brk + ";}");
+    close();
+
+    _break_labels.push_back(brk);
+    _continue_labels.push_back(cont);
+    emit_loop_body(stmt.body.get(), result, cont);
+    _break_labels.pop_back();
+    _continue_labels.pop_back();
+
+    close();
+    line(brk + ":;");
+    close();
+}
+
+void AotTranspiler::emit_repeat(RepeatStatement& stmt, const std::string& result)
+{
+    std::string brk = label("brk");
+    std::string cont = label("cont");
+
+    open();
+    std::string c = emit_expression(stmt.count.get());
+    if(!result.empty()) {line(result + " = Value();");}
+    std::string n = temp("n");
+    std::string i = temp("i");
+    line("int " + n + " = rt.repeat_count(" + c + ", " + std::to_string(stmt.line) + ");");
+    line("for(int " + i + " = 0; " + i + " < " + n + "; ++" + i + ")");
+    open();
+
+    _break_labels.push_back(brk);
+    _continue_labels.push_back(cont);
+    emit_loop_body(stmt.body.get(), result, cont);
+    _break_labels.pop_back();
+    _continue_labels.pop_back();
+
+    close();
+    line(brk + ":;");
+    close();
+}
+
+void AotTranspiler::emit_for(ForStatement& stmt, const std::string& result)
+{
+    std::string brk = label("brk");
+    std::string cont = label("cont");
+
+    open();
+    if(!result.empty()) {line(result + " = Value();");}
+    line("AotScope " + temp("s") + "(rt.env());");
+    if(stmt.initializer) {emit_statement(stmt.initializer.get(), "");}
+
+    line("while(true)");
+    open();
+    if(stmt.condition)
+    {
+        open();
+        std::string c = emit_condition(stmt.condition.get());
+        line("if(!" + c + ") {goto " + brk + ";}");
+        close();
+    }
+
+    _break_labels.push_back(brk);
+    _continue_labels.push_back(cont);
+    emit_loop_body(stmt.body.get(), result, cont);
+    _break_labels.pop_back();
+    _continue_labels.pop_back();
+
+    if(stmt.increment) {emit_statement(stmt.increment.get(), "");}
+    close();
+    line(brk + ":;");
+    close();
+}
+
+void AotTranspiler::emit_foreach(ForeachStatement& stmt, const std::string& result)
+{
+    std::string brk = label("brk");
+    std::string cont = label("cont");
+
+    open();
+    std::string it = emit_expression(stmt.iterable.get());
+    if(!result.empty()) {line(result + " = Value();");}
+    line("if(!is_iterable(" + it + ")) {rt.diag().error(\"foreach() expects an array, range or generator\", rt.file(), " + std::to_string(stmt.line) + ");}");
+    line("else");
+    open();
+    std::string cursor = temp("c");
+    std::string elem = temp("e");
+    line("ForeachCursor " + cursor + "(" + it + ");");
+    line("Value " + elem + ";");
+    line("while(" + cursor + ".next(" + elem + "))");
+    open();
+    line("AotScope " + temp("s") + "(rt.env());");
+    line("rt.env().define(" + name_ref(stmt.var_name) + ", " + elem + ");");
+
+    _break_labels.push_back(brk);
+    _continue_labels.push_back(cont);
+    emit_loop_body(stmt.body.get(), result, cont);
+    _break_labels.pop_back();
+    _continue_labels.pop_back();
+
+    close();
+    line(brk + ":;");
+    close();
+    close();
+}
+
+void AotTranspiler::emit_block(BlockStatement& stmt, const std::string& result)
+{
+    open();
+    line("AotScope " + temp("s") + "(rt.env());");
+    if(stmt.statements.empty() && !result.empty()) {line(result + " = Value();");}
+    for(size_t i = 0; i < stmt.statements.size(); ++i)
+    {
+        bool last = i + 1 == stmt.statements.size();
+        emit_statement(stmt.statements[i].get(), last ? result : "");
+    }
+    close();
+}
+
+void AotTranspiler::emit_index_assignment(IndexAssignment& stmt, const std::string& result)
+{
+    std::string at = std::to_string(stmt.line);
+    open();
+
+    std::vector<std::string> indices;
+    Expression* target_expr = stmt.target.get();
+    while(auto* idx = dynamic_cast<IndexExpr*>(target_expr))
+    {
+        indices.push_back(emit_expression(idx->index.get()));
+        target_expr = idx->array.get();
+    }
+
+    auto* var = dynamic_cast<VariableExpr*>(target_expr);
+    if(!var)
+    {
+        line("rt.diag().error(\"Indexed assignment target must be variable\", rt.file(), " + at + ");");
+        if(!result.empty()) {line(result + " = Value();");}
+        close();
+        return;
+    }
+
+    std::string name = name_ref(var->name);
+    std::string keys = temp("k");
+    line("std::vector<Value> " + keys + "{" + join(indices) + "};");
+    std::string v = emit_expression(stmt.value.get());
+    std::string r = temp();
+    line("Value " + r + " = rt.index_assign(" + name + ", " + keys + ", " + v + ", " + at + ");");
+    if(!result.empty()) {line(result + " = " + r + ";");}
+    close();
+}
+
+void AotTranspiler::emit_switch(SwitchStatement& stmt, const std::string& result)
+{
+    std::string brk = label("brk");
+
+    open();
+    std::string val = emit_expression(stmt.expression.get());
+    std::string matched = temp("m");
+    std::string value = result.empty() ? "" : temp("r");
+    line("bool " + matched + " = false;");
+    if(!value.empty()) {line("Value " + value + ";");}
+
+    // case из одних литералов: таблица собирается один раз, дальше каждый case сверяет только номер
+    bool literal = std::all_of(stmt.cases.begin(), stmt.cases.end(), [](const CaseClause& cs)
+    {
+        return !cs.value || (SwitchTable::is_constant_case(cs.value.get()) && SwitchTable::enum_member(cs.value.get()).empty());
+    });
+
+    std::string hit;
+    if(literal)
+    {
+        std::string table = temp("sw");
+        hit = temp("h");
+        line("static SwitchTable " + table + ";");
+        line("if(!" + table + ".ready())");
+        open();
+        for(size_t i = 0; i < stmt.cases.size(); ++i)
+        {
+            if(!stmt.cases[i].value) {line(table + ".add_default(" + std::to_string(i) + ");"); continue;}
+            std::string c = emit_expression(stmt.cases[i].value.get());
+            line(table + ".add_case(" + std::to_string(i) + ", " + c + ");");
+        }
+        line(table + ".finish();");
+        close();
+        line("int " + hit + " = " + table + ".match(" + val + ");");
+    }
+
+    // break внутри case выходит из switch, continue по-прежнему относится к внешнему циклу
+    _break_labels.push_back(brk);
+    open();
+    for(size_t i = 0; i < stmt.cases.size(); ++i)
+    {
+        auto& cs = stmt.cases[i];
+        open();
+        if(cs.value && literal) {line("if(" + hit + " == " + std::to_string(i) + ")"); open();}
+        else if(cs.value)
+        {
+            std::string c = emit_expression(cs.value.get());
+            line("if(" + val + ".to_string() == " + c + ".to_string())");
+            open();
+        }
+
+        line(matched + " = true;");
+        for(auto& s : cs.body) {emit_statement(s.get(), value);}
+
+        if(cs.value) {close();}
+        close();
+
+        // совпавший case останавливает перебор, default - нет (как в Evaluator)
+        if(cs.value) {line("if(" + matched + ") {goto " + brk + ";}");}
+    }
+    close();
+    _break_labels.pop_back();
+
+    line(brk + ":;");
+    if(!value.empty()) {line(result + " = " + value + ";");}
+    close();
+}
@@ -0,0 +1,94 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_AOTTRANSPILER_H
+#define BERESTALANGUAGE_AOTTRANSPILER_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "frontend/parser/Statement.h"
+#include "runtime/value/Value.h"
+#include "runtime/evaluator/TailCallAnalysis.h"
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FunctionIndex;
+
+// C++ исходник модуля и узлы AST, на которые он ссылается по номерам (функции и откат в Evaluator)
+struct AotUnit
+{
+    std::string source;
+    std::vector<FunctionStatement*> functions;
+    std::vector<Expression*> expressions;
+    std::vector<Statement*> statements;
+};
+
+// переводит AST модуля в C++ поверх AotRuntime: переменные остаются в Environment, управление - обычные if/while/goto
+class BERESTA_API AotTranspiler
+{
+    public:
+        AotTranspiler(FunctionIndex& index, std::string file);
+
+        AotUnit translate(const std::vector<std::unique_ptr<Statement>>& ast);
+
+    private:
+        FunctionIndex& _index;
+        std::string _file;
+        AotUnit _unit;
+
+        std::ostringstream _out;
+        int _indent = 0;
+        int _temps = 0;
+        int _labels = 0;
+        bool _in_function = false;
+        FunctionStatement* _function = nullptr;
+        bool _tail_used = false;
+        TailCallAnalysis _tail_calls;
+        std::vector<std::string> _break_labels;
+        std::vector<std::string> _continue_labels;
+
+        std::vector<std::string> _names;
+        std::unordered_map<std::string, size_t> _name_ids;
+        std::vector<std::string> _constants;
+        std::unordered_map<std::string, size_t> _constant_ids;
+        std::vector<std::string> _builtins;
+        std::unordered_map<std::string, size_t> _builtin_ids;
+        std::unordered_map<const FunctionStatement*, size_t> _function_ids;
+
+        void line(const std::string& text);
+        void open();
+        void close();
+        std::string temp(const std::string& prefix = "t");
+        std::string label(const std::string& prefix);
+
+        std::string name_ref(const std::string& name);
+        std::string constant_ref(const Value& value);
+        std::string builtin_ref(const std::string& name);
+        std::string fallback_expression(Expression* expr);
+        void fallback_statement(Statement* stmt, const std::string& result);
+
+        std::string emit_expression(Expression* expr);
+        std::string emit_condition(Expression* expr);
+        std::string emit_call(FunctionCallExpr& expr);
+        std::string emit_arguments(FunctionCallExpr& expr);
+
+        void emit_statement(Statement* stmt, const std::string& result);
+        void emit_loop_body(Statement* body, const std::string& result, const std::string& continue_label);
+        void emit_while(WhileStatement& stmt, const std::string& result);
+        void emit_repeat(RepeatStatement& stmt, const std::string& result);
+        void emit_for(ForStatement& stmt, const std::string& result);
+        void emit_foreach(ForeachStatement& stmt, const std::string& result);
+        void emit_block(BlockStatement& stmt, const std::string& result);
+        void emit_index_assignment(IndexAssignment& stmt, const std::string& result);
+        void emit_switch(SwitchStatement& stmt, const std::string& result);
+        void emit_function(FunctionStatement& fn, size_t id);
+        bool emit_tail_call(ReturnStatement& stmt);
+};
+
+
+#endif //BERESTALANGUAGE_AOTTRANSPILER_H
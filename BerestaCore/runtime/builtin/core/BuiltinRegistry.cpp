@@ -13,6 +13,12 @@ void register_builtin_random();
 void register_builtin_matrix_core();
 void register_builtin_array();
 void register_builtin_dictionary();
+void register_builtin_memo();
+void register_builtin_range();
+void register_builtin_struct_array();
+void register_builtin_set();
+void register_builtin_deque();
+void register_builtin_stats();
 
 BuiltinRegistry& BuiltinRegistry::instance()
 {
@@ -41,6 +47,10 @@ static Environment* g_active_env = nullptr;
 void set_active_environment(Environment* env) {g_active_env = env;}
 Environment* get_active_environment() {return g_active_env;}
 
+static Evaluator* g_active_evaluator = nullptr;
+void set_active_evaluator(Evaluator* evaluator) {g_active_evaluator = evaluator;}
+Evaluator* get_active_evaluator() {return g_active_evaluator;}
+
 void register_default_builtins()
 {
     register_builtin_console_print();
@@ -50,4 +60,10 @@ void register_default_builtins()
     register_builtin_matrix_core();
     register_builtin_array();
     register_builtin_dictionary();
+    register_builtin_memo();
+    register_builtin_range();
+    register_builtin_struct_array();
+    register_builtin_set();
+    register_builtin_deque();
+    register_builtin_stats();
 }
@@ -32,5 +32,19 @@ class Environment;
 void set_active_environment(Environment* env);
 Environment* get_active_environment();
 
+class Evaluator;
+
+// Evaluator, через который builtin с calls_back() зовёт функции языка; ставится только на время такого вызова
+void set_active_evaluator(Evaluator* evaluator);
+Evaluator* get_active_evaluator();
+
+struct ActiveEvaluator
+{
+    explicit ActiveEvaluator(Evaluator* evaluator) : saved(get_active_evaluator()) {set_active_evaluator(evaluator);}
+    ~ActiveEvaluator() {set_active_evaluator(saved);}
+
+    Evaluator* saved;
+};
+
 
 #endif //BERESTALANGUAGE_BUILTINREGISTRY_H
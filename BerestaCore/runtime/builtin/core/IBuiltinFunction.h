@@ -15,6 +15,10 @@ struct IBuiltinFunction
 {
     virtual ~IBuiltinFunction() = default;
     [[nodiscard]] virtual std::string name() const = 0;
+    // false - побочный эффект или недетерминированный результат, такой builtin нельзя звать из pure-функции
+    [[nodiscard]] virtual bool is_pure() const {return true;}
+    // true - вызывает функции языка через get_active_evaluator(), исполнитель ставит его перед invoke
+    [[nodiscard]] virtual bool calls_back() const {return false;}
     virtual Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) = 0;
 };
 
@@ -5,17 +5,87 @@
 #include "BuiltinArray.h"
 #include "runtime/builtin/core/BuiltinRegistry.h"
 #include "runtime/builtin/core/BuiltinUtils.h"
+#include "runtime/builtin/functions/stats/StatsKernels.h"
+#include "frontend/parser/Statement.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/evaluator/Evaluator.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/value/StructArray.h"
+#include "runtime/value/PersistentVector.h"
+#include "runtime/value/PackedArray.h"
+#include "runtime/value/ArraySlice.h"
+#include "runtime/value/SparseArray.h"
+#include "runtime/value/ValueSort.h"
 #include <algorithm>
 #include <random>
 #include <cmath>
+#include <limits>
 
 static bool ensure_array_arg(Diagnostics& diag, const std::string& file, int line, const std::vector<Value>& args, size_t idx, const std::string& name)
 {
     if(idx >= args.size()) {diag.error(name + ": missing argument #" + std::to_string(idx), file, line); return false;}
-    if(args[idx].type != ValueType::ARRAY) {diag.error(name + ": argument #" + std::to_string(idx) + " must be array", file, line); return false;}
+    if(!is_array(args[idx])) {diag.error(name + ": argument #" + std::to_string(idx) + " must be array", file, line); return false;}
     return true;
 }
 
+// элементы подряд для операций, которым всё равно нужен весь массив
+static const std::vector<Value>& array_items(const Value& v, std::vector<Value>& scratch)
+{
+    if(v.type == ValueType::ARRAY) {return std::get<std::vector<Value>>(v.data);}
+    if(v.type == ValueType::PACKED_ARRAY)     {scratch = std::get<std::shared_ptr<PackedArray>>(v.data)->to_values();}
+    else if(v.type == ValueType::ARRAY_SLICE) {scratch = std::get<std::shared_ptr<ArraySlice>>(v.data)->to_vector();}
+    else if(v.type == ValueType::SPARSE_ARRAY) {scratch = std::get<std::shared_ptr<SparseArray>>(v.data)->to_vector();}
+    else                                      {scratch = std::get<std::shared_ptr<PersistentVector>>(v.data)->to_vector();}
+    return scratch;
+}
+
+static std::vector<Value> array_copy(const Value& v)
+{
+    if(v.type == ValueType::ARRAY) {return std::get<std::vector<Value>>(v.data);}
+    std::vector<Value> scratch;
+    array_items(v, scratch);
+    return scratch;
+}
+
+static size_t array_size(const Value& v)
+{
+    if(v.type == ValueType::PERSISTENT_VECTOR) {return std::get<std::shared_ptr<PersistentVector>>(v.data)->size();}
+    if(v.type == ValueType::PACKED_ARRAY) {return std::get<std::shared_ptr<PackedArray>>(v.data)->size();}
+    if(v.type == ValueType::ARRAY_SLICE) {return std::get<std::shared_ptr<ArraySlice>>(v.data)->size();}
+    if(v.type == ValueType::SPARSE_ARRAY) {return std::get<std::shared_ptr<SparseArray>>(v.data)->size();}
+    return std::get<std::vector<Value>>(v.data).size();
+}
+
+static Value array_at(const Value& v, size_t i)
+{
+    if(v.type == ValueType::PERSISTENT_VECTOR) {return std::get<std::shared_ptr<PersistentVector>>(v.data)->at(i);}
+    if(v.type == ValueType::PACKED_ARRAY) {return std::get<std::shared_ptr<PackedArray>>(v.data)->get(i);}
+    if(v.type == ValueType::ARRAY_SLICE) {return std::get<std::shared_ptr<ArraySlice>>(v.data)->at(i);}
+    if(v.type == ValueType::SPARSE_ARRAY) {return std::get<std::shared_ptr<SparseArray>>(v.data)->at(i);}
+    return std::get<std::vector<Value>>(v.data)[i];
+}
+
+static PackedArray* packed_arg(const Value& v) {return v.type == ValueType::PACKED_ARRAY ? std::get<std::shared_ptr<PackedArray>>(v.data).get() : nullptr;}
+
+// с этого размера функциональные правки переводят массив в постоянный вектор: копия всего vector
+// становится дороже спуска по дереву, а старая версия остаётся целой без копирования.
+// Плотный массив при такой правке тоже становится обычным: результат - новый массив, а не общий
+static constexpr size_t PERSISTENT_MIN = 64;
+
+static bool wants_persistent(const Value& v)
+{
+    return v.type == ValueType::PERSISTENT_VECTOR || array_size(v) >= PERSISTENT_MIN;
+}
+
+static PersistentVector to_persistent(const Value& v)
+{
+    if(v.type == ValueType::PERSISTENT_VECTOR) {return *std::get<std::shared_ptr<PersistentVector>>(v.data);}
+    std::vector<Value> scratch;
+    return PersistentVector(array_items(v, scratch));
+}
+
+static Value persistent_value(PersistentVector vec) {return Value(std::make_shared<PersistentVector>(std::move(vec)));}
+
 static bool to_index_nonneg(const Value& v, size_t& out)
 {
     long long i = 0;
@@ -29,6 +99,18 @@ static bool to_index_nonneg(const Value& v, size_t& out)
 
 static bool value_equals(const Value& a, const Value& b)
 {
+    if(is_array(a) && is_array(b))
+    {
+        std::vector<Value> sa, sb;
+        const auto& va = array_items(a, sa);
+        const auto& vb = array_items(b, sb);
+        if(va.size() != vb.size()) return false;
+        for(size_t i = 0; i < va.size(); ++i)
+        {
+            if(!value_equals(va[i], vb[i])) {return false;}
+        }
+        return true;
+    }
     if(a.type != b.type) return false;
     switch(a.type)
     {
@@ -36,52 +118,41 @@ static bool value_equals(const Value& a, const Value& b)
         case ValueType::DOUBLE:  {return std::get<double>(a.data) == std::get<double>(b.data);}
         case ValueType::BOOLEAN: {return std::get<bool>(a.data) == std::get<bool>(b.data);}
         case ValueType::STRING:  {return std::get<std::string>(a.data) == std::get<std::string>(b.data);}
-        case ValueType::ARRAY:
-        {
-            const auto& va = std::get<std::vector<Value>>(a.data);
-            const auto& vb = std::get<std::vector<Value>>(b.data);
-            if(va.size() != vb.size()) return false;
-            for(size_t i = 0; i < va.size(); ++i)
-            {
-                if(!value_equals(va[i], vb[i])) {return false;}
-            }
-            return true;
-        }
         case ValueType::NONE: {return true;}
         default: {return false;}
     }
 }
 
-static bool value_less(const Value& a, const Value& b)
-{
-    if(a.type == ValueType::INTEGER && b.type == ValueType::INTEGER) {return std::get<int>(a.data) < std::get<int>(b.data);}
-    if(a.type == ValueType::DOUBLE && b.type == ValueType::DOUBLE) {return std::get<double>(a.data) < std::get<double>(b.data);}
-    if(a.type == ValueType::STRING && b.type == ValueType::STRING) {return std::get<std::string>(a.data) < std::get<std::string>(b.data);}
-    return a.type < b.type;
-}
 
 Value BuiltinArrayIsArray::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     ensure_arity(args, 1, 1);
-    return Value(args[0].type == ValueType::ARRAY);
+    return Value(is_array(args[0]));
 }
 
 Value BuiltinArrayLength::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     ensure_arity(args, 1, 1);
+    if(args[0].type == ValueType::RANGE)
+    {
+        // длина шире int возвращается числом double, как и результат арифметики
+        long long n = std::get<RangeValue>(args[0].data).size();
+        return n <= std::numeric_limits<int>::max() ? Value(static_cast<int>(n)) : Value(static_cast<double>(n));
+    }
+    if(args[0].type == ValueType::STRUCT_ARRAY) {return Value(static_cast<int>(std::get<std::shared_ptr<StructArray>>(args[0].data)->size()));}
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    return Value(static_cast<int>(std::get<std::vector<Value>>(args[0].data).size()));
+    return Value(static_cast<int>(array_size(args[0])));
 }
 
 Value BuiltinArrayGet::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     ensure_arity(args, 2, 2);
+    if(args[0].type == ValueType::RANGE || args[0].type == ValueType::STRUCT_ARRAY) {return index_value(args[0], args[1], diag, file, line);}
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
     size_t i = 0;
     if(!to_index_nonneg(args[1], i)) {diag.error("array_get: index must be non-negative", file, line); return {};}
-    const auto& v = std::get<std::vector<Value>>(args[0].data);
-    if(i >= v.size()) {diag.error("array_get: index out of bounds", file, line); return {};}
-    return v[i];
+    if(i >= array_size(args[0])) {diag.error("array_get: index out of bounds", file, line); return {};}
+    return array_at(args[0], i);
 }
 
 Value BuiltinArraySet::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
@@ -90,7 +161,14 @@ Value BuiltinArraySet::invoke(const std::vector<Value>& args, Diagnostics& diag,
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
     size_t i = 0;
     if(!to_index_nonneg(args[1], i)) {diag.error("array_set: index must be non-negative", file, line); return {};}
-    auto v = std::get<std::vector<Value>>(args[0].data);
+    if(wants_persistent(args[0]))
+    {
+        auto vec = to_persistent(args[0]);
+        if(i < vec.size()) {return persistent_value(vec.set(i, args[2]));}
+        while(vec.size() < i) {vec = vec.push(Value());}
+        return persistent_value(vec.push(args[2]));
+    }
+    auto v = array_copy(args[0]);
     if(i >= v.size()) {v.resize(i + 1, Value());}
     v[i] = args[2];
     return Value(v);
@@ -100,7 +178,8 @@ Value BuiltinArrayPush::invoke(const std::vector<Value>& args, Diagnostics& diag
 {
     ensure_min_arity(diag, file, line, args, 2);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    auto v = std::get<std::vector<Value>>(args[0].data);
+    if(wants_persistent(args[0])) {return persistent_value(to_persistent(args[0]).push(args[1]));}
+    auto v = array_copy(args[0]);
     v.push_back(args[1]);
     return Value(v);
 }
@@ -109,16 +188,22 @@ Value BuiltinArrayLast::invoke(const std::vector<Value>& args, Diagnostics& diag
 {
     ensure_arity(args, 1, 1);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    const auto& v = std::get<std::vector<Value>>(args[0].data);
-    if(v.empty()) {diag.error("array_last: empty array", file, line); return {};}
-    return v.back();
+    size_t n = array_size(args[0]);
+    if(n == 0) {diag.error("array_last: empty array", file, line); return {};}
+    return array_at(args[0], n - 1);
 }
 
 Value BuiltinArrayPop::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     ensure_arity(args, 1, 1);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    auto v = std::get<std::vector<Value>>(args[0].data);
+    if(args[0].type == ValueType::PERSISTENT_VECTOR)
+    {
+        const auto& vec = *std::get<std::shared_ptr<PersistentVector>>(args[0].data);
+        if(vec.empty()) {diag.error("array_pop: empty array", file, line); return args[0];}
+        return persistent_value(vec.erase(vec.size() - 1));
+    }
+    auto v = array_copy(args[0]);
     if(v.empty()) {diag.error("array_pop: empty array", file, line); return Value(v);}
     v.pop_back();
     return Value(v);
@@ -130,7 +215,12 @@ Value BuiltinArrayInsert::invoke(const std::vector<Value>& args, Diagnostics& di
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
     size_t i = 0;
     if(!to_index_nonneg(args[1], i)) {diag.error("array_insert: index must be non-negative", file, line); return {};}
-    auto v = std::get<std::vector<Value>>(args[0].data);
+    if(wants_persistent(args[0]))
+    {
+        auto vec = to_persistent(args[0]);
+        return persistent_value(vec.insert(std::min(i, vec.size()), args[2]));
+    }
+    auto v = array_copy(args[0]);
     if(i > v.size()) {i = v.size();}
     v.insert(v.begin() + static_cast<std::ptrdiff_t>(i), args[2]);
     return Value(v);
@@ -142,7 +232,13 @@ Value BuiltinArrayDelete::invoke(const std::vector<Value>& args, Diagnostics& di
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
     size_t i = 0;
     if(!to_index_nonneg(args[1], i)) {diag.error("array_delete: index must be non-negative", file, line); return {};}
-    auto v = std::get<std::vector<Value>>(args[0].data);
+    if(wants_persistent(args[0]))
+    {
+        auto vec = to_persistent(args[0]);
+        if(i >= vec.size()) {diag.error("array_delete: index out of bounds", file, line); return args[0];}
+        return persistent_value(vec.erase(i));
+    }
+    auto v = array_copy(args[0]);
     if(i >= v.size()) {diag.error("array_delete: index out of bounds", file, line); return Value(v);}
     v.erase(v.begin() + static_cast<std::ptrdiff_t>(i));
     return Value(v);
@@ -152,26 +248,41 @@ Value BuiltinArraySlice::invoke(const std::vector<Value>& args, Diagnostics& dia
 {
     ensure_min_arity(diag, file, line, args, 2);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    const auto& src = std::get<std::vector<Value>>(args[0].data);
+    size_t size = array_size(args[0]);
     size_t start = 0;
     if(!to_index_nonneg(args[1], start)) {diag.error("array_slice: start must be non-negative", file, line); return {};}
-    if(start >= src.size()) {return Value(std::vector<Value>{});}
-    size_t count = src.size() - start;
+    if(start >= size) {return Value(std::vector<Value>{});}
+    size_t count = size - start;
     if(args.size() >= 3)
     {
         size_t tmp = 0;
         if(!to_index_nonneg(args[2], tmp)) {diag.error("array_slice: count must be non-negative", file, line); return {};}
         count = tmp;
     }
-    size_t avail = src.size() - start;
-    size_t take = std::min(count, avail);
+    size_t take = std::min(count, size - start);
+
+    // срез среза - то же хранилище без копирования; из остальных массивов выбранные элементы копируются один раз
+    if(args[0].type == ValueType::ARRAY_SLICE) {return Value(std::make_shared<ArraySlice>(std::get<std::shared_ptr<ArraySlice>>(args[0].data)->slice(start, take)));}
+
     std::vector<Value> out;
     out.reserve(take);
-    for(size_t k = 0; k < take; ++k)
+    if(args[0].type == ValueType::ARRAY)
     {
-        out.push_back(src[start + k]);
+        const auto& src = std::get<std::vector<Value>>(args[0].data);
+        out.assign(src.begin() + static_cast<std::ptrdiff_t>(start), src.begin() + static_cast<std::ptrdiff_t>(start + take));
     }
-    return Value(out);
+    else
+    {
+        for(size_t k = 0; k < take; ++k) {out.push_back(array_at(args[0], start + k));}
+    }
+    return Value(std::make_shared<ArraySlice>(std::move(out)));
+}
+
+Value BuiltinArrayDense::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_dense")) {return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
+    return Value(array_copy(args[0]));
 }
 
 Value BuiltinArrayConcat::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
@@ -179,8 +290,10 @@ Value BuiltinArrayConcat::invoke(const std::vector<Value>& args, Diagnostics& di
     ensure_arity(args, 2, 2);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
     if(!ensure_array_arg(diag, file, line, args, 1, name())) {return {};}
-    auto a = std::get<std::vector<Value>>(args[0].data);
-    const auto& b = std::get<std::vector<Value>>(args[1].data);
+    if(wants_persistent(args[0]) || wants_persistent(args[1])) {return persistent_value(PersistentVector::concat(to_persistent(args[0]), to_persistent(args[1])));}
+    auto a = array_copy(args[0]);
+    std::vector<Value> scratch;
+    const auto& b = array_items(args[1], scratch);
     a.insert(a.end(), b.begin(), b.end());
     return Value(a);
 }
@@ -189,7 +302,7 @@ Value BuiltinArrayReverse::invoke(const std::vector<Value>& args, Diagnostics& d
 {
     ensure_arity(args, 1, 1);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    auto v = std::get<std::vector<Value>>(args[0].data);
+    auto v = array_copy(args[0]);
     std::reverse(v.begin(), v.end());
     return Value(v);
 }
@@ -198,7 +311,9 @@ Value BuiltinArrayIndexOf::invoke(const std::vector<Value>& args, Diagnostics& d
 {
     ensure_min_arity(diag, file, line, args, 2);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    const auto& v = std::get<std::vector<Value>>(args[0].data);
+    if(PackedArray* packed = packed_arg(args[0])) {return Value(static_cast<int>(packed->find(args[1])));}
+    std::vector<Value> scratch;
+    const auto& v = array_items(args[0], scratch);
     for(size_t i = 0; i < v.size(); ++i)
     {
         if(value_equals(v[i], args[1])) {return Value(static_cast<int>(i));}
@@ -210,7 +325,9 @@ Value BuiltinArrayContains::invoke(const std::vector<Value>& args, Diagnostics&
 {
     ensure_min_arity(diag, file, line, args, 2);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    const auto& v = std::get<std::vector<Value>>(args[0].data);
+    if(PackedArray* packed = packed_arg(args[0])) {return Value(packed->find(args[1]) >= 0);}
+    std::vector<Value> scratch;
+    const auto& v = array_items(args[0], scratch);
     for(const auto& e : v)
     {
         if(value_equals(e, args[1])) {return Value(true);}
@@ -223,7 +340,8 @@ Value BuiltinArrayJoin::invoke(const std::vector<Value>& args, Diagnostics& diag
     ensure_min_arity(diag, file, line, args, 1);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
     std::string sep = (args.size() >= 2 && args[1].type == ValueType::STRING) ? std::get<std::string>(args[1].data) : ",";
-    const auto& v = std::get<std::vector<Value>>(args[0].data);
+    std::vector<Value> scratch;
+    const auto& v = array_items(args[0], scratch);
     std::string out;
     for(size_t i = 0; i < v.size(); ++i)
     {
@@ -239,7 +357,7 @@ Value BuiltinArrayResize::invoke(const std::vector<Value>& args, Diagnostics& di
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
     size_t n = 0;
     if(!to_index_nonneg(args[1], n)) {diag.error("array_resize: new_size must be non-negative", file, line); return {};}
-    auto v = std::get<std::vector<Value>>(args[0].data);
+    auto v = array_copy(args[0]);
     Value fill = (args.size() >= 3) ? args[2] : Value();
     v.resize(n, fill);
     return Value(v);
@@ -250,35 +368,295 @@ Value BuiltinArrayFill::invoke(const std::vector<Value>& args, Diagnostics& diag
     ensure_min_arity(diag, file, line, args, 2);
     size_t n = 0;
     if(!to_index_nonneg(args[0], n)) {diag.error("array_fill: length must be non-negative", file, line); return {};}
+    if(args.size() >= 3)
+    {
+        auto type = args[2].type == ValueType::STRING ? packed_type_from_name(std::get<std::string>(args[2].data)) : std::nullopt;
+        if(!type) {diag.error("array_fill: dtype must be \"double\", \"int\" or \"bool\"", file, line); return {};}
+
+        auto packed = std::make_shared<PackedArray>(*type, n);
+        if(!packed->fits(args[1])) {diag.error("array_fill: fill value does not fit dtype", file, line); return {};}
+        for(size_t i = 0; i < n; ++i) {packed->set(i, args[1]);}
+        return Value(std::move(packed));
+    }
     std::vector<Value> v(n, args[1]);
     return Value(v);
 }
 
+Value BuiltinArrayPack::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "array_pack")) {return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
+    auto type = args[1].type == ValueType::STRING ? packed_type_from_name(std::get<std::string>(args[1].data)) : std::nullopt;
+    if(!type) {diag.error("array_pack: dtype must be \"double\", \"int\" or \"bool\"", file, line); return {};}
+
+    size_t n = array_size(args[0]);
+    auto packed = std::make_shared<PackedArray>(*type, n);
+    for(size_t i = 0; i < n; ++i)
+    {
+        if(!packed->set(i, array_at(args[0], i))) {diag.error("array_pack: element #" + std::to_string(i) + " does not fit dtype", file, line); return {};}
+    }
+    return Value(std::move(packed));
+}
+
+// сумма, минимум и максимум: плотный double и обычный массив идут через параллельные ядра статистики,
+// плотный int/bool - через свои ядра, чтобы результат остался целым
+static bool numeric_items(Diagnostics& diag, const std::string& file, int line, const Value& arr, const std::string& name, std::vector<double>& out)
+{
+    std::vector<Value> scratch;
+    const auto& v = array_items(arr, scratch);
+    out.reserve(v.size());
+    for(const auto& e : v)
+    {
+        if(!is_numeric(e)) {diag.error(name + ": array must contain only numbers", file, line); return false;}
+        out.push_back(num(e));
+    }
+    return true;
+}
+
+Value BuiltinArraySum::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_sum")) {return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
+    PackedArray* packed = packed_arg(args[0]);
+    if(packed && packed->type() == PackedType::DOUBLE) {return Value(stats_sum(packed->doubles().data(), packed->size()));}
+    if(packed) {return Value(packed->sum());}
+
+    std::vector<double> nums;
+    if(!numeric_items(diag, file, line, args[0], name(), nums)) {return {};}
+    return Value(stats_sum(nums.data(), nums.size()));
+}
+
+Value BuiltinArrayMin::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_min")) {return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
+    if(array_size(args[0]) == 0) {diag.error("array_min: empty array", file, line); return {};}
+    PackedArray* packed = packed_arg(args[0]);
+    if(packed && packed->type() == PackedType::DOUBLE) {return Value(stats_min(packed->doubles().data(), packed->size()));}
+    if(packed) {return packed->min();}
+
+    std::vector<double> nums;
+    if(!numeric_items(diag, file, line, args[0], name(), nums)) {return {};}
+    return Value(stats_min(nums.data(), nums.size()));
+}
+
+Value BuiltinArrayMax::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_max")) {return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
+    if(array_size(args[0]) == 0) {diag.error("array_max: empty array", file, line); return {};}
+    PackedArray* packed = packed_arg(args[0]);
+    if(packed && packed->type() == PackedType::DOUBLE) {return Value(stats_max(packed->doubles().data(), packed->size()));}
+    if(packed) {return packed->max();}
+
+    std::vector<double> nums;
+    if(!numeric_items(diag, file, line, args[0], name(), nums)) {return {};}
+    return Value(stats_max(nums.data(), nums.size()));
+}
+
+static Value sort_by_field(Diagnostics& diag, const std::string& file, int line, const std::vector<Value>& args)
+{
+    const std::string& field = std::get<std::string>(args[1].data);
+    bool asc = true;
+    if(args.size() >= 3 && args[2].type == ValueType::BOOLEAN) {asc = std::get<bool>(args[2].data);}
+
+    // у struct_array ключи - готовый столбец, числовой сортируется без Value
+    if(args[0].type == ValueType::STRUCT_ARRAY)
+    {
+        const auto& arr = std::get<std::shared_ptr<StructArray>>(args[0].data);
+        int slot = arr->shape()->slot(field);
+        if(slot < 0) {diag.error("array_sort: unknown struct field: " + field, file, line); return {};}
+
+        StructColumn& column = arr->column(slot);
+        if(column.packed()) {return Value(arr->reordered(sort_order(column.numbers(), asc)));}
+
+        std::vector<Value> keys;
+        keys.reserve(arr->size());
+        for(size_t i = 0; i < arr->size(); ++i) {keys.push_back(column.get(i));}
+        return Value(arr->reordered(sort_order(keys, asc)));
+    }
+
+    if(!ensure_array_arg(diag, file, line, args, 0, "array_sort")) {return {};}
+    std::vector<Value> scratch;
+    const auto& v = array_items(args[0], scratch);
+
+    std::vector<Value> keys;
+    keys.reserve(v.size());
+    const StructShape* shape = nullptr;
+    int slot = -1;
+    for(size_t i = 0; i < v.size(); ++i)
+    {
+        const StructInstance* inst = v[i].type == ValueType::STRUCT ? std::get<std::shared_ptr<StructInstance>>(v[i].data).get() : nullptr;
+        if(inst && inst->definition && inst->definition->shape != shape)
+        {
+            shape = inst->definition->shape;
+            slot = shape->slot(field);
+        }
+        if(!inst || !inst->definition || slot < 0) {diag.error("array_sort: element #" + std::to_string(i) + " has no field " + field, file, line); return {};}
+        keys.push_back(inst->fields[slot]);
+    }
+    return Value(permuted(v, sort_order(keys, asc)));
+}
+
 Value BuiltinArraySort::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     ensure_min_arity(diag, file, line, args, 1);
+    if(args.size() >= 2 && args[1].type == ValueType::STRING) {return sort_by_field(diag, file, line, args);}
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
     bool asc = true;
     if(args.size() >= 2 && args[1].type == ValueType::BOOLEAN) {asc = std::get<bool>(args[1].data);}
-    auto v = std::get<std::vector<Value>>(args[0].data);
-    std::stable_sort(v.begin(), v.end(), [&](const Value& x, const Value& y)
+    if(PackedArray* packed = packed_arg(args[0]))
     {
-        return asc ? value_less(x, y) : value_less(y, x);
-    });
-    return Value(v);
+        auto sorted = std::make_shared<PackedArray>(*packed);
+        sorted->sort(asc);
+        return Value(std::move(sorted));
+    }
+
+    std::vector<Value> scratch;
+    const auto& v = array_items(args[0], scratch);
+    return Value(permuted(v, sort_order(v, asc)));
 }
 
 Value BuiltinArrayShuffle::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     ensure_arity(args, 1, 1);
     if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
-    auto v = std::get<std::vector<Value>>(args[0].data);
+    auto v = array_copy(args[0]);
     static std::random_device rd;
     static std::mt19937 gen(rd());
     std::shuffle(v.begin(), v.end(), gen);
     return Value(v);
 }
 
+// функция для array_map и подобных: найдена один раз, аргументы переиспользуются, поэтому элемент стоит ровно одного вызова
+struct ArrayCallback
+{
+    IBuiltinFunction* builtin = nullptr;
+    const FunctionRef* function = nullptr;
+    Evaluator* evaluator = nullptr;
+    std::vector<Value> args;
+
+    Value call(Diagnostics& diag, const std::string& file, int line)
+    {
+        if(builtin) {return builtin->invoke(args, diag, file, line);}
+        return evaluator->call_function(*function, args);
+    }
+};
+
+// имя ищется так же, как при вызове f(...) в коде: сначала builtin, потом функция языка
+static bool resolve_callback(Diagnostics& diag, const std::string& file, int line, const Value& fn, const std::string& name, size_t arity, ArrayCallback& out)
+{
+    if(fn.type != ValueType::STRING) {diag.error(name + ": argument #2 must be a function name", file, line); return false;}
+    const std::string& fn_name = std::get<std::string>(fn.data);
+    out.args.resize(arity);
+
+    out.builtin = BuiltinRegistry::instance().get(fn_name);
+    if(out.builtin) {return true;}
+
+    out.evaluator = get_active_evaluator();
+    out.function = out.evaluator ? out.evaluator->find_function(fn_name) : nullptr;
+    if(!out.function) {diag.error(name + ": unknown function " + fn_name, file, line); return false;}
+    if(out.function->func->parameters.size() != arity) {diag.error(name + ": function " + fn_name + " must take " + std::to_string(arity) + " argument(s)", file, line); return false;}
+    return true;
+}
+
+Value BuiltinArrayMap::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "array_map")) {return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
+    ArrayCallback fn;
+    if(!resolve_callback(diag, file, line, args[1], name(), 1, fn)) {return {};}
+
+    std::vector<Value> scratch;
+    const auto& items = array_items(args[0], scratch);
+    std::vector<Value> out;
+    out.reserve(items.size());
+    for(const auto& e : items)
+    {
+        fn.args[0] = e;
+        out.push_back(fn.call(diag, file, line));
+    }
+    return Value(out);
+}
+
+Value BuiltinArrayFilter::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "array_filter")) {return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
+    ArrayCallback fn;
+    if(!resolve_callback(diag, file, line, args[1], name(), 1, fn)) {return {};}
+
+    std::vector<Value> scratch;
+    const auto& items = array_items(args[0], scratch);
+    std::vector<Value> out;
+    for(const auto& e : items)
+    {
+        fn.args[0] = e;
+        if(is_truthy(fn.call(diag, file, line))) {out.push_back(e);}
+    }
+    return Value(out);
+}
+
+Value BuiltinArrayReduce::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(args.size() != 2 && args.size() != 3) {diag.error("array_reduce expects 2 or 3 argument(s)", file, line); return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name())) {return {};}
+    ArrayCallback fn;
+    if(!resolve_callback(diag, file, line, args[1], name(), 2, fn)) {return {};}
+
+    std::vector<Value> scratch;
+    const auto& items = array_items(args[0], scratch);
+    size_t start = 0;
+    Value acc;
+    if(args.size() == 3) {acc = args[2];}
+    else if(items.empty()) {diag.error("array_reduce: empty array and no initial value", file, line); return {};}
+    else {acc = items[start++];}
+
+    for(size_t i = start; i < items.size(); ++i)
+    {
+        fn.args[0] = std::move(acc);
+        fn.args[1] = items[i];
+        acc = fn.call(diag, file, line);
+    }
+    return acc;
+}
+
+// true, как только pred(x) == wanted (без pred - сам x); иначе false
+static Value find_truth(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line, const std::string& name, bool wanted)
+{
+    if(args.size() != 1 && args.size() != 2) {diag.error(name + " expects 1 or 2 argument(s)", file, line); return {};}
+    if(!ensure_array_arg(diag, file, line, args, 0, name)) {return {};}
+
+    std::vector<Value> scratch;
+    const auto& items = array_items(args[0], scratch);
+    if(args.size() == 1)
+    {
+        for(const auto& e : items) {if(is_truthy(e) == wanted) {return Value(true);}}
+        return Value(false);
+    }
+
+    ArrayCallback fn;
+    if(!resolve_callback(diag, file, line, args[1], name, 1, fn)) {return {};}
+    for(const auto& e : items)
+    {
+        fn.args[0] = e;
+        if(is_truthy(fn.call(diag, file, line)) == wanted) {return Value(true);}
+    }
+    return Value(false);
+}
+
+Value BuiltinArrayAny::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    return find_truth(args, diag, file, line, name(), true);
+}
+
+Value BuiltinArrayAll::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    Value failed = find_truth(args, diag, file, line, name(), false);
+    if(failed.type != ValueType::BOOLEAN) {return {};}
+    return Value(!std::get<bool>(failed.data));
+}
+
 void register_builtin_array()
 {
     auto& reg = BuiltinRegistry::instance();
@@ -292,6 +670,7 @@ void register_builtin_array()
     reg.register_builtin(std::make_unique<BuiltinArrayInsert>());
     reg.register_builtin(std::make_unique<BuiltinArrayDelete>());
     reg.register_builtin(std::make_unique<BuiltinArraySlice>());
+    reg.register_builtin(std::make_unique<BuiltinArrayDense>());
     reg.register_builtin(std::make_unique<BuiltinArrayConcat>());
     reg.register_builtin(std::make_unique<BuiltinArrayReverse>());
     reg.register_builtin(std::make_unique<BuiltinArrayIndexOf>());
@@ -299,6 +678,15 @@ void register_builtin_array()
     reg.register_builtin(std::make_unique<BuiltinArrayJoin>());
     reg.register_builtin(std::make_unique<BuiltinArrayResize>());
     reg.register_builtin(std::make_unique<BuiltinArrayFill>());
+    reg.register_builtin(std::make_unique<BuiltinArrayPack>());
+    reg.register_builtin(std::make_unique<BuiltinArraySum>());
+    reg.register_builtin(std::make_unique<BuiltinArrayMin>());
+    reg.register_builtin(std::make_unique<BuiltinArrayMax>());
     reg.register_builtin(std::make_unique<BuiltinArraySort>());
     reg.register_builtin(std::make_unique<BuiltinArrayShuffle>());
+    reg.register_builtin(std::make_unique<BuiltinArrayMap>());
+    reg.register_builtin(std::make_unique<BuiltinArrayFilter>());
+    reg.register_builtin(std::make_unique<BuiltinArrayReduce>());
+    reg.register_builtin(std::make_unique<BuiltinArrayAny>());
+    reg.register_builtin(std::make_unique<BuiltinArrayAll>());
 }
@@ -62,12 +62,21 @@ struct BuiltinArrayDelete : IBuiltinFunction
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
+// array_slice(arr, start[, count]) - срез без копии хранилища: срез среза делит его с исходным,
+// из остальных массивов выбранные элементы копируются один раз. Запись по индексу разворачивает срез в обычный массив
 struct BuiltinArraySlice : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "array_slice";}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
+// обычный массив с теми же элементами; разреженный разворачивается за один проход по заполненным индексам
+struct BuiltinArrayDense : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_dense";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
 struct BuiltinArrayConcat : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "array_concat";}
@@ -104,12 +113,40 @@ struct BuiltinArrayResize : IBuiltinFunction
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
+// array_fill(n, value) - обычный массив; array_fill(n, value, dtype) - плотный массив "double", "int" или "bool"
 struct BuiltinArrayFill : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "array_fill";}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
+// array_pack(arr, dtype) - плотная копия массива; каждый элемент должен помещаться в dtype
+struct BuiltinArrayPack : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_pack";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinArraySum : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_sum";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinArrayMin : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_min";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinArrayMax : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_max";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// array_sort(arr[, asc]) - устойчивая сортировка копии;
+// array_sort(arr, "field"[, asc]) - массив структур или struct_array по полю, ключ читается один раз на элемент
 struct BuiltinArraySort : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "array_sort";}
@@ -119,10 +156,58 @@ struct BuiltinArraySort : IBuiltinFunction
 struct BuiltinArrayShuffle : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "array_shuffle";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
 void register_builtin_array();
 
 
+// array_map(arr, "f") - новый массив f(x); f - имя функции языка или builtin'а, ищется один раз на вызов.
+// Функция может иметь побочные эффекты, поэтому эти builtin'ы не считаются чистыми
+struct BuiltinArrayMap : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_map";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+    [[nodiscard]] bool calls_back() const override {return true;}
+};
+
+// array_filter(arr, "pred") - элементы, для которых pred(x) истинно, в исходном порядке
+struct BuiltinArrayFilter : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_filter";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+    [[nodiscard]] bool calls_back() const override {return true;}
+};
+
+// array_reduce(arr, "f"[, init]) - acc = f(acc, x) слева направо; без init начинает с первого элемента
+struct BuiltinArrayReduce : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_reduce";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+    [[nodiscard]] bool calls_back() const override {return true;}
+};
+
+// array_any/array_all(arr, "pred") - останавливаются на первом элементе, который решает ответ.
+// Без pred проверяются сами элементы: array_all(a == b) сводит поэлементное сравнение к bool
+struct BuiltinArrayAny : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_any";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+    [[nodiscard]] bool calls_back() const override {return true;}
+};
+
+struct BuiltinArrayAll : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_all";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+    [[nodiscard]] bool calls_back() const override {return true;}
+};
+
+
 #endif //BERESTALANGUAGE_BUILTINARRAY_H
@@ -0,0 +1,119 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "BuiltinDeque.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/builtin/core/BuiltinUtils.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/value/ValueDeque.h"
+
+static ValueDeque* deque_arg(Diagnostics& diag, const std::string& file, int line, const std::vector<Value>& args, size_t idx, const std::string& name)
+{
+    if(idx >= args.size() || args[idx].type != ValueType::DEQUE) {diag.error(name + ": argument #" + std::to_string(idx + 1) + " must be a deque", file, line); return nullptr;}
+    return std::get<std::shared_ptr<ValueDeque>>(args[idx].data).get();
+}
+
+// очередь для снятия или просмотра: не пустая
+static ValueDeque* nonempty_deque(Diagnostics& diag, const std::string& file, int line, const std::vector<Value>& args, const std::string& name)
+{
+    ValueDeque* deque = deque_arg(diag, file, line, args, 0, name);
+    if(deque && deque->empty()) {diag.error(name + ": deque is empty", file, line); return nullptr;}
+    return deque;
+}
+
+Value BuiltinDequeCreate::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(args.size() > 1) {diag.error("deque_create expects 0 or 1 argument(s)", file, line); return {};}
+
+    auto deque = std::make_shared<ValueDeque>();
+    if(args.empty()) {return Value(std::move(deque));}
+    if(!is_iterable(args[0])) {diag.error("deque_create: argument #1 must be an array, range, generator, set or deque", file, line); return {};}
+
+    ForeachCursor cursor(args[0]);
+    Value item;
+    while(cursor.next(item)) {deque->push_back(item);}
+    return Value(std::move(deque));
+}
+
+Value BuiltinDequePushBack::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity_range(diag, file, line, args, 2, "deque_push_back")) {return {};}
+    ValueDeque* deque = deque_arg(diag, file, line, args, 0, name());
+    if(!deque) {return {};}
+
+    for(size_t i = 1; i < args.size(); ++i) {deque->push_back(args[i]);}
+    return args[0];
+}
+
+Value BuiltinDequePushFront::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity_range(diag, file, line, args, 2, "deque_push_front")) {return {};}
+    ValueDeque* deque = deque_arg(diag, file, line, args, 0, name());
+    if(!deque) {return {};}
+
+    for(size_t i = 1; i < args.size(); ++i) {deque->push_front(args[i]);}
+    return args[0];
+}
+
+Value BuiltinDequePopFront::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "deque_pop_front")) {return {};}
+    ValueDeque* deque = nonempty_deque(diag, file, line, args, name());
+    if(!deque) {return {};}
+    return deque->pop_front();
+}
+
+Value BuiltinDequePopBack::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "deque_pop_back")) {return {};}
+    ValueDeque* deque = nonempty_deque(diag, file, line, args, name());
+    if(!deque) {return {};}
+    return deque->pop_back();
+}
+
+Value BuiltinDequePeekFront::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "deque_peek_front")) {return {};}
+    ValueDeque* deque = nonempty_deque(diag, file, line, args, name());
+    if(!deque) {return {};}
+    return deque->front();
+}
+
+Value BuiltinDequePeekBack::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "deque_peek_back")) {return {};}
+    ValueDeque* deque = nonempty_deque(diag, file, line, args, name());
+    if(!deque) {return {};}
+    return deque->back();
+}
+
+Value BuiltinDequeLength::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "deque_length")) {return {};}
+    ValueDeque* deque = deque_arg(diag, file, line, args, 0, name());
+    if(!deque) {return {};}
+    return Value(static_cast<int>(deque->size()));
+}
+
+Value BuiltinDequeToArray::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "deque_to_array")) {return {};}
+    ValueDeque* deque = deque_arg(diag, file, line, args, 0, name());
+    if(!deque) {return {};}
+    return Value(deque->to_vector());
+}
+
+void register_builtin_deque()
+{
+    auto& reg = BuiltinRegistry::instance();
+    reg.register_builtin(std::make_unique<BuiltinDequeCreate>());
+    reg.register_builtin(std::make_unique<BuiltinDequePushBack>());
+    reg.register_builtin(std::make_unique<BuiltinDequePushFront>());
+    reg.register_builtin(std::make_unique<BuiltinDequePopFront>());
+    reg.register_builtin(std::make_unique<BuiltinDequePopBack>());
+    reg.register_builtin(std::make_unique<BuiltinDequePeekFront>());
+    reg.register_builtin(std::make_unique<BuiltinDequePeekBack>());
+    reg.register_builtin(std::make_unique<BuiltinDequeLength>());
+    reg.register_builtin(std::make_unique<BuiltinDequeToArray>());
+}
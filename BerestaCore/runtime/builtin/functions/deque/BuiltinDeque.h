@@ -0,0 +1,78 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_BUILTINDEQUE_H
+#define BERESTALANGUAGE_BUILTINDEQUE_H
+
+#pragma once
+#include "runtime/builtin/core/IBuiltinFunction.h"
+
+// deque_create() / deque_create(iterable) - пустая очередь или элементы массива, диапазона, генератора по порядку
+struct BuiltinDequeCreate : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_create";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+// deque_push_back(q, v, ...) - добавляет в конец по порядку, возвращает q
+struct BuiltinDequePushBack : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_push_back";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+// deque_push_front(q, v, ...) - добавляет в начало по одному, последний аргумент оказывается первым; возвращает q
+struct BuiltinDequePushFront : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_push_front";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+// deque_pop_front/deque_pop_back(q) - снимает и возвращает крайний элемент; пустая очередь - ошибка
+struct BuiltinDequePopFront : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_pop_front";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+struct BuiltinDequePopBack : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_pop_back";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+// deque_peek_front/deque_peek_back(q) - крайний элемент без снятия
+struct BuiltinDequePeekFront : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_peek_front";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinDequePeekBack : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_peek_back";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinDequeLength : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_length";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinDequeToArray : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "deque_to_array";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+void register_builtin_deque();
+
+
+#endif //BERESTALANGUAGE_BUILTINDEQUE_H
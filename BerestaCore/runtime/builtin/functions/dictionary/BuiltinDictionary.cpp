@@ -6,6 +6,7 @@
 #include "runtime/builtin/core/BuiltinRegistry.h"
 #include "runtime/builtin/core/BuiltinUtils.h"
 #include "frontend/diagnostics/Diagnostics.h"
+#include "runtime/value/FlatDictionary.h"
 #include <iostream>
 
 static bool ensure_dict_arg(Diagnostics& diag, const std::string& file, int line, const std::vector<Value>& args, size_t idx, const std::string& name)
@@ -15,6 +16,12 @@ static bool ensure_dict_arg(Diagnostics& diag, const std::string& file, int line
     return true;
 }
 
+Value BuiltinDictionaryCreate::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    ensure_arity(args, 0, 0);
+    return Value(std::make_shared<Dictionary>());
+}
+
 Value BuiltinDictionaryKeys::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     ensure_arity(args, 1, 1);
@@ -22,9 +29,9 @@ Value BuiltinDictionaryKeys::invoke(const std::vector<Value>& args, Diagnostics&
     const auto& dict = *std::get<DictionaryPtr>(args[0].data);
     std::vector<Value> keys;
     keys.reserve(dict.size());
-    for(const auto& [k, v] : dict)
+    for(const auto& e : dict)
     {
-        keys.emplace_back(k);
+        keys.emplace_back(e.key);
     }
     return Value(keys);
 }
@@ -36,9 +43,9 @@ Value BuiltinDictionaryValues::invoke(const std::vector<Value>& args, Diagnostic
     const auto& dict = *std::get<DictionaryPtr>(args[0].data);
     std::vector<Value> values;
     values.reserve(dict.size());
-    for(const auto& [k, v] : dict)
+    for(const auto& e : dict)
     {
-        values.push_back(v);
+        values.push_back(e.value);
     }
     return Value(values);
 }
@@ -50,7 +57,7 @@ Value BuiltinDictionaryHas::invoke(const std::vector<Value>& args, Diagnostics&
     if(args[1].type != ValueType::STRING) {diag.error("dictionary_has: key must be string", file, line); return {};}
     const auto& dict = *std::get<DictionaryPtr>(args[0].data);
     const auto& key = std::get<std::string>(args[1].data);
-    return Value(dict.find(key) != dict.end());
+    return Value(dict.contains(key));
 }
 
 Value BuiltinDictionaryGet::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
@@ -60,8 +67,7 @@ Value BuiltinDictionaryGet::invoke(const std::vector<Value>& args, Diagnostics&
     if(args[1].type != ValueType::STRING) {diag.error("dictionary_get: key must be string", file, line); return {};}
     const auto& dict = *std::get<DictionaryPtr>(args[0].data);
     const auto& key = std::get<std::string>(args[1].data);
-    auto it = dict.find(key);
-    if(it != dict.end()) {return it->second;}
+    if(const Value* found = dict.find(key)) {return *found;}
     if(args.size() == 3) {return args[2];}
     return {};
 }
@@ -120,9 +126,9 @@ Value BuiltinDictionaryMerge::invoke(const std::vector<Value>& args, Diagnostics
     if(!ensure_dict_arg(diag, file, line, args, 1, name())) {return {};}
     auto& dict1 = *std::get<DictionaryPtr>(args[0].data);
     const auto& dict2 = *std::get<DictionaryPtr>(args[1].data);
-    for(const auto& [k, v] : dict2)
+    for(const auto& e : dict2)
     {
-        dict1[k] = v;
+        dict1[e.key] = e.value;
     }
     return args[0];
 }
@@ -138,6 +144,7 @@ Value BuiltinDictionaryDestroy::invoke(const std::vector<Value>& args, Diagnosti
 void register_builtin_dictionary()
 {
     auto& reg = BuiltinRegistry::instance();
+    reg.register_builtin(std::make_unique<BuiltinDictionaryCreate>());
     reg.register_builtin(std::make_unique<BuiltinDictionaryKeys>());
     reg.register_builtin(std::make_unique<BuiltinDictionaryValues>());
     reg.register_builtin(std::make_unique<BuiltinDictionaryHas>());
@@ -8,6 +8,13 @@
 #pragma once
 #include "runtime/builtin/core/IBuiltinFunction.h"
 
+struct BuiltinDictionaryCreate : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "dictionary_create";}
+    [[nodiscard]] bool is_pure() const override {return false;}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
 struct BuiltinDictionaryKeys : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "dictionary_keys";}
@@ -35,12 +42,14 @@ struct BuiltinDictionaryGet : IBuiltinFunction
 struct BuiltinDictionarySet : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "dictionary_set";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
 struct BuiltinDictionaryDelete : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "dictionary_delete";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
@@ -53,6 +62,7 @@ struct BuiltinDictionarySize : IBuiltinFunction
 struct BuiltinDictionaryClear : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "dictionary_clear";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
@@ -65,12 +75,14 @@ struct BuiltinDictionaryCopy : IBuiltinFunction
 struct BuiltinDictionaryMerge : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "dictionary_merge";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
 struct BuiltinDictionaryDestroy : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "dictionary_destroy";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
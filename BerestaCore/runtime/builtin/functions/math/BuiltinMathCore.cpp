@@ -5,107 +5,134 @@
 #include "BuiltinMathCore.h"
 #include "runtime/builtin/core/BuiltinRegistry.h"
 #include "runtime/builtin/core/BuiltinUtils.h"
+#include "MathKernels.h"
+#include "MathArrays.h"
+#include "runtime/builtin/functions/stats/BuiltinStats.h"
+#include "runtime/builtin/functions/stats/StatsKernels.h"
+#include "runtime/evaluator/Operators.h"
 #include <cmath>
 #include <algorithm>
 
 Value BuiltinSqr::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "sqr")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<1>(args, diag, file, line, "sqr", [](double x) {return math_sqr(x);});}
     if(!check_numeric(diag, file, line, args[0], "sqr", 1)) {return {};}
-    double x = num(args[0]);
-    return Value(x * x);
+    return Value(math_sqr(num(args[0])));
 }
 
 Value BuiltinSqrt::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "sqrt")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "sqrt", cols)) {return {};}
+        if(!column_all(cols.data[0], [](double x) {return x >= 0.0;})) {diag.error("sqrt: argument must be non-negative", file, line); return {};}
+        return map_columns<1>(cols, [](double x) {return math_sqrt(x);});
+    }
     if(!check_numeric(diag, file, line, args[0], "sqrt", 1)) {return {};}
     double x = num(args[0]);
     if(x < 0.0) {diag.error("sqrt: argument must be non-negative", file, line); return {};}
-    return Value(std::sqrt(x));
+    return Value(math_sqrt(x));
 }
 
 Value BuiltinAbs::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "abs")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<1>(args, diag, file, line, "abs", [](double x) {return math_abs(x);});}
     if(!check_numeric(diag, file, line, args[0], "abs", 1)) {return {};}
-    return Value(std::fabs(num(args[0])));
+    return Value(math_abs(num(args[0])));
 }
 
 Value BuiltinRound::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "round")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<1>(args, diag, file, line, "round", [](double x) {return math_round(x);});}
     if(!check_numeric(diag, file, line, args[0], "round", 1)) {return {};}
-    return Value(std::round(num(args[0])));
+    return Value(math_round(num(args[0])));
 }
 
 Value BuiltinFloor::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "floor")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<1>(args, diag, file, line, "floor", [](double x) {return math_floor(x);});}
     if(!check_numeric(diag, file, line, args[0], "floor", 1)) {return {};}
-    return Value(std::floor(num(args[0])));
+    return Value(math_floor(num(args[0])));
 }
 
 Value BuiltinCeil::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "ceil")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<1>(args, diag, file, line, "ceil", [](double x) {return math_ceil(x);});}
     if(!check_numeric(diag, file, line, args[0], "ceil", 1)) {return {};}
-    return Value(std::ceil(num(args[0])));
+    return Value(math_ceil(num(args[0])));
 }
 
 Value BuiltinFrac::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "frac")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<1>(args, diag, file, line, "frac", [](double x) {return math_frac(x);});}
     if(!check_numeric(diag, file, line, args[0], "frac", 1)) {return {};}
-    double x = num(args[0]);
-    return Value(x - std::floor(x));
+    return Value(math_frac(num(args[0])));
 }
 
 Value BuiltinPower::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 2, "power")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<2>(args, diag, file, line, "power", [](double x, double y) {return math_power(x, y);});}
     if(!check_numeric(diag, file, line, args[0], "power", 1)) {return {};}
     if(!check_numeric(diag, file, line, args[1], "power", 2)) {return {};}
-    return Value(std::pow(num(args[0]), num(args[1])));
+    return Value(math_power(num(args[0]), num(args[1])));
 }
 
 Value BuiltinClamp::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 3, "clamp")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<3>(args, diag, file, line, "clamp", [](double v, double mn, double mx) {return math_clamp(v, mn, mx);});}
     if(!check_numeric(diag, file, line, args[0], "clamp", 1) || !check_numeric(diag, file, line, args[1], "clamp", 2) || !check_numeric(diag, file, line, args[2], "clamp", 3)) {return {};}
     double v = num(args[0]);
     double mn = num(args[1]);
     double mx = num(args[2]);
-    return Value(std::clamp(v, mn, mx));
+    return Value(math_clamp(v, mn, mx));
 }
 
 Value BuiltinLerp::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 3, "lerp")) {return {};}
-    if(args[0].type != ValueType::DOUBLE || args[1].type != ValueType::DOUBLE || args[2].type != ValueType::DOUBLE) {diag.error("lerp expects 3 double arguments (a, b, amount)", file, line); return {};}
-    double a = std::get<double>(args[0].data);
-    double b = std::get<double>(args[1].data);
-    double amt = std::get<double>(args[2].data);
-    return Value(a + (b - a) * amt);
+    if(has_array_arg(args)) {return map_elementwise<3>(args, diag, file, line, "lerp", [](double a, double b, double amt) {return math_lerp(a, b, amt);});}
+    if(!check_numeric(diag, file, line, args[0], "lerp", 1) || !check_numeric(diag, file, line, args[1], "lerp", 2) || !check_numeric(diag, file, line, args[2], "lerp", 3)) {return {};}
+    return Value(math_lerp(num(args[0]), num(args[1]), num(args[2])));
 }
 
 Value BuiltinMin::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 2, "min")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<2>(args, diag, file, line, "min", [](double a, double b) {return math_min(a, b);});}
     if(!check_numeric(diag, file, line, args[0], "min", 1) || !check_numeric(diag, file, line, args[1], "min", 2)) {return {};}
-    return Value(std::min(num(args[0]), num(args[1])));
+    return Value(math_min(num(args[0]), num(args[1])));
 }
 
 Value BuiltinMax::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 2, "max")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<2>(args, diag, file, line, "max", [](double a, double b) {return math_max(a, b);});}
     if(!check_numeric(diag, file, line, args[0], "max", 1) || !check_numeric(diag, file, line, args[1], "max", 2)) {return {};}
-    return Value(std::max(num(args[0]), num(args[1])));
+    return Value(math_max(num(args[0]), num(args[1])));
 }
 
 Value BuiltinMean::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity_range(diag, file, line, args, 1, "mean")) {return {};}
+    if(args.size() == 1 && is_array(args[0]))
+    {
+        std::vector<double> owned;
+        size_t n = 0;
+        const double* p = stats_data(diag, file, line, args[0], "mean", owned, n);
+        if(!p) {return {};}
+        if(n == 0) {diag.error("mean: empty array", file, line); return {};}
+        return Value(stats_sum(p, n) / static_cast<double>(n));
+    }
     double sum = 0.0;
     for(size_t i = 0; i < args.size(); ++i)
     {
@@ -119,47 +146,89 @@ Value BuiltinMedian::invoke(const std::vector<Value>& args, Diagnostics& diag, c
 {
     if(!check_arity_range(diag, file, line, args, 1, "median")) {return {};}
     std::vector<double> vals;
-    vals.reserve(args.size());
-    for(size_t i = 0; i < args.size(); ++i)
+    if(args.size() == 1 && is_array(args[0]))
+    {
+        size_t n = 0;
+        const double* p = stats_data(diag, file, line, args[0], "median", vals, n);
+        if(!p) {return {};}
+        if(n == 0) {diag.error("median: empty array", file, line); return {};}
+        if(p != vals.data()) {vals.assign(p, p + n);}
+    }
+    else
     {
-        if(!check_numeric(diag, file, line, args[i], "median", static_cast<int>(i + 1))) {return {};}
-        vals.push_back(num(args[i]));
+        vals.reserve(args.size());
+        for(size_t i = 0; i < args.size(); ++i)
+        {
+            if(!check_numeric(diag, file, line, args[i], "median", static_cast<int>(i + 1))) {return {};}
+            vals.push_back(num(args[i]));
+        }
     }
-    std::sort(vals.begin(), vals.end());
+
+    // верхний из двух средних при чётной длине; полная сортировка не нужна
     size_t mid = vals.size() / 2;
+    std::nth_element(vals.begin(), vals.begin() + static_cast<std::ptrdiff_t>(mid), vals.end());
     return Value(vals[mid]);
 }
 
 Value BuiltinLn::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "ln")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "ln", cols)) {return {};}
+        if(!column_all(cols.data[0], [](double x) {return x > 0.0;})) {diag.error("ln: input must be > 0", file, line); return {};}
+        return map_columns<1>(cols, [](double x) {return math_ln(x);});
+    }
     if(!check_numeric(diag, file, line, args[0], "ln", 1)) {return {};}
     double x = num(args[0]);
     if(x <= 0.0) {diag.error("ln: input must be > 0", file, line); return {};}
-    return Value(std::log(x));
+    return Value(math_ln(x));
 }
 
 Value BuiltinLog2::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "log2")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "log2", cols)) {return {};}
+        if(!column_all(cols.data[0], [](double x) {return x > 0.0;})) {diag.error("log2 domain error: input must be positive", file, line); return {};}
+        return map_columns<1>(cols, [](double x) {return math_log2(x);});
+    }
     if(!check_numeric(diag, file, line, args[0], "log2", 1)) {return {};}
     double x = num(args[0]);
     if(x <= 0.0) {diag.error("log2 domain error: input must be positive", file, line); return {};}
-    return Value(std::log2(x));
+    return Value(math_log2(x));
 }
 
 Value BuiltinLog10::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 1, "log10")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "log10", cols)) {return {};}
+        if(!column_all(cols.data[0], [](double x) {return x > 0.0;})) {diag.error("log10 domain error: input must be positive", file, line); return {};}
+        return map_columns<1>(cols, [](double x) {return math_log10(x);});
+    }
     if(!check_numeric(diag, file, line, args[0], "log10", 1)) {return {};}
     double x = num(args[0]);
     if(x <= 0.0) {diag.error("log10 domain error: input must be positive", file, line); return {};}
-    return Value(std::log10(x));
+    return Value(math_log10(x));
 }
 
 Value BuiltinLogn::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 2, "logn")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "logn", cols)) {return {};}
+        bool base_ok = column_all(cols.data[0], [](double b) {return b > 0.0 && b != 1.0;});
+        if(!base_ok || !column_all(cols.data[1], [](double v) {return v > 0.0;})) {diag.error("logn domain error: base must be > 0 and ≠ 1, value must be > 0", file, line); return {};}
+        return map_columns<2>(cols, [](double base, double val) {return std::log(val) / std::log(base);});
+    }
     if(!check_numeric(diag, file, line, args[0], "logn", 1) || !check_numeric(diag, file, line, args[1], "logn", 2)) {return {};}
     double base = num(args[0]);
     double val  = num(args[1]);
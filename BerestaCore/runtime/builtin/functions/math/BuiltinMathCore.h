@@ -80,12 +80,14 @@ struct BuiltinMax : IBuiltinFunction
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line) override;
 };
 
+// mean(a, b, ...) или mean(array)
 struct BuiltinMean : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "mean";}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line) override;
 };
 
+// median(a, b, ...) или median(array): при чётной длине - верхний из двух средних
 struct BuiltinMedian : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "median";}
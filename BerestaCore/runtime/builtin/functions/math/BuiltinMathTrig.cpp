@@ -5,26 +5,73 @@
 #include "BuiltinMathTrig.h"
 #include "runtime/builtin/core/BuiltinRegistry.h"
 #include "runtime/builtin/core/BuiltinUtils.h"
+#include "MathKernels.h"
+#include "MathArrays.h"
 #include <cmath>
 
-static constexpr double DEGTORAD = M_PI / 180.0;
-static constexpr double RADTODEG = 180.0 / M_PI;
+namespace
+{
+    // sin/cos массива ядрами math_sin_n/math_cos_n: angle - номер столбца с углом, scale переводит его в радианы,
+    // post(i, t) собирает элемент результата из значения функции
+    template<typename Post>
+    Value trig_columns(const NumericColumns& cols, size_t angle, double scale, bool sine, Post post)
+    {
+        std::vector<double> radians(cols.n);
+        std::vector<double> out(cols.n);
+        for(size_t i = 0; i < cols.n; ++i) {radians[i] = cols.data[angle][i] * scale;}
+        if(sine) {math_sin_n(radians.data(), out.data(), cols.n);}
+        else     {math_cos_n(radians.data(), out.data(), cols.n);}
+        for(size_t i = 0; i < cols.n; ++i) {out[i] = post(i, out[i]);}
+        return double_array(std::move(out), cols.packed);
+    }
+
+    // как у скалярных dsin/dcos/dtan: почти ноль становится нулём, затем два знака после запятой
+    double degree_result(double t) {return math_round2(std::abs(t) < 1e-5 ? 0.0 : t);}
+}
 
 Value BuiltinSin::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "sin") || !check_numeric(diag, file, line, args[0], "sin", 1)) {return {};}
-    return Value(std::sin(num(args[0])));
+    if(!check_arity(diag, file, line, args, 1, "sin")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "sin", cols)) {return {};}
+        return trig_columns(cols, 0, 1.0, true, [](size_t, double s) {return s;});
+    }
+    if(!check_numeric(diag, file, line, args[0], "sin", 1)) {return {};}
+    return Value(math_sin(num(args[0])));
 }
 
 Value BuiltinCos::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "cos") || !check_numeric(diag, file, line, args[0], "cos", 1)) {return {};}
-    return Value(std::cos(num(args[0])));
+    if(!check_arity(diag, file, line, args, 1, "cos")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "cos", cols)) {return {};}
+        return trig_columns(cols, 0, 1.0, false, [](size_t, double c) {return c;});
+    }
+    if(!check_numeric(diag, file, line, args[0], "cos", 1)) {return {};}
+    return Value(math_cos(num(args[0])));
 }
 
 Value BuiltinTan::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "tan") || !check_numeric(diag, file, line, args[0], "tan", 1)) {return {};}
+    if(!check_arity(diag, file, line, args, 1, "tan")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "tan", cols)) {return {};}
+        std::vector<double> out(cols.n);
+        for(size_t i = 0; i < cols.n; ++i)
+        {
+            double result = std::tan(cols.data[0][i]);
+            if(!std::isfinite(result)) {diag.error("tan argument results in infinity (asymptote)", file, line); return {};}
+            out[i] = std::abs(result) < 1e-5 ? 0.0 : result;
+        }
+        return double_array(std::move(out), cols.packed);
+    }
+    if(!check_numeric(diag, file, line, args[0], "tan", 1)) {return {};}
     double radians = num(args[0]);
     double result = std::tan(radians);
     if(std::abs(result) < 1e-5) {result = 0.0;}
@@ -34,61 +81,99 @@ Value BuiltinTan::invoke(const std::vector<Value>& args, Diagnostics& diag, cons
 
 Value BuiltinArcsin::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "arcsin") || !check_numeric(diag, file, line, args[0], "arcsin", 1)) {return {};}
+    if(!check_arity(diag, file, line, args, 1, "arcsin")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "arcsin", cols)) {return {};}
+        if(!column_all(cols.data[0], [](double v) {return v >= -1.0 && v <= 1.0;})) {diag.error("arcsin domain error: input must be in range [-1, 1]", file, line); return {};}
+        return map_columns<1>(cols, [](double v) {return math_arcsin(v);});
+    }
+    if(!check_numeric(diag, file, line, args[0], "arcsin", 1)) {return {};}
     double v = num(args[0]);
     if(v < -1.0 || v > 1.0) {diag.error("arcsin domain error: input must be in range [-1, 1]", file, line); return {};}
-    return Value(std::asin(v));
+    return Value(math_arcsin(v));
 }
 
 Value BuiltinArccos::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "arccos") || !check_numeric(diag, file, line, args[0], "arccos", 1)) {return {};}
+    if(!check_arity(diag, file, line, args, 1, "arccos")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "arccos", cols)) {return {};}
+        if(!column_all(cols.data[0], [](double v) {return v >= -1.0 && v <= 1.0;})) {diag.error("arccos domain error: input must be in range [-1, 1]", file, line); return {};}
+        return map_columns<1>(cols, [](double v) {return math_arccos(v);});
+    }
+    if(!check_numeric(diag, file, line, args[0], "arccos", 1)) {return {};}
     double v = num(args[0]);
     if(v < -1.0 || v > 1.0) {diag.error("arccos domain error: input must be in range [-1, 1]", file, line); return {};}
-    return Value(std::acos(v));
+    return Value(math_arccos(v));
 }
 
 Value BuiltinArctan::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "arctan") || !check_numeric(diag, file, line, args[0], "arctan", 1)) {return {};}
-    return Value(std::atan(num(args[0])));
+    if(!check_arity(diag, file, line, args, 1, "arctan")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<1>(args, diag, file, line, "arctan", [](double v) {return math_arctan(v);});}
+    if(!check_numeric(diag, file, line, args[0], "arctan", 1)) {return {};}
+    return Value(math_arctan(num(args[0])));
 }
 
 Value BuiltinArctan2::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 2, "arctan2") || !check_numeric(diag, file, line, args[0], "arctan2", 1) || !check_numeric(diag, file, line, args[1], "arctan2", 2)) {return {};}
-    double y = num(args[0]);
-    double x = num(args[1]);
-    double result = std::atan2(y, x);
-    result = std::round(result * 100.0) / 100.0;
-    return Value(result);
+    if(!check_arity(diag, file, line, args, 2, "arctan2")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<2>(args, diag, file, line, "arctan2", [](double y, double x) {return math_arctan2(y, x);});}
+    if(!check_numeric(diag, file, line, args[0], "arctan2", 1) || !check_numeric(diag, file, line, args[1], "arctan2", 2)) {return {};}
+    return Value(math_arctan2(num(args[0]), num(args[1])));
 }
 
 Value BuiltinDsin::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "dsin") || !check_numeric(diag, file, line, args[0], "dsin", 1)) {return {};}
-    double radians = num(args[0]) * DEGTORAD;
-    double result = std::sin(radians);
-    if(std::abs(result) < 1e-5) {result = 0.0;}
-    result = std::round(result * 100.0) / 100.0;
-    return Value(result);
+    if(!check_arity(diag, file, line, args, 1, "dsin")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "dsin", cols)) {return {};}
+        return trig_columns(cols, 0, MATH_DEGTORAD, true, [](size_t, double s) {return degree_result(s);});
+    }
+    if(!check_numeric(diag, file, line, args[0], "dsin", 1)) {return {};}
+    return Value(math_dsin(num(args[0])));
 }
 
 Value BuiltinDcos::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "dcos") || !check_numeric(diag, file, line, args[0], "dcos", 1)) {return {};}
-    double radians = num(args[0]) * DEGTORAD;
-    double result = std::cos(radians);
-    if(std::abs(result) < 1e-5) {result = 0.0;}
-    result = std::round(result * 100.0) / 100.0;
-    return Value(result);
+    if(!check_arity(diag, file, line, args, 1, "dcos")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "dcos", cols)) {return {};}
+        return trig_columns(cols, 0, MATH_DEGTORAD, false, [](size_t, double c) {return degree_result(c);});
+    }
+    if(!check_numeric(diag, file, line, args[0], "dcos", 1)) {return {};}
+    return Value(math_dcos(num(args[0])));
 }
 
 Value BuiltinDtan::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "dtan") || !check_numeric(diag, file, line, args[0], "dtan", 1)) {return {};}
+    if(!check_arity(diag, file, line, args, 1, "dtan")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "dtan", cols)) {return {};}
+        std::vector<double> out(cols.n);
+        for(size_t i = 0; i < cols.n; ++i)
+        {
+            double degrees = cols.data[0][i];
+            if(std::fabs(std::fmod(std::abs(degrees), 180.0) - 90.0) < 1e-6) {diag.error("dtan asymptote at " + std::to_string(degrees) + " degrees", file, line); return {};}
+            double result = std::tan(degrees * MATH_DEGTORAD);
+            if(!std::isfinite(result)) {diag.error("dtan argument results in infinity (asymptote)", file, line); return {};}
+            out[i] = degree_result(result);
+        }
+        return double_array(std::move(out), cols.packed);
+    }
+    if(!check_numeric(diag, file, line, args[0], "dtan", 1)) {return {};}
     double degrees = num(args[0]);
-    double radians = degrees * DEGTORAD;
+    double radians = degrees * MATH_DEGTORAD;
     double result = std::tan(radians);
     if(std::fabs(std::fmod(std::abs(degrees), 180.0) - 90.0) < 1e-6) {diag.error("dtan asymptote at " + std::to_string(degrees) + " degrees", file, line); return {};}
     if(!std::isfinite(result)) {diag.error("dtan argument results in infinity (asymptote)", file, line); return {};}
@@ -99,83 +184,100 @@ Value BuiltinDtan::invoke(const std::vector<Value>& args, Diagnostics& diag, con
 
 Value BuiltinDarcsin::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "darcsin") || !check_numeric(diag, file, line, args[0], "darcsin", 1)) {return {};}
+    if(!check_arity(diag, file, line, args, 1, "darcsin")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "darcsin", cols)) {return {};}
+        if(!column_all(cols.data[0], [](double v) {return v >= -1.0 && v <= 1.0;})) {diag.error("darcsin domain error: input must be in range [-1, 1]", file, line); return {};}
+        return map_columns<1>(cols, [](double v) {return math_darcsin(v);});
+    }
+    if(!check_numeric(diag, file, line, args[0], "darcsin", 1)) {return {};}
     double v = num(args[0]);
     if(v < -1.0 || v > 1.0) {diag.error("darcsin domain error: input must be in range [-1, 1]", file, line); return {};}
-    double degrees = std::asin(v) * RADTODEG;
-    degrees = std::round(degrees * 100.0) / 100.0;
-    return Value(degrees);
+    return Value(math_darcsin(v));
 }
 
 Value BuiltinDarccos::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "darccos") || !check_numeric(diag, file, line, args[0], "darccos", 1)) {return {};}
+    if(!check_arity(diag, file, line, args, 1, "darccos")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "darccos", cols)) {return {};}
+        if(!column_all(cols.data[0], [](double v) {return v >= -1.0 && v <= 1.0;})) {diag.error("darccos domain error: input must be in range [-1, 1]", file, line); return {};}
+        return map_columns<1>(cols, [](double v) {return math_darccos(v);});
+    }
+    if(!check_numeric(diag, file, line, args[0], "darccos", 1)) {return {};}
     double v = num(args[0]);
     if(v < -1.0 || v > 1.0) {diag.error("darccos domain error: input must be in range [-1, 1]", file, line); return {};}
-    double degrees = std::acos(v) * RADTODEG;
-    degrees = std::round(degrees * 100.0) / 100.0;
-    return Value(degrees);
+    return Value(math_darccos(v));
 }
 
 Value BuiltinDarctan::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 1, "darctan") || !check_numeric(diag, file, line, args[0], "darctan", 1)) {return {};}
-    double degrees = std::atan(num(args[0])) * RADTODEG;
-    degrees = std::round(degrees * 100.0) / 100.0;
-    return Value(degrees);
+    if(!check_arity(diag, file, line, args, 1, "darctan")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<1>(args, diag, file, line, "darctan", [](double v) {return math_darctan(v);});}
+    if(!check_numeric(diag, file, line, args[0], "darctan", 1)) {return {};}
+    return Value(math_darctan(num(args[0])));
 }
 
 Value BuiltinDarctan2::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 2, "darctan2") || !check_numeric(diag, file, line, args[0], "darctan2", 1) || !check_numeric(diag, file, line, args[1], "darctan2", 2)) {return {};}
-    double y = num(args[0]);
-    double x = num(args[1]);
-    double degrees = std::atan2(y, x) * RADTODEG;
-    degrees = std::round(degrees * 100.0) / 100.0;
-    return Value(degrees);
+    if(!check_arity(diag, file, line, args, 2, "darctan2")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<2>(args, diag, file, line, "darctan2", [](double y, double x) {return math_darctan2(y, x);});}
+    if(!check_numeric(diag, file, line, args[0], "darctan2", 1) || !check_numeric(diag, file, line, args[1], "darctan2", 2)) {return {};}
+    return Value(math_darctan2(num(args[0]), num(args[1])));
 }
 
 Value BuiltinPointDirection::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 4, "point_direction")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<4>(args, diag, file, line, "point_direction", [](double x1, double y1, double x2, double y2) {return math_point_direction(x1, y1, x2, y2);});}
     for(int i = 0; i < 4; ++i)
     {
         if(!check_numeric(diag, file, line, args[i], "point_direction", i + 1)) {return {};}
     }
-    double x1 = num(args[0]), y1 = num(args[1]), x2 = num(args[2]), y2 = num(args[3]);
-    double radians = std::atan2(y2 - y1, x2 - x1);
-    double degrees = radians * RADTODEG;
-    degrees = std::round(degrees * 100.0) / 100.0;
-    return Value(degrees);
+    return Value(math_point_direction(num(args[0]), num(args[1]), num(args[2]), num(args[3])));
 }
 
 Value BuiltinPointDistance::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
     if(!check_arity(diag, file, line, args, 4, "point_distance")) {return {};}
+    if(has_array_arg(args)) {return map_elementwise<4>(args, diag, file, line, "point_distance", [](double x1, double y1, double x2, double y2) {return math_point_distance(x1, y1, x2, y2);});}
     for(int i = 0; i < 4; ++i)
     {
         if(!check_numeric(diag, file, line, args[i], "point_distance", i + 1)) {return {};}
     }
-    double x1 = num(args[0]), y1 = num(args[1]), x2 = num(args[2]), y2 = num(args[3]);
-    double distance = std::sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
-    distance = std::round(distance * 100.0) / 100.0;
-    return Value(distance);
+    return Value(math_point_distance(num(args[0]), num(args[1]), num(args[2]), num(args[3])));
 }
 
 Value BuiltinLengthdirX::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 2, "lengthdir_x") || !check_numeric(diag, file, line, args[0], "lengthdir_x", 1) || !check_numeric(diag, file, line, args[1], "lengthdir_x", 2)) {return {};}
-    double len = num(args[0]);
-    double dir = num(args[1]) * DEGTORAD;
-    return Value(len * std::cos(dir));
+    if(!check_arity(diag, file, line, args, 2, "lengthdir_x")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "lengthdir_x", cols)) {return {};}
+        const double* len = cols.data[0].data();
+        return trig_columns(cols, 1, MATH_DEGTORAD, false, [len](size_t i, double c) {return len[i] * c;});
+    }
+    if(!check_numeric(diag, file, line, args[0], "lengthdir_x", 1) || !check_numeric(diag, file, line, args[1], "lengthdir_x", 2)) {return {};}
+    return Value(math_lengthdir_x(num(args[0]), num(args[1])));
 }
 
 Value BuiltinLengthdirY::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
 {
-    if(!check_arity(diag, file, line, args, 2, "lengthdir_y") || !check_numeric(diag, file, line, args[0], "lengthdir_y", 1) || !check_numeric(diag, file, line, args[1], "lengthdir_y", 2)) {return {};}
-    double len = num(args[0]);
-    double dir = num(args[1]) * DEGTORAD;
-    return Value(-len * std::sin(dir));
+    if(!check_arity(diag, file, line, args, 2, "lengthdir_y")) {return {};}
+    if(has_array_arg(args))
+    {
+        NumericColumns cols;
+        if(!gather_columns(args, diag, file, line, "lengthdir_y", cols)) {return {};}
+        const double* len = cols.data[0].data();
+        return trig_columns(cols, 1, MATH_DEGTORAD, true, [len](size_t i, double s) {return -len[i] * s;});
+    }
+    if(!check_numeric(diag, file, line, args[0], "lengthdir_y", 1) || !check_numeric(diag, file, line, args[1], "lengthdir_y", 2)) {return {};}
+    return Value(math_lengthdir_y(num(args[0]), num(args[1])));
 }
 
 void register_builtin_math_trig()
@@ -0,0 +1,96 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "MathArrays.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/value/PackedArray.h"
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+    constexpr double TRIG_POLY_LIMIT = 1e5;
+
+    constexpr double INV_PIO2 = 6.36619772367581382433e-01;
+    constexpr double PIO2_1   = 1.57079632673412561417e+00;
+    constexpr double PIO2_2   = 6.07710050630396597660e-11;
+    constexpr double PIO2_3   = 2.02226624871116645580e-21;
+    constexpr double ROUNDER  = 6755399441055744.0;              // 1.5 * 2^52: прибавление округляет до целого
+
+    // q - номер четверти, r = x - q * pi/2 в трёх частях, чтобы не терять биты на больших x
+    inline void sincos_reduced(double x, double& s, double& c, int64_t& q)
+    {
+        double qd = (x * INV_PIO2 + ROUNDER) - ROUNDER;
+        double r = ((x - qd * PIO2_1) - qd * PIO2_2) - qd * PIO2_3;
+        double z = r * r;
+        s = r + r * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+        c = 1.0 - 0.5 * z + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 + z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+        q = static_cast<int64_t>(qd);
+    }
+
+    template<bool SIN, typename Fallback>
+    void trig_n(const double* x, double* out, size_t n, Fallback fallback)
+    {
+        // первый проход без ветвлений; большие и нечисловые элементы считаются как 0 и исправляются вторым проходом
+        for(size_t i = 0; i < n; ++i)
+        {
+            double v = std::fabs(x[i]) < TRIG_POLY_LIMIT ? x[i] : 0.0;
+            double s, c;
+            int64_t q;
+            sincos_reduced(v, s, c, q);
+            if(!SIN) {++q;}
+            double r = (q & 1) ? c : s;
+            out[i] = (q & 2) ? -r : r;
+        }
+        for(size_t i = 0; i < n; ++i)
+        {
+            if(!(std::fabs(x[i]) < TRIG_POLY_LIMIT)) {out[i] = fallback(x[i]);}
+        }
+    }
+}
+
+bool has_array_arg(const std::vector<Value>& args)
+{
+    for(const auto& a : args)
+    {
+        if(is_array(a)) {return true;}
+    }
+    return false;
+}
+
+bool gather_columns(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line, const std::string& name, NumericColumns& cols)
+{
+    bool sized = false;
+    for(size_t i = 0; i < args.size(); ++i)
+    {
+        if(!is_array(args[i])) {continue;}
+        if(args[i].type == ValueType::PACKED_ARRAY) {cols.packed = true;}
+        size_t len = array_length(args[i]);
+        if(sized && len != cols.n) {diag.error(name + ": array arguments must have the same length", file, line); return false;}
+        cols.n = len;
+        sized = true;
+    }
+
+    cols.data.resize(args.size());
+    for(size_t i = 0; i < args.size(); ++i)
+    {
+        if(!is_number(args[i]) && !is_array(args[i])) {diag.error(name + ": argument #" + std::to_string(i + 1) + " must be numeric or a numeric array", file, line); return false;}
+        if(!numeric_column(args[i], cols.n, cols.data[i])) {diag.error(name + ": argument #" + std::to_string(i + 1) + " must contain only numbers", file, line); return false;}
+    }
+    return true;
+}
+
+Value double_array(std::vector<double> values, bool packed)
+{
+    if(packed) {return Value(std::make_shared<PackedArray>(std::move(values)));}
+
+    std::vector<Value> items;
+    items.reserve(values.size());
+    for(double d : values) {items.emplace_back(d);}
+    return Value(items);
+}
+
+void math_sin_n(const double* x, double* out, size_t n) {trig_n<true>(x, out, n, [](double v) {return std::sin(v);});}
+
+void math_cos_n(const double* x, double* out, size_t n) {trig_n<false>(x, out, n, [](double v) {return std::cos(v);});}
@@ -0,0 +1,69 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_MATHKERNELS_H
+#define BERESTALANGUAGE_MATHKERNELS_H
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+// чистые формулы математических builtin'ов без проверок аргументов, их же напрямую вызывает JIT
+inline constexpr double MATH_DEGTORAD = M_PI / 180.0;
+inline constexpr double MATH_RADTODEG = 180.0 / M_PI;
+
+inline double math_round2(double x) {return std::round(x * 100.0) / 100.0;}
+
+inline double math_sqr(double x)   {return x * x;}
+inline double math_sqrt(double x)  {return std::sqrt(x);}
+inline double math_abs(double x)   {return std::fabs(x);}
+inline double math_round(double x) {return std::round(x);}
+inline double math_floor(double x) {return std::floor(x);}
+inline double math_ceil(double x)  {return std::ceil(x);}
+inline double math_frac(double x)  {return x - std::floor(x);}
+inline double math_ln(double x)    {return std::log(x);}
+inline double math_log2(double x)  {return std::log2(x);}
+inline double math_log10(double x) {return std::log10(x);}
+
+inline double math_power(double x, double y)                 {return std::pow(x, y);}
+inline double math_min(double a, double b)                   {return std::min(a, b);}
+inline double math_max(double a, double b)                   {return std::max(a, b);}
+inline double math_clamp(double v, double mn, double mx)     {return std::clamp(v, mn, mx);}
+inline double math_lerp(double a, double b, double amt)      {return a + (b - a) * amt;}
+
+inline double math_sin(double x)    {return std::sin(x);}
+inline double math_cos(double x)    {return std::cos(x);}
+inline double math_arcsin(double x) {return std::asin(x);}
+inline double math_arccos(double x) {return std::acos(x);}
+inline double math_arctan(double x) {return std::atan(x);}
+
+inline double math_arctan2(double y, double x) {return math_round2(std::atan2(y, x));}
+
+inline double math_dsin(double deg)
+{
+    double result = std::sin(deg * MATH_DEGTORAD);
+    if(std::abs(result) < 1e-5) {result = 0.0;}
+    return math_round2(result);
+}
+
+inline double math_dcos(double deg)
+{
+    double result = std::cos(deg * MATH_DEGTORAD);
+    if(std::abs(result) < 1e-5) {result = 0.0;}
+    return math_round2(result);
+}
+
+inline double math_darcsin(double v)            {return math_round2(std::asin(v) * MATH_RADTODEG);}
+inline double math_darccos(double v)            {return math_round2(std::acos(v) * MATH_RADTODEG);}
+inline double math_darctan(double v)            {return math_round2(std::atan(v) * MATH_RADTODEG);}
+inline double math_darctan2(double y, double x) {return math_round2(std::atan2(y, x) * MATH_RADTODEG);}
+
+inline double math_point_direction(double x1, double y1, double x2, double y2) {return math_round2(std::atan2(y2 - y1, x2 - x1) * MATH_RADTODEG);}
+inline double math_point_distance(double x1, double y1, double x2, double y2)  {return math_round2(std::sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1)));}
+
+inline double math_lengthdir_x(double len, double dir) {return len * std::cos(dir * MATH_DEGTORAD);}
+inline double math_lengthdir_y(double len, double dir) {return -len * std::sin(dir * MATH_DEGTORAD);}
+
+
+#endif //BERESTALANGUAGE_MATHKERNELS_H
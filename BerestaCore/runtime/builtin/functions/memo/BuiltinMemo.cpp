@@ -0,0 +1,21 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "BuiltinMemo.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/evaluator/Memoization.h"
+
+Value BuiltinMemoStats::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(args.size() > 1) {diag.error("memo_stats expects 0 or 1 arguments", file, line); return {};}
+    if(!args.empty() && args[0].type != ValueType::STRING) {diag.error("memo_stats: argument must be a function name", file, line); return {};}
+
+    MemoStats s = args.empty() ? Memoization::instance().stats() : Memoization::instance().stats(std::get<std::string>(args[0].data));
+    return Value(std::vector<Value>{Value(static_cast<int>(s.hits)), Value(static_cast<int>(s.misses)), Value(static_cast<int>(s.size))});
+}
+
+void register_builtin_memo()
+{
+    BuiltinRegistry::instance().register_builtin(std::make_unique<BuiltinMemoStats>());
+}
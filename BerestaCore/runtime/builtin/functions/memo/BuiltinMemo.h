@@ -0,0 +1,20 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_BUILTINMEMO_H
+#define BERESTALANGUAGE_BUILTINMEMO_H
+
+#pragma once
+#include "runtime/builtin/core/IBuiltinFunction.h"
+
+// memo_stats() или memo_stats("name") -> [hits, misses, size]
+struct BuiltinMemoStats : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "memo_stats";}
+    [[nodiscard]] bool is_pure() const override {return false;}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+
+#endif //BERESTALANGUAGE_BUILTINMEMO_H
@@ -11,6 +11,7 @@
 struct BuiltinPrint : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "console_print";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
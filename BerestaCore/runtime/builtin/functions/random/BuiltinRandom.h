@@ -11,30 +11,35 @@
 struct BuiltinChooseFrom : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "choose_from";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
 struct BuiltinRandom : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "random";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
 struct BuiltinRandomRange : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "random_range";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
 struct BuiltinIntRandom : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "int_random";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
 struct BuiltinIntRandomRange : IBuiltinFunction
 {
     [[nodiscard]] std::string name() const override {return "int_random_range";}
+    [[nodiscard]] bool is_pure() const override {return false;}
     Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
 };
 
@@ -0,0 +1,43 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "BuiltinRange.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/builtin/core/BuiltinUtils.h"
+#include <cmath>
+#include <limits>
+
+static bool to_range_bound(const Value& v, int& out)
+{
+    if(v.type == ValueType::INTEGER) {out = std::get<int>(v.data); return true;}
+    if(v.type != ValueType::DOUBLE) {return false;}
+
+    double d = std::get<double>(v.data);
+    if(std::trunc(d) != d || d < std::numeric_limits<int>::min() || d > std::numeric_limits<int>::max()) {return false;}
+    out = static_cast<int>(d);
+    return true;
+}
+
+Value BuiltinRange::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(args.empty() || args.size() > 3) {diag.error("range expects 1 to 3 arguments", file, line); return {};}
+
+    int bounds[3] = {0, 0, 1};
+    for(size_t i = 0; i < args.size(); ++i)
+    {
+        if(!to_range_bound(args[i], bounds[i])) {diag.error("range: argument #" + std::to_string(i + 1) + " must be a whole number", file, line); return {};}
+    }
+
+    RangeValue r;
+    if(args.size() == 1) {r.end = bounds[0];}
+    else                 {r.start = bounds[0]; r.end = bounds[1]; r.step = bounds[2];}
+
+    if(r.step == 0) {diag.error("range: step must not be 0", file, line); return {};}
+    return Value(r);
+}
+
+void register_builtin_range()
+{
+    BuiltinRegistry::instance().register_builtin(std::make_unique<BuiltinRange>());
+}
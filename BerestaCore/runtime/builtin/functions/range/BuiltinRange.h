@@ -0,0 +1,19 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_BUILTINRANGE_H
+#define BERESTALANGUAGE_BUILTINRANGE_H
+
+#pragma once
+#include "runtime/builtin/core/IBuiltinFunction.h"
+
+// range(end), range(start, end), range(start, end, step) - ленивый диапазон [start, end)
+struct BuiltinRange : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "range";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+
+#endif //BERESTALANGUAGE_BUILTINRANGE_H
@@ -0,0 +1,105 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "BuiltinSet.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/builtin/core/BuiltinUtils.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/value/ValueSet.h"
+
+static ValueSet* set_arg(Diagnostics& diag, const std::string& file, int line, const std::vector<Value>& args, size_t idx, const std::string& name)
+{
+    if(idx >= args.size() || args[idx].type != ValueType::SET) {diag.error(name + ": argument #" + std::to_string(idx + 1) + " must be a set", file, line); return nullptr;}
+    return std::get<std::shared_ptr<ValueSet>>(args[idx].data).get();
+}
+
+Value BuiltinSetCreate::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(args.size() > 1) {diag.error("set_create expects 0 or 1 argument(s)", file, line); return {};}
+
+    auto set = std::make_shared<ValueSet>();
+    if(args.empty()) {return Value(std::move(set));}
+    if(!is_iterable(args[0])) {diag.error("set_create: argument #1 must be an array, range, generator or set", file, line); return {};}
+
+    if(args[0].type == ValueType::ARRAY) {set->reserve(std::get<std::vector<Value>>(args[0].data).size());}
+    ForeachCursor cursor(args[0]);
+    Value item;
+    while(cursor.next(item)) {set->add(item);}
+    return Value(std::move(set));
+}
+
+Value BuiltinSetAdd::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity_range(diag, file, line, args, 2, "set_add")) {return {};}
+    ValueSet* set = set_arg(diag, file, line, args, 0, name());
+    if(!set) {return {};}
+
+    for(size_t i = 1; i < args.size(); ++i) {set->add(args[i]);}
+    return args[0];
+}
+
+Value BuiltinSetHas::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "set_has")) {return {};}
+    ValueSet* set = set_arg(diag, file, line, args, 0, name());
+    if(!set) {return {};}
+    return Value(set->has(args[1]));
+}
+
+Value BuiltinSetRemove::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "set_remove")) {return {};}
+    ValueSet* set = set_arg(diag, file, line, args, 0, name());
+    if(!set) {return {};}
+
+    set->remove(args[1]);
+    return args[0];
+}
+
+Value BuiltinSetSize::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "set_size")) {return {};}
+    ValueSet* set = set_arg(diag, file, line, args, 0, name());
+    if(!set) {return {};}
+    return Value(static_cast<int>(set->size()));
+}
+
+Value BuiltinSetUnion::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "set_union")) {return {};}
+    ValueSet* a = set_arg(diag, file, line, args, 0, name());
+    ValueSet* b = a ? set_arg(diag, file, line, args, 1, name()) : nullptr;
+    if(!b) {return {};}
+    return Value(std::make_shared<ValueSet>(ValueSet::merge(*a, *b)));
+}
+
+Value BuiltinSetIntersection::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "set_intersection")) {return {};}
+    ValueSet* a = set_arg(diag, file, line, args, 0, name());
+    ValueSet* b = a ? set_arg(diag, file, line, args, 1, name()) : nullptr;
+    if(!b) {return {};}
+    return Value(std::make_shared<ValueSet>(ValueSet::intersect(*a, *b)));
+}
+
+Value BuiltinSetToArray::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "set_to_array")) {return {};}
+    ValueSet* set = set_arg(diag, file, line, args, 0, name());
+    if(!set) {return {};}
+    return Value(set->items());
+}
+
+void register_builtin_set()
+{
+    auto& reg = BuiltinRegistry::instance();
+    reg.register_builtin(std::make_unique<BuiltinSetCreate>());
+    reg.register_builtin(std::make_unique<BuiltinSetAdd>());
+    reg.register_builtin(std::make_unique<BuiltinSetHas>());
+    reg.register_builtin(std::make_unique<BuiltinSetRemove>());
+    reg.register_builtin(std::make_unique<BuiltinSetSize>());
+    reg.register_builtin(std::make_unique<BuiltinSetUnion>());
+    reg.register_builtin(std::make_unique<BuiltinSetIntersection>());
+    reg.register_builtin(std::make_unique<BuiltinSetToArray>());
+}
@@ -0,0 +1,71 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_BUILTINSET_H
+#define BERESTALANGUAGE_BUILTINSET_H
+
+#pragma once
+#include "runtime/builtin/core/IBuiltinFunction.h"
+
+// set_create() / set_create(iterable) - пустое множество или уникальные элементы массива, диапазона, генератора
+struct BuiltinSetCreate : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "set_create";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+// set_add(s, v, ...) - добавляет значения, возвращает s
+struct BuiltinSetAdd : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "set_add";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+struct BuiltinSetHas : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "set_has";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// set_remove(s, v) - возвращает s; порядок элементов после удаления может измениться
+struct BuiltinSetRemove : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "set_remove";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+struct BuiltinSetSize : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "set_size";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// set_union/set_intersection(a, b) - новое множество, операнды не меняются
+struct BuiltinSetUnion : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "set_union";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+struct BuiltinSetIntersection : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "set_intersection";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+struct BuiltinSetToArray : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "set_to_array";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+void register_builtin_set();
+
+
+#endif //BERESTALANGUAGE_BUILTINSET_H
@@ -0,0 +1,174 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "BuiltinStats.h"
+#include "StatsKernels.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/builtin/core/BuiltinUtils.h"
+#include "runtime/builtin/functions/math/MathArrays.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/value/PackedArray.h"
+#include <algorithm>
+#include <cmath>
+
+const double* stats_data(Diagnostics& diag, const std::string& file, int line, const Value& arr, const std::string& name, std::vector<double>& owned, size_t& n)
+{
+    if(!is_array(arr)) {diag.error(name + ": argument #1 must be an array", file, line); return nullptr;}
+
+    n = array_length(arr);
+    if(arr.type == ValueType::PACKED_ARRAY)
+    {
+        const auto& packed = *std::get<std::shared_ptr<PackedArray>>(arr.data);
+        if(packed.type() == PackedType::DOUBLE) {return packed.doubles().data();}
+    }
+    if(!numeric_column(arr, n, owned)) {diag.error(name + ": array must contain only numbers", file, line); return nullptr;}
+    return owned.data();
+}
+
+// непустой числовой массив первым аргументом
+static const double* nonempty_data(Diagnostics& diag, const std::string& file, int line, const std::vector<Value>& args, const std::string& name, std::vector<double>& owned, size_t& n)
+{
+    const double* p = stats_data(diag, file, line, args[0], name, owned, n);
+    if(p && n == 0) {diag.error(name + ": empty array", file, line); return nullptr;}
+    return p;
+}
+
+static bool percent_arg(Diagnostics& diag, const std::string& file, int line, const Value& v, const std::string& name, double& out)
+{
+    if(!is_numeric(v) || !(num(v) >= 0.0 && num(v) <= 100.0)) {diag.error(name + ": percentile must be a number in 0..100", file, line); return false;}
+    out = num(v);
+    return true;
+}
+
+Value BuiltinArrayMean::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_mean")) {return {};}
+    std::vector<double> owned;
+    size_t n = 0;
+    const double* p = nonempty_data(diag, file, line, args, name(), owned, n);
+    if(!p) {return {};}
+    return Value(stats_sum(p, n) / static_cast<double>(n));
+}
+
+Value BuiltinArrayVariance::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_variance")) {return {};}
+    std::vector<double> owned;
+    size_t n = 0;
+    const double* p = nonempty_data(diag, file, line, args, name(), owned, n);
+    if(!p) {return {};}
+    return Value(stats_variance(p, n));
+}
+
+Value BuiltinArrayArgmin::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_argmin")) {return {};}
+    std::vector<double> owned;
+    size_t n = 0;
+    const double* p = nonempty_data(diag, file, line, args, name(), owned, n);
+    if(!p) {return {};}
+    return Value(static_cast<int>(stats_argmin(p, n)));
+}
+
+Value BuiltinArrayArgmax::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_argmax")) {return {};}
+    std::vector<double> owned;
+    size_t n = 0;
+    const double* p = nonempty_data(diag, file, line, args, name(), owned, n);
+    if(!p) {return {};}
+    return Value(static_cast<int>(stats_argmax(p, n)));
+}
+
+Value BuiltinArrayMedian::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "array_median")) {return {};}
+    std::vector<double> owned;
+    size_t n = 0;
+    const double* p = nonempty_data(diag, file, line, args, name(), owned, n);
+    if(!p) {return {};}
+
+    // выбор переставляет элементы, поэтому плотный массив копируется
+    std::vector<double> values(p, p + n);
+    size_t mid = n / 2;
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(mid), values.end());
+    return Value(values[mid]);
+}
+
+Value BuiltinArrayPercentile::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "array_percentile")) {return {};}
+
+    std::vector<double> percents;
+    if(is_array(args[1]))
+    {
+        for(size_t i = 0; i < array_length(args[1]); ++i)
+        {
+            double pct = 0.0;
+            if(!percent_arg(diag, file, line, array_element(args[1], i), name(), pct)) {return {};}
+            percents.push_back(pct);
+        }
+    }
+    else
+    {
+        double pct = 0.0;
+        if(!percent_arg(diag, file, line, args[1], name(), pct)) {return {};}
+        percents.push_back(pct);
+    }
+
+    std::vector<double> owned;
+    size_t n = 0;
+    const double* p = nonempty_data(diag, file, line, args, name(), owned, n);
+    if(!p) {return {};}
+
+    std::vector<double> values = p == owned.data() ? std::move(owned) : std::vector<double>(p, p + n);
+    std::vector<double> result = stats_percentiles(values, percents);
+    if(!is_array(args[1])) {return Value(result[0]);}
+    return double_array(std::move(result), args[1].type == ValueType::PACKED_ARRAY);
+}
+
+Value BuiltinArrayHistogram::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(args.size() != 2 && args.size() != 4) {diag.error("array_histogram expects 2 or 4 argument(s)", file, line); return {};}
+    if(!is_numeric(args[1]) || num(args[1]) < 1.0) {diag.error("array_histogram: bins must be a positive number", file, line); return {};}
+    auto bins = static_cast<size_t>(num(args[1]));
+
+    std::vector<double> owned;
+    size_t n = 0;
+    const double* p = stats_data(diag, file, line, args[0], name(), owned, n);
+    if(!p) {return {};}
+
+    double lo = 0.0;
+    double hi = 0.0;
+    if(args.size() == 4)
+    {
+        if(!check_numeric(diag, file, line, args[2], "array_histogram", 3)) {return {};}
+        if(!check_numeric(diag, file, line, args[3], "array_histogram", 4)) {return {};}
+        lo = num(args[2]);
+        hi = num(args[3]);
+        if(!(lo <= hi)) {diag.error("array_histogram: lo must not exceed hi", file, line); return {};}
+    }
+    else if(n > 0)
+    {
+        lo = stats_min(p, n);
+        hi = stats_max(p, n);
+    }
+
+    std::vector<Value> out;
+    out.reserve(bins);
+    for(int64_t c : stats_histogram(p, n, bins, lo, hi)) {out.emplace_back(static_cast<int>(c));}
+    return Value(out);
+}
+
+void register_builtin_stats()
+{
+    auto& reg = BuiltinRegistry::instance();
+    reg.register_builtin(std::make_unique<BuiltinArrayMean>());
+    reg.register_builtin(std::make_unique<BuiltinArrayVariance>());
+    reg.register_builtin(std::make_unique<BuiltinArrayArgmin>());
+    reg.register_builtin(std::make_unique<BuiltinArrayArgmax>());
+    reg.register_builtin(std::make_unique<BuiltinArrayMedian>());
+    reg.register_builtin(std::make_unique<BuiltinArrayPercentile>());
+    reg.register_builtin(std::make_unique<BuiltinArrayHistogram>());
+}
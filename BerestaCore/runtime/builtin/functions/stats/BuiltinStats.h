@@ -0,0 +1,69 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_BUILTINSTATS_H
+#define BERESTALANGUAGE_BUILTINSTATS_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/builtin/core/IBuiltinFunction.h"
+#include "runtime/value/Value.h"
+#include <string>
+#include <vector>
+
+class Diagnostics;
+
+// числа массива для статистики: плотный double читается на месте, остальное копируется в owned.
+// nullptr - аргумент не массив или в нём не только числа (ошибка уже выдана)
+BERESTA_API const double* stats_data(Diagnostics& diag, const std::string& file, int line, const Value& arr, const std::string& name, std::vector<double>& owned, size_t& n);
+
+struct BuiltinArrayMean : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_mean";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// дисперсия генеральной совокупности (деление на n)
+struct BuiltinArrayVariance : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_variance";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// индекс первого наименьшего / наибольшего элемента
+struct BuiltinArrayArgmin : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_argmin";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinArrayArgmax : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_argmax";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// медиана, как у median(): при чётной длине - верхний из двух средних. Среднее двух средних даёт array_percentile(a, 50)
+struct BuiltinArrayMedian : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_median";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// array_percentile(a, p) - число; array_percentile(a, [p1, p2, ...]) - массив. p в 0..100, между рангами линейная интерполяция
+struct BuiltinArrayPercentile : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_percentile";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// array_histogram(a, bins) / array_histogram(a, bins, lo, hi) - массив счётчиков; по умолчанию отрезок [min, max]
+struct BuiltinArrayHistogram : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "array_histogram";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+
+#endif //BERESTALANGUAGE_BUILTINSTATS_H
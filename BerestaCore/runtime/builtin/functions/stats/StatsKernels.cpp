@@ -0,0 +1,154 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "StatsKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    // граница кусков зависит только от n, поэтому порядок сложения одинаков на любой машине
+    constexpr size_t CHUNK = 1 << 16;
+
+    // f(from, to) для каждого куска; результаты лежат в порядке кусков
+    template<typename T, typename F>
+    std::vector<T> map_chunks(size_t n, F f)
+    {
+        size_t chunks = (n + CHUNK - 1) / CHUNK;
+        std::vector<T> out(chunks);
+        size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), chunks);
+        auto run = [&](size_t w)
+        {
+            for(size_t c = w; c < chunks; c += workers) {out[c] = f(c * CHUNK, std::min(n, (c + 1) * CHUNK));}
+        };
+
+        if(workers <= 1) {run(0); return out;}
+
+        std::vector<std::thread> threads;
+        for(size_t w = 1; w < workers; ++w) {threads.emplace_back(run, w);}
+        run(0);
+        for(auto& t : threads) {t.join();}
+        return out;
+    }
+
+    // четыре независимые суммы внутри куска, чтобы сложения не ждали друг друга
+    template<typename F>
+    double chunk_sum(const double* p, size_t from, size_t to, F term)
+    {
+        double s[4] = {0.0, 0.0, 0.0, 0.0};
+        size_t i = from;
+        for(; i + 4 <= to; i += 4)
+        {
+            s[0] += term(p[i]); s[1] += term(p[i + 1]); s[2] += term(p[i + 2]); s[3] += term(p[i + 3]);
+        }
+        double total = (s[0] + s[1]) + (s[2] + s[3]);
+        for(; i < to; ++i) {total += term(p[i]);}
+        return total;
+    }
+
+    template<typename F>
+    double sum_of(const double* p, size_t n, F term)
+    {
+        double total = 0.0;
+        for(double part : map_chunks<double>(n, [&](size_t from, size_t to) {return chunk_sum(p, from, to, term);})) {total += part;}
+        return total;
+    }
+
+    // индекс первого элемента, который better предпочитает всем остальным
+    template<typename Better>
+    size_t arg_extreme(const double* p, size_t n, Better better)
+    {
+        auto best = map_chunks<size_t>(n, [&](size_t from, size_t to)
+        {
+            size_t k = from;
+            for(size_t i = from + 1; i < to; ++i)
+            {
+                if(better(p[i], p[k])) {k = i;}
+            }
+            return k;
+        });
+
+        size_t k = best.empty() ? 0 : best[0];
+        for(size_t c = 1; c < best.size(); ++c)
+        {
+            if(better(p[best[c]], p[k])) {k = best[c];}
+        }
+        return k;
+    }
+}
+
+double stats_sum(const double* p, size_t n) {return sum_of(p, n, [](double x) {return x;});}
+
+size_t stats_argmin(const double* p, size_t n) {return arg_extreme(p, n, [](double a, double b) {return a < b;});}
+size_t stats_argmax(const double* p, size_t n) {return arg_extreme(p, n, [](double a, double b) {return a > b;});}
+
+double stats_min(const double* p, size_t n) {return p[stats_argmin(p, n)];}
+double stats_max(const double* p, size_t n) {return p[stats_argmax(p, n)];}
+
+double stats_variance(const double* p, size_t n)
+{
+    double mean = stats_sum(p, n) / static_cast<double>(n);
+    return sum_of(p, n, [mean](double x) {return (x - mean) * (x - mean);}) / static_cast<double>(n);
+}
+
+std::vector<double> stats_percentiles(std::vector<double>& values, const std::vector<double>& percents)
+{
+    size_t n = values.size();
+    std::vector<size_t> ranks;
+    for(double pct : percents)
+    {
+        double pos = pct / 100.0 * static_cast<double>(n - 1);
+        auto lo = static_cast<size_t>(std::floor(pos));
+        ranks.push_back(lo);
+        ranks.push_back(std::min(n - 1, lo + 1));
+    }
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+
+    // после nth_element по рангу r всё правее не меньше, поэтому следующий ранг ищется только в хвосте
+    auto from = values.begin();
+    for(size_t r : ranks)
+    {
+        std::nth_element(from, values.begin() + static_cast<std::ptrdiff_t>(r), values.end());
+        from = values.begin() + static_cast<std::ptrdiff_t>(r) + 1;
+    }
+
+    std::vector<double> out;
+    out.reserve(percents.size());
+    for(double pct : percents)
+    {
+        double pos = pct / 100.0 * static_cast<double>(n - 1);
+        auto lo = static_cast<size_t>(std::floor(pos));
+        double frac = pos - static_cast<double>(lo);
+        double v = values[lo];
+        if(frac > 0.0 && lo + 1 < n) {v += frac * (values[lo + 1] - v);}
+        out.push_back(v);
+    }
+    return out;
+}
+
+std::vector<int64_t> stats_histogram(const double* p, size_t n, size_t bins, double lo, double hi)
+{
+    double scale = hi > lo ? static_cast<double>(bins) / (hi - lo) : 0.0;
+    auto parts = map_chunks<std::vector<int64_t>>(n, [&](size_t from, size_t to)
+    {
+        std::vector<int64_t> counts(bins, 0);
+        for(size_t i = from; i < to; ++i)
+        {
+            double x = p[i];
+            if(!(x >= lo && x <= hi)) {continue;}
+            auto b = static_cast<size_t>((x - lo) * scale);
+            ++counts[std::min(b, bins - 1)];
+        }
+        return counts;
+    });
+
+    std::vector<int64_t> total(bins, 0);
+    for(const auto& part : parts)
+    {
+        for(size_t b = 0; b < bins; ++b) {total[b] += part[b];}
+    }
+    return total;
+}
@@ -0,0 +1,31 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_STATSKERNELS_H
+#define BERESTALANGUAGE_STATSKERNELS_H
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// редукции над сырым double. Большой вход режется на куски фиксированного размера, куски считаются в потоках,
+// частичные результаты складываются по порядку кусков - число потоков на результат не влияет
+double stats_sum(const double* p, size_t n);
+double stats_min(const double* p, size_t n);
+double stats_max(const double* p, size_t n);
+size_t stats_argmin(const double* p, size_t n);         // первый индекс наименьшего
+size_t stats_argmax(const double* p, size_t n);
+
+// дисперсия генеральной совокупности, два прохода: сначала среднее, потом квадраты отклонений
+double stats_variance(const double* p, size_t n);
+
+// перцентили 0..100 с линейной интерполяцией между соседними рангами; values переставляется (nth_element)
+std::vector<double> stats_percentiles(std::vector<double>& values, const std::vector<double>& percents);
+
+// bins равных корзин на [lo, hi]; hi попадает в последнюю, значения вне отрезка не считаются
+std::vector<int64_t> stats_histogram(const double* p, size_t n, size_t bins, double lo, double hi);
+
+
+#endif //BERESTALANGUAGE_STATSKERNELS_H
@@ -0,0 +1,148 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "BuiltinStructArray.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/builtin/core/BuiltinUtils.h"
+#include "runtime/value/StructArray.h"
+#include <algorithm>
+#include <limits>
+
+static StructArray* struct_array_arg(Diagnostics& diag, const std::string& file, int line, const std::vector<Value>& args, const std::string& name)
+{
+    if(args.empty() || args[0].type != ValueType::STRUCT_ARRAY) {diag.error(name + ": argument #1 must be a struct array", file, line); return nullptr;}
+    return std::get<std::shared_ptr<StructArray>>(args[0].data).get();
+}
+
+// столбец поля по имени; после вызова он плотный, иначе ошибка
+static StructColumn* numeric_column(Diagnostics& diag, const std::string& file, int line, StructArray& arr, const Value& field, const std::string& name)
+{
+    if(field.type != ValueType::STRING) {diag.error(name + ": field name must be a string", file, line); return nullptr;}
+
+    int slot = arr.shape()->slot(std::get<std::string>(field.data));
+    if(slot < 0) {diag.error(name + ": unknown struct field: " + std::get<std::string>(field.data), file, line); return nullptr;}
+
+    StructColumn& column = arr.column(slot);
+    if(!column.pack()) {diag.error(name + ": field " + std::get<std::string>(field.data) + " is not numeric", file, line); return nullptr;}
+    return &column;
+}
+
+Value BuiltinStructArray::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 1, "struct_array")) {return {};}
+    if(args[0].type != ValueType::STRUCT) {diag.error("struct_array: argument #1 must be a struct template", file, line); return {};}
+
+    const auto& tmpl = std::get<std::shared_ptr<StructInstance>>(args[0].data);
+    return Value(std::make_shared<StructArray>(tmpl->definition));
+}
+
+Value BuiltinStructArrayPush::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "struct_array_push")) {return {};}
+    StructArray* arr = struct_array_arg(diag, file, line, args, name());
+    if(!arr) {return {};}
+
+    const StructInstance* inst = args[1].type == ValueType::STRUCT ? std::get<std::shared_ptr<StructInstance>>(args[1].data).get() : nullptr;
+    if(!inst || !arr->push(*inst)) {diag.error("struct_array_push: item must be a struct of the same shape", file, line); return {};}
+    return args[0];
+}
+
+Value BuiltinStructArraySum::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "struct_array_sum")) {return {};}
+    StructArray* arr = struct_array_arg(diag, file, line, args, name());
+    StructColumn* column = arr ? numeric_column(diag, file, line, *arr, args[1], name()) : nullptr;
+    if(!column) {return {};}
+
+    double total = 0.0;
+    for(double d : column->numbers()) {total += d;}
+    return Value(total);
+}
+
+Value BuiltinStructArrayMin::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "struct_array_min")) {return {};}
+    StructArray* arr = struct_array_arg(diag, file, line, args, name());
+    StructColumn* column = arr ? numeric_column(diag, file, line, *arr, args[1], name()) : nullptr;
+    if(!column) {return {};}
+    if(column->numbers().empty()) {diag.error("struct_array_min: empty struct array", file, line); return {};}
+
+    return Value(*std::min_element(column->numbers().begin(), column->numbers().end()));
+}
+
+Value BuiltinStructArrayMax::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 2, "struct_array_max")) {return {};}
+    StructArray* arr = struct_array_arg(diag, file, line, args, name());
+    StructColumn* column = arr ? numeric_column(diag, file, line, *arr, args[1], name()) : nullptr;
+    if(!column) {return {};}
+    if(column->numbers().empty()) {diag.error("struct_array_max: empty struct array", file, line); return {};}
+
+    return Value(*std::max_element(column->numbers().begin(), column->numbers().end()));
+}
+
+template<typename Op>
+static void update_column(std::vector<double>& dst, const std::vector<double>* src, double scalar, Op op)
+{
+    if(src) {for(size_t i = 0; i < dst.size(); ++i) {dst[i] = op(dst[i], (*src)[i]);}}
+    else    {for(double& d : dst) {d = op(d, scalar);}}
+}
+
+Value BuiltinStructArrayUpdate::invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!check_arity(diag, file, line, args, 4, "struct_array_update")) {return {};}
+    StructArray* arr = struct_array_arg(diag, file, line, args, name());
+    if(!arr) {return {};}
+
+    if(args[2].type != ValueType::STRING) {diag.error("struct_array_update: operator must be a string", file, line); return {};}
+    const std::string& op = std::get<std::string>(args[2].data);
+    if(op != "=" && op != "+" && op != "-" && op != "*" && op != "/") {diag.error("struct_array_update: unknown operator " + op, file, line); return {};}
+
+    // "=" перезаписывает столбец, поэтому старые значения могут быть любыми
+    if(op == "=" && args[1].type == ValueType::STRING && is_numeric(args[3]))
+    {
+        int slot = arr->shape()->slot(std::get<std::string>(args[1].data));
+        if(slot < 0) {diag.error("struct_array_update: unknown struct field: " + std::get<std::string>(args[1].data), file, line); return {};}
+        for(size_t i = 0; i < arr->size(); ++i) {arr->column(slot).set(i, args[3]);}
+        return args[0];
+    }
+
+    StructColumn* dst = numeric_column(diag, file, line, *arr, args[1], name());
+    if(!dst) {return {};}
+
+    const std::vector<double>* src = nullptr;
+    const StructColumn* src_column = nullptr;
+    double scalar = 0.0;
+    if(args[3].type == ValueType::STRING)
+    {
+        src_column = numeric_column(diag, file, line, *arr, args[3], name());
+        if(!src_column) {return {};}
+        src = &src_column->numbers();
+    }
+    else if(is_numeric(args[3])) {scalar = args[3].type == ValueType::DOUBLE ? std::get<double>(args[3].data) : std::get<int>(args[3].data);}
+    else {diag.error("struct_array_update: operand must be a number or a field name", file, line); return {};}
+
+    auto& numbers = dst->numbers();
+    if(op == "=")      {update_column(numbers, src, scalar, [](double, double b) {return b;});}
+    else if(op == "+") {update_column(numbers, src, scalar, [](double a, double b) {return a + b;});}
+    else if(op == "-") {update_column(numbers, src, scalar, [](double a, double b) {return a - b;});}
+    else if(op == "*") {update_column(numbers, src, scalar, [](double a, double b) {return a * b;});}
+    else               {update_column(numbers, src, scalar, [](double a, double b) {return b != 0.0 ? a / b : 0.0;});}
+
+    // копия столбца сохраняет целые, арифметика, как и в языке, даёт double
+    if(op == "=") {dst->copy_kinds(*src_column);}
+    else          {dst->mark_doubles();}
+    return args[0];
+}
+
+void register_builtin_struct_array()
+{
+    auto& reg = BuiltinRegistry::instance();
+    reg.register_builtin(std::make_unique<BuiltinStructArray>());
+    reg.register_builtin(std::make_unique<BuiltinStructArrayPush>());
+    reg.register_builtin(std::make_unique<BuiltinStructArraySum>());
+    reg.register_builtin(std::make_unique<BuiltinStructArrayMin>());
+    reg.register_builtin(std::make_unique<BuiltinStructArrayMax>());
+    reg.register_builtin(std::make_unique<BuiltinStructArrayUpdate>());
+}
@@ -0,0 +1,56 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_BUILTINSTRUCTARRAY_H
+#define BERESTALANGUAGE_BUILTINSTRUCTARRAY_H
+
+#pragma once
+#include "runtime/builtin/core/IBuiltinFunction.h"
+
+// struct_array(template) - пустой массив структур формы шаблона, поля хранятся по столбцам
+struct BuiltinStructArray : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "struct_array";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+// struct_array_push(arr, item) - добавляет экземпляр той же формы, возвращает arr
+struct BuiltinStructArrayPush : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "struct_array_push";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+// struct_array_sum/min/max(arr, "field") - свёртка числового столбца целиком
+struct BuiltinStructArraySum : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "struct_array_sum";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinStructArrayMin : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "struct_array_min";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+struct BuiltinStructArrayMax : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "struct_array_max";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+};
+
+// struct_array_update(arr, "field", op, operand) - field = field op operand для всех элементов сразу;
+// op: "=", "+", "-", "*", "/"; operand - число или имя другого числового поля
+struct BuiltinStructArrayUpdate : IBuiltinFunction
+{
+    [[nodiscard]] std::string name() const override {return "struct_array_update";}
+    Value invoke(const std::vector<Value>& args, Diagnostics& diag, const std::string& filename, int line) override;
+    [[nodiscard]] bool is_pure() const override {return false;}
+};
+
+
+#endif //BERESTALANGUAGE_BUILTINSTRUCTARRAY_H
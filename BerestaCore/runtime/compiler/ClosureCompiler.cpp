@@ -0,0 +1,760 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "ClosureCompiler.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/evaluator/FusedArrayExpr.h"
+#include "runtime/evaluator/SwitchTable.h"
+#include "runtime/evaluator/Memoization.h"
+#include "runtime/jit/NumericJit.h"
+#include "runtime/value/StructValue.h"
+#include "runtime/value/ArraySlice.h"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    template<BinaryOp OP>
+    ClosureCompiler::Closure numeric_binary(ClosureCompiler::Closure left, ClosureCompiler::Closure right, Diagnostics& diag, const std::string* file, int line)
+    {
+        return [left = std::move(left), right = std::move(right), &diag, file, line]() -> Value
+        {
+            Value lv = left();
+            Value rv = right();
+            return apply_binary_fast<OP>(lv, rv, diag, *file, line);
+        };
+    }
+
+    ClosureCompiler::Closure constant(Value v)
+    {
+        return [v = std::move(v)]() -> Value {return v;};
+    }
+}
+
+ClosureCompiler::ClosureCompiler(Environment& env, FunctionIndex& index, std::string current_file, Diagnostics& diag)
+    : BaseContext(diag, std::move(current_file)), _env(env), _index(index), _tail_calls(index), _vector_loops(index)
+    {
+        _file = intern_file(_current_file);
+    }
+
+const std::string* ClosureCompiler::intern_file(const std::string& file)
+{
+    return &*_files.insert(file).first;
+}
+
+Evaluator& ClosureCompiler::fallback(const std::string& file)
+{
+    auto& slot = _fallbacks[file];
+    if(!slot) {slot = std::make_unique<Evaluator>(_env, _index, file, _diag);}
+    return *slot;
+}
+
+Value ClosureCompiler::run_statement(Statement* stmt)
+{
+    _file = intern_file(current_file());
+    Closure code = compile_statement(stmt);
+    Value result = code();
+    _flow = Flow::NORMAL;
+    return result;
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_expression(Expression* expr)
+{
+    if(!expr) {return constant(Value());}
+
+    const std::string* file = _file;
+    int line = expr->line;
+
+    switch(expr->type)
+    {
+        case ExpressionType::NUMBER:  {return constant(static_cast<NumberExpr*>(expr)->value);}
+        case ExpressionType::STRING:  {return constant(Value(static_cast<StringExpr*>(expr)->value));}
+        case ExpressionType::BOOLEAN: {return constant(Value(static_cast<BoolExpr*>(expr)->value));}
+
+        case ExpressionType::VARIABLE:
+        {
+            std::string name = static_cast<VariableExpr*>(expr)->name;
+            return [this, name = std::move(name), file, line]() -> Value {return _env.get(name, *file, line);};
+        }
+
+        case ExpressionType::UNARY:
+        {
+            auto& un = *static_cast<UnaryExpr*>(expr);
+            Closure right = compile_expression(un.right.get());
+            char op = un.op;
+            return [this, right = std::move(right), op, file, line]() -> Value {return apply_unary(op, right(), _diag, *file, line);};
+        }
+
+        case ExpressionType::BINARY:        {return compile_binary(*static_cast<BinaryExpr*>(expr));}
+        case ExpressionType::FUNCTION_CALL: {return compile_call(*static_cast<FunctionCallExpr*>(expr));}
+
+        case ExpressionType::ARRAY_LITERAL:
+        {
+            std::vector<Closure> elements;
+            for(auto& e : static_cast<ArrayLiteralExpr*>(expr)->elements) {elements.push_back(compile_expression(e.get()));}
+
+            return [elements = std::move(elements)]() -> Value
+            {
+                std::vector<Value> values;
+                values.reserve(elements.size());
+                for(const auto& e : elements) {values.push_back(e());}
+                return Value(values);
+            };
+        }
+
+        case ExpressionType::INDEX:
+        {
+            auto& ix = *static_cast<IndexExpr*>(expr);
+            Closure container = compile_expression(ix.array.get());
+            Closure index = compile_expression(ix.index.get());
+            return [this, container = std::move(container), index = std::move(index), file, line]() -> Value
+            {
+                Value c = container();
+                Value i = index();
+                return index_value(c, i, _diag, *file, line);
+            };
+        }
+
+        default:
+        {
+            // словари, структуры и доступ к членам редкие, их отдаём обычному Evaluator
+            return [this, expr, file]() -> Value {return fallback(*file).eval_expression(expr);};
+        }
+    }
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_binary(BinaryExpr& expr)
+{
+    if(!FusedArrayExpr::is_chain(expr)) {return compile_operator(expr);}
+
+    // цепочка операторов: листья считаются по разу, путь (слитый проход или свёртка над числами) выбирается по их значениям
+    if(!expr.fused) {expr.fused = std::make_shared<FusedArrayExpr>(expr);}
+    std::shared_ptr<FusedArrayExpr> fused = expr.fused;
+    std::vector<Closure> leaves;
+    for(auto* leaf : fused->leaves()) {leaves.push_back(compile_expression(leaf));}
+
+    const std::string* file = _file;
+    int line = expr.line;
+    return [this, fused, leaves = std::move(leaves), file, line]() -> Value
+    {
+        return fused->run([&](size_t i) {return leaves[i]();}, _diag, *file, line);
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_operator(BinaryExpr& expr)
+{
+    Closure left = compile_expression(expr.left.get());
+    Closure right = compile_expression(expr.right.get());
+    const std::string* file = _file;
+    int line = expr.line;
+
+    switch(expr.opcode)
+    {
+        case BinaryOp::ADD:           {return numeric_binary<BinaryOp::ADD>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::SUB:           {return numeric_binary<BinaryOp::SUB>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::MUL:           {return numeric_binary<BinaryOp::MUL>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::DIV:           {return numeric_binary<BinaryOp::DIV>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::EQUAL:         {return numeric_binary<BinaryOp::EQUAL>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::NOT_EQUAL:     {return numeric_binary<BinaryOp::NOT_EQUAL>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::LESS:          {return numeric_binary<BinaryOp::LESS>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::LESS_EQUAL:    {return numeric_binary<BinaryOp::LESS_EQUAL>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::GREATER:       {return numeric_binary<BinaryOp::GREATER>(std::move(left), std::move(right), _diag, file, line);}
+        case BinaryOp::GREATER_EQUAL: {return numeric_binary<BinaryOp::GREATER_EQUAL>(std::move(left), std::move(right), _diag, file, line);}
+        default:                      {break;}
+    }
+
+    BinaryOp op = expr.opcode;
+    return [this, left = std::move(left), right = std::move(right), op, file, line]() -> Value
+    {
+        Value lv = left();
+        if(short_circuits(op, lv)) {return lv;}
+
+        Value rv = right();
+        return apply_binary(op, lv, rv, _diag, *file, line);
+    };
+}
+
+ClosureCompiler::Condition ClosureCompiler::compile_condition(Expression* expr)
+{
+    if(!is_fused_condition(expr))
+    {
+        Closure value = compile_expression(expr);
+        const std::string* file = _file;
+        int line = expr->line;
+        return [this, value = std::move(value), file, line]() {return condition_truthy(value(), _diag, *file, line);};
+    }
+
+    auto& bin = *static_cast<BinaryExpr*>(expr);
+    if(bin.opcode == BinaryOp::AND || bin.opcode == BinaryOp::OR)
+    {
+        Condition left = compile_condition(bin.left.get());
+        Condition right = compile_condition(bin.right.get());
+        if(bin.opcode == BinaryOp::AND) {return [left = std::move(left), right = std::move(right)]() {return left() && right();};}
+        return [left = std::move(left), right = std::move(right)]() {return left() || right();};
+    }
+
+    Closure left = compile_expression(bin.left.get());
+    Closure right = compile_expression(bin.right.get());
+    const std::string* file = _file;
+    int line = bin.line;
+    BinaryOp op = bin.opcode;
+
+    return [this, left = std::move(left), right = std::move(right), op, file, line]()
+    {
+        Value lv = left();
+        Value rv = right();
+        return apply_condition(op, lv, rv, _diag, *file, line);
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_call(FunctionCallExpr& expr)
+{
+    if(auto* var = dynamic_cast<VariableExpr*>(expr.callee.get()))
+    {
+        if(auto* impl = BuiltinRegistry::instance().get(var->name))
+        {
+            std::vector<Closure> args;
+            for(auto& a : expr.arguments) {args.push_back(compile_expression(a.get()));}
+
+            const std::string* file = _file;
+            int line = expr.line;
+
+            // функции языка из array_map и подобных исполняет Evaluator этого файла
+            if(impl->calls_back())
+            {
+                Evaluator* caller = &fallback(*file);
+                return [this, impl, caller, args = std::move(args), file, line]() -> Value
+                {
+                    std::vector<Value> values;
+                    values.reserve(args.size());
+                    for(const auto& a : args) {values.push_back(a());}
+
+                    ActiveEvaluator active(caller);
+                    try                             {return impl->invoke(values, _diag, *file, line);}
+                    catch(const std::exception& ex) {_diag.error(std::string("Builtin error: ") + ex.what(), *file, line); return {};}
+                    catch(...)                      {_diag.error("Builtin error: exception", *file, line); return {};}
+                };
+            }
+
+            return [this, impl, args = std::move(args), file, line]() -> Value
+            {
+                std::vector<Value> values;
+                values.reserve(args.size());
+                for(const auto& a : args) {values.push_back(a());}
+
+                try                             {return impl->invoke(values, _diag, *file, line);}
+                catch(const std::exception& ex) {_diag.error(std::string("Builtin error: ") + ex.what(), *file, line); return {};}
+                catch(...)                      {_diag.error("Builtin error: exception", *file, line); return {};}
+            };
+        }
+
+        if(const FunctionRef* ref = _index.find_function(var->name, *_file)) {return compile_user_call(expr, ref->func, ref->file);}
+    }
+
+    return compile_struct_call(expr);
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_user_call(FunctionCallExpr& expr, FunctionStatement* fn, const std::string& fn_file)
+{
+    std::vector<Closure> args;
+    for(auto& a : expr.arguments) {args.push_back(compile_expression(a.get()));}
+
+    // генератор шагает корутиной Evaluator, замыкания для его тела не строим
+    if(fn->is_generator)
+    {
+        FunctionRef ref {fn, fn_file, true};
+        const std::string* file = _file;
+        return [this, ref, file, args = std::move(args)]() -> Value
+        {
+            std::vector<Value> values;
+            values.reserve(args.size());
+            for(const auto& a : args) {values.push_back(a());}
+            return fallback(*file).call_function(ref, values);
+        };
+    }
+
+    CallTarget target {fn, function_body(fn), intern_file(fn_file)};
+    return [this, target, args = std::move(args)]() -> Value
+    {
+        std::vector<Value> values;
+        values.reserve(args.size());
+        for(const auto& a : args) {values.push_back(a());}
+        return invoke(target, std::move(values));
+    };
+}
+
+Value ClosureCompiler::invoke(CallTarget target, std::vector<Value> values)
+{
+    // как Evaluator::call_function: хвостовые вызовы выполняются циклом, pure-функции цепочки получают один общий результат
+    std::vector<std::pair<MemoCache*, std::vector<Value>>> memo_pending;
+    auto finish = [&](const Value& result)
+    {
+        for(auto& [cache, key] : memo_pending) {cache->insert(key, result);}
+        return result;
+    };
+
+    while(true)
+    {
+        FunctionStatement* fn = target.fn;
+        if(values.size() != fn->parameters.size()) {std::cerr << "[ERROR] Function " << fn->name << " expects " << fn->parameters.size() << " args, got " << values.size() << "\n"; return {};}
+
+        if(MemoCache* memo = Memoization::instance().cache_for(*fn, _index, *target.file, _diag))
+        {
+            if(std::all_of(values.begin(), values.end(), is_hashable))
+            {
+                if(const Value* hit = memo->find(values)) {return finish(*hit);}
+                memo_pending.emplace_back(memo, values);
+            }
+        }
+
+        Value jitted;
+        if(NumericJit::instance().enabled() && NumericJit::instance().try_call(*fn, values, jitted)) {return finish(jitted);}
+
+        if(!*target.body)
+        {
+            const std::string* saved = _file;
+            const FunctionStatement* saved_function = _compiling_function;
+            _file = target.file;
+            _compiling_function = fn;
+            *target.body = compile_statement(fn->body.get());
+            _file = saved;
+            _compiling_function = saved_function;
+        }
+
+        _env.push_scope();
+        for(size_t i = 0; i < values.size(); ++i)
+        {
+            _env.define(fn->parameters[i], values[i]);
+        }
+
+        Value result = (*target.body)();
+        if(_flow == Flow::RETURN) {result = std::move(_return_value); _return_value = Value();}
+        _flow = Flow::NORMAL;
+
+        _env.pop_scope();
+
+        if(!_tail_pending) {return finish(result);}
+        _tail_pending = false;
+        target = std::move(_tail_target);
+        values = std::move(_tail_args);
+    }
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_return(ReturnStatement& stmt)
+{
+    if(_compiling_function && stmt.value && stmt.value->type == ExpressionType::FUNCTION_CALL)
+    {
+        auto& call = static_cast<FunctionCallExpr&>(*stmt.value);
+        auto* var = dynamic_cast<VariableExpr*>(call.callee.get());
+        const FunctionRef* ref = (var && !BuiltinRegistry::instance().get(var->name)) ? _index.find_function(var->name, *_file) : nullptr;
+
+        if(ref && !ref->func->is_generator && _tail_calls.can_reuse_frame(*_compiling_function, *_file, *ref))
+        {
+            std::vector<Closure> args;
+            for(auto& a : call.arguments) {args.push_back(compile_expression(a.get()));}
+
+            CallTarget target {ref->func, function_body(ref->func), intern_file(ref->file)};
+            return [this, target, args = std::move(args)]() -> Value
+            {
+                std::vector<Value> values;
+                values.reserve(args.size());
+                for(const auto& a : args) {values.push_back(a());}
+
+                _tail_target = target;
+                _tail_args = std::move(values);
+                _tail_pending = true;
+                _flow = Flow::RETURN;
+                return {};
+            };
+        }
+    }
+
+    Closure value = compile_expression(stmt.value.get());
+    return [this, value = std::move(value)]() -> Value
+    {
+        _return_value = value();
+        _flow = Flow::RETURN;
+        return {};
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_struct_call(FunctionCallExpr& expr)
+{
+    Closure callee = compile_expression(expr.callee.get());
+    std::vector<Closure> args;
+    for(auto& a : expr.arguments) {args.push_back(compile_expression(a.get()));}
+
+    const std::string* file = _file;
+    int line = expr.line;
+    return [this, callee = std::move(callee), args = std::move(args), file, line]() -> Value
+    {
+        Value callee_val = callee();
+        if(callee_val.type != ValueType::STRUCT) {_diag.error("Callee is not a function or struct template", *file, line); return {};}
+
+        std::vector<Value> values;
+        size_t n = std::min(struct_field_count(callee_val), args.size());
+        values.reserve(n);
+        for(size_t i = 0; i < n; ++i) {values.push_back(args[i]());}
+
+        return construct_struct(callee_val, values);
+    };
+}
+
+std::shared_ptr<ClosureCompiler::Closure> ClosureCompiler::function_body(const FunctionStatement* fn)
+{
+    auto& slot = _bodies[fn];
+    if(!slot) {slot = std::make_shared<Closure>();}
+    return slot;
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_statement(Statement* stmt)
+{
+    if(!stmt) {return constant(Value());}
+
+    const std::string* file = _file;
+    int line = stmt->line;
+
+    switch(stmt->type)
+    {
+        case StatementType::ASSIGNMENT:
+        {
+            auto& as = *static_cast<Assignment*>(stmt);
+            Closure value = compile_expression(as.value.get());
+            std::string name = as.name;
+
+            if(as.is_let) {return [this, value = std::move(value), name = std::move(name)]() -> Value {Value v = value(); _env.define(name, v); return v;};}
+            return [this, value = std::move(value), name = std::move(name), file, line]() -> Value {Value v = value(); _env.assign(name, v, *file, line); return v;};
+        }
+
+        case StatementType::ASSIGNMENT_STATEMENT: {return compile_statement(static_cast<AssignmentStatement*>(stmt)->assignment.get());}
+        case StatementType::EXPRESSION:           {return compile_expression(static_cast<ExpressionStatement*>(stmt)->expression.get());}
+
+        case StatementType::IF:
+        {
+            auto& st = *static_cast<IfStatement*>(stmt);
+            Condition cond = compile_condition(st.condition.get());
+            Closure then_branch = compile_statement(st.then_branch.get());
+            Closure else_branch = st.else_branch ? compile_statement(st.else_branch.get()) : Closure();
+
+            return [cond = std::move(cond), then_branch = std::move(then_branch), else_branch = std::move(else_branch)]() -> Value
+            {
+                if(cond()) {return then_branch();}
+                else if(else_branch)  {return else_branch();}
+                return {};
+            };
+        }
+
+        case StatementType::WHILE:            {return compile_while(*static_cast<WhileStatement*>(stmt));}
+        case StatementType::REPEAT:           {return compile_repeat(*static_cast<RepeatStatement*>(stmt));}
+        case StatementType::FOR:              {return compile_for(*static_cast<ForStatement*>(stmt));}
+        case StatementType::FOREACH:          {return compile_foreach(*static_cast<ForeachStatement*>(stmt));}
+        case StatementType::BLOCK:            {return compile_block(*static_cast<BlockStatement*>(stmt));}
+        case StatementType::INDEX_ASSIGNMENT: {return compile_index_assignment(*static_cast<IndexAssignment*>(stmt));}
+        case StatementType::SWITCH:           {return compile_switch(*static_cast<SwitchStatement*>(stmt));}
+
+        // функции уже проиндексированы, как и в Evaluator
+        case StatementType::FUNCTION: {return constant(Value());}
+
+        case StatementType::RETURN: {return compile_return(*static_cast<ReturnStatement*>(stmt));}
+
+        case StatementType::BREAK:    {return [this]() -> Value {_flow = Flow::BREAK; return {};};}
+        case StatementType::CONTINUE: {return [this]() -> Value {_flow = Flow::CONTINUE; return {};};}
+
+        default:
+        {
+            // enum и #macros исполняются один раз, собирать их нет смысла
+            return [this, stmt, file]() -> Value {return fallback(*file).eval_statement(stmt);};
+        }
+    }
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_block(BlockStatement& stmt)
+{
+    std::vector<Closure> statements;
+    statements.reserve(stmt.statements.size());
+    for(auto& st : stmt.statements) {statements.push_back(compile_statement(st.get()));}
+
+    return [this, statements = std::move(statements)]() -> Value
+    {
+        _env.push_scope();
+        Value result;
+        for(const auto& st : statements)
+        {
+            Value v = st();
+            if(_flow != Flow::NORMAL) {break;}
+            result = std::move(v);
+        }
+        _env.pop_scope();
+        return result;
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_while(WhileStatement& stmt)
+{
+    Condition cond = compile_condition(stmt.condition.get());
+    Closure body = compile_statement(stmt.body.get());
+
+    return [this, cond = std::move(cond), body = std::move(body)]() -> Value
+    {
+        Value result;
+        while(cond())
+        {
+            Value v = body();
+            if(_flow == Flow::NORMAL)   {result = std::move(v); continue;}
+            if(_flow == Flow::CONTINUE) {_flow = Flow::NORMAL; continue;}
+            if(_flow == Flow::BREAK)    {_flow = Flow::NORMAL;}
+            break;
+        }
+        return result;
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_repeat(RepeatStatement& stmt)
+{
+    Closure count = compile_expression(stmt.count.get());
+    Closure body = compile_statement(stmt.body.get());
+    const std::string* file = _file;
+    int line = stmt.line;
+
+    return [this, count = std::move(count), body = std::move(body), file, line]() -> Value
+    {
+        Value cnt = count();
+        int n = 0;
+        if(cnt.type == ValueType::INTEGER)     {n = std::get<int>(cnt.data);}
+        else if(cnt.type == ValueType::DOUBLE) {n = static_cast<int>(std::get<double>(cnt.data));}
+        else                                   {_diag.error("repeat() count must be numeric", *file, line); return {};}
+
+        Value result;
+        for(int i = 0; i < n; ++i)
+        {
+            Value v = body();
+            if(_flow == Flow::NORMAL)   {result = std::move(v); continue;}
+            if(_flow == Flow::CONTINUE) {_flow = Flow::NORMAL; continue;}
+            if(_flow == Flow::BREAK)    {_flow = Flow::NORMAL;}
+            break;
+        }
+        return result;
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_for(ForStatement& stmt)
+{
+    Closure init = stmt.initializer ? compile_statement(stmt.initializer.get()) : Closure();
+    Condition cond = stmt.condition ? compile_condition(stmt.condition.get()) : Condition();
+    Closure inc = stmt.increment ? compile_statement(stmt.increment.get()) : Closure();
+    Closure body = compile_statement(stmt.body.get());
+
+    const std::string* file = _file;
+    return [this, &stmt, init = std::move(init), cond = std::move(cond), inc = std::move(inc), body = std::move(body), file]() -> Value
+    {
+        Value result;
+        _env.push_scope();
+        if(init) {init();}
+        if(_vector_loops.run_for(stmt, _env, *file, result)) {_env.pop_scope(); return result;}
+
+        while(true)
+        {
+            if(cond && !cond()) {break;}
+
+            Value v = body();
+            if(_flow == Flow::BREAK)       {_flow = Flow::NORMAL; break;}
+            if(_flow == Flow::RETURN)      {break;}
+            if(_flow == Flow::CONTINUE)    {_flow = Flow::NORMAL;}
+            else                           {result = std::move(v);}
+
+            if(inc) {inc();}
+        }
+
+        _env.pop_scope();
+        return result;
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_foreach(ForeachStatement& stmt)
+{
+    Closure iterable = compile_expression(stmt.iterable.get());
+    Closure body = compile_statement(stmt.body.get());
+    std::string var_name = stmt.var_name;
+    const std::string* file = _file;
+    int line = stmt.line;
+
+    return [this, &stmt, iterable = std::move(iterable), body = std::move(body), var_name = std::move(var_name), file, line]() -> Value
+    {
+        Value it = iterable();
+        if(!is_iterable(it)) {_diag.error("foreach() expects an array, range or generator", *file, line); return {};}
+
+        Value result;
+        if(_vector_loops.run_foreach(stmt, it, _env, *file, result)) {return result;}
+
+        // false - цикл прерван
+        auto step = [&](const Value& elem)
+        {
+            _env.push_scope();
+            _env.define(var_name, elem);
+            Value v = body();
+            _env.pop_scope();
+
+            if(_flow == Flow::NORMAL)   {result = std::move(v); return true;}
+            if(_flow == Flow::CONTINUE) {_flow = Flow::NORMAL; return true;}
+            if(_flow == Flow::BREAK)    {_flow = Flow::NORMAL;}
+            return false;
+        };
+
+        if(it.type == ValueType::ARRAY)
+        {
+            for(const auto& elem : std::get<std::vector<Value>>(it.data))
+            {
+                if(!step(elem)) {break;}
+            }
+            return result;
+        }
+
+        if(it.type == ValueType::ARRAY_SLICE)
+        {
+            for(const auto& elem : *std::get<std::shared_ptr<ArraySlice>>(it.data))
+            {
+                if(!step(elem)) {break;}
+            }
+            return result;
+        }
+
+        ForeachCursor cursor(it);
+        Value elem;
+        while(cursor.next(elem))
+        {
+            if(!step(elem)) {break;}
+        }
+        return result;
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_index_assignment(IndexAssignment& stmt)
+{
+    std::vector<Closure> indices;
+    Expression* target_expr = stmt.target.get();
+
+    while(auto* idx = dynamic_cast<IndexExpr*>(target_expr))
+    {
+        indices.push_back(compile_expression(idx->index.get()));
+        target_expr = idx->array.get();
+    }
+
+    const std::string* file = _file;
+    int line = stmt.line;
+
+    auto* var = dynamic_cast<VariableExpr*>(target_expr);
+    if(!var) {return [this, file, line]() -> Value {_diag.error("Indexed assignment target must be variable", *file, line); return {};};}
+
+    Closure value = compile_expression(stmt.value.get());
+    std::string name = var->name;
+
+    return [this, indices = std::move(indices), value = std::move(value), name = std::move(name), file, line]() -> Value
+    {
+        std::vector<Value> keys;
+        keys.reserve(indices.size());
+        for(const auto& i : indices) {keys.push_back(i());}
+
+        Value new_val = value();
+        Value container = _env.take(name, *file, line);
+        std::reverse(keys.begin(), keys.end());
+
+        bool stored = assign_indexed(container, keys, new_val, _diag, *file, line);
+        if(container.type != ValueType::NONE) {_env.assign(name, std::move(container), *file, line);}
+        return stored ? new_val : Value();
+    };
+}
+
+ClosureCompiler::Closure ClosureCompiler::compile_switch(SwitchStatement& stmt)
+{
+    struct CompiledCase
+    {
+        Closure value;
+        std::string member;
+        std::vector<Closure> body;
+    };
+
+    Closure expression = compile_expression(stmt.expression.get());
+    std::vector<CompiledCase> cases;
+    bool constant = true;
+    for(auto& cs : stmt.cases)
+    {
+        CompiledCase cc;
+        if(cs.value)
+        {
+            cc.value = compile_expression(cs.value.get());
+            cc.member = SwitchTable::enum_member(cs.value.get());
+            constant = constant && SwitchTable::is_constant_case(cs.value.get());
+        }
+        for(auto& s : cs.body) {cc.body.push_back(compile_statement(s.get()));}
+        cases.push_back(std::move(cc));
+    }
+
+    // таблица константных case собирается при первом выполнении, когда enum уже определены
+    auto table = constant ? std::make_shared<SwitchTable>() : nullptr;
+    auto build = [this, table](const std::vector<CompiledCase>& cases)
+    {
+        SwitchTable built;
+        for(size_t i = 0; i < cases.size(); ++i)
+        {
+            if(!cases[i].value) {built.add_default(static_cast<int>(i)); continue;}
+            if(!cases[i].member.empty() && !_env.exists(cases[i].member)) {return;}
+            built.add_case(static_cast<int>(i), cases[i].value());
+        }
+        built.finish();
+        *table = std::move(built);
+    };
+
+    return [this, expression = std::move(expression), cases = std::move(cases), table, build = std::move(build)]() -> Value
+    {
+        Value val = expression();
+        bool matched = false;
+        Value result;
+
+        if(table && !table->ready()) {build(cases);}
+        bool dispatch = table && table->ready();
+        int hit = SwitchTable::NO_CASE;
+        size_t start = 0;
+        if(dispatch)
+        {
+            hit = table->match(val);
+            int entry = table->entry(hit);
+            if(entry == SwitchTable::NO_CASE) {return result;}
+            start = static_cast<size_t>(entry);
+        }
+
+        for(size_t i = start; i < cases.size(); ++i)
+        {
+            const auto& cs = cases[i];
+            bool is_default = !cs.value;
+            bool condition = false;
+
+            if(!is_default && dispatch) {condition = static_cast<int>(i) == hit;}
+            else if(!is_default)
+            {
+                Value case_val = cs.value();
+                condition = (val.to_string() == case_val.to_string());
+            }
+
+            if(condition || is_default)
+            {
+                matched = true;
+                bool leave = false;
+                for(const auto& s : cs.body)
+                {
+                    Value v = s();
+                    if(_flow == Flow::BREAK)  {_flow = Flow::NORMAL; leave = true; break;}
+                    if(_flow != Flow::NORMAL) {leave = true; break;}
+                    result = std::move(v);
+                }
+                if(leave) {break;}
+            }
+
+            if(matched && !is_default) {break;}
+        }
+
+        return result;
+    };
+}
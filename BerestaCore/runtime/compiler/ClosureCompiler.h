@@ -0,0 +1,98 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_CLOSURECOMPILER_H
+#define BERESTALANGUAGE_CLOSURECOMPILER_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "frontend/parser/Statement.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "frontend/diagnostics/BaseContext.h"
+#include "runtime/value/Value.h"
+#include "runtime/environment/Environment.h"
+#include "runtime/evaluator/Evaluator.h"
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+class FunctionIndex;
+
+// собирает AST в дерево замыканий один раз: оператор, builtin и функция выбираются при сборке, а не на каждом узле через accept
+class BERESTA_API ClosureCompiler : public BaseContext
+{
+    public:
+        using Closure = std::function<Value()>;
+        using Condition = std::function<bool()>;
+
+        ClosureCompiler(Environment& env, FunctionIndex& index, std::string current_file, Diagnostics& diag);
+
+        Value run_statement(Statement* stmt);
+
+        Closure compile_expression(Expression* expr);
+        Closure compile_statement(Statement* stmt);
+
+    private:
+        enum class Flow
+        {
+            NORMAL,
+            BREAK,
+            CONTINUE,
+            RETURN
+        };
+
+        // функция с уже выделенным слотом под собранное тело
+        struct CallTarget
+        {
+            FunctionStatement* fn = nullptr;
+            std::shared_ptr<Closure> body;
+            const std::string* file = nullptr;
+        };
+
+        Environment& _env;
+        FunctionIndex& _index;
+        Flow _flow = Flow::NORMAL;
+        Value _return_value;
+
+        // return g(...) в хвостовой позиции: вместо вызова кладёт сюда g и аргументы, invoke выполнит их на месте кадра
+        bool _tail_pending = false;
+        CallTarget _tail_target;
+        std::vector<Value> _tail_args;
+        const FunctionStatement* _compiling_function = nullptr;
+        TailCallAnalysis _tail_calls;
+
+        const std::string* _file = nullptr;
+        std::set<std::string> _files;
+        std::unordered_map<std::string, std::unique_ptr<Evaluator>> _fallbacks;
+        std::unordered_map<const FunctionStatement*, std::shared_ptr<Closure>> _bodies;
+        VectorLoops _vector_loops;
+
+        const std::string* intern_file(const std::string& file);
+        Evaluator& fallback(const std::string& file);
+
+        Closure compile_call(FunctionCallExpr& expr);
+        Closure compile_user_call(FunctionCallExpr& expr, FunctionStatement* fn, const std::string& fn_file);
+        Closure compile_return(ReturnStatement& stmt);
+        Value invoke(CallTarget target, std::vector<Value> values);
+        Closure compile_struct_call(FunctionCallExpr& expr);
+        Closure compile_binary(BinaryExpr& expr);
+        Closure compile_operator(BinaryExpr& expr);
+        Condition compile_condition(Expression* expr);
+
+        Closure compile_block(BlockStatement& stmt);
+        Closure compile_while(WhileStatement& stmt);
+        Closure compile_repeat(RepeatStatement& stmt);
+        Closure compile_for(ForStatement& stmt);
+        Closure compile_foreach(ForeachStatement& stmt);
+        Closure compile_index_assignment(IndexAssignment& stmt);
+        Closure compile_switch(SwitchStatement& stmt);
+
+        std::shared_ptr<Closure> function_body(const FunctionStatement* fn);
+};
+
+
+#endif //BERESTALANGUAGE_CLOSURECOMPILER_H
@@ -3,6 +3,7 @@
 //
 
 #include "Environment.h"
+#include <utility>
 
 Environment::Environment(Diagnostics* diag, Environment* parent) : _diag(diag), _parent(parent), _scopes(1) {}
 
@@ -17,15 +18,15 @@ void Environment::define_global(const std::string& name, const Value& val)
     _scopes.front()[name] = val;
 }
 
-bool Environment::assign(const std::string& name, const Value& v, const std::string& file, int line)
+bool Environment::assign(const std::string& name, Value v, const std::string& file, int line)
 {
     for(int i = static_cast<int>(_scopes.size()) - 1; i >= 0; --i)
     {
         auto it = _scopes[i].find(name);
-        if(it != _scopes[i].end()) {it->second = v; return true;}
+        if(it != _scopes[i].end()) {it->second = std::move(v); return true;}
     }
-    if(_parent) {return _parent->assign(name, v, file, line);}
-    _scopes.front()[name] = v;
+    if(_parent) {return _parent->assign(name, std::move(v), file, line);}
+    _scopes.front()[name] = std::move(v);
     return true;
 }
 
@@ -41,6 +42,18 @@ bool Environment::assign(const std::string& name, const Value& v, const std::str
     return {};
 }
 
+Value Environment::take(const std::string& name, const std::string& file, int line)
+{
+    for(int i = static_cast<int>(_scopes.size()) - 1; i >= 0; --i)
+    {
+        auto it = _scopes[i].find(name);
+        if(it != _scopes[i].end()) {return std::exchange(it->second, Value());}
+    }
+    if(_parent) {return _parent->take(name, file, line);}
+    if(_diag) {_diag->error("Variable not found: " + name, file, line);}
+    return {};
+}
+
 [[nodiscard]] bool Environment::exists(const std::string& name) const
 {
     for(int i = static_cast<int>(_scopes.size()) - 1; i >= 0; --i)
@@ -48,4 +61,20 @@ bool Environment::assign(const std::string& name, const Value& v, const std::str
         if(_scopes[i].count(name)) {return true;}
     }
     return _parent ? _parent->exists(name) : false;
-}
\ No newline at end of file
+}
+
+Environment::Scopes Environment::take_scopes(size_t from)
+{
+    Scopes taken;
+    if(from >= _scopes.size()) {return taken;}
+
+    taken.assign(std::make_move_iterator(_scopes.begin() + static_cast<std::ptrdiff_t>(from)), std::make_move_iterator(_scopes.end()));
+    _scopes.resize(from);
+    return taken;
+}
+
+void Environment::restore_scopes(Scopes&& scopes)
+{
+    for(auto& scope : scopes) {_scopes.push_back(std::move(scope));}
+    scopes.clear();
+}
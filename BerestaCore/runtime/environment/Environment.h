@@ -23,10 +23,19 @@ class BERESTA_API Environment
         void define(const std::string& name, const Value& val);
         void define_global(const std::string& name, const Value& val);
 
-        bool assign(const std::string& name, const Value& v, const std::string& file = "", int line = -1);
+        bool assign(const std::string& name, Value v, const std::string& file = "", int line = -1);
         [[nodiscard]] Value get(const std::string& name, const std::string& file = "", int line = -1) const;
+        // значение забирается из слота без копии (в слоте остаётся none) и возвращается через assign:
+        // так запись по индексу меняет массив, которым больше никто не владеет, на месте
+        [[nodiscard]] Value take(const std::string& name, const std::string& file = "", int line = -1);
         [[nodiscard]] bool exists(const std::string& name) const;
 
+        // приостановленный генератор уносит свои скоупы с вершины стека и возвращает их при следующем шаге
+        using Scopes = std::vector<std::unordered_map<std::string, Value>>;
+        [[nodiscard]] size_t depth() const {return _scopes.size();}
+        Scopes take_scopes(size_t from);
+        void restore_scopes(Scopes&& scopes);
+
         void set_output_streams(std::ostream* out, std::ostream* err)
         {
             _out = out ? out : &std::cout;
@@ -37,7 +46,7 @@ class BERESTA_API Environment
         std::ostream& err() {return *_err;}
 
     private:
-        std::vector<std::unordered_map<std::string, Value>> _scopes;
+        Scopes _scopes;
         Environment* _parent;
         Diagnostics* _diag;
         std::ostream* _out = &std::cout;
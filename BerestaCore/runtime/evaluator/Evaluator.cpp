@@ -3,20 +3,37 @@
 //
 
 #include "Evaluator.h"
+#include "Operators.h"
+#include "FusedArrayExpr.h"
+#include "runtime/jit/NumericJit.h"
+#include "runtime/evaluator/Memoization.h"
+#include "runtime/evaluator/Generator.h"
 #include "frontend/parser/Expression.h"
 #include "frontend/parser/Statement.h"
 #include "interpreter/FunctionIndex.h"
 #include "runtime/builtin/core/BuiltinRegistry.h"
 #include "runtime/value/StructValue.h"
+#include "runtime/value/StructArray.h"
+#include "runtime/value/FlatDictionary.h"
+#include "runtime/value/ArraySlice.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <unordered_map>
-#include <cmath>
 
-struct ReturnException {Value value; explicit ReturnException(Value val) : value(std::move(val)) {}};
+struct ReturnException
+{
+    Value value;
+    bool tail = false;              // return g(...) в хвостовой позиции: вызов выполнит call_function вместо текущего кадра
+    FunctionRef target;
+    std::vector<Value> args;
+
+    explicit ReturnException(Value val) : value(std::move(val)) {}
+    ReturnException(FunctionRef fn, std::vector<Value> call_args) : tail(true), target(std::move(fn)), args(std::move(call_args)) {}
+};
 
 Evaluator::Evaluator(Environment &env, FunctionIndex &index, std::string current_file, Diagnostics& diagnostics)
-    : BaseContext(diagnostics, std::move(current_file)), _env(env), _index(index)
+    : BaseContext(diagnostics, std::move(current_file)), _env(env), _index(index), _tail_calls(index), _loops(index), _vector_loops(index)
     {
         _file_stack.push_back(_current_file);
     }
@@ -33,27 +50,6 @@ Value Evaluator::eval_statement(Statement* stmt)
     return stmt->accept(*this);
 }
 
-bool Evaluator::is_truthy(const Value& val)
-{
-    switch(val.type)
-    {
-        case ValueType::BOOLEAN:    {return std::get<bool>(val.data);}
-        case ValueType::INTEGER:    {return std::get<int>(val.data) != 0;}
-        case ValueType::DOUBLE:     {return std::get<double>(val.data) != 0.0;}
-        case ValueType::STRING:     {return !std::get<std::string>(val.data).empty();}
-        case ValueType::ARRAY:      {return !std::get<std::vector<Value>>(val.data).empty();}
-        case ValueType::DICTIONARY: {return !std::get<DictionaryPtr>(val.data)->empty();}
-        case ValueType::NONE:       {return false;}
-    }
-
-    return false;
-}
-
-void Evaluator::type_error(int line, const char* msg)
-{
-    _diag.error(msg, current_file(), line);
-}
-
 struct BreakSignal {};
 struct ContinueSignal {};
 
@@ -68,95 +64,39 @@ Value Evaluator::visit_variable(VariableExpr& expr) {return _env.get(expr.name,
 Value Evaluator::visit_unary(UnaryExpr& expr)
 {
     Value r = eval_expression(expr.right.get());
-    switch(expr.op)
-    {
-        case '+':
-        {
-            if(r.type == ValueType::INTEGER) {return Value(std::get<int>(r.data));}
-            if(r.type == ValueType::DOUBLE) {return Value(std::get<double>(r.data));}
-            break;
-        }
-
-        case '-':
-        {
-            if(r.type == ValueType::INTEGER) {return Value(-std::get<int>(r.data));}
-            if(r.type == ValueType::DOUBLE) {return Value(-std::get<double>(r.data));}
-            break;
-        }
-
-        case '!':
-        {
-            bool b = is_truthy(r);
-            return Value(!b);
-        }
-    }
-
-    type_error(expr.line, "Unsupported unary operand type");
-    return {};
+    return apply_unary(expr.op, r, _diag, current_file(), expr.line);
 }
 
 Value Evaluator::visit_binary(BinaryExpr& expr)
 {
-    Value lv = eval_expression(expr.left.get());
-    Value rv = eval_expression(expr.right.get());
-    const std::string& op = expr.op;
-
-    auto both_nums = (lv.type == ValueType::INTEGER || lv.type == ValueType::DOUBLE) && (rv.type == ValueType::INTEGER || rv.type == ValueType::DOUBLE);
-    auto as_double = [](const Value& v)->double {return v.type == ValueType::DOUBLE ? std::get<double>(v.data) : static_cast<double>(std::get<int>(v.data));};
-
-    if(both_nums)
+    // цепочка операторов: листья считаются по разу, и уже по ним видно, идут ли операторы одним проходом
+    // по элементам массивов или сворачиваются по очереди над числами
+    if(expr.fused || FusedArrayExpr::is_chain(expr))
     {
-        auto is_int = [](const Value& v){return v.type == ValueType::INTEGER;};
-        auto is_dbl = [](const Value& v){return v.type == ValueType::DOUBLE;};
-
-        if(op == "%")
-        {
-            if((is_int(lv) || is_dbl(lv)) && (is_int(rv) || is_dbl(rv)))
-            {
-                double r = (rv.type == ValueType::DOUBLE) ? std::get<double>(rv.data) : static_cast<double>(std::get<int>(rv.data));
-                if(r == 0.0) {_diag.error("Modulo by zero", current_file(), expr.line); return {};}
-
-                if(is_int(lv) && is_int(rv))
-                {
-                    int l = std::get<int>(lv.data);
-                    int rr = std::get<int>(rv.data);
-                    return Value(l % rr);
-                }
-                else
-                {
-                    double l = (lv.type == ValueType::DOUBLE) ? std::get<double>(lv.data) : static_cast<double>(std::get<int>(lv.data));
-                    return Value(std::fmod(l, r));
-                }
-            }
-        }
+        if(!expr.fused) {expr.fused = std::make_shared<FusedArrayExpr>(expr);}
+        const auto& leaves = expr.fused->leaves();
+        return expr.fused->run([&](size_t i) {return eval_expression(leaves[i]);}, _diag, current_file(), expr.line);
+    }
 
-        double l = as_double(lv), r = as_double(rv);
-        if(op == "+") {return Value(l + r);}
-        if(op == "-") {return Value(l - r);}
-        if(op == "*") {return Value(l * r);}
-        if(op == "/") {return Value(r != 0.0 ? l / r : 0.0);}
+    Value lv = eval_expression(expr.left.get());
+    if(short_circuits(expr.opcode, lv)) {return lv;}
 
-        if(op == "==") {return Value(l == r);}
-        if(op == "!=") {return Value(l != r);}
-        if(op == "<")  {return Value(l < r);}
-        if(op == "<=") {return Value(l <= r);}
-        if(op == ">")  {return Value(l > r);}
-        if(op == ">=") {return Value(l >= r);}
-    }
+    Value rv = eval_expression(expr.right.get());
+    return apply_binary(expr.opcode, lv, rv, _diag, current_file(), expr.line);
+}
 
-    if(lv.type == ValueType::BOOLEAN && rv.type == ValueType::BOOLEAN)
-    {
-        bool l = std::get<bool>(lv.data), r = std::get<bool>(rv.data);
-        if(op == "==") {return Value(l == r);}
-        if(op == "!=") {return Value(l != r);}
-        if(op == "and" || op == "&&") {return Value(l && r);}
-        if(op == "or"  || op == "||") {return Value(l || r);}
-    }
+bool Evaluator::eval_condition(Expression* expr)
+{
+    // сравнения чисел в if/while/for не собирают промежуточный bool-Value
+    if(!is_fused_condition(expr)) {return condition_truthy(eval_expression(expr), _diag, current_file(), expr->line);}
 
-    if(op == "+" && (lv.type == ValueType::STRING || rv.type == ValueType::STRING)) {return Value(lv.to_string() + rv.to_string());}
+    auto& bin = static_cast<BinaryExpr&>(*expr);
+    if(bin.opcode == BinaryOp::AND) {return eval_condition(bin.left.get()) && eval_condition(bin.right.get());}
+    if(bin.opcode == BinaryOp::OR)  {return eval_condition(bin.left.get()) || eval_condition(bin.right.get());}
 
-    type_error(expr.line, "Unsupported operand types for binary operator");
-    return {};
+    Value lv = eval_expression(bin.left.get());
+    Value rv = eval_expression(bin.right.get());
+    return apply_condition(bin.opcode, lv, rv, _diag, current_file(), bin.line);
 }
 
 Value Evaluator::visit_call(FunctionCallExpr& expr)
@@ -173,6 +113,7 @@ Value Evaluator::visit_call(FunctionCallExpr& expr)
                 args.push_back(eval_expression(a.get()));
             }
 
+            ActiveEvaluator active(impl->calls_back() ? this : get_active_evaluator());
             try                             {return impl->invoke(args, _diag, current_file(), expr.line);}
             catch(const std::exception& ex) {_diag.error(std::string("Builtin error: ") + ex.what(), current_file(), expr.line); return {};}
             catch(...)                      {_diag.error("Builtin error: exception", current_file(), expr.line); return {};}
@@ -186,59 +127,112 @@ Value Evaluator::visit_call(FunctionCallExpr& expr)
                 args.push_back(eval_expression(a.get()));
             }
 
-            FunctionStatement* fn = ref->func;
-            if(args.size() != fn->parameters.size()) {std::cerr << "[ERROR] Function " << fn_name << " expects " << fn->parameters.size() << " args, got " << args.size() << "\n"; return {};}
+            return call_function(*ref, args);
+        }
+    }
 
-            bool pushed_file = false;
-            if(ref->is_public && ref->file != current_file())
-            {
-                set_current_file(ref->file);
-                _file_stack.push_back(ref->file);
-                pushed_file = true;
-            }
+    Value callee_val = eval_expression(expr.callee.get());
+    if(callee_val.type == ValueType::STRUCT)
+    {
+        std::vector<Value> args;
+        size_t n = std::min(struct_field_count(callee_val), expr.arguments.size());
+        args.reserve(n);
+        for(size_t i = 0; i < n; ++i)
+        {
+            args.push_back(eval_expression(expr.arguments[i].get()));
+        }
 
-            _env.push_scope();
-            for(size_t i = 0; i < args.size(); ++i)
-            {
-                _env.define(fn->parameters[i], args[i]);
-            }
+        return construct_struct(callee_val, args);
+    }
 
-            Value result;
-            try                              {result = eval_statement(fn->body.get());}
-            catch(const ReturnException& re) {result = re.value;}
+    _diag.error("Callee is not a function or struct template", current_file(), expr.line);
+    return {};
+}
 
-            _env.pop_scope();
-            if(pushed_file)
+void Evaluator::leave_frame(bool pushed_file)
+{
+    _env.pop_scope();
+    if(pushed_file)
+    {
+        _file_stack.pop_back();
+        if(!_file_stack.empty()) {set_current_file(_file_stack.back());}
+    }
+}
+
+const FunctionRef* Evaluator::find_function(const std::string& name) {return _index.find_function(name, current_file());}
+
+Value Evaluator::call_function(const FunctionRef& ref, const std::vector<Value>& args)
+{
+    // хвостовые вызовы (return g(...)) приходят сюда же через ReturnException и выполняются циклом на месте кадра
+    FunctionRef target = ref;
+    std::vector<Value> call_args = args;
+    const FunctionStatement* saved_function = _current_function;
+
+    // pure-функции, чей результат ещё предстоит узнать: цепочка хвостовых вызовов возвращает одно значение на всех
+    std::vector<std::pair<MemoCache*, std::vector<Value>>> memo_pending;
+    auto finish = [&](const Value& result)
+    {
+        for(auto& [cache, key] : memo_pending) {cache->insert(key, result);}
+        _current_function = saved_function;
+        return result;
+    };
+
+    while(true)
+    {
+        FunctionStatement* fn = target.func;
+        if(call_args.size() != fn->parameters.size()) {std::cerr << "[ERROR] Function " << fn->name << " expects " << fn->parameters.size() << " args, got " << call_args.size() << "\n"; break;}
+
+        // тело генератора не выполняется при вызове, его шаги запрашивает foreach
+        if(fn->is_generator) {return finish(Value(std::make_shared<GeneratorObject>(_env, _index, target, std::move(call_args), _diag)));}
+
+        if(MemoCache* memo = Memoization::instance().cache_for(*fn, _index, target.file, _diag))
+        {
+            if(std::all_of(call_args.begin(), call_args.end(), is_hashable))
             {
-                _file_stack.pop_back();
-                if(!_file_stack.empty()) {set_current_file(_file_stack.back());}
+                if(const Value* hit = memo->find(call_args)) {return finish(*hit);}
+                memo_pending.emplace_back(memo, call_args);
             }
-
-            return result;
         }
-    }
 
-    Value callee_val = eval_expression(expr.callee.get());
-    if(callee_val.type == ValueType::STRUCT)
-    {
-        auto tmpl = std::get<std::shared_ptr<StructInstance>>(callee_val.data);
+        Value jitted;
+        if(NumericJit::instance().enabled() && NumericJit::instance().try_call(*fn, call_args, jitted)) {return finish(jitted);}
+
+        bool pushed_file = false;
+        if(target.is_public && target.file != current_file())
+        {
+            set_current_file(target.file);
+            _file_stack.push_back(target.file);
+            pushed_file = true;
+        }
 
-        auto inst = std::make_shared<StructInstance>();
-        inst->definition = tmpl->definition;
-        inst->fields     = tmpl->fields;
+        _env.push_scope();
+        for(size_t i = 0; i < call_args.size(); ++i)
+        {
+            _env.define(fn->parameters[i], call_args[i]);
+        }
 
-        const auto& order = inst->definition->field_names;
-        size_t n = std::min(order.size(), expr.arguments.size());
-        for(size_t i = 0; i < n; ++i)
+        _current_function = fn;
+        Value result;
+        bool tail = false;
+        try {result = eval_statement(fn->body.get());}
+        catch(ReturnException& re)
+        {
+            if(re.tail) {tail = true; target = re.target; call_args = std::move(re.args);}
+            else        {result = std::move(re.value);}
+        }
+        catch(...)
         {
-            Value v = eval_expression(expr.arguments[i].get());
-            inst->fields[order[i]] = v;
+            leave_frame(pushed_file);
+            _current_function = saved_function;
+            throw;
         }
 
-        return Value(*inst);
+        leave_frame(pushed_file);
+
+        if(!tail) {return finish(result);}
     }
 
-    _diag.error("Callee is not a function or struct template", current_file(), expr.line);
+    _current_function = saved_function;
     return {};
 }
 
@@ -253,89 +247,90 @@ Value Evaluator::visit_array(ArrayLiteralExpr& expr)
 
     return Value(elems);
 }
-/*
 Value Evaluator::visit_dictionary(DictionaryLiteralExpr& expr)
 {
-    Dictionary dict;
+    auto dict = std::make_shared<Dictionary>();
     for(auto& kv : expr.entries)
     {
         Value k = eval_expression(kv.first.get());
         Value v = eval_expression(kv.second.get());
         if(k.type != ValueType::STRING) {_diag.error("Dictionary key must be string literal", current_file(), expr.line); return {};}
-        dict[std::get<std::string>(k.data)] = v;
+        (*dict)[std::get<std::string>(k.data)] = std::move(v);
     }
 
-    return Value(dict);
-}
-*/
-
-Value Evaluator::visit_dictionary(DictionaryLiteralExpr& expr)
-{
-    _diag.error("Dictionary literals are disabled in this build", current_file(), expr.line);
-    return {};
+    return Value(std::move(dict));
 }
 
 Value Evaluator::visit_struct(StructLiteralExpr& expr)
 {
-    auto def = std::make_shared<StructDefinition>();
-    auto inst = std::make_shared<StructInstance>();
-
-    def->field_names.reserve(expr.fields.size());
-    for(auto& kv : expr.fields)
+    if(!expr.definition)
     {
-        const std::string& name = kv.first;
-        def->field_names.push_back(name);
-    }
-
-    inst->definition = def;
+        std::vector<std::string> names;
+        names.reserve(expr.fields.size());
+        for(auto& kv : expr.fields)
+        {
+            names.push_back(kv.first);
+        }
 
-    for(const auto& name : def->field_names)
-    {
-        inst->fields[name] = Value();
+        expr.definition = std::make_shared<StructDefinition>();
+        expr.definition->shape = StructShape::intern(names);
     }
 
-    return Value(*inst);
+    auto inst = std::make_shared<StructInstance>();
+    inst->definition = expr.definition;
+    inst->fields.resize(expr.definition->shape->field_names.size());
+    return Value(std::move(inst));
 }
 
 Value Evaluator::visit_index(IndexExpr& expr)
 {
     Value container = eval_expression(expr.array.get());
     Value idx = eval_expression(expr.index.get());
+    return index_value(container, idx, _diag, current_file(), expr.line);
+}
 
-    if(container.type == ValueType::ARRAY)
-    {
-        int i = 0;
-        if(idx.type == ValueType::INTEGER)     {i = std::get<int>(idx.data);}
-        else if(idx.type == ValueType::DOUBLE) {i = static_cast<int>(std::get<double>(idx.data));}
-        else                                   {_diag.error("Array index must be numeric", current_file(), expr.line); return {};}
-
-        auto& arr = std::get<std::vector<Value>>(container.data);
-        if(i < 0 || i >= static_cast<int>(arr.size())) {_diag.error("Array index out of bounds", current_file(), expr.line); return {};}
-        return arr[i];
-    }
-    /*
-    if(container.type == ValueType::DICTIONARY)
+// форма и слот последнего доступа: пока форма та же, имя поля не ищется
+static int member_slot(MemberAccessExpr& expr, const StructShape* shape)
+{
+    if(shape != expr.cached_shape)
     {
-        std::string key = (idx.type == ValueType::STRING) ? std::get<std::string>(idx.data) : idx.to_string();
-        const auto& dict = *std::get<DictionaryPtr>(container.data);
-        auto it = dict.find(key);
-        if(it == dict.end()) {_diag.error("Key not found in dictionary: " + key, current_file(), expr.line); return {};}
-        return it->second;
+        expr.cached_shape = shape;
+        expr.cached_slot = shape->slot(expr.member);
     }
-    */
-    _diag.error("Indexing not supported for this type", current_file(), expr.line);
-    return {};
+    return expr.cached_slot;
 }
 
 Value Evaluator::visit_member(MemberAccessExpr& expr)
 {
-    Value obj_val = eval_expression(expr.object.get());
+    Value obj_val;
+    if(expr.object->type == ExpressionType::INDEX)
+    {
+        // arr[i].x у массива структур читает один столбец, элемент целиком не собирается
+        auto& idx = static_cast<IndexExpr&>(*expr.object);
+        Value container = eval_expression(idx.array.get());
+        Value index = eval_expression(idx.index.get());
+
+        if(container.type == ValueType::STRUCT_ARRAY && is_number(index))
+        {
+            const auto& arr = *std::get<std::shared_ptr<StructArray>>(container.data);
+            auto i = static_cast<long long>(as_number(index));
+            if(i < 0 || i >= static_cast<long long>(arr.size())) {_diag.error("Array index out of bounds", current_file(), idx.line); return {};}
+
+            int slot = member_slot(expr, arr.shape());
+            if(slot < 0) {_diag.error("Unknown struct field: " + expr.member, current_file(), expr.line); return {};}
+            return arr.field(static_cast<size_t>(i), slot);
+        }
+
+        obj_val = index_value(container, index, _diag, current_file(), idx.line);
+    }
+    else {obj_val = eval_expression(expr.object.get());}
+
     if(obj_val.type == ValueType::STRUCT)
     {
-        auto inst = std::get<std::shared_ptr<StructInstance>>(obj_val.data);
-        auto it = inst->fields.find(expr.member);
-        if(it == inst->fields.end()) {_diag.error("Unknown struct field: " + expr.member, current_file(), expr.line); return {};}
-        return it->second;
+        const auto& inst = std::get<std::shared_ptr<StructInstance>>(obj_val.data);
+        int slot = member_slot(expr, inst->definition->shape);
+        if(slot < 0) {_diag.error("Unknown struct field: " + expr.member, current_file(), expr.line); return {};}
+        return inst->fields[slot];
     }
 
     std::string base_name;
@@ -368,7 +363,7 @@ Value Evaluator::visit_expr_stmt(ExpressionStatement& stmt)
 
 Value Evaluator::visit_if(IfStatement& stmt)
 {
-    if(is_truthy(eval_expression(stmt.condition.get()))) {return eval_statement(stmt.then_branch.get());}
+    if(eval_condition(stmt.condition.get())) {return eval_statement(stmt.then_branch.get());}
     else if(stmt.else_branch) {return eval_statement(stmt.else_branch.get());}
     return {};
 }
@@ -376,7 +371,7 @@ Value Evaluator::visit_if(IfStatement& stmt)
 Value Evaluator::visit_while(WhileStatement& stmt)
 {
     Value result;
-    while(is_truthy(eval_expression(stmt.condition.get())))
+    while(eval_condition(stmt.condition.get()))
     {
         try                          {result = eval_statement(stmt.body.get());}
         catch(const ContinueSignal&) {continue;}
@@ -403,16 +398,90 @@ Value Evaluator::visit_repeat(RepeatStatement& stmt)
     return result;
 }
 
+static bool whole_number(const Value& v, long long& out)
+{
+    if(v.type == ValueType::INTEGER) {out = std::get<int>(v.data); return true;}
+    if(v.type != ValueType::DOUBLE) {return false;}
+
+    double d = std::get<double>(v.data);
+    if(std::trunc(d) != d || std::fabs(d) >= 1e15) {return false;}
+    out = static_cast<long long>(d);
+    return true;
+}
+
+bool Evaluator::run_counting_loop(ForStatement& stmt, const CountingLoop& loop, Value& result)
+{
+    // false - дальше цикл ведёт общий путь: счётчик уже лежит в окружении, следующая проверка условия за ним
+    if(!_env.exists(loop.var)) {return false;}
+
+    long long i = 0;
+    if(!whole_number(_env.get(loop.var), i)) {return false;}
+
+    double limit = 0.0;
+    auto fetch_limit = [&]()
+    {
+        Value b = eval_expression(loop.bound);
+        if(!is_number(b)) {return false;}
+        limit = as_number(b);
+        return true;
+    };
+    if(loop.bound_invariant && !fetch_limit()) {return false;}
+
+    // арифметика языка идёт в double, поэтому после первого шага счётчик в окружении тоже double
+    bool dirty = false;
+    auto write_back = [&]()
+    {
+        if(dirty) {_env.assign(loop.var, Value(static_cast<double>(i)), current_file(), stmt.line);}
+        dirty = false;
+    };
+
+    try
+    {
+        while(true)
+        {
+            if(!loop.bound_invariant && !fetch_limit()) {write_back(); return false;}
+            if(!compare_numbers(loop.cmp, static_cast<double>(i), limit)) {break;}
+            if(loop.body_reads) {write_back();}
+
+            bool did_break = false;
+            try                          {result = eval_statement(stmt.body.get());}
+            catch(const ContinueSignal&) {}
+            catch(const BreakSignal&)    {did_break = true;}
+
+            if(did_break) {break;}
+
+            if(loop.body_writes && !whole_number(_env.get(loop.var), i))
+            {
+                eval_statement(stmt.increment.get());
+                return false;
+            }
+
+            i += loop.step;
+            dirty = true;
+        }
+    }
+    catch(...) {write_back(); throw;}
+
+    write_back();
+    return true;
+}
+
 Value Evaluator::visit_for(ForStatement& stmt)
 {
     Value result;
     _env.push_scope();
     if(stmt.initializer) {eval_statement(stmt.initializer.get());}
 
+    const CountingLoop& loop = _loops.counting_loop(stmt, current_file());
+    bool finished = false;
+    try {finished = _vector_loops.run_for(stmt, _env, current_file(), result) || (loop.valid && run_counting_loop(stmt, loop, result));}
+    catch(...) {_env.pop_scope(); throw;}
+    if(finished) {_env.pop_scope(); return result;}
+
     while(true)
     {
         bool truthy = true;
-        if(stmt.condition) {truthy = is_truthy(eval_expression(stmt.condition.get()));}
+        if(stmt.condition) {truthy = eval_condition(stmt.condition.get());}
         if(!truthy) {break;}
 
         bool did_continue = false;
@@ -421,6 +490,7 @@ Value Evaluator::visit_for(ForStatement& stmt)
         try                          {result = eval_statement(stmt.body.get());}
         catch(const ContinueSignal&) {did_continue = true;}
         catch(const BreakSignal&)    {did_break = true;}
+        catch(...)                   {_env.pop_scope(); throw;}
 
         if(did_break) {break;}
 
@@ -436,19 +506,51 @@ Value Evaluator::visit_for(ForStatement& stmt)
 Value Evaluator::visit_foreach(ForeachStatement& stmt)
 {
     Value it = eval_expression(stmt.iterable.get());
-    if(it.type != ValueType::ARRAY) {_diag.error("foreach() expects an array", current_file(), stmt.line); return {};}
-    const auto& arr = std::get<std::vector<Value>>(it.data);
+    if(!is_iterable(it)) {_diag.error("foreach() expects an array, range or generator", current_file(), stmt.line); return {};}
+
     Value result;
-    for(const auto& elem : arr)
+    if(_vector_loops.run_foreach(stmt, it, _env, current_file(), result)) {return result;}
+
+    // false - цикл прерван через break
+    auto step = [&](const Value& elem)
     {
         _env.push_scope();
         _env.define(stmt.var_name, elem);
 
         try                          {result = eval_statement(stmt.body.get());}
-        catch(const ContinueSignal&) {_env.pop_scope(); continue;}
-        catch(const BreakSignal&)    {_env.pop_scope(); break;}
+        catch(const ContinueSignal&) {_env.pop_scope(); return true;}
+        catch(const BreakSignal&)    {_env.pop_scope(); return false;}
+        catch(...)                   {_env.pop_scope(); throw;}
 
         _env.pop_scope();
+        return true;
+    };
+
+    if(it.type == ValueType::ARRAY)
+    {
+        for(const auto& elem : std::get<std::vector<Value>>(it.data))
+        {
+            if(!step(elem)) {break;}
+        }
+        return result;
+    }
+
+    // срез идёт по общему хранилищу на месте
+    if(it.type == ValueType::ARRAY_SLICE)
+    {
+        for(const auto& elem : *std::get<std::shared_ptr<ArraySlice>>(it.data))
+        {
+            if(!step(elem)) {break;}
+        }
+        return result;
+    }
+
+    // диапазон, генератор и массив структур отдают элементы по одному, массив под них не строится
+    ForeachCursor cursor(it);
+    Value elem;
+    while(cursor.next(elem))
+    {
+        if(!step(elem)) {break;}
     }
     return result;
 }
@@ -457,10 +559,15 @@ Value Evaluator::visit_block(BlockStatement& stmt)
 {
     _env.push_scope();
     Value result;
-    for(const auto& st : stmt.statements)
+    // return/break/continue летят исключением, скоуп блока нужно снять и в этом случае
+    try
     {
-        result = eval_statement(st.get());
+        for(const auto& st : stmt.statements)
+        {
+            result = eval_statement(st.get());
+        }
     }
+    catch(...) {_env.pop_scope(); throw;}
     _env.pop_scope();
     return result;
 }
@@ -470,10 +577,34 @@ Value Evaluator::visit_function(FunctionStatement& stmt) {return {};}
 
 Value Evaluator::visit_return(ReturnStatement& stmt)
 {
+    if(_current_function && stmt.value && stmt.value->type == ExpressionType::FUNCTION_CALL)
+    {
+        auto& call = static_cast<FunctionCallExpr&>(*stmt.value);
+        auto* var = dynamic_cast<VariableExpr*>(call.callee.get());
+        const FunctionRef* ref = (var && !BuiltinRegistry::instance().get(var->name)) ? _index.find_function(var->name, current_file()) : nullptr;
+
+        if(ref && _tail_calls.can_reuse_frame(*_current_function, current_file(), *ref))
+        {
+            std::vector<Value> args; args.reserve(call.arguments.size());
+            for(auto& a : call.arguments)
+            {
+                args.push_back(eval_expression(a.get()));
+            }
+            throw ReturnException(*ref, std::move(args));
+        }
+    }
+
     Value v = stmt.value ? eval_expression(stmt.value.get()) : Value();
     throw ReturnException(v);
 }
 
+// yield исполняется только внутри корутины генератора (run_yielding), сюда он попадает вне её
+Value Evaluator::visit_yield(YieldStatement& stmt)
+{
+    _diag.error("yield outside of generator", current_file(), stmt.line);
+    return {};
+}
+
 Value Evaluator::visit_index_assignment(IndexAssignment& stmt)
 {
     std::vector<Value> indices;
@@ -488,48 +619,14 @@ Value Evaluator::visit_index_assignment(IndexAssignment& stmt)
     auto* var = dynamic_cast<VariableExpr*>(target_expr);
     if(!var) {_diag.error("Indexed assignment target must be variable", current_file(), stmt.line); return {};}
 
-    Value container = _env.get(var->name);
+    // значение считается до того, как массив забран из переменной: выражение справа может её читать
     Value new_val = eval_expression(stmt.value.get());
+    Value container = _env.take(var->name, current_file(), stmt.line);
     std::reverse(indices.begin(), indices.end());
-    Value* cur = &container;
-
-    for(size_t level = 0; level < indices.size(); ++level)
-    {
-        Value idx_val = indices[level];
-        bool last = (level + 1 == indices.size());
-
-        if(cur->type == ValueType::ARRAY)
-        {
-            int i = (idx_val.type == ValueType::INTEGER) ? std::get<int>(idx_val.data) : static_cast<int>(std::get<double>(idx_val.data));
-            auto& arr = std::get<std::vector<Value>>(cur->data);
-            if(i < 0)                             {_diag.error("Negative array index", current_file(), stmt.line); return {};}
-            if(i >= static_cast<int>(arr.size())) {arr.resize(i + 1, Value());}
-            if(last)                              {arr[i] = new_val;}
-            else
-            {
-                if(arr[i].type == ValueType::NONE) {arr[i] = Value(std::vector<Value>{});}
-                cur = &arr[i];
-            }
-        }
-        /*
-        else if(cur->type == ValueType::DICTIONARY)
-        {
-            std::string key = (idx_val.type == ValueType::STRING) ? std::get<std::string>(idx_val.data) : idx_val.to_string();
-            auto& dict = *std::get<DictionaryPtr>(cur->data);
-            if(last) {dict[key] = new_val;}
-            else
-            {
-                auto it = dict.find(key);
-                if(it == dict.end()) {dict[key] = Value(Dictionary{}); cur = &dict[key];}
-                else                 {cur = &it->second;}
-            }
-        }
-        */
-        else {_diag.error("Indexed assignment not supported for this type", current_file(), stmt.line); return {};}
-    }
 
-    _env.assign(var->name, container, current_file(), stmt.line);
-    return new_val;
+    bool stored = assign_indexed(container, indices, new_val, _diag, current_file(), stmt.line);
+    if(container.type != ValueType::NONE) {_env.assign(var->name, std::move(container), current_file(), stmt.line);}
+    return stored ? new_val : Value();
 }
 
 Value Evaluator::visit_enum(EnumStatement& stmt)
@@ -563,18 +660,57 @@ Value Evaluator::visit_break(BreakStatement& stmt)
     throw BreakSignal();
 }
 
+const SwitchTable* Evaluator::switch_table(SwitchStatement& stmt)
+{
+    auto it = _switch_tables.find(&stmt);
+    if(it != _switch_tables.end()) {return &it->second;}
+
+    for(auto& cs : stmt.cases)
+    {
+        if(cs.value && !SwitchTable::is_constant_case(cs.value.get())) {return nullptr;}
+    }
+
+    // члены enum появляются только после выполнения enum, до этого таблицу не строим
+    SwitchTable table;
+    for(size_t i = 0; i < stmt.cases.size(); ++i)
+    {
+        Expression* value = stmt.cases[i].value.get();
+        if(!value) {table.add_default(static_cast<int>(i)); continue;}
+        std::string member = SwitchTable::enum_member(value);
+        if(!member.empty() && !_env.exists(member)) {return nullptr;}
+        table.add_case(static_cast<int>(i), eval_expression(value));
+    }
+    table.finish();
+
+    return &(_switch_tables[&stmt] = std::move(table));
+}
+
 Value Evaluator::visit_switch(SwitchStatement& stmt)
 {
     Value val = eval_expression(stmt.expression.get());
     bool matched = false;
     Value result;
 
-    for(auto& cs : stmt.cases)
+    // все case константы: совпавший номер известен сразу, обход начинается с него (или с default перед ним)
+    const SwitchTable* table = switch_table(stmt);
+    int hit = SwitchTable::NO_CASE;
+    size_t start = 0;
+    if(table)
     {
+        hit = table->match(val);
+        int entry = table->entry(hit);
+        if(entry == SwitchTable::NO_CASE) {return result;}
+        start = static_cast<size_t>(entry);
+    }
+
+    for(size_t i = start; i < stmt.cases.size(); ++i)
+    {
+        auto& cs = stmt.cases[i];
         bool is_default = !cs.value;
         bool condition = false;
 
-        if(!is_default)
+        if(!is_default && table) {condition = static_cast<int>(i) == hit;}
+        else if(!is_default)
         {
             Value case_val = eval_expression(cs.value.get());
             condition = (val.to_string() == case_val.to_string());
@@ -598,3 +734,238 @@ Value Evaluator::visit_switch(SwitchStatement& stmt)
 
     return result;
 }
+
+bool Evaluator::contains_yield(Statement* stmt)
+{
+    if(!stmt) {return false;}
+    auto cached = _yielding.find(stmt);
+    if(cached != _yielding.end()) {return cached->second;}
+
+    bool found = false;
+    switch(stmt->type)
+    {
+        case StatementType::YIELD:   {found = true; break;}
+        case StatementType::WHILE:   {found = contains_yield(static_cast<WhileStatement*>(stmt)->body.get()); break;}
+        case StatementType::REPEAT:  {found = contains_yield(static_cast<RepeatStatement*>(stmt)->body.get()); break;}
+        case StatementType::FOR:     {found = contains_yield(static_cast<ForStatement*>(stmt)->body.get()); break;}
+        case StatementType::FOREACH: {found = contains_yield(static_cast<ForeachStatement*>(stmt)->body.get()); break;}
+
+        case StatementType::IF:
+        {
+            auto* s = static_cast<IfStatement*>(stmt);
+            found = contains_yield(s->then_branch.get()) || contains_yield(s->else_branch.get());
+            break;
+        }
+
+        case StatementType::BLOCK:
+        {
+            for(const auto& st : static_cast<BlockStatement*>(stmt)->statements) {found = found || contains_yield(st.get());}
+            break;
+        }
+
+        case StatementType::SWITCH:
+        {
+            for(const auto& cs : static_cast<SwitchStatement*>(stmt)->cases)
+            {
+                for(const auto& st : cs.body) {found = found || contains_yield(st.get());}
+            }
+            break;
+        }
+
+        default: {break;}
+    }
+
+    _yielding[stmt] = found;
+    return found;
+}
+
+YieldStream Evaluator::generator_body(const FunctionStatement* fn, std::vector<Value> args)
+{
+    _env.push_scope();
+    for(size_t i = 0; i < args.size(); ++i)
+    {
+        _env.define(fn->parameters[i], args[i]);
+    }
+
+    // return завершает генератор, его значение никуда не уходит
+    try
+    {
+        YieldStream body = run_yielding(fn->body.get());
+        while(body.next()) {co_yield body.value();}
+    }
+    catch(const ReturnException&) {}
+    catch(...) {_env.pop_scope(); throw;}
+    _env.pop_scope();
+}
+
+// did_break - тело цикла прервано break; continue просто заканчивает проход
+YieldStream Evaluator::run_loop_body(Statement* body, bool& did_break)
+{
+    did_break = false;
+    try
+    {
+        YieldStream inner = run_yielding(body);
+        while(inner.next()) {co_yield inner.value();}
+    }
+    catch(const ContinueSignal&) {}
+    catch(const BreakSignal&)    {did_break = true;}
+}
+
+// корутина на каждый оператор, внутри которого есть yield: вложенные потоки пробрасываются наружу по одному значению.
+// Операторы без yield выполняются обычным eval_statement, поэтому между yield генератор работает со скоростью Evaluator
+YieldStream Evaluator::run_yielding(Statement* stmt)
+{
+    if(!contains_yield(stmt)) {eval_statement(stmt); co_return;}
+
+    switch(stmt->type)
+    {
+        case StatementType::YIELD:
+        {
+            co_yield eval_expression(static_cast<YieldStatement*>(stmt)->value.get());
+            break;
+        }
+
+        case StatementType::BLOCK:
+        {
+            _env.push_scope();
+            try
+            {
+                for(const auto& st : static_cast<BlockStatement*>(stmt)->statements)
+                {
+                    if(!contains_yield(st.get())) {eval_statement(st.get()); continue;}
+                    YieldStream inner = run_yielding(st.get());
+                    while(inner.next()) {co_yield inner.value();}
+                }
+            }
+            catch(...) {_env.pop_scope(); throw;}
+            _env.pop_scope();
+            break;
+        }
+
+        case StatementType::IF:
+        {
+            auto* s = static_cast<IfStatement*>(stmt);
+            Statement* branch = eval_condition(s->condition.get()) ? s->then_branch.get() : s->else_branch.get();
+            if(!branch) {break;}
+
+            YieldStream inner = run_yielding(branch);
+            while(inner.next()) {co_yield inner.value();}
+            break;
+        }
+
+        case StatementType::WHILE:
+        {
+            auto* s = static_cast<WhileStatement*>(stmt);
+            while(eval_condition(s->condition.get()))
+            {
+                bool did_break = false;
+                YieldStream body = run_loop_body(s->body.get(), did_break);
+                while(body.next()) {co_yield body.value();}
+                if(did_break) {break;}
+            }
+            break;
+        }
+
+        case StatementType::REPEAT:
+        {
+            auto* s = static_cast<RepeatStatement*>(stmt);
+            Value cnt = eval_expression(s->count.get());
+            if(!is_number(cnt)) {_diag.error("repeat() count must be numeric", current_file(), stmt->line); break;}
+
+            int n = static_cast<int>(as_number(cnt));
+            for(int i = 0; i < n; ++i)
+            {
+                bool did_break = false;
+                YieldStream body = run_loop_body(s->body.get(), did_break);
+                while(body.next()) {co_yield body.value();}
+                if(did_break) {break;}
+            }
+            break;
+        }
+
+        case StatementType::FOR:
+        {
+            auto* s = static_cast<ForStatement*>(stmt);
+            _env.push_scope();
+            try
+            {
+                if(s->initializer) {eval_statement(s->initializer.get());}
+                while(!s->condition || eval_condition(s->condition.get()))
+                {
+                    bool did_break = false;
+                    YieldStream body = run_loop_body(s->body.get(), did_break);
+                    while(body.next()) {co_yield body.value();}
+                    if(did_break) {break;}
+
+                    if(s->increment) {eval_statement(s->increment.get());}
+                }
+            }
+            catch(...) {_env.pop_scope(); throw;}
+            _env.pop_scope();
+            break;
+        }
+
+        case StatementType::FOREACH:
+        {
+            auto* s = static_cast<ForeachStatement*>(stmt);
+            Value it = eval_expression(s->iterable.get());
+            if(!is_iterable(it)) {_diag.error("foreach() expects an array, range or generator", current_file(), stmt->line); break;}
+
+            ForeachCursor cursor(it);
+            Value elem;
+            while(cursor.next(elem))
+            {
+                _env.push_scope();
+                _env.define(s->var_name, elem);
+
+                bool did_break = false;
+                try
+                {
+                    YieldStream body = run_loop_body(s->body.get(), did_break);
+                    while(body.next()) {co_yield body.value();}
+                }
+                catch(...) {_env.pop_scope(); throw;}
+                _env.pop_scope();
+
+                if(did_break) {break;}
+            }
+            break;
+        }
+
+        // как обычный switch без таблицы: совпавший case останавливает перебор, default - нет
+        case StatementType::SWITCH:
+        {
+            auto* s = static_cast<SwitchStatement*>(stmt);
+            Value val = eval_expression(s->expression.get());
+            bool matched = false;
+
+            for(const auto& cs : s->cases)
+            {
+                bool is_default = !cs.value;
+                bool condition = !is_default && val.to_string() == eval_expression(cs.value.get()).to_string();
+
+                if(condition || is_default)
+                {
+                    matched = true;
+                    bool did_break = false;
+                    try
+                    {
+                        for(const auto& st : cs.body)
+                        {
+                            if(!contains_yield(st.get())) {eval_statement(st.get()); continue;}
+                            YieldStream inner = run_yielding(st.get());
+                            while(inner.next()) {co_yield inner.value();}
+                        }
+                    }
+                    catch(const BreakSignal&) {did_break = true;}
+                    if(did_break) {break;}
+                }
+
+                if(matched && !is_default) {break;}
+            }
+            break;
+        }
+
+        default: {eval_statement(stmt); break;}
+    }
+}
@@ -14,11 +14,17 @@
 #include "frontend/diagnostics/BaseContext.h"
 #include "runtime/value/Value.h"
 #include "runtime/environment/Environment.h"
+#include "runtime/evaluator/TailCallAnalysis.h"
+#include "runtime/evaluator/LoopAnalysis.h"
+#include "runtime/evaluator/VectorLoop.h"
+#include "runtime/evaluator/SwitchTable.h"
+#include "runtime/evaluator/YieldStream.h"
 #include <unordered_map>
 #include <string>
 #include <stack>
 
 class FunctionIndex;
+struct FunctionRef;
 
 class BERESTA_API Evaluator : public BaseContext, public ExprVisitor, public StmtVisitor
 {
@@ -28,13 +34,33 @@ class BERESTA_API Evaluator : public BaseContext, public ExprVisitor, public Stm
         Value eval_expression(Expression* expr);
         Value eval_statement(Statement* stmt);
 
+        // вызов уже найденной пользовательской функции, аргументы вычислены вызывающей стороной
+        Value call_function(const FunctionRef& ref, const std::vector<Value>& args);
+
+        // функция языка, видимая из текущего файла; nullptr - такой нет
+        const FunctionRef* find_function(const std::string& name);
+
+        // тело функции с yield как корутина; скоупы между шагами переносит GeneratorObject
+        YieldStream generator_body(const FunctionStatement* fn, std::vector<Value> args);
+
     private:
         Environment& _env;
         FunctionIndex& _index;
         std::vector<std::string> _file_stack;
+        TailCallAnalysis _tail_calls;
+        LoopAnalysis _loops;
+        VectorLoops _vector_loops;
+        std::unordered_map<const SwitchStatement*, SwitchTable> _switch_tables;
+        std::unordered_map<const Statement*, bool> _yielding;
+        const FunctionStatement* _current_function = nullptr;
 
-        [[nodiscard]] static bool is_truthy(const Value& val) ;
-        void type_error(int line, const char* msg);
+        void leave_frame(bool pushed_file);
+        bool eval_condition(Expression* expr);
+        const SwitchTable* switch_table(SwitchStatement& stmt);
+        bool run_counting_loop(ForStatement& stmt, const CountingLoop& loop, Value& result);
+        bool contains_yield(Statement* stmt);
+        YieldStream run_yielding(Statement* stmt);
+        YieldStream run_loop_body(Statement* body, bool& did_break);
 
         Value visit_number(NumberExpr& expr) override;
         Value visit_string(StringExpr& expr) override;
@@ -60,6 +86,7 @@ class BERESTA_API Evaluator : public BaseContext, public ExprVisitor, public Stm
         Value visit_block(BlockStatement& stmt) override;
         Value visit_function(FunctionStatement& stmt) override;
         Value visit_return(ReturnStatement& stmt) override;
+        Value visit_yield(YieldStatement& stmt) override;
         Value visit_index_assignment(IndexAssignment& stmt) override;
         Value visit_enum(EnumStatement& stmt) override;
         Value visit_macros(MacrosStatement& stmt) override;
@@ -0,0 +1,271 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "FunctionUsage.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include <vector>
+
+namespace
+{
+    // повторяет скоупы Evaluator: блок, for и foreach открывают свой, вызов функции - кадр с параметрами
+    class UsageWalker
+    {
+        public:
+            UsageWalker(FunctionIndex& index, std::string file, FunctionUsage& usage) : _index(index), _file(std::move(file)), _usage(usage) {}
+
+            void function(const FunctionStatement& fn)
+            {
+                _scopes.emplace_back();
+                for(const auto& p : fn.parameters) {bind(p);}
+                statement(fn.body.get());
+                _scopes.pop_back();
+            }
+
+            void root(Statement* stmt)
+            {
+                _scopes.emplace_back();
+                statement(stmt);
+                _scopes.pop_back();
+            }
+
+            void root(Expression* expr)
+            {
+                _scopes.emplace_back();
+                expression(expr);
+                _scopes.pop_back();
+            }
+
+        private:
+            FunctionIndex& _index;
+            std::string _file;
+            FunctionUsage& _usage;
+            std::vector<std::unordered_set<std::string>> _scopes;
+
+            void bind(const std::string& name)
+            {
+                _scopes.back().insert(name);
+                _usage.locals.insert(name);
+                _usage.writes.insert(name);
+            }
+
+            void use(const std::string& name, bool write = false)
+            {
+                if(write) {_usage.writes.insert(name);}
+                else      {_usage.reads.insert(name);}
+
+                for(auto it = _scopes.rbegin(); it != _scopes.rend(); ++it)
+                {
+                    if(it->count(name)) {return;}
+                }
+                _usage.free.insert(name);
+            }
+
+            void statement(Statement* stmt)
+            {
+                if(!stmt) {return;}
+
+                switch(stmt->type)
+                {
+                    case StatementType::ASSIGNMENT:
+                    {
+                        auto& as = *static_cast<Assignment*>(stmt);
+                        expression(as.value.get());
+                        if(as.is_let) {bind(as.name);}
+                        else          {use(as.name, true);}
+                        break;
+                    }
+
+                    case StatementType::ASSIGNMENT_STATEMENT: {statement(static_cast<AssignmentStatement*>(stmt)->assignment.get()); break;}
+                    case StatementType::EXPRESSION:           {expression(static_cast<ExpressionStatement*>(stmt)->expression.get()); break;}
+
+                    case StatementType::IF:
+                    {
+                        auto& st = *static_cast<IfStatement*>(stmt);
+                        expression(st.condition.get());
+                        statement(st.then_branch.get());
+                        statement(st.else_branch.get());
+                        break;
+                    }
+
+                    case StatementType::WHILE:
+                    {
+                        auto& st = *static_cast<WhileStatement*>(stmt);
+                        expression(st.condition.get());
+                        statement(st.body.get());
+                        break;
+                    }
+
+                    case StatementType::REPEAT:
+                    {
+                        auto& st = *static_cast<RepeatStatement*>(stmt);
+                        expression(st.count.get());
+                        statement(st.body.get());
+                        break;
+                    }
+
+                    case StatementType::FOR:
+                    {
+                        auto& st = *static_cast<ForStatement*>(stmt);
+                        _scopes.emplace_back();
+                        statement(st.initializer.get());
+                        expression(st.condition.get());
+                        statement(st.body.get());
+                        statement(st.increment.get());
+                        _scopes.pop_back();
+                        break;
+                    }
+
+                    case StatementType::FOREACH:
+                    {
+                        auto& st = *static_cast<ForeachStatement*>(stmt);
+                        expression(st.iterable.get());
+                        _scopes.emplace_back();
+                        bind(st.var_name);
+                        statement(st.body.get());
+                        _scopes.pop_back();
+                        break;
+                    }
+
+                    case StatementType::BLOCK:
+                    {
+                        _scopes.emplace_back();
+                        for(auto& s : static_cast<BlockStatement*>(stmt)->statements) {statement(s.get());}
+                        _scopes.pop_back();
+                        break;
+                    }
+
+                    case StatementType::RETURN:  {expression(static_cast<ReturnStatement*>(stmt)->value.get()); break;}
+                    case StatementType::YIELD:   {expression(static_cast<YieldStatement*>(stmt)->value.get()); break;}
+                    case StatementType::MACROS:  {expression(static_cast<MacrosStatement*>(stmt)->value.get()); break;}
+
+                    case StatementType::INDEX_ASSIGNMENT:
+                    {
+                        auto& st = *static_cast<IndexAssignment*>(stmt);
+                        _usage.index_assigns = true;
+                        expression(st.target.get());
+                        expression(st.value.get());
+
+                        Expression* root = st.target.get();
+                        while(root && root->type == ExpressionType::INDEX) {root = static_cast<IndexExpr*>(root)->array.get();}
+                        if(root && root->type == ExpressionType::VARIABLE) {use(static_cast<VariableExpr*>(root)->name, true);}
+                        break;
+                    }
+
+                    case StatementType::SWITCH:
+                    {
+                        auto& st = *static_cast<SwitchStatement*>(stmt);
+                        expression(st.expression.get());
+                        for(auto& cs : st.cases)
+                        {
+                            expression(cs.value.get());
+                            for(auto& s : cs.body) {statement(s.get());}
+                        }
+                        break;
+                    }
+
+                    default: {break;}
+                }
+            }
+
+            void callback(Expression* arg)
+            {
+                if(!arg || arg->type != ExpressionType::STRING) {_usage.dynamic_calls = true; return;}
+
+                const std::string& name = static_cast<StringExpr*>(arg)->value;
+                if(BuiltinRegistry::instance().get(name)) {_usage.builtins.insert(name);}
+                else if(_index.find_function(name, _file)) {_usage.calls.insert(name);}
+            }
+
+            void expression(Expression* expr)
+            {
+                if(!expr) {return;}
+
+                switch(expr->type)
+                {
+                    case ExpressionType::VARIABLE: {use(static_cast<VariableExpr*>(expr)->name); break;}
+                    case ExpressionType::UNARY:    {expression(static_cast<UnaryExpr*>(expr)->right.get()); break;}
+
+                    case ExpressionType::BINARY:
+                    {
+                        auto& bin = *static_cast<BinaryExpr*>(expr);
+                        expression(bin.left.get());
+                        expression(bin.right.get());
+                        break;
+                    }
+
+                    case ExpressionType::FUNCTION_CALL:
+                    {
+                        auto& call = *static_cast<FunctionCallExpr*>(expr);
+                        auto* var = dynamic_cast<VariableExpr*>(call.callee.get());
+                        IBuiltinFunction* builtin = var ? BuiltinRegistry::instance().get(var->name) : nullptr;
+                        if(builtin) {_usage.builtins.insert(var->name);}
+                        else if(var && _index.find_function(var->name, _file)) {_usage.calls.insert(var->name);}
+                        else {expression(call.callee.get());}
+
+                        // array_map(xs, "f") и подобные вызывают f отсюда же, имя функции - аргумент #2
+                        if(builtin && builtin->calls_back() && call.arguments.size() > 1) {callback(call.arguments[1].get());}
+
+                        for(auto& a : call.arguments) {expression(a.get());}
+                        break;
+                    }
+
+                    case ExpressionType::ARRAY_LITERAL:
+                    {
+                        for(auto& e : static_cast<ArrayLiteralExpr*>(expr)->elements) {expression(e.get());}
+                        break;
+                    }
+
+                    case ExpressionType::DICTIONARY_LITERAL:
+                    {
+                        for(auto& kv : static_cast<DictionaryLiteralExpr*>(expr)->entries)
+                        {
+                            expression(kv.first.get());
+                            expression(kv.second.get());
+                        }
+                        break;
+                    }
+
+                    case ExpressionType::STRUCT_LITERAL:
+                    {
+                        for(auto& kv : static_cast<StructLiteralExpr*>(expr)->fields) {expression(kv.second.get());}
+                        break;
+                    }
+
+                    case ExpressionType::INDEX:
+                    {
+                        auto& ix = *static_cast<IndexExpr*>(expr);
+                        expression(ix.array.get());
+                        expression(ix.index.get());
+                        break;
+                    }
+
+                    case ExpressionType::MEMBER_ACCESS: {expression(static_cast<MemberAccessExpr*>(expr)->object.get()); break;}
+
+                    default: {break;}
+                }
+            }
+    };
+}
+
+FunctionUsage collect_function_usage(const FunctionStatement& fn, FunctionIndex& index, const std::string& file)
+{
+    FunctionUsage usage;
+    UsageWalker(index, file, usage).function(fn);
+    return usage;
+}
+
+FunctionUsage collect_statement_usage(Statement* stmt, FunctionIndex& index, const std::string& file)
+{
+    FunctionUsage usage;
+    UsageWalker(index, file, usage).root(stmt);
+    return usage;
+}
+
+FunctionUsage collect_expression_usage(Expression* expr, FunctionIndex& index, const std::string& file)
+{
+    FunctionUsage usage;
+    UsageWalker(index, file, usage).root(expr);
+    return usage;
+}
@@ -0,0 +1,39 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_FUNCTIONUSAGE_H
+#define BERESTALANGUAGE_FUNCTIONUSAGE_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "frontend/parser/Statement.h"
+#include <string>
+#include <unordered_set>
+
+class FunctionIndex;
+
+// какие имена функция берёт за пределами своего кадра и что вызывает; скоупы повторяют Evaluator
+struct FunctionUsage
+{
+    std::unordered_set<std::string> locals;     // параметры и всё, что объявлено let/foreach внутри функции
+    std::unordered_set<std::string> free;       // имена, которые функция ищет за пределами своего кадра (чтение и присваивание)
+    std::unordered_set<std::string> calls;      // вызываемые пользовательские функции
+    std::unordered_set<std::string> builtins;
+    std::unordered_set<std::string> reads;      // все прочитанные имена, включая локальные
+    std::unordered_set<std::string> writes;     // все присвоенные имена, включая let
+    // builtin с обратным вызовом получил имя функции не литералом: что будет вызвано, заранее не известно
+    bool dynamic_calls = false;
+    // есть запись по индексу: массив структур, плотный массив и другие общие контейнеры меняются и через псевдонимы
+    bool index_assigns = false;
+};
+
+BERESTA_API FunctionUsage collect_function_usage(const FunctionStatement& fn, FunctionIndex& index, const std::string& file);
+
+// то же для отдельного фрагмента (тело цикла, выражение); имена, объявленные вне фрагмента, попадают в free
+BERESTA_API FunctionUsage collect_statement_usage(Statement* stmt, FunctionIndex& index, const std::string& file);
+BERESTA_API FunctionUsage collect_expression_usage(Expression* expr, FunctionIndex& index, const std::string& file);
+
+
+#endif //BERESTALANGUAGE_FUNCTIONUSAGE_H
@@ -0,0 +1,302 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "FusedArrayExpr.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/value/PackedArray.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+    bool is_fusable(const Expression* expr, bool root)
+    {
+        if(!expr || expr->type != ExpressionType::BINARY) {return false;}
+        BinaryOp op = static_cast<const BinaryExpr*>(expr)->opcode;
+        return is_broadcast_op(op) && (root || !is_comparison(op));
+    }
+
+    bool is_scalar(const Value& v) {return is_number(v) || v.type == ValueType::BOOLEAN;}
+
+    // все числа листа целые: от этого зависит, останется ли целым остаток от деления
+    bool int_valued(const Value& v, size_t n)
+    {
+        if(v.type == ValueType::INTEGER)      {return true;}
+        if(v.type == ValueType::PACKED_ARRAY) {return std::get<std::shared_ptr<PackedArray>>(v.data)->type() == PackedType::INT;}
+        if(!is_array(v))                      {return false;}
+        for(size_t i = 0; i < n; ++i)
+        {
+            if(array_element(v, i).type != ValueType::INTEGER) {return false;}
+        }
+        return true;
+    }
+
+    // два числа без apply_binary, как в apply_binary_fast; остаток от деления идёт обычным путём из-за целых
+    Value number_step(BinaryOp op, double l, double r)
+    {
+        switch(op)
+        {
+            case BinaryOp::ADD:           {return Value(l + r);}
+            case BinaryOp::SUB:           {return Value(l - r);}
+            case BinaryOp::MUL:           {return Value(l * r);}
+            case BinaryOp::DIV:           {return Value(r != 0.0 ? l / r : 0.0);}
+            case BinaryOp::EQUAL:         {return Value(l == r);}
+            case BinaryOp::NOT_EQUAL:     {return Value(l != r);}
+            case BinaryOp::LESS:          {return Value(l < r);}
+            case BinaryOp::LESS_EQUAL:    {return Value(l <= r);}
+            case BinaryOp::GREATER:       {return Value(l > r);}
+            case BinaryOp::GREATER_EQUAL: {return Value(l >= r);}
+            default:                      {return {};}
+        }
+    }
+
+    template<typename F>
+    void block_loop(const double* a, const double* b, double* out, size_t m, F f)
+    {
+        for(size_t i = 0; i < m; ++i) {out[i] = f(a[i], b[i]);}
+    }
+
+    // false - деление по модулю на ноль
+    bool apply_block(BinaryOp op, const double* a, const double* b, double* out, size_t m)
+    {
+        switch(op)
+        {
+            case BinaryOp::ADD:           {block_loop(a, b, out, m, [](double l, double r) {return l + r;}); return true;}
+            case BinaryOp::SUB:           {block_loop(a, b, out, m, [](double l, double r) {return l - r;}); return true;}
+            case BinaryOp::MUL:           {block_loop(a, b, out, m, [](double l, double r) {return l * r;}); return true;}
+            case BinaryOp::DIV:           {block_loop(a, b, out, m, [](double l, double r) {return r != 0.0 ? l / r : 0.0;}); return true;}
+            case BinaryOp::EQUAL:         {block_loop(a, b, out, m, [](double l, double r) {return l == r ? 1.0 : 0.0;}); return true;}
+            case BinaryOp::NOT_EQUAL:     {block_loop(a, b, out, m, [](double l, double r) {return l != r ? 1.0 : 0.0;}); return true;}
+            case BinaryOp::LESS:          {block_loop(a, b, out, m, [](double l, double r) {return l < r ? 1.0 : 0.0;}); return true;}
+            case BinaryOp::LESS_EQUAL:    {block_loop(a, b, out, m, [](double l, double r) {return l <= r ? 1.0 : 0.0;}); return true;}
+            case BinaryOp::GREATER:       {block_loop(a, b, out, m, [](double l, double r) {return l > r ? 1.0 : 0.0;}); return true;}
+            case BinaryOp::GREATER_EQUAL: {block_loop(a, b, out, m, [](double l, double r) {return l >= r ? 1.0 : 0.0;}); return true;}
+
+            case BinaryOp::MOD:
+            {
+                if(std::find(b, b + m, 0.0) != b + m) {return false;}
+                block_loop(a, b, out, m, [](double l, double r) {return std::fmod(l, r);});
+                return true;
+            }
+
+            default: {return true;}
+        }
+    }
+}
+
+FusedArrayExpr::FusedArrayExpr(BinaryExpr& root)
+{
+    flatten(&root, true);
+}
+
+FusedArrayExpr::FusedArrayExpr(BinaryOp op)
+{
+    _program = {{0, op}, {1, op}, {-1, op}};
+}
+
+bool FusedArrayExpr::is_chain(const BinaryExpr& root)
+{
+    return is_broadcast_op(root.opcode) && (is_fusable(root.left.get(), false) || is_fusable(root.right.get(), false));
+}
+
+void FusedArrayExpr::flatten(Expression* expr, bool root)
+{
+    if(!is_fusable(expr, root))
+    {
+        _program.push_back({static_cast<int>(_leaves.size()), BinaryOp::UNKNOWN});
+        _leaves.push_back(expr);
+        return;
+    }
+
+    auto* bin = static_cast<BinaryExpr*>(expr);
+    flatten(bin->left.get(), false);
+    flatten(bin->right.get(), false);
+    _program.push_back({-1, bin->opcode});
+}
+
+Value FusedArrayExpr::evaluate(std::span<Value> values, Diagnostics& diag, const std::string& file, int line) const
+{
+    bool any_array = false;
+    bool plain = true;
+    bool same_length = true;
+    size_t n = 0;
+    for(const auto& v : values)
+    {
+        if(is_array(v))
+        {
+            size_t len = array_length(v);
+            if(any_array && len != n) {same_length = false;}
+            n = len;
+            any_array = true;
+        }
+        else if(!is_scalar(v)) {plain = false;}
+    }
+
+    // строки и прочее дают ту же семантику, что и без слияния: каждый оператор по очереди
+    if(!any_array || !plain) {return fold(values, diag, file, line);}
+    if(!same_length) {diag.error("Array operands must have the same length", file, line); return {};}
+
+    Value out;
+    if(numeric(values, n, out, diag, file, line)) {return out;}
+    if(_program.size() == 3) {return elementwise(values, n, diag, file, line);}
+    return fold(values, diag, file, line);
+}
+
+Value FusedArrayExpr::fold(std::span<Value> values, Diagnostics& diag, const std::string& file, int line) const
+{
+    size_t top = 0;
+    for(const auto& step : _program)
+    {
+        if(step.leaf >= 0)
+        {
+            if(static_cast<size_t>(step.leaf) != top) {values[top] = std::move(values[step.leaf]);}
+            ++top;
+            continue;
+        }
+
+        --top;
+        Value& lv = values[top - 1];
+        const Value& rv = values[top];
+        if(step.op != BinaryOp::MOD && is_number(lv) && is_number(rv)) {lv = number_step(step.op, as_number(lv), as_number(rv)); continue;}
+
+        lv = apply_binary(step.op, lv, rv, diag, file, line);
+        if(lv.type == ValueType::NONE) {return {};}
+    }
+    return std::move(values[0]);
+}
+
+Value FusedArrayExpr::elementwise(std::span<const Value> values, size_t n, Diagnostics& diag, const std::string& file, int line) const
+{
+    const Value& lv = values[0];
+    const Value& rv = values[1];
+    BinaryOp op = _program.back().op;
+
+    // не только числа (bool, вложенные массивы): по элементу через apply_binary, результат - обычный массив
+    std::vector<Value> out;
+    out.reserve(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+        Value r = apply_binary(op, is_array(lv) ? array_element(lv, i) : lv, is_array(rv) ? array_element(rv, i) : rv, diag, file, line);
+        if(r.type == ValueType::NONE) {return {};}
+        out.push_back(std::move(r));
+    }
+    return Value(out);
+}
+
+bool FusedArrayExpr::numeric(std::span<const Value> values, size_t n, Value& out, Diagnostics& diag, const std::string& file, int line) const
+{
+    // источник листа: плотный double читается на месте, число - блоком одинаковых значений без сдвига
+    struct Source
+    {
+        const double* base = nullptr;
+        bool scalar = false;
+        std::vector<double> owned;
+    };
+
+    std::vector<Source> sources(values.size());
+    bool packed_input = false;
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+        const Value& v = values[i];
+        Source& src = sources[i];
+        if(!is_number(v) && !is_array(v)) {return false;}
+        if(v.type == ValueType::PACKED_ARRAY) {packed_input = true;}
+
+        if(is_number(v))
+        {
+            src.owned.assign(BLOCK, as_number(v));
+            src.scalar = true;
+        }
+        else if(v.type == ValueType::PACKED_ARRAY && std::get<std::shared_ptr<PackedArray>>(v.data)->type() == PackedType::DOUBLE)
+        {
+            src.base = std::get<std::shared_ptr<PackedArray>>(v.data)->doubles().data();
+            continue;
+        }
+        else if(!numeric_column(v, n, src.owned)) {return false;}
+        src.base = src.owned.data();
+    }
+
+    std::vector<double> result(n);
+    std::vector<std::vector<double>> scratch(_program.size());
+    for(size_t k = 0; k < _program.size(); ++k)
+    {
+        if(_program[k].leaf < 0) {scratch[k].resize(BLOCK);}
+    }
+
+    std::vector<const double*> stack;
+    stack.reserve(_program.size());
+    for(size_t start = 0; start < n; start += BLOCK)
+    {
+        size_t m = std::min(BLOCK, n - start);
+        stack.clear();
+        for(size_t k = 0; k < _program.size(); ++k)
+        {
+            const Step& step = _program[k];
+            if(step.leaf >= 0)
+            {
+                const Source& src = sources[step.leaf];
+                stack.push_back(src.scalar ? src.base : src.base + start);
+                continue;
+            }
+
+            const double* b = stack.back();
+            stack.pop_back();
+            double* dst = scratch[k].data();
+            if(!apply_block(step.op, stack.back(), b, dst, m)) {diag.error("Modulo by zero", file, line); out = Value(); return true;}
+            stack.back() = dst;
+        }
+        std::copy(stack.back(), stack.back() + m, result.begin() + static_cast<std::ptrdiff_t>(start));
+    }
+
+    // как у скаляров: + - * / дают double, % двух целых - целое, сравнение - bool.
+    // Плотный результат только у плотного входа, иначе обычный массив, который можно менять как угодно
+    BinaryOp root = _program.back().op;
+    bool ints = false;
+    if(root == BinaryOp::MOD)
+    {
+        std::vector<bool> kinds;
+        for(const auto& step : _program)
+        {
+            if(step.leaf >= 0) {kinds.push_back(int_valued(values[step.leaf], n)); continue;}
+            bool r = kinds.back();
+            kinds.pop_back();
+            kinds.back() = step.op == BinaryOp::MOD && kinds.back() && r;
+        }
+        ints = kinds.back();
+    }
+
+    if(packed_input)
+    {
+        if(is_comparison(root) || ints)
+        {
+            auto packed = std::make_shared<PackedArray>(is_comparison(root) ? PackedType::BOOL : PackedType::INT, n);
+            for(size_t i = 0; i < n; ++i)
+            {
+                if(ints)                  {packed->set(i, Value(static_cast<int>(result[i])));}
+                else if(result[i] != 0.0) {packed->set(i, Value(true));}
+            }
+            out = Value(packed);
+        }
+        else {out = Value(std::make_shared<PackedArray>(std::move(result)));}
+        return true;
+    }
+
+    std::vector<Value> items;
+    items.reserve(n);
+    for(double d : result)
+    {
+        if(is_comparison(root)) {items.emplace_back(d != 0.0);}
+        else if(ints)           {items.emplace_back(static_cast<int>(d));}
+        else                    {items.emplace_back(d);}
+    }
+    out = Value(items);
+    return true;
+}
+
+Value broadcast_binary(BinaryOp op, const Value& lv, const Value& rv, Diagnostics& diag, const std::string& file, int line)
+{
+    std::array<Value, 2> values = {lv, rv};
+    return FusedArrayExpr(op).evaluate(values, diag, file, line);
+}
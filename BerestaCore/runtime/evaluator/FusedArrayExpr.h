@@ -0,0 +1,96 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_FUSEDARRAYEXPR_H
+#define BERESTALANGUAGE_FUSEDARRAYEXPR_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "runtime/value/Value.h"
+#include <cstddef>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+// дерево операторов + - * / % (сравнение - только в корне) над массивами, которое считается одним проходом:
+// листья вычисляются заранее, дальше числа идут блоками по BLOCK элементов без промежуточного массива на каждый оператор.
+// Если среди листьев есть не числа и не массивы или массивы не только из чисел, дерево сворачивается обычным apply_binary
+class BERESTA_API FusedArrayExpr
+{
+    public:
+        explicit FusedArrayExpr(BinaryExpr& root);
+        explicit FusedArrayExpr(BinaryOp op);
+
+        // корень, под которым есть ещё хотя бы один оператор: сливать есть что
+        static bool is_chain(const BinaryExpr& root);
+
+        [[nodiscard]] const std::vector<Expression*>& leaves() const {return _leaves;}
+        // values - значения листов; свёртка идёт прямо в них, после вызова содержимое не определено
+        [[nodiscard]] Value evaluate(std::span<Value> values, Diagnostics& diag, const std::string& file, int line) const;
+
+        // leaf(i) вычисляет i-й лист; у короткой цепочки значения лежат на стеке, чтобы свёртка чисел не ходила в кучу
+        template<typename F>
+        [[nodiscard]] Value run(F&& leaf, Diagnostics& diag, const std::string& file, int line) const
+        {
+            if(_leaves.size() <= INLINE)
+            {
+                InlineValues values;
+                for(size_t i = 0; i < _leaves.size(); ++i) {values.push(leaf(i));}
+                return evaluate({values.data(), values.size()}, diag, file, line);
+            }
+
+            std::vector<Value> values;
+            values.reserve(_leaves.size());
+            for(size_t i = 0; i < _leaves.size(); ++i) {values.push_back(leaf(i));}
+            return evaluate(values, diag, file, line);
+        }
+
+    private:
+        static constexpr size_t BLOCK = 256;
+        static constexpr size_t INLINE = 8;
+
+        // до INLINE значений без кучи; слоты конструируются по мере вычисления листов, а не заранее
+        class InlineValues
+        {
+            public:
+                InlineValues() = default;
+                InlineValues(const InlineValues&) = delete;
+                InlineValues& operator=(const InlineValues&) = delete;
+                ~InlineValues() {for(size_t i = 0; i < _size; ++i) {data()[i].~Value();}}
+
+                void push(Value v) {new(_storage + _size * sizeof(Value)) Value(std::move(v)); ++_size;}
+                [[nodiscard]] Value* data() {return std::launder(reinterpret_cast<Value*>(_storage));}
+                [[nodiscard]] size_t size() const {return _size;}
+
+            private:
+                alignas(Value) std::byte _storage[INLINE * sizeof(Value)];
+                size_t _size = 0;
+        };
+
+        struct Step
+        {
+            int leaf;                   // номер листа или -1 для оператора
+            BinaryOp op;
+        };
+
+        std::vector<Step> _program;     // обратная польская запись: листья слева направо, как их вычислил бы обход дерева
+        std::vector<Expression*> _leaves;
+
+        void flatten(Expression* expr, bool root);
+
+        // стек свёртки не длиннее числа уже прочитанных листов, поэтому им служит сам values
+        [[nodiscard]] Value fold(std::span<Value> values, Diagnostics& diag, const std::string& file, int line) const;
+        [[nodiscard]] Value elementwise(std::span<const Value> values, size_t n, Diagnostics& diag, const std::string& file, int line) const;
+        // false, если какой-то массив не только из чисел: тогда out не тронут
+        bool numeric(std::span<const Value> values, size_t n, Value& out, Diagnostics& diag, const std::string& file, int line) const;
+};
+
+// оператор над массивом и числом или двумя массивами; apply_binary отдаёт сюда всё, где есть массив
+BERESTA_API Value broadcast_binary(BinaryOp op, const Value& lv, const Value& rv, Diagnostics& diag, const std::string& file, int line);
+
+
+#endif //BERESTALANGUAGE_FUSEDARRAYEXPR_H
@@ -0,0 +1,29 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "Generator.h"
+#include "interpreter/FunctionIndex.h"
+
+GeneratorObject::GeneratorObject(Environment& env, FunctionIndex& index, const FunctionRef& ref, std::vector<Value> args, Diagnostics& diag)
+    : _env(env), _diag(diag), _name(ref.func->name), _evaluator(env, index, ref.file, diag), _stream(_evaluator.generator_body(ref.func, std::move(args))) {}
+
+bool GeneratorObject::next(Value& out)
+{
+    // корутину нельзя возобновить изнутри неё самой
+    if(_running) {_diag.error("Generator '" + _name + "' is already running"); return false;}
+
+    // тело видит скоупы того, кто сейчас просит значение, как и при обычном вызове
+    size_t base = _env.depth();
+    _env.restore_scopes(std::move(_saved));
+
+    bool produced = false;
+    _running = true;
+    try {produced = _stream.next();}
+    catch(...) {_running = false; _env.take_scopes(base); throw;}
+
+    _running = false;
+    _saved = _env.take_scopes(base);
+    if(produced) {out = _stream.value();}
+    return produced;
+}
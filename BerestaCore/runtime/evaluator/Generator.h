@@ -0,0 +1,38 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_GENERATOR_H
+#define BERESTALANGUAGE_GENERATOR_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/evaluator/Evaluator.h"
+#include "runtime/evaluator/YieldStream.h"
+#include "runtime/environment/Environment.h"
+#include <string>
+#include <vector>
+
+struct FunctionRef;
+
+// результат вызова функции с yield: тело выполняется по шагам, пока кто-то просит следующее значение
+class BERESTA_API GeneratorObject
+{
+    public:
+        GeneratorObject(Environment& env, FunctionIndex& index, const FunctionRef& ref, std::vector<Value> args, Diagnostics& diag);
+
+        bool next(Value& out);
+        [[nodiscard]] const std::string& name() const {return _name;}
+
+    private:
+        Environment& _env;
+        Diagnostics& _diag;
+        std::string _name;
+        bool _running = false;
+        Evaluator _evaluator;
+        Environment::Scopes _saved;     // скоупы тела, пока генератор стоит на yield
+        YieldStream _stream;
+};
+
+
+#endif //BERESTALANGUAGE_GENERATOR_H
@@ -0,0 +1,147 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "LoopAnalysis.h"
+#include "FunctionUsage.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    const std::string* assigned_name(Statement* stmt)
+    {
+        if(!stmt || stmt->type != StatementType::ASSIGNMENT_STATEMENT) {return nullptr;}
+        return &static_cast<AssignmentStatement*>(stmt)->assignment->name;
+    }
+
+    bool is_variable(Expression* expr, const std::string& name)
+    {
+        return expr && expr->type == ExpressionType::VARIABLE && static_cast<VariableExpr*>(expr)->name == name;
+    }
+
+    bool whole_literal(Expression* expr, long long& out)
+    {
+        if(!expr || expr->type != ExpressionType::NUMBER) {return false;}
+
+        const Value& v = static_cast<NumberExpr*>(expr)->value;
+        if(v.type == ValueType::INTEGER) {out = std::get<int>(v.data); return true;}
+        if(v.type == ValueType::DOUBLE && std::trunc(std::get<double>(v.data)) == std::get<double>(v.data) && std::fabs(std::get<double>(v.data)) < 1e15)
+        {
+            out = static_cast<long long>(std::get<double>(v.data));
+            return true;
+        }
+        return false;
+    }
+
+    bool all_pure(const std::unordered_set<std::string>& builtins)
+    {
+        for(const auto& name : builtins)
+        {
+            auto* impl = BuiltinRegistry::instance().get(name);
+            if(impl && !impl->is_pure()) {return false;}
+        }
+        return true;
+    }
+}
+
+LoopAnalysis::LoopAnalysis(FunctionIndex& index) : _index(index) {}
+
+const CountingLoop& LoopAnalysis::counting_loop(const ForStatement& loop, const std::string& file)
+{
+    auto it = _loops.find(&loop);
+    if(it != _loops.end()) {return it->second;}
+
+    return _loops[&loop] = analyze(loop, file);
+}
+
+std::unordered_set<std::string> LoopAnalysis::callee_names(const std::unordered_set<std::string>& calls, const std::string& file, bool& dynamic, bool& mutates)
+{
+    // все внешние имена, которых касаются вызываемые функции (транзитивно); переменные динамические, так что это и переменные цикла
+    std::unordered_set<std::string> names;
+    std::unordered_set<const FunctionStatement*> visited;
+    std::vector<std::pair<const FunctionStatement*, std::string>> pending;
+    for(const auto& name : calls)
+    {
+        if(const FunctionRef* ref = _index.find_function(name, file)) {pending.emplace_back(ref->func, ref->file);}
+    }
+
+    while(!pending.empty())
+    {
+        auto [fn, fn_file] = pending.back();
+        pending.pop_back();
+        if(!visited.insert(fn).second) {continue;}
+
+        FunctionUsage usage = collect_function_usage(*fn, _index, fn_file);
+        dynamic = dynamic || usage.dynamic_calls;
+        mutates = mutates || usage.index_assigns || !all_pure(usage.builtins);
+        names.insert(usage.free.begin(), usage.free.end());
+        for(const auto& name : usage.calls)
+        {
+            if(const FunctionRef* ref = _index.find_function(name, fn_file)) {pending.emplace_back(ref->func, ref->file);}
+        }
+    }
+    return names;
+}
+
+CountingLoop LoopAnalysis::analyze(const ForStatement& loop, const std::string& file)
+{
+    CountingLoop result;
+
+    const std::string* var = assigned_name(loop.initializer.get());
+    if(!var) {return result;}
+
+    if(!loop.condition || loop.condition->type != ExpressionType::BINARY) {return result;}
+    auto& cond = static_cast<BinaryExpr&>(*loop.condition);
+    switch(cond.opcode)
+    {
+        case BinaryOp::LESS: case BinaryOp::LESS_EQUAL: case BinaryOp::GREATER: case BinaryOp::GREATER_EQUAL: case BinaryOp::NOT_EQUAL: {break;}
+        default: {return result;}
+    }
+    if(!is_variable(cond.left.get(), *var)) {return result;}
+
+    // i = i + c, i = c + i или i = i - c
+    const std::string* inc_var = assigned_name(loop.increment.get());
+    if(!inc_var || *inc_var != *var) {return result;}
+    auto& inc = *static_cast<AssignmentStatement*>(loop.increment.get())->assignment;
+    if(inc.is_let || !inc.value || inc.value->type != ExpressionType::BINARY) {return result;}
+
+    auto& step = static_cast<BinaryExpr&>(*inc.value);
+    long long c = 0;
+    if(step.opcode == BinaryOp::ADD && is_variable(step.left.get(), *var) && whole_literal(step.right.get(), c))      {result.step = c;}
+    else if(step.opcode == BinaryOp::ADD && is_variable(step.right.get(), *var) && whole_literal(step.left.get(), c)) {result.step = c;}
+    else if(step.opcode == BinaryOp::SUB && is_variable(step.left.get(), *var) && whole_literal(step.right.get(), c)) {result.step = -c;}
+    else {return result;}
+
+    FunctionUsage bound = collect_expression_usage(cond.right.get(), _index, file);
+    FunctionUsage body = collect_statement_usage(loop.body.get(), _index, file);
+    if(bound.reads.count(*var) || !bound.calls.empty() || bound.dynamic_calls) {return result;}
+    if(body.writes.count(*var)) {return result;}
+
+    // неизвестный обратный вызов может читать и менять что угодно, в том числе переменную цикла
+    bool dynamic = body.dynamic_calls;
+    bool mutates = body.index_assigns || !all_pure(body.builtins);
+    std::unordered_set<std::string> touched = callee_names(body.calls, file, dynamic, mutates);
+    if(dynamic) {return result;}
+
+    // запись в переменные границы ищется по именам, а общий контейнер (массив структур, плотный массив, очередь)
+    // может расти через другую переменную: если граница читает не просто переменную или число, любая запись
+    // по индексу или изменяющий builtin в теле делают её переменной
+    bool plain_bound = cond.right->type == ExpressionType::VARIABLE || cond.right->type == ExpressionType::NUMBER;
+    bool bound_stable = all_pure(bound.builtins) && (plain_bound || !mutates);
+    for(const auto& name : bound.reads)
+    {
+        if(body.writes.count(name) || touched.count(name)) {bound_stable = false; break;}
+    }
+
+    result.valid = true;
+    result.var = *var;
+    result.cmp = cond.opcode;
+    result.bound = cond.right.get();
+    result.bound_invariant = bound_stable;
+    result.body_reads = body.reads.count(*var) > 0 || touched.count(*var) > 0;
+    result.body_writes = touched.count(*var) > 0;
+    return result;
+}
@@ -0,0 +1,49 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_LOOPANALYSIS_H
+#define BERESTALANGUAGE_LOOPANALYSIS_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "frontend/parser/Statement.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+class FunctionIndex;
+
+// for(i = a; i < b; i = i + c) с целым шагом: счётчик можно вести нативным целым, а не через окружение
+struct CountingLoop
+{
+    bool valid = false;
+    std::string var;
+    BinaryOp cmp = BinaryOp::LESS;
+    Expression* bound = nullptr;
+    long long step = 0;
+    bool bound_invariant = false;   // предел вычисляется один раз до входа в цикл
+    bool body_reads = false;        // тело или вызываемые им функции видят счётчик: пишем его в окружение перед итерацией
+    bool body_writes = false;       // вызываемые функции могут присвоить счётчик: перечитываем его после тела
+};
+
+class BERESTA_API LoopAnalysis
+{
+    public:
+        explicit LoopAnalysis(FunctionIndex& index);
+
+        const CountingLoop& counting_loop(const ForStatement& loop, const std::string& file);
+
+    private:
+        FunctionIndex& _index;
+        std::unordered_map<const ForStatement*, CountingLoop> _loops;
+
+        CountingLoop analyze(const ForStatement& loop, const std::string& file);
+        // dynamic - где-то в цепочке функция передана builtin'у не литералом, и набор имён неполон;
+        // mutates - вызываемые функции пишут по индексу или зовут builtin с побочным эффектом
+        std::unordered_set<std::string> callee_names(const std::unordered_set<std::string>& calls, const std::string& file, bool& dynamic, bool& mutates);
+};
+
+
+#endif //BERESTALANGUAGE_LOOPANALYSIS_H
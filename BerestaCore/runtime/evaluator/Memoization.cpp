@@ -0,0 +1,121 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "Memoization.h"
+#include "FunctionUsage.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include <unordered_set>
+#include <vector>
+
+MemoCache::MemoCache(std::string name, size_t capacity) : _name(std::move(name)), _capacity(capacity) {}
+
+const Value* MemoCache::find(const std::vector<Value>& args)
+{
+    auto it = _index.find(&args);
+    if(it == _index.end()) {++_stats.misses; return nullptr;}
+
+    ++_stats.hits;
+    _order.splice(_order.begin(), _order, it->second);
+    return &it->second->second;
+}
+
+void MemoCache::insert(const std::vector<Value>& args, const Value& result)
+{
+    if(_index.count(&args)) {return;}
+    // результат с общим изменяемым состоянием (плотный массив, словарь) не кешируется: иначе все вызовы получили бы один объект
+    if(!is_hashable(result)) {return;}
+
+    if(_order.size() >= _capacity)
+    {
+        _index.erase(&_order.back().first);
+        _order.pop_back();
+        ++_stats.evictions;
+    }
+
+    _order.emplace_front(args, result);
+    _index.emplace(&_order.front().first, _order.begin());
+}
+
+MemoStats MemoCache::stats() const
+{
+    MemoStats s = _stats;
+    s.size = _order.size();
+    return s;
+}
+
+Memoization& Memoization::instance()
+{
+    static Memoization inst;
+    return inst;
+}
+
+bool Memoization::check_pure(const FunctionStatement& fn, FunctionIndex& index, const std::string& file, Diagnostics& diag)
+{
+    // переменные динамические: чтение чужой переменной так же делает результат зависимым от вызывающего, как и запись
+    std::unordered_set<const FunctionStatement*> visited;
+    std::vector<std::pair<const FunctionStatement*, std::string>> pending {{&fn, file}};
+    std::string prefix = "Function '" + fn.name + "' cannot be pure: ";
+
+    while(!pending.empty())
+    {
+        auto [current, current_file] = pending.back();
+        pending.pop_back();
+        if(!visited.insert(current).second) {continue;}
+
+        FunctionUsage usage = collect_function_usage(*current, index, current_file);
+        std::string where = current == &fn ? "" : " (via '" + current->name + "')";
+
+        // генератор хранит позицию между шагами, один и тот же объект на все вызовы отдавать нельзя
+        if(current->is_generator) {diag.error(prefix + "returns a generator" + where, file, fn.line); return false;}
+
+        if(!usage.free.empty()) {diag.error(prefix + "uses outer variable '" + *usage.free.begin() + "'" + where, file, fn.line); return false;}
+
+        for(const auto& name : usage.builtins)
+        {
+            auto* impl = BuiltinRegistry::instance().get(name);
+            if(impl && !impl->is_pure()) {diag.error(prefix + "calls impure builtin '" + name + "'" + where, file, fn.line); return false;}
+        }
+
+        for(const auto& name : usage.calls)
+        {
+            if(const FunctionRef* ref = index.find_function(name, current_file)) {pending.emplace_back(ref->func, ref->file);}
+        }
+    }
+    return true;
+}
+
+MemoCache* Memoization::cache_for(FunctionStatement& fn, FunctionIndex& index, const std::string& file, Diagnostics& diag)
+{
+    if(!fn.is_pure) {return nullptr;}
+    if(fn.memo_cache) {return fn.memo_cache.get();}
+
+    if(!check_pure(fn, index, file, diag)) {fn.is_pure = false; return nullptr;}
+
+    fn.memo_cache = std::make_shared<MemoCache>(fn.name, _capacity);
+    std::erase_if(_caches, [](const std::weak_ptr<MemoCache>& c) {return c.expired();});
+    _caches.push_back(fn.memo_cache);
+    return fn.memo_cache.get();
+}
+
+MemoStats Memoization::stats() const {return collect("");}
+
+MemoStats Memoization::stats(const std::string& function) const {return collect(function);}
+
+MemoStats Memoization::collect(const std::string& function) const
+{
+    MemoStats total;
+    for(const auto& weak : _caches)
+    {
+        auto cache = weak.lock();
+        if(!cache || (!function.empty() && cache->name() != function)) {continue;}
+
+        MemoStats s = cache->stats();
+        total.hits += s.hits;
+        total.misses += s.misses;
+        total.evictions += s.evictions;
+        total.size += s.size;
+    }
+    return total;
+}
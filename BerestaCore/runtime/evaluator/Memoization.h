@@ -0,0 +1,85 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_MEMOIZATION_H
+#define BERESTALANGUAGE_MEMOIZATION_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "frontend/parser/Statement.h"
+#include "runtime/value/Value.h"
+#include "runtime/value/ValueHash.h"
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class FunctionIndex;
+
+struct MemoStats
+{
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t size = 0;
+};
+
+// LRU-кеш результатов одной pure-функции по значениям аргументов, живёт на узле FunctionStatement
+class BERESTA_API MemoCache
+{
+    public:
+        MemoCache(std::string name, size_t capacity);
+
+        [[nodiscard]] const std::string& name() const {return _name;}
+
+        // nullptr - промах; при попадании запись становится самой свежей
+        const Value* find(const std::vector<Value>& args);
+        void insert(const std::vector<Value>& args, const Value& result);
+
+        [[nodiscard]] MemoStats stats() const;
+
+    private:
+        using Entry = std::pair<std::vector<Value>, Value>;
+
+        struct KeyHash  {size_t operator()(const std::vector<Value>* k) const {return ValueHash{}(*k);}};
+        struct KeyEqual {bool operator()(const std::vector<Value>* a, const std::vector<Value>* b) const {return ValueEqual{}(*a, *b);}};
+
+        std::string _name;
+        size_t _capacity;
+        std::list<Entry> _order;
+        std::unordered_map<const std::vector<Value>*, std::list<Entry>::iterator, KeyHash, KeyEqual> _index;
+        MemoStats _stats;
+};
+
+// модификатор pure: проверка чистоты при первом вызове и счётчики всех кешей
+class BERESTA_API Memoization
+{
+    public:
+        static Memoization& instance();
+
+        // ёмкость (в записях) для кешей, которые будут созданы после вызова
+        void set_capacity(size_t entries) {_capacity = entries > 0 ? entries : 1;}
+        [[nodiscard]] size_t capacity() const {return _capacity;}
+
+        // кеш pure-функции; nullptr, если функция не pure или проверку не прошла (тогда ошибка уже в diag, а модификатор снят)
+        MemoCache* cache_for(FunctionStatement& fn, FunctionIndex& index, const std::string& file, Diagnostics& diag);
+
+        [[nodiscard]] MemoStats stats() const;
+        [[nodiscard]] MemoStats stats(const std::string& function) const;
+
+    private:
+        Memoization() = default;
+
+        size_t _capacity = 1024;
+        std::vector<std::weak_ptr<MemoCache>> _caches;
+
+        MemoStats collect(const std::string& function) const;
+        bool check_pure(const FunctionStatement& fn, FunctionIndex& index, const std::string& file, Diagnostics& diag);
+};
+
+
+#endif //BERESTALANGUAGE_MEMOIZATION_H
@@ -0,0 +1,504 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "Operators.h"
+#include "runtime/value/StructValue.h"
+#include "runtime/value/StructArray.h"
+#include "runtime/value/FlatDictionary.h"
+#include "runtime/value/ValueSet.h"
+#include "runtime/value/PersistentVector.h"
+#include "runtime/value/PackedArray.h"
+#include "runtime/value/ArraySlice.h"
+#include "runtime/value/SparseArray.h"
+#include "runtime/value/ValueDeque.h"
+#include "runtime/evaluator/Generator.h"
+#include "runtime/evaluator/FusedArrayExpr.h"
+#include <algorithm>
+#include <cmath>
+
+bool is_truthy(const Value& val)
+{
+    switch(val.type)
+    {
+        case ValueType::BOOLEAN:           {return std::get<bool>(val.data);}
+        case ValueType::INTEGER:           {return std::get<int>(val.data) != 0;}
+        case ValueType::DOUBLE:            {return std::get<double>(val.data) != 0.0;}
+        case ValueType::STRING:            {return !std::get<std::string>(val.data).empty();}
+        case ValueType::ARRAY:             {return !std::get<std::vector<Value>>(val.data).empty();}
+        case ValueType::DICTIONARY:        {return !std::get<DictionaryPtr>(val.data)->empty();}
+        case ValueType::RANGE:             {return std::get<RangeValue>(val.data).size() > 0;}
+        case ValueType::GENERATOR:         {return true;}
+        case ValueType::STRUCT_ARRAY:      {return std::get<std::shared_ptr<StructArray>>(val.data)->size() > 0;}
+        case ValueType::SET:               {return !std::get<std::shared_ptr<ValueSet>>(val.data)->empty();}
+        case ValueType::DEQUE:             {return !std::get<std::shared_ptr<ValueDeque>>(val.data)->empty();}
+        case ValueType::PERSISTENT_VECTOR: {return !std::get<std::shared_ptr<PersistentVector>>(val.data)->empty();}
+        case ValueType::PACKED_ARRAY:      {return std::get<std::shared_ptr<PackedArray>>(val.data)->size() > 0;}
+        case ValueType::ARRAY_SLICE:       {return !std::get<std::shared_ptr<ArraySlice>>(val.data)->empty();}
+        case ValueType::SPARSE_ARRAY:      {return std::get<std::shared_ptr<SparseArray>>(val.data)->size() > 0;}
+        case ValueType::NONE:              {return false;}
+        default:                           {return false;}
+    }
+}
+
+bool condition_truthy(const Value& val, Diagnostics& diag, const std::string& file, int line)
+{
+    if(!is_array(val)) {return is_truthy(val);}
+    diag.error("Condition is an array; reduce it with array_all() or array_any()", file, line);
+    return false;
+}
+
+Value apply_unary(char op, const Value& r, Diagnostics& diag, const std::string& file, int line)
+{
+    switch(op)
+    {
+        case '+':
+        {
+            if(r.type == ValueType::INTEGER) {return Value(std::get<int>(r.data));}
+            if(r.type == ValueType::DOUBLE) {return Value(std::get<double>(r.data));}
+            break;
+        }
+
+        case '-':
+        {
+            if(r.type == ValueType::INTEGER) {return Value(-std::get<int>(r.data));}
+            if(r.type == ValueType::DOUBLE) {return Value(-std::get<double>(r.data));}
+            break;
+        }
+
+        case '!':
+        {
+            bool b = is_truthy(r);
+            return Value(!b);
+        }
+    }
+
+    diag.error("Unsupported unary operand type", file, line);
+    return {};
+}
+
+Value apply_binary(BinaryOp op, const Value& lv, const Value& rv, Diagnostics& diag, const std::string& file, int line)
+{
+    // массив с числом, bool или таким же массивом - поэлементно; строка с массивом по-прежнему склеивается
+    if((is_array(lv) || is_array(rv)) && is_broadcast_op(op))
+    {
+        auto operand = [](const Value& v) {return is_array(v) || is_number(v) || v.type == ValueType::BOOLEAN;};
+        if(operand(lv) && operand(rv)) {return broadcast_binary(op, lv, rv, diag, file, line);}
+    }
+
+    auto both_nums = (lv.type == ValueType::INTEGER || lv.type == ValueType::DOUBLE) && (rv.type == ValueType::INTEGER || rv.type == ValueType::DOUBLE);
+    auto as_double = [](const Value& v)->double {return v.type == ValueType::DOUBLE ? std::get<double>(v.data) : static_cast<double>(std::get<int>(v.data));};
+
+    if(both_nums)
+    {
+        if(op == BinaryOp::MOD)
+        {
+            double r = as_double(rv);
+            if(r == 0.0) {diag.error("Modulo by zero", file, line); return {};}
+
+            if(lv.type == ValueType::INTEGER && rv.type == ValueType::INTEGER) {return Value(std::get<int>(lv.data) % std::get<int>(rv.data));}
+            return Value(std::fmod(as_double(lv), r));
+        }
+
+        double l = as_double(lv), r = as_double(rv);
+        switch(op)
+        {
+            case BinaryOp::ADD:           {return Value(l + r);}
+            case BinaryOp::SUB:           {return Value(l - r);}
+            case BinaryOp::MUL:           {return Value(l * r);}
+            case BinaryOp::DIV:           {return Value(r != 0.0 ? l / r : 0.0);}
+            case BinaryOp::EQUAL:         {return Value(l == r);}
+            case BinaryOp::NOT_EQUAL:     {return Value(l != r);}
+            case BinaryOp::LESS:          {return Value(l < r);}
+            case BinaryOp::LESS_EQUAL:    {return Value(l <= r);}
+            case BinaryOp::GREATER:       {return Value(l > r);}
+            case BinaryOp::GREATER_EQUAL: {return Value(l >= r);}
+            default:                      {break;}
+        }
+    }
+
+    if(lv.type == ValueType::BOOLEAN && rv.type == ValueType::BOOLEAN)
+    {
+        bool l = std::get<bool>(lv.data), r = std::get<bool>(rv.data);
+        switch(op)
+        {
+            case BinaryOp::EQUAL:     {return Value(l == r);}
+            case BinaryOp::NOT_EQUAL: {return Value(l != r);}
+            case BinaryOp::AND:       {return Value(l && r);}
+            case BinaryOp::OR:        {return Value(l || r);}
+            default:                  {break;}
+        }
+    }
+
+    if(op == BinaryOp::ADD && (lv.type == ValueType::STRING || rv.type == ValueType::STRING)) {return Value(lv.to_string() + rv.to_string());}
+
+    diag.error("Unsupported operand types for binary operator", file, line);
+    return {};
+}
+
+size_t array_length(const Value& v)
+{
+    switch(v.type)
+    {
+        case ValueType::ARRAY:             {return std::get<std::vector<Value>>(v.data).size();}
+        case ValueType::PERSISTENT_VECTOR: {return std::get<std::shared_ptr<PersistentVector>>(v.data)->size();}
+        case ValueType::PACKED_ARRAY:      {return std::get<std::shared_ptr<PackedArray>>(v.data)->size();}
+        case ValueType::ARRAY_SLICE:       {return std::get<std::shared_ptr<ArraySlice>>(v.data)->size();}
+        case ValueType::SPARSE_ARRAY:      {return std::get<std::shared_ptr<SparseArray>>(v.data)->size();}
+        default:                           {return 0;}
+    }
+}
+
+Value array_element(const Value& v, size_t i)
+{
+    switch(v.type)
+    {
+        case ValueType::ARRAY:             {return std::get<std::vector<Value>>(v.data)[i];}
+        case ValueType::PERSISTENT_VECTOR: {return std::get<std::shared_ptr<PersistentVector>>(v.data)->at(i);}
+        case ValueType::PACKED_ARRAY:      {return std::get<std::shared_ptr<PackedArray>>(v.data)->get(i);}
+        case ValueType::ARRAY_SLICE:       {return std::get<std::shared_ptr<ArraySlice>>(v.data)->at(i);}
+        case ValueType::SPARSE_ARRAY:      {return std::get<std::shared_ptr<SparseArray>>(v.data)->at(i);}
+        default:                           {return {};}
+    }
+}
+
+bool numeric_column(const Value& v, size_t n, std::vector<double>& out)
+{
+    if(is_number(v))
+    {
+        out.assign(n, as_number(v));
+        return true;
+    }
+
+    if(v.type == ValueType::PACKED_ARRAY)
+    {
+        const auto& arr = *std::get<std::shared_ptr<PackedArray>>(v.data);
+        if(arr.type() == PackedType::DOUBLE) {out = arr.doubles(); return true;}
+        if(arr.type() == PackedType::INT)    {out.assign(arr.ints().begin(), arr.ints().end()); return true;}
+        return false;
+    }
+
+    bool numeric = true;
+    auto take = [&](const Value& e)
+    {
+        if(!is_number(e)) {numeric = false; return;}
+        out.push_back(as_number(e));
+    };
+
+    out.clear();
+    out.reserve(n);
+    if(v.type == ValueType::PERSISTENT_VECTOR) {std::get<std::shared_ptr<PersistentVector>>(v.data)->for_each(take);}
+    else if(v.type == ValueType::ARRAY)
+    {
+        for(const auto& e : std::get<std::vector<Value>>(v.data)) {take(e);}
+    }
+    else if(v.type == ValueType::ARRAY_SLICE)
+    {
+        for(const auto& e : *std::get<std::shared_ptr<ArraySlice>>(v.data)) {take(e);}
+    }
+    else if(v.type == ValueType::SPARSE_ARRAY)
+    {
+        const auto& arr = *std::get<std::shared_ptr<SparseArray>>(v.data);
+        if(arr.populated() < arr.size()) {return false;}
+        for(size_t i = 0; i < arr.size(); ++i) {take(arr.at(i));}
+    }
+    else {return false;}
+    return numeric;
+}
+
+bool ForeachCursor::next(Value& out)
+{
+    switch(_iterable.type)
+    {
+        case ValueType::ARRAY:
+        {
+            const auto& arr = std::get<std::vector<Value>>(_iterable.data);
+            if(_index >= arr.size()) {return false;}
+            out = arr[_index++];
+            return true;
+        }
+
+        case ValueType::RANGE:
+        {
+            const auto& r = std::get<RangeValue>(_iterable.data);
+            if(_index >= static_cast<size_t>(r.size())) {return false;}
+            out = Value(r.at(static_cast<long long>(_index++)));
+            return true;
+        }
+
+        case ValueType::GENERATOR: {return std::get<std::shared_ptr<GeneratorObject>>(_iterable.data)->next(out);}
+
+        case ValueType::STRUCT_ARRAY:
+        {
+            const auto& arr = *std::get<std::shared_ptr<StructArray>>(_iterable.data);
+            if(_index >= arr.size()) {return false;}
+            out = arr.row(_index++);
+            return true;
+        }
+
+        case ValueType::PERSISTENT_VECTOR:
+        {
+            const auto& vec = *std::get<std::shared_ptr<PersistentVector>>(_iterable.data);
+            if(_index >= vec.size()) {return false;}
+            out = vec.at(_index++);
+            return true;
+        }
+
+        case ValueType::PACKED_ARRAY:
+        {
+            const auto& arr = *std::get<std::shared_ptr<PackedArray>>(_iterable.data);
+            if(_index >= arr.size()) {return false;}
+            out = arr.get(_index++);
+            return true;
+        }
+
+        case ValueType::ARRAY_SLICE:
+        {
+            const auto& slice = *std::get<std::shared_ptr<ArraySlice>>(_iterable.data);
+            if(_index >= slice.size()) {return false;}
+            out = slice.at(_index++);
+            return true;
+        }
+
+        // пропуски отдаются none, как у обычного массива
+        case ValueType::SPARSE_ARRAY:
+        {
+            const auto& arr = *std::get<std::shared_ptr<SparseArray>>(_iterable.data);
+            if(_index >= arr.size()) {return false;}
+            out = arr.at(_index++);
+            return true;
+        }
+
+        case ValueType::SET:
+        {
+            const auto& items = std::get<std::shared_ptr<ValueSet>>(_iterable.data)->items();
+            if(_index >= items.size()) {return false;}
+            out = items[_index++];
+            return true;
+        }
+
+        // обход идёт по сквозным номерам: добавленное в конец во время обхода тоже будет пройдено,
+        // а снятие спереди не сдвигает ещё не пройденные элементы
+        case ValueType::DEQUE:
+        {
+            const auto& deque = *std::get<std::shared_ptr<ValueDeque>>(_iterable.data);
+            _position = std::max(_position, deque.first());
+            if(_position - deque.first() >= static_cast<long long>(deque.size())) {return false;}
+            out = deque.at(static_cast<size_t>(_position++ - deque.first()));
+            return true;
+        }
+
+        default: {return false;}
+    }
+}
+
+Value index_value(const Value& container, const Value& idx, Diagnostics& diag, const std::string& file, int line)
+{
+    if(container.type == ValueType::ARRAY)
+    {
+        int i = 0;
+        if(idx.type == ValueType::INTEGER)     {i = std::get<int>(idx.data);}
+        else if(idx.type == ValueType::DOUBLE) {i = static_cast<int>(std::get<double>(idx.data));}
+        else                                   {diag.error("Array index must be numeric", file, line); return {};}
+
+        const auto& arr = std::get<std::vector<Value>>(container.data);
+        if(i < 0 || i >= static_cast<int>(arr.size())) {diag.error("Array index out of bounds", file, line); return {};}
+        return arr[i];
+    }
+
+    if(container.type == ValueType::PERSISTENT_VECTOR)
+    {
+        if(idx.type != ValueType::INTEGER && idx.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return {};}
+        int i = idx.type == ValueType::INTEGER ? std::get<int>(idx.data) : static_cast<int>(std::get<double>(idx.data));
+
+        const auto& vec = *std::get<std::shared_ptr<PersistentVector>>(container.data);
+        if(i < 0 || i >= static_cast<int>(vec.size())) {diag.error("Array index out of bounds", file, line); return {};}
+        return vec.at(static_cast<size_t>(i));
+    }
+
+    if(container.type == ValueType::PACKED_ARRAY)
+    {
+        if(idx.type != ValueType::INTEGER && idx.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return {};}
+        int i = idx.type == ValueType::INTEGER ? std::get<int>(idx.data) : static_cast<int>(std::get<double>(idx.data));
+
+        const auto& arr = *std::get<std::shared_ptr<PackedArray>>(container.data);
+        if(i < 0 || i >= static_cast<int>(arr.size())) {diag.error("Array index out of bounds", file, line); return {};}
+        return arr.get(static_cast<size_t>(i));
+    }
+
+    if(container.type == ValueType::ARRAY_SLICE)
+    {
+        if(idx.type != ValueType::INTEGER && idx.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return {};}
+        int i = idx.type == ValueType::INTEGER ? std::get<int>(idx.data) : static_cast<int>(std::get<double>(idx.data));
+
+        const auto& slice = *std::get<std::shared_ptr<ArraySlice>>(container.data);
+        if(i < 0 || i >= static_cast<int>(slice.size())) {diag.error("Array index out of bounds", file, line); return {};}
+        return slice.at(static_cast<size_t>(i));
+    }
+
+    if(container.type == ValueType::SPARSE_ARRAY)
+    {
+        if(idx.type != ValueType::INTEGER && idx.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return {};}
+        int i = idx.type == ValueType::INTEGER ? std::get<int>(idx.data) : static_cast<int>(std::get<double>(idx.data));
+
+        const auto& arr = *std::get<std::shared_ptr<SparseArray>>(container.data);
+        if(i < 0 || i >= static_cast<int>(arr.size())) {diag.error("Array index out of bounds", file, line); return {};}
+        return arr.at(static_cast<size_t>(i));
+    }
+
+    if(container.type == ValueType::RANGE)
+    {
+        if(idx.type != ValueType::INTEGER && idx.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return {};}
+        int i = idx.type == ValueType::INTEGER ? std::get<int>(idx.data) : static_cast<int>(std::get<double>(idx.data));
+
+        const auto& r = std::get<RangeValue>(container.data);
+        if(i < 0 || i >= r.size()) {diag.error("Array index out of bounds", file, line); return {};}
+        return Value(r.at(i));
+    }
+
+    if(container.type == ValueType::STRUCT_ARRAY)
+    {
+        if(idx.type != ValueType::INTEGER && idx.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return {};}
+        int i = idx.type == ValueType::INTEGER ? std::get<int>(idx.data) : static_cast<int>(std::get<double>(idx.data));
+
+        const auto& arr = *std::get<std::shared_ptr<StructArray>>(container.data);
+        if(i < 0 || i >= static_cast<int>(arr.size())) {diag.error("Array index out of bounds", file, line); return {};}
+        return arr.row(static_cast<size_t>(i));
+    }
+    if(container.type == ValueType::DICTIONARY)
+    {
+        std::string key = (idx.type == ValueType::STRING) ? std::get<std::string>(idx.data) : idx.to_string();
+        const auto& dict = *std::get<DictionaryPtr>(container.data);
+        const Value* found = dict.find(key);
+        if(!found) {diag.error("Key not found in dictionary: " + key, file, line); return {};}
+        return *found;
+    }
+    diag.error("Indexing not supported for this type", file, line);
+    return {};
+}
+
+bool assign_indexed(Value& container, const std::vector<Value>& indices, const Value& new_val, Diagnostics& diag, const std::string& file, int line)
+{
+    Value* cur = &container;
+
+    for(size_t level = 0; level < indices.size(); ++level)
+    {
+        const Value& idx_val = indices[level];
+        bool last = (level + 1 == indices.size());
+
+        // запись по индексу меняет массив на месте: версия переменной разворачивается в обычный массив,
+        // остальные владельцы вектора или общего хранилища среза продолжают видеть старые элементы
+        if(cur->type == ValueType::PERSISTENT_VECTOR) {*cur = Value(std::get<std::shared_ptr<PersistentVector>>(cur->data)->to_vector());}
+        if(cur->type == ValueType::ARRAY_SLICE)       {*cur = Value(std::get<std::shared_ptr<ArraySlice>>(cur->data)->to_vector());}
+
+        // запись далеко за конец не заполняет пропуск none: массив переходит в разреженную таблицу
+        if(cur->type == ValueType::ARRAY && (idx_val.type == ValueType::INTEGER || idx_val.type == ValueType::DOUBLE))
+        {
+            int i = (idx_val.type == ValueType::INTEGER) ? std::get<int>(idx_val.data) : static_cast<int>(std::get<double>(idx_val.data));
+            const auto& arr = std::get<std::vector<Value>>(cur->data);
+            if(i >= 0 && SparseArray::prefers(arr.size(), static_cast<size_t>(i))) {*cur = Value(std::make_shared<SparseArray>(arr));}
+        }
+
+        if(cur->type == ValueType::ARRAY)
+        {
+            if(idx_val.type != ValueType::INTEGER && idx_val.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return false;}
+
+            int i = (idx_val.type == ValueType::INTEGER) ? std::get<int>(idx_val.data) : static_cast<int>(std::get<double>(idx_val.data));
+            auto& arr = std::get<std::vector<Value>>(cur->data);
+            if(i < 0)                             {diag.error("Negative array index", file, line); return false;}
+            if(i >= static_cast<int>(arr.size())) {arr.resize(i + 1, Value());}
+            if(last)                              {arr[i] = new_val;}
+            else
+            {
+                if(arr[i].type == ValueType::NONE) {arr[i] = Value(std::vector<Value>{});}
+                cur = &arr[i];
+            }
+        }
+        // разреженный массив копируется при записи, как обычный при присваивании: таблица, которую делит
+        // ещё одна переменная, сначала копируется. Вложенная запись заводит ячейку под массив
+        else if(cur->type == ValueType::SPARSE_ARRAY)
+        {
+            if(idx_val.type != ValueType::INTEGER && idx_val.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return false;}
+
+            int i = (idx_val.type == ValueType::INTEGER) ? std::get<int>(idx_val.data) : static_cast<int>(std::get<double>(idx_val.data));
+            if(i < 0) {diag.error("Negative array index", file, line); return false;}
+
+            auto& table = std::get<std::shared_ptr<SparseArray>>(cur->data);
+            if(table.use_count() > 1) {table = std::make_shared<SparseArray>(*table);}
+            auto& arr = *table;
+            if(last) {arr.set(static_cast<size_t>(i), new_val);}
+            else
+            {
+                Value& slot = arr.slot(static_cast<size_t>(i));
+                if(slot.type == ValueType::NONE) {slot = Value(std::vector<Value>{});}
+                cur = &slot;
+            }
+        }
+        // плотный массив, как и разреженный, копируется при записи, если его делит ещё одна переменная;
+        // запись сразу за последним добавляет элемент, дальше - выход за границы. Вложенных массивов в нём нет
+        else if(cur->type == ValueType::PACKED_ARRAY)
+        {
+            if(idx_val.type != ValueType::INTEGER && idx_val.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return false;}
+            if(!last) {diag.error("Packed array elements are scalars", file, line); return false;}
+
+            int i = (idx_val.type == ValueType::INTEGER) ? std::get<int>(idx_val.data) : static_cast<int>(std::get<double>(idx_val.data));
+            if(i < 0) {diag.error("Negative array index", file, line); return false;}
+
+            auto& packed = std::get<std::shared_ptr<PackedArray>>(cur->data);
+            if(i > static_cast<int>(packed->size())) {diag.error("Array index out of bounds", file, line); return false;}
+            if(packed.use_count() > 1) {packed = std::make_shared<PackedArray>(*packed);}
+            auto& arr = *packed;
+            if(!arr.set(static_cast<size_t>(i), new_val)) {diag.error("Value does not fit the packed array type", file, line); return false;}
+        }
+        // элемент массива структур заменяется целиком; запись сразу за последним добавляет новый
+        else if(cur->type == ValueType::STRUCT_ARRAY)
+        {
+            if(idx_val.type != ValueType::INTEGER && idx_val.type != ValueType::DOUBLE) {diag.error("Array index must be numeric", file, line); return false;}
+            if(!last) {diag.error("Struct array elements are read-only structs", file, line); return false;}
+
+            int i = (idx_val.type == ValueType::INTEGER) ? std::get<int>(idx_val.data) : static_cast<int>(std::get<double>(idx_val.data));
+            auto& arr = *std::get<std::shared_ptr<StructArray>>(cur->data);
+            if(i < 0 || i > static_cast<int>(arr.size())) {diag.error("Array index out of bounds", file, line); return false;}
+
+            const StructInstance* inst = new_val.type == ValueType::STRUCT ? std::get<std::shared_ptr<StructInstance>>(new_val.data).get() : nullptr;
+            bool stored = inst && (i == static_cast<int>(arr.size()) ? arr.push(*inst) : arr.set_row(static_cast<size_t>(i), *inst));
+            if(!stored) {diag.error("Struct array element must be a struct of the same shape", file, line); return false;}
+        }
+        else if(cur->type == ValueType::DICTIONARY)
+        {
+            std::string key = (idx_val.type == ValueType::STRING) ? std::get<std::string>(idx_val.data) : idx_val.to_string();
+            auto& dict = *std::get<DictionaryPtr>(cur->data);
+            if(last) {dict[key] = new_val;}
+            else
+            {
+                Value* found = dict.find(key);
+                if(!found) {dict[key] = Value(std::make_shared<Dictionary>()); cur = dict.find(key);}
+                else       {cur = found;}
+            }
+        }
+        else {diag.error("Indexed assignment not supported for this type", file, line); return false;}
+    }
+
+    return true;
+}
+
+size_t struct_field_count(const Value& tmpl)
+{
+    return std::get<std::shared_ptr<StructInstance>>(tmpl.data)->definition->shape->field_names.size();
+}
+
+Value construct_struct(const Value& tmpl, const std::vector<Value>& args)
+{
+    const auto& source = std::get<std::shared_ptr<StructInstance>>(tmpl.data);
+
+    // аргументы идут в порядке полей шаблона, слот поля i - слот его имени в форме
+    auto inst = std::make_shared<StructInstance>(*source);
+    const StructShape& shape = *inst->definition->shape;
+    size_t n = std::min(shape.field_names.size(), args.size());
+    for(size_t i = 0; i < n; ++i)
+    {
+        inst->fields[shape.slot(shape.field_names[i])] = args[i];
+    }
+
+    return Value(std::move(inst));
+}
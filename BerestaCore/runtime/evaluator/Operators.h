@@ -0,0 +1,147 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_OPERATORS_H
+#define BERESTALANGUAGE_OPERATORS_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "runtime/value/Value.h"
+#include <limits>
+#include <string>
+#include <vector>
+
+// семантика операций над значениями, общая для всех режимов исполнения (Evaluator, ClosureCompiler)
+BERESTA_API bool is_truthy(const Value& val);
+// условие if/while/for: массив (например, результат поэлементного сравнения) - ошибка, а не проверка на пустоту
+BERESTA_API bool condition_truthy(const Value& val, Diagnostics& diag, const std::string& file, int line);
+
+BERESTA_API Value apply_unary(char op, const Value& r, Diagnostics& diag, const std::string& file, int line);
+BERESTA_API Value apply_binary(BinaryOp op, const Value& lv, const Value& rv, Diagnostics& diag, const std::string& file, int line);
+
+inline bool is_number(const Value& v) {return v.type == ValueType::INTEGER || v.type == ValueType::DOUBLE;}
+inline double as_number(const Value& v) {return v.type == ValueType::DOUBLE ? std::get<double>(v.data) : static_cast<double>(std::get<int>(v.data));}
+
+// and/or ленивые: правый операнд не вычисляется, если левый уже решил результат (false and ..., true or ...)
+inline bool short_circuits(BinaryOp op, const Value& lv)
+{
+    if(lv.type != ValueType::BOOLEAN) {return false;}
+    return op == BinaryOp::AND ? !std::get<bool>(lv.data) : (op == BinaryOp::OR && std::get<bool>(lv.data));
+}
+
+inline bool is_comparison(BinaryOp op)
+{
+    switch(op)
+    {
+        case BinaryOp::EQUAL: case BinaryOp::NOT_EQUAL: case BinaryOp::LESS: case BinaryOp::LESS_EQUAL: case BinaryOp::GREATER: case BinaryOp::GREATER_EQUAL: {return true;}
+        default: {return false;}
+    }
+}
+
+inline bool compare_numbers(BinaryOp op, double l, double r)
+{
+    switch(op)
+    {
+        case BinaryOp::EQUAL:         {return l == r;}
+        case BinaryOp::NOT_EQUAL:     {return l != r;}
+        case BinaryOp::LESS:          {return l < r;}
+        case BinaryOp::LESS_EQUAL:    {return l <= r;}
+        case BinaryOp::GREATER:       {return l > r;}
+        case BinaryOp::GREATER_EQUAL: {return l >= r;}
+        default:                      {return false;}
+    }
+}
+
+// сравнение в условии if/while/for: числа сравниваются сразу в bool, остальное идёт через apply_binary
+inline bool apply_condition(BinaryOp op, const Value& lv, const Value& rv, Diagnostics& diag, const std::string& file, int line)
+{
+    if(is_number(lv) && is_number(rv)) {return compare_numbers(op, as_number(lv), as_number(rv));}
+    return condition_truthy(apply_binary(op, lv, rv, diag, file, line), diag, file, line);
+}
+
+// условие, которое можно считать сразу в bool: сравнение или and/or из таких же условий
+inline bool is_fused_condition(const Expression* expr)
+{
+    if(!expr || expr->type != ExpressionType::BINARY) {return false;}
+
+    auto& bin = static_cast<const BinaryExpr&>(*expr);
+    if(is_comparison(bin.opcode)) {return true;}
+    return (bin.opcode == BinaryOp::AND || bin.opcode == BinaryOp::OR) && is_fused_condition(bin.left.get()) && is_fused_condition(bin.right.get());
+}
+
+// оператор известен заранее (ClosureCompiler, AOT): два числа считаются на месте, остальное уходит в apply_binary
+template<BinaryOp OP>
+inline Value apply_binary_fast(const Value& lv, const Value& rv, Diagnostics& diag, const std::string& file, int line)
+{
+    if constexpr(OP != BinaryOp::MOD && OP != BinaryOp::AND && OP != BinaryOp::OR && OP != BinaryOp::UNKNOWN)
+    {
+        if(is_number(lv) && is_number(rv))
+        {
+            double l = as_number(lv);
+            double r = as_number(rv);
+            if constexpr(OP == BinaryOp::ADD)           {return Value(l + r);}
+            if constexpr(OP == BinaryOp::SUB)           {return Value(l - r);}
+            if constexpr(OP == BinaryOp::MUL)           {return Value(l * r);}
+            if constexpr(OP == BinaryOp::DIV)           {return Value(r != 0.0 ? l / r : 0.0);}
+            if constexpr(OP == BinaryOp::EQUAL)         {return Value(l == r);}
+            if constexpr(OP == BinaryOp::NOT_EQUAL)     {return Value(l != r);}
+            if constexpr(OP == BinaryOp::LESS)          {return Value(l < r);}
+            if constexpr(OP == BinaryOp::LESS_EQUAL)    {return Value(l <= r);}
+            if constexpr(OP == BinaryOp::GREATER)       {return Value(l > r);}
+            if constexpr(OP == BinaryOp::GREATER_EQUAL) {return Value(l >= r);}
+        }
+    }
+    return apply_binary(OP, lv, rv, diag, file, line);
+}
+
+// массив в скрипте хранится обычным vector, постоянным вектором после функциональных правок, плотным массивом одного типа,
+// срезом общего хранилища или разреженной таблицей после записи далеко за конец
+inline bool is_array(const Value& v)
+{
+    return v.type == ValueType::ARRAY || v.type == ValueType::PERSISTENT_VECTOR || v.type == ValueType::PACKED_ARRAY || v.type == ValueType::ARRAY_SLICE
+        || v.type == ValueType::SPARSE_ARRAY;
+}
+
+// длина и элемент массива любого вида; для остальных значений длина 0
+BERESTA_API size_t array_length(const Value& v);
+BERESTA_API Value array_element(const Value& v, size_t i);
+
+// числа массива подряд в double (число растягивается на n); false, если в массиве есть не число
+BERESTA_API bool numeric_column(const Value& v, size_t n, std::vector<double>& out);
+
+// + - * / % и сравнения: для них массив поэлементно сочетается с числом или другим массивом той же длины
+inline bool is_broadcast_op(BinaryOp op) {return op != BinaryOp::AND && op != BinaryOp::OR && op != BinaryOp::UNKNOWN;}
+
+// foreach идёт по массиву, диапазону, генератору, массиву структур, множеству или очереди
+inline bool is_iterable(const Value& v)
+{
+    return is_array(v) || v.type == ValueType::RANGE || v.type == ValueType::GENERATOR || v.type == ValueType::STRUCT_ARRAY || v.type == ValueType::SET
+        || v.type == ValueType::DEQUE;
+}
+
+// элементы по одному, не зная, что именно перебирается; значение должно жить, пока идёт обход
+class BERESTA_API ForeachCursor
+{
+    public:
+        explicit ForeachCursor(const Value& iterable) : _iterable(iterable) {}
+        bool next(Value& out);
+
+    private:
+        const Value& _iterable;
+        size_t _index = 0;
+        // для очереди - сквозной номер следующего элемента (ValueDeque::first), до первого шага - минимум
+        long long _position = std::numeric_limits<long long>::min();
+};
+
+BERESTA_API Value index_value(const Value& container, const Value& idx, Diagnostics& diag, const std::string& file, int line);
+BERESTA_API bool assign_indexed(Value& container, const std::vector<Value>& indices, const Value& new_val, Diagnostics& diag, const std::string& file, int line);
+
+// вызов шаблона структуры как функции: Point(1, 2) копирует шаблон и заполняет первые поля по порядку
+BERESTA_API size_t struct_field_count(const Value& tmpl);
+BERESTA_API Value construct_struct(const Value& tmpl, const std::vector<Value>& args);
+
+
+#endif //BERESTALANGUAGE_OPERATORS_H
@@ -0,0 +1,117 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "SwitchTable.h"
+#include <algorithm>
+#include <charconv>
+
+namespace
+{
+    // строка, которую дал бы to_string() целого числа
+    bool canonical_int(const std::string& s, long long& out)
+    {
+        if(s.empty() || s.size() > 19) {return false;}
+        auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+        if(ec != std::errc() || end != s.data() + s.size()) {return false;}
+        return std::to_string(out) == s;
+    }
+}
+
+bool SwitchTable::is_constant_case(const Expression* expr)
+{
+    if(!expr) {return false;}
+
+    switch(expr->type)
+    {
+        case ExpressionType::NUMBER: case ExpressionType::STRING: case ExpressionType::BOOLEAN: {return true;}
+        case ExpressionType::UNARY:
+        {
+            auto* un = static_cast<const UnaryExpr*>(expr);
+            return un->op == '-' && un->right && un->right->type == ExpressionType::NUMBER;
+        }
+        case ExpressionType::MEMBER_ACCESS:
+        {
+            auto* member = static_cast<const MemberAccessExpr*>(expr);
+            return member->object && member->object->type == ExpressionType::VARIABLE;
+        }
+        default: {return false;}
+    }
+}
+
+std::string SwitchTable::enum_member(const Expression* expr)
+{
+    if(!expr || expr->type != ExpressionType::MEMBER_ACCESS) {return "";}
+
+    auto* member = static_cast<const MemberAccessExpr*>(expr);
+    return static_cast<const VariableExpr*>(member->object.get())->name + "." + member->member;
+}
+
+void SwitchTable::add_case(int index, const Value& value)
+{
+    long long key = 0;
+    if(value.type == ValueType::INTEGER) {_int_cases.emplace_back(std::get<int>(value.data), index); return;}
+
+    std::string text = value.to_string();
+    if(canonical_int(text, key)) {_int_cases.emplace_back(key, index);}
+    else                         {_string_cases.emplace(std::move(text), index);}
+}
+
+void SwitchTable::add_default(int index)
+{
+    if(_first_default == NO_CASE) {_first_default = index;}
+}
+
+void SwitchTable::finish()
+{
+    _ready = true;
+    if(_int_cases.empty()) {return;}
+
+    auto [lo, hi] = std::minmax_element(_int_cases.begin(), _int_cases.end());
+    long long span = hi->first - lo->first + 1;
+
+    // enum и небольшие диапазоны - плотная таблица, редкие значения - хеш
+    if(span <= static_cast<long long>(_int_cases.size()) * 2 + 16)
+    {
+        _dense_base = lo->first;
+        _dense.assign(static_cast<size_t>(span), NO_CASE);
+        for(const auto& [key, index] : _int_cases)
+        {
+            int& slot = _dense[static_cast<size_t>(key - _dense_base)];
+            if(slot == NO_CASE) {slot = index;}
+        }
+        return;
+    }
+
+    for(const auto& [key, index] : _int_cases) {_sparse.emplace(key, index);}
+}
+
+int SwitchTable::match_int(long long key) const
+{
+    if(!_dense.empty())
+    {
+        if(key < _dense_base || key - _dense_base >= static_cast<long long>(_dense.size())) {return NO_CASE;}
+        return _dense[static_cast<size_t>(key - _dense_base)];
+    }
+
+    auto it = _sparse.find(key);
+    return it == _sparse.end() ? NO_CASE : it->second;
+}
+
+int SwitchTable::match(const Value& value) const
+{
+    if(value.type == ValueType::INTEGER) {return match_int(std::get<int>(value.data));}
+
+    std::string text = value.to_string();
+    long long key = 0;
+    if(canonical_int(text, key)) {return match_int(key);}
+
+    auto it = _string_cases.find(text);
+    return it == _string_cases.end() ? NO_CASE : it->second;
+}
+
+int SwitchTable::entry(int matched) const
+{
+    if(matched != NO_CASE && (_first_default == NO_CASE || matched < _first_default)) {return matched;}
+    return _first_default;
+}
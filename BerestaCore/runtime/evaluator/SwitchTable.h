@@ -0,0 +1,54 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_SWITCHTABLE_H
+#define BERESTALANGUAGE_SWITCHTABLE_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "runtime/value/Value.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// выбор case по заранее посчитанным константам. Совпадение, как и раньше, - равенство to_string(),
+// поэтому целые ключи ("3" от 3, 3.0 и "3") идут в плотную таблицу, остальные - в хеш по строке
+class BERESTA_API SwitchTable
+{
+    public:
+        static constexpr int NO_CASE = -1;
+
+        // литерал или член enum: значение не меняется между выполнениями switch
+        static bool is_constant_case(const Expression* expr);
+
+        // "Color.RED" для члена enum, иначе пусто: такой case можно посчитать только после выполнения enum
+        static std::string enum_member(const Expression* expr);
+
+        void add_case(int index, const Value& value);
+        void add_default(int index);
+        void finish();
+
+        [[nodiscard]] bool ready() const {return _ready;}
+
+        // номер первого не-default case с таким значением или NO_CASE
+        [[nodiscard]] int match(const Value& value) const;
+
+        // с какого case начинать обход: совпавший, если перед ним нет default, иначе первый default
+        [[nodiscard]] int entry(int matched) const;
+
+    private:
+        std::vector<std::pair<long long, int>> _int_cases;
+        std::unordered_map<std::string, int> _string_cases;
+        std::unordered_map<long long, int> _sparse;
+        std::vector<int> _dense;
+        long long _dense_base = 0;
+        int _first_default = NO_CASE;
+        bool _ready = false;
+
+        int match_int(long long key) const;
+};
+
+
+#endif //BERESTALANGUAGE_SWITCHTABLE_H
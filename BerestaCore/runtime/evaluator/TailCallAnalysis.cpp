@@ -0,0 +1,53 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "TailCallAnalysis.h"
+#include "interpreter/FunctionIndex.h"
+#include <vector>
+
+TailCallAnalysis::TailCallAnalysis(FunctionIndex& index) : _index(index) {}
+
+const FunctionUsage& TailCallAnalysis::usage(const FunctionStatement& fn, const std::string& file)
+{
+    auto it = _usage.find(&fn);
+    if(it != _usage.end()) {return it->second;}
+
+    return _usage[&fn] = collect_function_usage(fn, _index, file);
+}
+
+bool TailCallAnalysis::can_reuse_frame(const FunctionStatement& caller, const std::string& caller_file, const FunctionRef& callee)
+{
+    auto key = std::make_pair(&caller, static_cast<const FunctionStatement*>(callee.func));
+    auto cached = _verdicts.find(key);
+    if(cached != _verdicts.end()) {return cached->second;}
+
+    const auto& caller_locals = usage(caller, caller_file).locals;
+
+    // обходим всё, что может выполниться внутри callee, и ищем чтение локальных caller'а
+    bool safe = true;
+    std::unordered_set<const FunctionStatement*> visited;
+    std::vector<std::pair<const FunctionStatement*, std::string>> pending {{callee.func, callee.file}};
+
+    while(safe && !pending.empty())
+    {
+        auto [fn, file] = pending.back();
+        pending.pop_back();
+        if(!visited.insert(fn).second) {continue;}
+
+        const FunctionUsage& u = usage(*fn, file);
+        if(u.dynamic_calls) {safe = false; break;}
+        for(const auto& name : u.free)
+        {
+            if(caller_locals.count(name)) {safe = false; break;}
+        }
+
+        for(const auto& name : u.calls)
+        {
+            if(const FunctionRef* ref = _index.find_function(name, file)) {pending.emplace_back(ref->func, ref->file);}
+        }
+    }
+
+    _verdicts[key] = safe;
+    return safe;
+}
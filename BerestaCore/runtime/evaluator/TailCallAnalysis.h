@@ -0,0 +1,39 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_TAILCALLANALYSIS_H
+#define BERESTALANGUAGE_TAILCALLANALYSIS_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "frontend/parser/Statement.h"
+#include "runtime/evaluator/FunctionUsage.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+class FunctionIndex;
+struct FunctionRef;
+
+// Переменные ищутся динамически по стеку скоупов, поэтому вызываемая функция видит локальные вызывающей.
+// return g(...) можно выполнить на месте кадра f, только если g и всё, что она вызывает, не обращаются к именам, локальным для f
+class BERESTA_API TailCallAnalysis
+{
+    public:
+        explicit TailCallAnalysis(FunctionIndex& index);
+
+        bool can_reuse_frame(const FunctionStatement& caller, const std::string& caller_file, const FunctionRef& callee);
+
+    private:
+        FunctionIndex& _index;
+        std::unordered_map<const FunctionStatement*, FunctionUsage> _usage;
+        std::map<std::pair<const FunctionStatement*, const FunctionStatement*>, bool> _verdicts;
+
+        const FunctionUsage& usage(const FunctionStatement& fn, const std::string& file);
+};
+
+
+#endif //BERESTALANGUAGE_TAILCALLANALYSIS_H
@@ -0,0 +1,552 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "VectorLoop.h"
+#include "runtime/evaluator/Operators.h"
+#include "runtime/builtin/functions/math/MathKernels.h"
+#include "runtime/value/PackedArray.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr size_t BLOCK = 256;
+
+    struct UnaryKernel
+    {
+        double (*f)(double);
+        bool (*domain)(double);
+    };
+
+    bool non_negative(double x) {return x >= 0.0;}
+    bool positive(double x)     {return x > 0.0;}
+    bool unit_range(double x)   {return x >= -1.0 && x <= 1.0;}
+
+    // те же math_* ядра, что у скалярных builtin'ов, с теми же проверками области
+    const std::unordered_map<std::string, UnaryKernel>& unary_kernels()
+    {
+        static const std::unordered_map<std::string, UnaryKernel> table = {
+            {"sqr", {math_sqr, nullptr}}, {"sqrt", {math_sqrt, non_negative}}, {"abs", {math_abs, nullptr}},
+            {"round", {math_round, nullptr}}, {"floor", {math_floor, nullptr}}, {"ceil", {math_ceil, nullptr}}, {"frac", {math_frac, nullptr}},
+            {"ln", {math_ln, positive}}, {"log2", {math_log2, positive}}, {"log10", {math_log10, positive}},
+            {"sin", {math_sin, nullptr}}, {"cos", {math_cos, nullptr}}, {"arctan", {math_arctan, nullptr}},
+            {"arcsin", {math_arcsin, unit_range}}, {"arccos", {math_arccos, unit_range}},
+            {"dsin", {math_dsin, nullptr}}, {"dcos", {math_dcos, nullptr}}, {"darctan", {math_darctan, nullptr}},
+            {"darcsin", {math_darcsin, unit_range}}, {"darccos", {math_darccos, unit_range}}
+        };
+        return table;
+    }
+
+    const std::unordered_map<std::string, double (*)(double, double)>& binary_kernels()
+    {
+        static const std::unordered_map<std::string, double (*)(double, double)> table = {
+            {"power", math_power}, {"min", math_min}, {"max", math_max}, {"arctan2", math_arctan2}, {"darctan2", math_darctan2},
+            {"lengthdir_x", math_lengthdir_x}, {"lengthdir_y", math_lengthdir_y}
+        };
+        return table;
+    }
+
+    double combine_add(double acc, double e)     {return acc + e;}
+    double combine_sub(double acc, double e)     {return acc - e;}
+    double combine_mul(double acc, double e)     {return acc * e;}
+    double combine_min(double acc, double e)     {return math_min(acc, e);}
+    double combine_max(double acc, double e)     {return math_max(acc, e);}
+    double combine_min_rev(double acc, double e) {return math_min(e, acc);}
+    double combine_max_rev(double acc, double e) {return math_max(e, acc);}
+
+    bool is_variable(const Expression* expr, const std::string& name)
+    {
+        return expr && expr->type == ExpressionType::VARIABLE && static_cast<const VariableExpr*>(expr)->name == name;
+    }
+
+    const std::string* variable_name(const Expression* expr)
+    {
+        if(!expr || expr->type != ExpressionType::VARIABLE) {return nullptr;}
+        return &static_cast<const VariableExpr*>(expr)->name;
+    }
+
+    int slot_of(std::vector<std::string>& names, const std::string& name)
+    {
+        auto it = std::find(names.begin(), names.end(), name);
+        if(it != names.end()) {return static_cast<int>(it - names.begin());}
+        names.push_back(name);
+        return static_cast<int>(names.size() - 1);
+    }
+
+    struct Compiler
+    {
+        VectorLoop& loop;
+        bool indexed;
+
+        bool compile(const Expression* expr, std::vector<KernelStep>& out)
+        {
+            if(!expr) {return false;}
+
+            switch(expr->type)
+            {
+                case ExpressionType::NUMBER:
+                {
+                    const Value& v = static_cast<const NumberExpr*>(expr)->value;
+                    if(!is_number(v)) {return false;}
+                    out.push_back({KernelStep::Kind::CONSTANT, as_number(v)});
+                    return true;
+                }
+
+                case ExpressionType::VARIABLE:
+                {
+                    const std::string& name = static_cast<const VariableExpr*>(expr)->name;
+                    if(name == loop.var) {out.push_back({indexed ? KernelStep::Kind::COUNTER : KernelStep::Kind::ELEMENT}); return true;}
+
+                    KernelStep step{KernelStep::Kind::SCALAR};
+                    step.slot = slot_of(loop.scalars, name);
+                    out.push_back(step);
+                    return true;
+                }
+
+                case ExpressionType::INDEX:
+                {
+                    auto* idx = static_cast<const IndexExpr*>(expr);
+                    const std::string* array = variable_name(idx->array.get());
+                    if(!indexed || !array || *array == loop.var || !is_variable(idx->index.get(), loop.var)) {return false;}
+
+                    KernelStep step{KernelStep::Kind::ARRAY_AT};
+                    step.slot = slot_of(loop.arrays, *array);
+                    out.push_back(step);
+                    return true;
+                }
+
+                case ExpressionType::UNARY:
+                {
+                    auto* un = static_cast<const UnaryExpr*>(expr);
+                    if(un->op != '-' && un->op != '+') {return false;}
+                    if(!compile(un->right.get(), out)) {return false;}
+                    if(un->op == '-') {out.push_back({KernelStep::Kind::NEGATE});}
+                    return true;
+                }
+
+                case ExpressionType::BINARY:
+                {
+                    auto* bin = static_cast<const BinaryExpr*>(expr);
+                    switch(bin->opcode)
+                    {
+                        case BinaryOp::ADD: case BinaryOp::SUB: case BinaryOp::MUL: case BinaryOp::DIV: {break;}
+                        default: {return false;}
+                    }
+                    if(!compile(bin->left.get(), out) || !compile(bin->right.get(), out)) {return false;}
+
+                    KernelStep step{KernelStep::Kind::BINARY};
+                    step.op = bin->opcode;
+                    out.push_back(step);
+                    return true;
+                }
+
+                case ExpressionType::FUNCTION_CALL:
+                {
+                    auto* call = static_cast<const FunctionCallExpr*>(expr);
+                    const std::string* name = variable_name(call->callee.get());
+                    if(!name) {return false;}
+
+                    if(call->arguments.size() == 1)
+                    {
+                        auto it = unary_kernels().find(*name);
+                        if(it == unary_kernels().end() || !compile(call->arguments[0].get(), out)) {return false;}
+
+                        KernelStep step{KernelStep::Kind::CALL1};
+                        step.f1 = it->second.f;
+                        step.domain = it->second.domain;
+                        out.push_back(step);
+                        return true;
+                    }
+
+                    if(call->arguments.size() == 2)
+                    {
+                        auto it = binary_kernels().find(*name);
+                        if(it == binary_kernels().end() || !compile(call->arguments[0].get(), out) || !compile(call->arguments[1].get(), out)) {return false;}
+
+                        KernelStep step{KernelStep::Kind::CALL2};
+                        step.f2 = it->second;
+                        out.push_back(step);
+                        return true;
+                    }
+                    return false;
+                }
+
+                default: {return false;}
+            }
+        }
+
+        // acc = acc + e, acc = e + acc, acc = acc - e, acc = acc * e, acc = e * acc, acc = min(acc, e), acc = max(e, acc) ...
+        bool reduction(const Assignment& assign, KernelStatement& out)
+        {
+            const std::string& acc = assign.name;
+            const Expression* value = assign.value.get();
+            const Expression* e = nullptr;
+            if(!value) {return false;}
+
+            if(value->type == ExpressionType::BINARY)
+            {
+                auto* bin = static_cast<const BinaryExpr*>(value);
+                bool acc_left = is_variable(bin->left.get(), acc);
+                bool acc_right = is_variable(bin->right.get(), acc);
+                switch(bin->opcode)
+                {
+                    case BinaryOp::ADD: {out.combine = combine_add; break;}
+                    case BinaryOp::MUL: {out.combine = combine_mul; break;}
+                    case BinaryOp::SUB: {out.combine = combine_sub; acc_right = false; break;}
+                    default:            {return false;}
+                }
+                if(acc_left)       {e = bin->right.get();}
+                else if(acc_right) {e = bin->left.get();}
+            }
+            else if(value->type == ExpressionType::FUNCTION_CALL)
+            {
+                auto* call = static_cast<const FunctionCallExpr*>(value);
+                const std::string* name = variable_name(call->callee.get());
+                if(!name || (*name != "min" && *name != "max") || call->arguments.size() != 2) {return false;}
+
+                bool is_min = *name == "min";
+                if(is_variable(call->arguments[0].get(), acc))
+                {
+                    e = call->arguments[1].get();
+                    out.combine = is_min ? combine_min : combine_max;
+                }
+                else if(is_variable(call->arguments[1].get(), acc))
+                {
+                    e = call->arguments[0].get();
+                    out.combine = is_min ? combine_min_rev : combine_max_rev;
+                }
+            }
+
+            out.reduce = true;
+            out.target = acc;
+            return e && compile(e, out.program);
+        }
+
+        // out[i] = e: результат должен быть double, как у арифметики и math-builtin'ов
+        bool map(const IndexAssignment& assign, KernelStatement& out)
+        {
+            if(!indexed || !assign.target || assign.target->type != ExpressionType::INDEX) {return false;}
+            auto* idx = static_cast<const IndexExpr*>(assign.target.get());
+            const std::string* array = variable_name(idx->array.get());
+            if(!array || !is_variable(idx->index.get(), loop.var)) {return false;}
+
+            const Expression* value = assign.value.get();
+            if(!value || (value->type != ExpressionType::BINARY && value->type != ExpressionType::FUNCTION_CALL)) {return false;}
+
+            out.reduce = false;
+            out.target = *array;
+            return compile(value, out.program);
+        }
+    };
+
+    bool load_number(Environment& env, const std::string& name, double& out)
+    {
+        if(!env.exists(name)) {return false;}
+        Value v = env.get(name);
+        if(!is_number(v)) {return false;}
+        out = as_number(v);
+        return true;
+    }
+
+    // for(...; i < предел; ...): предел - число, переменная или array_length(переменная)
+    bool bound_value(const Expression* bound, Environment& env, double& out)
+    {
+        if(!bound) {return false;}
+        if(bound->type == ExpressionType::NUMBER)
+        {
+            const Value& v = static_cast<const NumberExpr*>(bound)->value;
+            if(!is_number(v)) {return false;}
+            out = as_number(v);
+            return true;
+        }
+        if(const std::string* name = variable_name(bound)) {return load_number(env, *name, out);}
+
+        if(bound->type != ExpressionType::FUNCTION_CALL) {return false;}
+        auto* call = static_cast<const FunctionCallExpr*>(bound);
+        if(!is_variable(call->callee.get(), "array_length") || call->arguments.size() != 1) {return false;}
+
+        const std::string* name = variable_name(call->arguments[0].get());
+        if(!name || !env.exists(*name)) {return false;}
+        Value v = env.get(*name);
+        if(!is_array(v)) {return false;}
+        out = static_cast<double>(array_length(v));
+        return true;
+    }
+
+    bool whole(double d, long long& out)
+    {
+        if(std::trunc(d) != d || std::fabs(d) >= 1e15) {return false;}
+        out = static_cast<long long>(d);
+        return true;
+    }
+
+    struct KernelInputs
+    {
+        const double* elements = nullptr;
+        const double* counter = nullptr;
+        std::vector<double> scalars;
+        std::vector<std::vector<double>> arrays;
+    };
+
+    // false - аргумент builtin'а вне области: интерпретатор на этом месте выдал бы ошибку
+    bool run_program(const std::vector<KernelStep>& program, const KernelInputs& in, size_t n, std::vector<double>& out)
+    {
+        out.resize(n);
+        std::vector<std::vector<double>> scratch(program.size(), std::vector<double>(BLOCK));
+        std::vector<double*> stack;
+        stack.reserve(program.size());
+
+        for(size_t start = 0; start < n; start += BLOCK)
+        {
+            size_t m = std::min(BLOCK, n - start);
+            stack.clear();
+            for(size_t k = 0; k < program.size(); ++k)
+            {
+                const KernelStep& step = program[k];
+                double* dst = scratch[k].data();
+                switch(step.kind)
+                {
+                    case KernelStep::Kind::CONSTANT: {std::fill(dst, dst + m, step.value); break;}
+                    case KernelStep::Kind::SCALAR:   {std::fill(dst, dst + m, in.scalars[step.slot]); break;}
+                    case KernelStep::Kind::ELEMENT:  {std::copy(in.elements + start, in.elements + start + m, dst); break;}
+                    case KernelStep::Kind::COUNTER:  {std::copy(in.counter + start, in.counter + start + m, dst); break;}
+
+                    case KernelStep::Kind::ARRAY_AT:
+                    {
+                        const double* col = in.arrays[step.slot].data();
+                        for(size_t j = 0; j < m; ++j) {dst[j] = col[static_cast<size_t>(in.counter[start + j])];}
+                        break;
+                    }
+
+                    case KernelStep::Kind::NEGATE:
+                    {
+                        double* a = stack.back();
+                        for(size_t j = 0; j < m; ++j) {a[j] = -a[j];}
+                        continue;
+                    }
+
+                    case KernelStep::Kind::BINARY:
+                    {
+                        double* b = stack.back();
+                        stack.pop_back();
+                        double* a = stack.back();
+                        switch(step.op)
+                        {
+                            case BinaryOp::ADD: {for(size_t j = 0; j < m; ++j) {a[j] = a[j] + b[j];} break;}
+                            case BinaryOp::SUB: {for(size_t j = 0; j < m; ++j) {a[j] = a[j] - b[j];} break;}
+                            case BinaryOp::MUL: {for(size_t j = 0; j < m; ++j) {a[j] = a[j] * b[j];} break;}
+                            case BinaryOp::DIV: {for(size_t j = 0; j < m; ++j) {a[j] = b[j] != 0.0 ? a[j] / b[j] : 0.0;} break;}
+                            default:            {break;}
+                        }
+                        continue;
+                    }
+
+                    case KernelStep::Kind::CALL1:
+                    {
+                        double* a = stack.back();
+                        if(step.domain && !std::all_of(a, a + m, step.domain)) {return false;}
+                        for(size_t j = 0; j < m; ++j) {a[j] = step.f1(a[j]);}
+                        continue;
+                    }
+
+                    case KernelStep::Kind::CALL2:
+                    {
+                        double* b = stack.back();
+                        stack.pop_back();
+                        double* a = stack.back();
+                        for(size_t j = 0; j < m; ++j) {a[j] = step.f2(a[j], b[j]);}
+                        continue;
+                    }
+                }
+                stack.push_back(dst);
+            }
+            std::copy(stack.back(), stack.back() + m, out.begin() + static_cast<std::ptrdiff_t>(start));
+        }
+        return true;
+    }
+}
+
+VectorLoops::VectorLoops(FunctionIndex& index) : _counting(index) {}
+
+const VectorLoop& VectorLoops::analyze(const Statement& stmt, const std::string& var, Statement* body, bool indexed)
+{
+    auto it = _loops.find(&stmt);
+    if(it != _loops.end()) {return it->second;}
+
+    VectorLoop& loop = _loops[&stmt];
+    loop.var = var;
+    if(!body) {return loop;}
+
+    std::vector<Statement*> statements;
+    if(body->type == StatementType::BLOCK)
+    {
+        for(auto& st : static_cast<BlockStatement*>(body)->statements) {statements.push_back(st.get());}
+    }
+    else {statements.push_back(body);}
+    if(statements.empty()) {return loop;}
+
+    Compiler compiler{loop, indexed};
+    for(Statement* st : statements)
+    {
+        KernelStatement ks;
+        bool ok = false;
+        if(st->type == StatementType::ASSIGNMENT_STATEMENT)
+        {
+            auto& assign = *static_cast<AssignmentStatement*>(st)->assignment;
+            ok = !assign.is_let && compiler.reduction(assign, ks);
+        }
+        else if(st->type == StatementType::INDEX_ASSIGNMENT) {ok = compiler.map(*static_cast<IndexAssignment*>(st), ks);}
+
+        if(!ok) {loop.statements.clear(); return loop;}
+        loop.statements.push_back(std::move(ks));
+    }
+
+    // каждая запись - своя переменная, и никакое выражение тела её не читает: итерации независимы
+    std::vector<std::string> targets;
+    for(const auto& ks : loop.statements)
+    {
+        const std::string& t = ks.target;
+        bool read = std::count(loop.scalars.begin(), loop.scalars.end(), t) || std::count(loop.arrays.begin(), loop.arrays.end(), t);
+        if(t == var || read || std::count(targets.begin(), targets.end(), t)) {loop.statements.clear(); return loop;}
+        targets.push_back(t);
+    }
+
+    loop.valid = true;
+    return loop;
+}
+
+bool VectorLoops::run_for(const ForStatement& stmt, Environment& env, const std::string& file, Value& result)
+{
+    const CountingLoop& header = _counting.counting_loop(stmt, file);
+    if(!header.valid || header.step <= 0 || (header.cmp != BinaryOp::LESS && header.cmp != BinaryOp::LESS_EQUAL)) {return false;}
+
+    const VectorLoop& loop = analyze(stmt, header.var, stmt.body.get(), true);
+    if(!loop.valid) {return false;}
+
+    // предел, который пишет само тело, к началу цикла ещё не известен
+    if(const std::string* name = variable_name(header.bound))
+    {
+        for(const auto& ks : loop.statements)
+        {
+            if(ks.reduce && ks.target == *name) {return false;}
+        }
+    }
+
+    double start = 0.0;
+    double limit = 0.0;
+    long long i = 0;
+    if(!load_number(env, header.var, start) || !whole(start, i) || !bound_value(header.bound, env, limit) || !std::isfinite(limit)) {return false;}
+
+    std::vector<double> counter;
+    for(; compare_numbers(header.cmp, static_cast<double>(i), limit); i += header.step) {counter.push_back(static_cast<double>(i));}
+
+    if(!execute(loop, counter, nullptr, env, result)) {return false;}
+    if(!counter.empty()) {env.assign(header.var, Value(static_cast<double>(i)), file, stmt.line);}
+    return true;
+}
+
+bool VectorLoops::run_foreach(const ForeachStatement& stmt, const Value& iterable, Environment& env, const std::string&, Value& result)
+{
+    if(!is_array(iterable) && iterable.type != ValueType::RANGE) {return false;}
+
+    const VectorLoop& loop = analyze(stmt, stmt.var_name, stmt.body.get(), false);
+    if(!loop.valid) {return false;}
+    return execute(loop, {}, &iterable, env, result);
+}
+
+bool VectorLoops::execute(const VectorLoop& loop, const std::vector<double>& counter, const Value* elements, Environment& env, Value& result)
+{
+    KernelInputs in;
+    size_t n = counter.size();
+    std::vector<double> element_column;
+    if(elements)
+    {
+        if(elements->type == ValueType::RANGE)
+        {
+            // столбец такого диапазона не поместится в память, цикл идёт обычным путём
+            const auto& r = std::get<RangeValue>(elements->data);
+            if(r.size() > std::numeric_limits<int>::max()) {return false;}
+            n = static_cast<size_t>(r.size());
+            element_column.resize(n);
+            for(size_t k = 0; k < n; ++k) {element_column[k] = r.at(static_cast<long long>(k));}
+        }
+        else
+        {
+            n = array_length(*elements);
+            if(!numeric_column(*elements, n, element_column)) {return false;}
+        }
+        in.elements = element_column.data();
+    }
+    in.counter = counter.data();
+
+    in.scalars.resize(loop.scalars.size());
+    for(size_t s = 0; s < loop.scalars.size(); ++s)
+    {
+        if(!load_number(env, loop.scalars[s], in.scalars[s])) {return false;}
+    }
+
+    // a[i] за пределами массива - ошибка интерпретатора, её выдаст общий путь
+    in.arrays.resize(loop.arrays.size());
+    for(size_t a = 0; a < loop.arrays.size(); ++a)
+    {
+        if(!env.exists(loop.arrays[a])) {return false;}
+        Value v = env.get(loop.arrays[a]);
+        if(!is_array(v) || !numeric_column(v, array_length(v), in.arrays[a])) {return false;}
+        if(n > 0 && (counter.front() < 0.0 || counter.back() >= static_cast<double>(in.arrays[a].size()))) {return false;}
+    }
+
+    std::vector<Value> targets(loop.statements.size());
+    for(size_t s = 0; s < loop.statements.size(); ++s)
+    {
+        const KernelStatement& ks = loop.statements[s];
+        if(!env.exists(ks.target)) {return false;}
+        targets[s] = env.get(ks.target);
+
+        if(ks.reduce) {if(!is_number(targets[s])) {return false;} continue;}
+
+        const Value& t = targets[s];
+        bool packed_double = t.type == ValueType::PACKED_ARRAY && std::get<std::shared_ptr<PackedArray>>(t.data)->type() == PackedType::DOUBLE;
+        if(t.type != ValueType::ARRAY && !packed_double) {return false;}
+        if(n > 0 && (counter.front() < 0.0 || counter.back() >= static_cast<double>(array_length(t)))) {return false;}
+    }
+
+    // всё считается до первой записи: если ядро откажется, окружение останется нетронутым
+    std::vector<std::vector<double>> columns(loop.statements.size());
+    for(size_t s = 0; s < loop.statements.size(); ++s)
+    {
+        if(!run_program(loop.statements[s].program, in, n, columns[s])) {return false;}
+    }
+
+    for(size_t s = 0; s < loop.statements.size(); ++s)
+    {
+        const KernelStatement& ks = loop.statements[s];
+        const std::vector<double>& col = columns[s];
+        if(n == 0) {continue;}
+
+        if(ks.reduce)
+        {
+            double acc = as_number(targets[s]);
+            for(double e : col) {acc = ks.combine(acc, e);}
+            result = Value(acc);
+            env.assign(ks.target, result);
+            continue;
+        }
+
+        Value& t = targets[s];
+        if(t.type == ValueType::ARRAY)
+        {
+            auto& items = std::get<std::vector<Value>>(t.data);
+            for(size_t k = 0; k < n; ++k) {items[static_cast<size_t>(counter[k])] = Value(col[k]);}
+            env.assign(ks.target, t);
+        }
+        else
+        {
+            auto& arr = *std::get<std::shared_ptr<PackedArray>>(t.data);
+            for(size_t k = 0; k < n; ++k) {arr.set(static_cast<size_t>(counter[k]), Value(col[k]));}
+        }
+        result = Value(col.back());
+    }
+    return true;
+}
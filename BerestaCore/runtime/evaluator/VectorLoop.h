@@ -0,0 +1,84 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_VECTORLOOP_H
+#define BERESTALANGUAGE_VECTORLOOP_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Expression.h"
+#include "frontend/parser/Statement.h"
+#include "runtime/environment/Environment.h"
+#include "runtime/evaluator/LoopAnalysis.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FunctionIndex;
+
+// выражение тела цикла в обратной польской записи над столбцами: считается блоками без Value и окружения
+struct KernelStep
+{
+    enum class Kind
+    {
+        CONSTANT,
+        ELEMENT,        // переменная foreach
+        COUNTER,        // счётчик for
+        SCALAR,         // переменная, которую цикл не меняет: читается один раз
+        ARRAY_AT,       // a[i] по счётчику for
+        BINARY,
+        NEGATE,
+        CALL1,
+        CALL2
+    };
+
+    Kind kind;
+    double value = 0.0;
+    int slot = -1;
+    BinaryOp op = BinaryOp::UNKNOWN;
+    double (*f1)(double) = nullptr;
+    double (*f2)(double, double) = nullptr;
+    bool (*domain)(double) = nullptr;           // вне области builtin выдал бы ошибку: такой цикл уходит общим путём
+};
+
+// acc = acc + f(...) (а также -, *, min, max) или out[i] = f(...)
+struct KernelStatement
+{
+    bool reduce = true;
+    std::string target;
+    double (*combine)(double, double) = nullptr;
+    std::vector<KernelStep> program;
+};
+
+struct VectorLoop
+{
+    bool valid = false;
+    std::string var;
+    std::vector<std::string> scalars;
+    std::vector<std::string> arrays;
+    std::vector<KernelStatement> statements;
+};
+
+// цикл, тело которого - только редукции и поэлементные присваивания из арифметики и чистых math-builtin'ов,
+// без вызовов пользовательских функций и без записей, которые видит само тело: такой цикл считается нативными ядрами.
+// Вычисление повторяет язык (double, x / 0 = 0, порядок накопления слева направо), поэтому результат тот же, что у интерпретатора
+class BERESTA_API VectorLoops
+{
+    public:
+        explicit VectorLoops(FunctionIndex& index);
+
+        // false - цикл не подходит или данные оказались не числами: окружение не тронуто, цикл идёт обычным путём
+        bool run_for(const ForStatement& loop, Environment& env, const std::string& file, Value& result);
+        bool run_foreach(const ForeachStatement& loop, const Value& iterable, Environment& env, const std::string& file, Value& result);
+
+    private:
+        LoopAnalysis _counting;
+        std::unordered_map<const Statement*, VectorLoop> _loops;
+
+        const VectorLoop& analyze(const Statement& loop, const std::string& var, Statement* body, bool indexed);
+        bool execute(const VectorLoop& loop, const std::vector<double>& counter, const Value* elements, Environment& env, Value& result);
+};
+
+
+#endif //BERESTALANGUAGE_VECTORLOOP_H
@@ -0,0 +1,64 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_YIELDSTREAM_H
+#define BERESTALANGUAGE_YIELDSTREAM_H
+
+#pragma once
+#include "runtime/value/Value.h"
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// корутина, отдающая значения yield по одному; до первого next() тело не выполняется
+class YieldStream
+{
+    public:
+        struct promise_type
+        {
+            Value current;
+            std::exception_ptr error;
+
+            YieldStream get_return_object() {return YieldStream(std::coroutine_handle<promise_type>::from_promise(*this));}
+            std::suspend_always initial_suspend() noexcept {return {};}
+            std::suspend_always final_suspend() noexcept {return {};}
+            std::suspend_always yield_value(Value v) {current = std::move(v); return {};}
+            void return_void() {}
+            void unhandled_exception() {error = std::current_exception();}
+        };
+
+        YieldStream() = default;
+        YieldStream(YieldStream&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+        YieldStream& operator=(YieldStream&& other) noexcept
+        {
+            if(this != &other)
+            {
+                if(_handle) {_handle.destroy();}
+                _handle = std::exchange(other._handle, nullptr);
+            }
+            return *this;
+        }
+        YieldStream(const YieldStream&) = delete;
+        YieldStream& operator=(const YieldStream&) = delete;
+        ~YieldStream() {if(_handle) {_handle.destroy();}}
+
+        // false - тело дошло до конца; исключение из тела (break, ошибка) летит отсюда
+        bool next()
+        {
+            if(!_handle || _handle.done()) {return false;}
+            _handle.resume();
+            if(auto error = std::exchange(_handle.promise().error, nullptr)) {std::rethrow_exception(error);}
+            return !_handle.done();
+        }
+
+        [[nodiscard]] const Value& value() const {return _handle.promise().current;}
+
+    private:
+        std::coroutine_handle<promise_type> _handle;
+
+        explicit YieldStream(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+};
+
+
+#endif //BERESTALANGUAGE_YIELDSTREAM_H
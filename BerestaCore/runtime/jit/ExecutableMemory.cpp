@@ -0,0 +1,57 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "ExecutableMemory.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+ExecutableMemory::~ExecutableMemory()
+{
+    if(!_ptr) {return;}
+#ifdef _WIN32
+    VirtualFree(_ptr, 0, MEM_RELEASE);
+#else
+    munmap(_ptr, _size);
+#endif
+}
+
+bool ExecutableMemory::load(const std::vector<uint8_t>& code)
+{
+    if(_ptr || code.empty()) {return false;}
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t page = info.dwPageSize;
+#else
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    size_t size = (code.size() + page - 1) / page * page;
+
+#ifdef _WIN32
+    void* mem = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if(!mem) {return false;}
+    std::memcpy(mem, code.data(), code.size());
+
+    DWORD old = 0;
+    if(!VirtualProtect(mem, size, PAGE_EXECUTE_READ, &old)) {VirtualFree(mem, 0, MEM_RELEASE); return false;}
+    FlushInstructionCache(GetCurrentProcess(), mem, size);
+#else
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mem == MAP_FAILED) {return false;}
+    std::memcpy(mem, code.data(), code.size());
+
+    if(mprotect(mem, size, PROT_READ | PROT_EXEC) != 0) {munmap(mem, size); return false;}
+#endif
+
+    _ptr = mem;
+    _size = size;
+    return true;
+}
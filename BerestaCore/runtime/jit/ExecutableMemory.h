@@ -0,0 +1,32 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_EXECUTABLEMEMORY_H
+#define BERESTALANGUAGE_EXECUTABLEMEMORY_H
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// страницы под машинный код: пишем пока RW, потом переводим в RX (W^X)
+class ExecutableMemory
+{
+    public:
+        ExecutableMemory() = default;
+        ~ExecutableMemory();
+
+        ExecutableMemory(const ExecutableMemory&) = delete;
+        ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+
+        bool load(const std::vector<uint8_t>& code);
+        [[nodiscard]] void* entry() const {return _ptr;}
+
+    private:
+        void* _ptr = nullptr;
+        size_t _size = 0;
+};
+
+
+#endif //BERESTALANGUAGE_EXECUTABLEMEMORY_H
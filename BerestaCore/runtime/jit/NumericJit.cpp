@@ -0,0 +1,982 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "NumericJit.h"
+#include "ExecutableMemory.h"
+#include "X64Assembler.h"
+#include "frontend/parser/Expression.h"
+#include "runtime/builtin/functions/math/MathKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#if defined(BERESTA_JIT) && (defined(__x86_64__) || defined(_M_X64))
+#define BERESTA_JIT_ACTIVE 1
+#endif
+
+JitFunctionCache::~JitFunctionCache() = default;
+
+NumericJit& NumericJit::instance()
+{
+    static NumericJit jit;
+    return jit;
+}
+
+bool NumericJit::available()
+{
+#ifdef BERESTA_JIT_ACTIVE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void NumericJit::set_enabled(bool enabled) {_enabled = enabled && available();}
+
+#ifndef BERESTA_JIT_ACTIVE
+
+bool NumericJit::try_call(FunctionStatement&, const std::vector<Value>&, Value&) {return false;}
+
+#else
+
+namespace
+{
+    enum class JitType
+    {
+        UNSET,
+        INT,
+        DOUBLE,
+        BOOL,
+        NUM,        // int или double, точный тип хранится в теге переменной
+        INVALID
+    };
+
+    // сгенерированная функция: 0 - деоптимизация, иначе тип результата
+    using JitEntry = int(*)(const double* args, double* result);
+
+    constexpr int JIT_DEOPT  = 0;
+    constexpr int JIT_INT    = 1;
+    constexpr int JIT_DOUBLE = 2;
+    constexpr int JIT_BOOL   = 3;
+
+    constexpr size_t MAX_SIGNATURES = 8;
+
+    // проверки аргумента, при которых builtin пишет ошибку; в нативном коде они уводят в интерпретатор
+    enum class Guard
+    {
+        NONE,
+        NON_NEGATIVE,
+        POSITIVE,
+        UNIT
+    };
+
+    struct MathBuiltin
+    {
+        int arity;
+        const void* fn;
+        Guard guard;
+        bool strict_double;
+    };
+
+    template<typename F>
+    const void* fn_ptr(F f) {return reinterpret_cast<const void*>(f);}
+
+    double jit_fmod(double a, double b) {return std::fmod(a, b);}
+
+    const std::unordered_map<std::string, MathBuiltin>& math_builtins()
+    {
+        static const std::unordered_map<std::string, MathBuiltin> table =
+        {
+            {"sqr",             {1, fn_ptr(&math_sqr),             Guard::NONE,         false}},
+            {"sqrt",            {1, fn_ptr(&math_sqrt),            Guard::NON_NEGATIVE, false}},
+            {"abs",             {1, fn_ptr(&math_abs),             Guard::NONE,         false}},
+            {"round",           {1, fn_ptr(&math_round),           Guard::NONE,         false}},
+            {"floor",           {1, fn_ptr(&math_floor),           Guard::NONE,         false}},
+            {"ceil",            {1, fn_ptr(&math_ceil),            Guard::NONE,         false}},
+            {"frac",            {1, fn_ptr(&math_frac),            Guard::NONE,         false}},
+            {"ln",              {1, fn_ptr(&math_ln),              Guard::POSITIVE,     false}},
+            {"log2",            {1, fn_ptr(&math_log2),            Guard::POSITIVE,     false}},
+            {"log10",           {1, fn_ptr(&math_log10),           Guard::POSITIVE,     false}},
+            {"power",           {2, fn_ptr(&math_power),           Guard::NONE,         false}},
+            {"min",             {2, fn_ptr(&math_min),             Guard::NONE,         false}},
+            {"max",             {2, fn_ptr(&math_max),             Guard::NONE,         false}},
+            {"clamp",           {3, fn_ptr(&math_clamp),           Guard::NONE,         false}},
+            {"lerp",            {3, fn_ptr(&math_lerp),            Guard::NONE,         true}},
+            {"sin",             {1, fn_ptr(&math_sin),             Guard::NONE,         false}},
+            {"cos",             {1, fn_ptr(&math_cos),             Guard::NONE,         false}},
+            {"arcsin",          {1, fn_ptr(&math_arcsin),          Guard::UNIT,         false}},
+            {"arccos",          {1, fn_ptr(&math_arccos),          Guard::UNIT,         false}},
+            {"arctan",          {1, fn_ptr(&math_arctan),          Guard::NONE,         false}},
+            {"arctan2",         {2, fn_ptr(&math_arctan2),         Guard::NONE,         false}},
+            {"dsin",            {1, fn_ptr(&math_dsin),            Guard::NONE,         false}},
+            {"dcos",            {1, fn_ptr(&math_dcos),            Guard::NONE,         false}},
+            {"darcsin",         {1, fn_ptr(&math_darcsin),         Guard::UNIT,         false}},
+            {"darccos",         {1, fn_ptr(&math_darccos),         Guard::UNIT,         false}},
+            {"darctan",         {1, fn_ptr(&math_darctan),         Guard::NONE,         false}},
+            {"darctan2",        {2, fn_ptr(&math_darctan2),        Guard::NONE,         false}},
+            {"point_direction", {4, fn_ptr(&math_point_direction), Guard::NONE,         false}},
+            {"point_distance",  {4, fn_ptr(&math_point_distance),  Guard::NONE,         false}},
+            {"lengthdir_x",     {2, fn_ptr(&math_lengthdir_x),     Guard::NONE,         false}},
+            {"lengthdir_y",     {2, fn_ptr(&math_lengthdir_y),     Guard::NONE,         false}},
+        };
+        return table;
+    }
+
+    bool is_numeric(JitType t) {return t == JitType::INT || t == JitType::DOUBLE || t == JitType::NUM;}
+
+    JitType join(JitType a, JitType b)
+    {
+        if(a == JitType::UNSET) {return b;}
+        if(b == JitType::UNSET) {return a;}
+        if(a == b)              {return a;}
+        if(is_numeric(a) && is_numeric(b)) {return JitType::NUM;}
+        return JitType::INVALID;
+    }
+
+    bool is_comparison(BinaryOp op)
+    {
+        return op == BinaryOp::EQUAL || op == BinaryOp::NOT_EQUAL || op == BinaryOp::LESS || op == BinaryOp::LESS_EQUAL || op == BinaryOp::GREATER || op == BinaryOp::GREATER_EQUAL;
+    }
+
+    // разрешает имена в слоты и выводит статические типы переменных; всё, что не подходит, отдаётся интерпретатору
+    class FunctionAnalyzer
+    {
+        public:
+            FunctionAnalyzer(const FunctionStatement& fn, const std::string& signature) : _fn(fn), _signature(signature) {}
+
+            std::vector<JitType> types;
+            std::unordered_map<const Expression*, int> refs;
+            std::unordered_map<const Assignment*, int> defs;
+
+            bool run()
+            {
+                auto* body = dynamic_cast<const BlockStatement*>(_fn.body.get());
+                if(!body || body->statements.empty() || !body->statements.back() || body->statements.back()->type != StatementType::RETURN) {return false;}
+
+                _scopes.emplace_back();
+                for(size_t i = 0; i < _fn.parameters.size(); ++i)
+                {
+                    int id = declare(_fn.parameters[i]);
+                    char c = _signature[i];
+                    types[id] = c == 'i' ? JitType::INT : c == 'd' ? JitType::DOUBLE : JitType::BOOL;
+                }
+
+                if(!resolve(_fn.body.get())) {return false;}
+
+                for(int pass = 0; pass < 8; ++pass)
+                {
+                    bool changed = false;
+                    for(const auto* as : _assignments)
+                    {
+                        JitType t = type_of(as->value.get());
+                        if(t == JitType::INVALID) {return false;}
+
+                        int id = defs.at(as);
+                        JitType joined = join(types[id], t);
+                        if(joined == JitType::INVALID) {return false;}
+                        if(joined != types[id]) {types[id] = joined; changed = true;}
+                    }
+                    if(!changed) {break;}
+                }
+
+                for(const auto* as : _assignments)
+                {
+                    JitType t = type_of(as->value.get());
+                    if(t == JitType::UNSET || t == JitType::INVALID) {return false;}
+                }
+                for(const auto* e : _checked)
+                {
+                    JitType t = type_of(e);
+                    if(t == JitType::UNSET || t == JitType::INVALID) {return false;}
+                }
+                for(const auto* e : _numeric)
+                {
+                    if(!is_numeric(type_of(e))) {return false;}
+                }
+                return true;
+            }
+
+            JitType type_of(const Expression* e) const
+            {
+                switch(e->type)
+                {
+                    case ExpressionType::NUMBER:   {return static_cast<const NumberExpr*>(e)->value.type == ValueType::INTEGER ? JitType::INT : JitType::DOUBLE;}
+                    case ExpressionType::BOOLEAN:  {return JitType::BOOL;}
+                    case ExpressionType::VARIABLE: {return types[refs.at(e)];}
+
+                    case ExpressionType::UNARY:
+                    {
+                        auto* un = static_cast<const UnaryExpr*>(e);
+                        JitType r = type_of(un->right.get());
+                        if(r == JitType::UNSET || r == JitType::INVALID) {return r;}
+                        if(un->op == '!')                                {return JitType::BOOL;}
+                        if(un->op == '-' || un->op == '+')               {return r == JitType::INT || r == JitType::DOUBLE ? r : JitType::INVALID;}
+                        return JitType::INVALID;
+                    }
+
+                    case ExpressionType::BINARY:
+                    {
+                        auto* bin = static_cast<const BinaryExpr*>(e);
+                        JitType l = type_of(bin->left.get());
+                        JitType r = type_of(bin->right.get());
+                        if(l == JitType::INVALID || r == JitType::INVALID) {return JitType::INVALID;}
+                        if(l == JitType::UNSET || r == JitType::UNSET)     {return JitType::UNSET;}
+
+                        if(is_numeric(l) && is_numeric(r))
+                        {
+                            switch(bin->opcode)
+                            {
+                                case BinaryOp::ADD: case BinaryOp::SUB: case BinaryOp::MUL: case BinaryOp::DIV: {return JitType::DOUBLE;}
+                                case BinaryOp::MOD:
+                                {
+                                    if(l == JitType::DOUBLE || r == JitType::DOUBLE) {return JitType::DOUBLE;}
+                                    if(l == JitType::INT && r == JitType::INT)       {return JitType::INT;}
+                                    return JitType::NUM;
+                                }
+                                default: {return is_comparison(bin->opcode) ? JitType::BOOL : JitType::INVALID;}
+                            }
+                        }
+
+                        if(l == JitType::BOOL && r == JitType::BOOL)
+                        {
+                            switch(bin->opcode)
+                            {
+                                case BinaryOp::EQUAL: case BinaryOp::NOT_EQUAL: case BinaryOp::AND: case BinaryOp::OR: {return JitType::BOOL;}
+                                default: {return JitType::INVALID;}
+                            }
+                        }
+                        return JitType::INVALID;
+                    }
+
+                    case ExpressionType::FUNCTION_CALL:
+                    {
+                        auto* call = static_cast<const FunctionCallExpr*>(e);
+                        const auto& info = math_builtins().at(static_cast<const VariableExpr*>(call->callee.get())->name);
+
+                        bool pending = false;
+                        for(const auto& a : call->arguments)
+                        {
+                            JitType t = type_of(a.get());
+                            if(t == JitType::INVALID) {return JitType::INVALID;}
+                            if(t == JitType::UNSET)   {pending = true; continue;}
+                            if(!is_numeric(t) || (info.strict_double && t != JitType::DOUBLE)) {return JitType::INVALID;}
+                        }
+                        if(pending) {return JitType::UNSET;}
+                        return JitType::DOUBLE;
+                    }
+
+                    default: {return JitType::INVALID;}
+                }
+            }
+
+        private:
+            const FunctionStatement& _fn;
+            const std::string& _signature;
+            std::vector<std::unordered_map<std::string, int>> _scopes;
+            std::vector<const Assignment*> _assignments;
+            std::vector<const Expression*> _checked;
+            std::vector<const Expression*> _numeric;
+            int _loop_depth = 0;
+
+            int declare(const std::string& name)
+            {
+                int id = static_cast<int>(types.size());
+                types.push_back(JitType::UNSET);
+                _scopes.back()[name] = id;
+                return id;
+            }
+
+            int lookup(const std::string& name) const
+            {
+                for(auto it = _scopes.rbegin(); it != _scopes.rend(); ++it)
+                {
+                    auto found = it->find(name);
+                    if(found != it->end()) {return found->second;}
+                }
+                return -1;
+            }
+
+            // тело ветки или цикла без фигурных скобок тоже получает свою область, чтобы let не утёк наружу
+            bool resolve_scoped(const Statement* s)
+            {
+                _scopes.emplace_back();
+                bool ok = resolve(s);
+                _scopes.pop_back();
+                return ok;
+            }
+
+            bool resolve_loop_body(const Statement* s)
+            {
+                ++_loop_depth;
+                bool ok = resolve_scoped(s);
+                --_loop_depth;
+                return ok;
+            }
+
+            bool resolve(const Statement* s)
+            {
+                if(!s) {return true;}
+
+                switch(s->type)
+                {
+                    case StatementType::BLOCK:
+                    {
+                        _scopes.emplace_back();
+                        for(const auto& st : static_cast<const BlockStatement*>(s)->statements)
+                        {
+                            if(!resolve(st.get())) {return false;}
+                        }
+                        _scopes.pop_back();
+                        return true;
+                    }
+
+                    case StatementType::ASSIGNMENT:
+                    {
+                        auto* as = static_cast<const Assignment*>(s);
+                        if(!resolve(as->value.get())) {return false;}
+
+                        int id = as->is_let ? declare(as->name) : lookup(as->name);
+                        if(id < 0) {return false;}
+
+                        defs[as] = id;
+                        _assignments.push_back(as);
+                        return true;
+                    }
+
+                    case StatementType::ASSIGNMENT_STATEMENT: {return resolve(static_cast<const AssignmentStatement*>(s)->assignment.get());}
+
+                    case StatementType::EXPRESSION:
+                    {
+                        auto* e = static_cast<const ExpressionStatement*>(s)->expression.get();
+                        _checked.push_back(e);
+                        return resolve(e);
+                    }
+
+                    case StatementType::IF:
+                    {
+                        auto* st = static_cast<const IfStatement*>(s);
+                        _checked.push_back(st->condition.get());
+                        return resolve(st->condition.get()) && resolve_scoped(st->then_branch.get()) && resolve_scoped(st->else_branch.get());
+                    }
+
+                    case StatementType::WHILE:
+                    {
+                        auto* st = static_cast<const WhileStatement*>(s);
+                        _checked.push_back(st->condition.get());
+                        return resolve(st->condition.get()) && resolve_loop_body(st->body.get());
+                    }
+
+                    case StatementType::REPEAT:
+                    {
+                        auto* st = static_cast<const RepeatStatement*>(s);
+                        _numeric.push_back(st->count.get());
+                        return resolve(st->count.get()) && resolve_loop_body(st->body.get());
+                    }
+
+                    case StatementType::FOR:
+                    {
+                        auto* st = static_cast<const ForStatement*>(s);
+                        _scopes.emplace_back();
+                        bool ok = resolve(st->initializer.get());
+                        if(ok && st->condition) {_checked.push_back(st->condition.get()); ok = resolve(st->condition.get());}
+                        ok = ok && resolve_loop_body(st->body.get()) && resolve(st->increment.get());
+                        _scopes.pop_back();
+                        return ok;
+                    }
+
+                    case StatementType::RETURN:
+                    {
+                        auto* e = static_cast<const ReturnStatement*>(s)->value.get();
+                        if(!e) {return false;}
+                        _checked.push_back(e);
+                        return resolve(e);
+                    }
+
+                    case StatementType::BREAK:
+                    case StatementType::CONTINUE: {return _loop_depth > 0;}
+
+                    default: {return false;}
+                }
+            }
+
+            bool resolve(const Expression* e)
+            {
+                if(!e) {return false;}
+
+                switch(e->type)
+                {
+                    case ExpressionType::NUMBER:
+                    case ExpressionType::BOOLEAN: {return true;}
+
+                    case ExpressionType::VARIABLE:
+                    {
+                        int id = lookup(static_cast<const VariableExpr*>(e)->name);
+                        if(id < 0) {return false;}
+                        refs[e] = id;
+                        return true;
+                    }
+
+                    case ExpressionType::UNARY:  {return resolve(static_cast<const UnaryExpr*>(e)->right.get());}
+
+                    case ExpressionType::BINARY:
+                    {
+                        auto* bin = static_cast<const BinaryExpr*>(e);
+                        return resolve(bin->left.get()) && resolve(bin->right.get());
+                    }
+
+                    case ExpressionType::FUNCTION_CALL:
+                    {
+                        auto* call = static_cast<const FunctionCallExpr*>(e);
+                        auto* callee = dynamic_cast<const VariableExpr*>(call->callee.get());
+                        if(!callee) {return false;}
+
+                        auto it = math_builtins().find(callee->name);
+                        if(it == math_builtins().end() || it->second.arity != static_cast<int>(call->arguments.size())) {return false;}
+
+                        for(const auto& a : call->arguments)
+                        {
+                            if(!resolve(a.get())) {return false;}
+                        }
+                        return true;
+                    }
+
+                    default: {return false;}
+                }
+            }
+    };
+
+    // переменные и временные значения лежат в слотах кадра, вычисление идёт через xmm0/xmm1
+    class CodeGen
+    {
+        public:
+            explicit CodeGen(const FunctionAnalyzer& an) : _an(an) {}
+
+            std::vector<uint8_t> generate(const FunctionStatement& fn, const std::string& signature)
+            {
+                _result_tag = alloc();
+                for(JitType t : _an.types)
+                {
+                    _value_slot.push_back(alloc());
+                    _tag_slot.push_back(t == JitType::NUM ? alloc() : -1);
+                }
+
+                _deopt = _as.new_label();
+                _exit = _as.new_label();
+
+                _as.prologue();
+                _as.mov_rbx_arg(0);
+                for(size_t i = 0; i < fn.parameters.size(); ++i)
+                {
+                    _as.movsd_load_rbx(Xmm::XMM0, static_cast<int>(8 * i));
+                    _as.movsd_store(disp(_value_slot[i]), Xmm::XMM0);
+                    if(_tag_slot[i] >= 0) {_as.mov_slot_imm(disp(_tag_slot[i]), signature[i] == 'd' ? 1 : 0);}
+                }
+                _as.mov_rbx_arg(1);
+
+                stmt(fn.body.get());
+
+                _as.bind(_deopt);
+                _as.mov_eax_imm(JIT_DEOPT);
+                _as.bind(_exit);
+                _as.epilogue();
+
+                int frame = 8 * _max_slots + 32;
+                if(frame % 16 == 0) {frame += 8;}
+                _as.set_frame_size(frame);
+
+                return _as.code();
+            }
+
+        private:
+            struct Operand
+            {
+                JitType type;
+                int tag_slot;
+            };
+
+            struct Loop
+            {
+                X64Assembler::Label brk;
+                X64Assembler::Label cont;
+            };
+
+            X64Assembler _as;
+            const FunctionAnalyzer& _an;
+            std::vector<int> _value_slot;
+            std::vector<int> _tag_slot;
+            std::vector<Loop> _loops;
+            X64Assembler::Label _deopt = -1;
+            X64Assembler::Label _exit = -1;
+            int _result_tag = -1;
+            int _slots = 0;
+            int _max_slots = 0;
+
+            static int disp(int slot) {return -16 - 8 * slot;}
+
+            int alloc()
+            {
+                int s = _slots++;
+                _max_slots = std::max(_max_slots, _slots);
+                return s;
+            }
+
+            void release(int count) {_slots -= count;}
+
+            // xmm0 - проверяемое значение, прыжок если оно "ложно" (0, но не NaN)
+            void branch_if_false(X64Assembler::Label target)
+            {
+                X64Assembler::Label cont = _as.new_label();
+                _as.xorpd(Xmm::XMM1, Xmm::XMM1);
+                _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                _as.jcc(Cond::P, cont);
+                _as.jcc(Cond::E, target);
+                _as.bind(cont);
+            }
+
+            void bool_from_al()
+            {
+                _as.movzx_eax_al();
+                _as.cvtsi2sd_eax(Xmm::XMM0);
+            }
+
+            void emit_guard(Guard guard)
+            {
+                switch(guard)
+                {
+                    case Guard::NONE: {return;}
+
+                    case Guard::NON_NEGATIVE:
+                    {
+                        _as.xorpd(Xmm::XMM1, Xmm::XMM1);
+                        _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                        _as.jcc(Cond::B, _deopt);
+                        return;
+                    }
+
+                    case Guard::POSITIVE:
+                    {
+                        _as.xorpd(Xmm::XMM1, Xmm::XMM1);
+                        _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                        _as.jcc(Cond::BE, _deopt);
+                        return;
+                    }
+
+                    case Guard::UNIT:
+                    {
+                        _as.load_const(Xmm::XMM1, -1.0);
+                        _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                        _as.jcc(Cond::B, _deopt);
+                        _as.load_const(Xmm::XMM1, 1.0);
+                        _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                        _as.jcc(Cond::A, _deopt);
+                        return;
+                    }
+                }
+            }
+
+            Operand expr(const Expression* e)
+            {
+                switch(e->type)
+                {
+                    case ExpressionType::NUMBER:
+                    {
+                        const Value& v = static_cast<const NumberExpr*>(e)->value;
+                        bool is_int = v.type == ValueType::INTEGER;
+                        _as.load_const(Xmm::XMM0, is_int ? static_cast<double>(std::get<int>(v.data)) : std::get<double>(v.data));
+                        return {is_int ? JitType::INT : JitType::DOUBLE, -1};
+                    }
+
+                    case ExpressionType::BOOLEAN:
+                    {
+                        _as.load_const(Xmm::XMM0, static_cast<const BoolExpr*>(e)->value ? 1.0 : 0.0);
+                        return {JitType::BOOL, -1};
+                    }
+
+                    case ExpressionType::VARIABLE:
+                    {
+                        int id = _an.refs.at(e);
+                        _as.movsd_load(Xmm::XMM0, disp(_value_slot[id]));
+                        return {_an.types[id], _tag_slot[id]};
+                    }
+
+                    case ExpressionType::UNARY:
+                    {
+                        auto* un = static_cast<const UnaryExpr*>(e);
+                        Operand r = expr(un->right.get());
+                        if(un->op == '-')
+                        {
+                            _as.load_const(Xmm::XMM1, -0.0);
+                            _as.xorpd(Xmm::XMM0, Xmm::XMM1);
+                        }
+                        else if(un->op == '!')
+                        {
+                            _as.xorpd(Xmm::XMM1, Xmm::XMM1);
+                            _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                            _as.setcc_al(Cond::E);
+                            _as.setcc_cl(Cond::NP);
+                            _as.and_al_cl();
+                            bool_from_al();
+                            return {JitType::BOOL, -1};
+                        }
+                        return {r.type, -1};
+                    }
+
+                    case ExpressionType::BINARY:        {return binary(*static_cast<const BinaryExpr*>(e));}
+                    case ExpressionType::FUNCTION_CALL: {return call(*static_cast<const FunctionCallExpr*>(e));}
+                    default:                            {return {JitType::INVALID, -1};}
+                }
+            }
+
+            Operand binary(const BinaryExpr& bin)
+            {
+                Operand l = expr(bin.left.get());
+                int tmp = alloc();
+                _as.movsd_store(disp(tmp), Xmm::XMM0);
+
+                // тег левого операнда может лежать в _result_tag, правый операнд его перезапишет
+                int left_tag = -1;
+                if(l.type == JitType::NUM)
+                {
+                    left_tag = alloc();
+                    _as.mov_rax_slot(disp(l.tag_slot));
+                    _as.mov_slot_rax(disp(left_tag));
+                }
+
+                Operand r = expr(bin.right.get());
+                _as.movsd(Xmm::XMM1, Xmm::XMM0);
+                _as.movsd_load(Xmm::XMM0, disp(tmp));
+                if(bin.opcode == BinaryOp::MOD)
+                {
+                    if(left_tag >= 0) {_as.mov_rax_slot(disp(left_tag));}
+                    else              {_as.xor_eax_eax();}
+                    if(r.type == JitType::NUM) {_as.or_rax_slot(disp(r.tag_slot));}
+                }
+                release(left_tag >= 0 ? 2 : 1);
+
+                switch(bin.opcode)
+                {
+                    case BinaryOp::ADD: {_as.addsd(Xmm::XMM0, Xmm::XMM1); return {JitType::DOUBLE, -1};}
+                    case BinaryOp::SUB: {_as.subsd(Xmm::XMM0, Xmm::XMM1); return {JitType::DOUBLE, -1};}
+                    case BinaryOp::MUL: {_as.mulsd(Xmm::XMM0, Xmm::XMM1); return {JitType::DOUBLE, -1};}
+
+                    case BinaryOp::DIV:
+                    {
+                        // деление на ноль в Beresta даёт 0.0
+                        X64Assembler::Label do_div = _as.new_label(), done = _as.new_label();
+                        _as.xorpd(Xmm::XMM2, Xmm::XMM2);
+                        _as.ucomisd(Xmm::XMM1, Xmm::XMM2);
+                        _as.jcc(Cond::P, do_div);
+                        _as.jcc(Cond::NE, do_div);
+                        _as.xorpd(Xmm::XMM0, Xmm::XMM0);
+                        _as.jmp(done);
+                        _as.bind(do_div);
+                        _as.divsd(Xmm::XMM0, Xmm::XMM1);
+                        _as.bind(done);
+                        return {JitType::DOUBLE, -1};
+                    }
+
+                    case BinaryOp::MOD:
+                    {
+                        if(l.type == JitType::INT && r.type == JitType::INT)       {int_mod(); return {JitType::INT, -1};}
+                        if(l.type == JitType::DOUBLE || r.type == JitType::DOUBLE) {float_mod(); return {JitType::DOUBLE, -1};}
+
+                        // int % int остаётся int, иначе fmod; какой путь - решают теги (rax = tag_l | tag_r)
+                        X64Assembler::Label as_float = _as.new_label(), done = _as.new_label();
+                        _as.test_rax();
+                        _as.jcc(Cond::NE, as_float);
+                        int_mod();
+                        _as.mov_slot_imm(disp(_result_tag), 0);
+                        _as.jmp(done);
+                        _as.bind(as_float);
+                        float_mod();
+                        _as.mov_slot_imm(disp(_result_tag), 1);
+                        _as.bind(done);
+                        return {JitType::NUM, _result_tag};
+                    }
+
+                    case BinaryOp::EQUAL:
+                    {
+                        _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                        _as.setcc_al(Cond::E);
+                        _as.setcc_cl(Cond::NP);
+                        _as.and_al_cl();
+                        break;
+                    }
+
+                    case BinaryOp::NOT_EQUAL:
+                    {
+                        _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                        _as.setcc_al(Cond::NE);
+                        _as.setcc_cl(Cond::P);
+                        _as.or_al_cl();
+                        break;
+                    }
+
+                    case BinaryOp::LESS:          {_as.ucomisd(Xmm::XMM1, Xmm::XMM0); _as.setcc_al(Cond::A);  break;}
+                    case BinaryOp::LESS_EQUAL:    {_as.ucomisd(Xmm::XMM1, Xmm::XMM0); _as.setcc_al(Cond::AE); break;}
+                    case BinaryOp::GREATER:       {_as.ucomisd(Xmm::XMM0, Xmm::XMM1); _as.setcc_al(Cond::A);  break;}
+                    case BinaryOp::GREATER_EQUAL: {_as.ucomisd(Xmm::XMM0, Xmm::XMM1); _as.setcc_al(Cond::AE); break;}
+
+                    // bool хранится как 0.0/1.0, побитовые and/or над ними дают тот же 0.0/1.0
+                    case BinaryOp::AND: {_as.andpd(Xmm::XMM0, Xmm::XMM1); return {JitType::BOOL, -1};}
+                    case BinaryOp::OR:  {_as.orpd(Xmm::XMM0, Xmm::XMM1);  return {JitType::BOOL, -1};}
+
+                    default: {return {JitType::INVALID, -1};}
+                }
+
+                bool_from_al();
+                return {JitType::BOOL, -1};
+            }
+
+            // xmm0 % xmm1 для двух int; деление на ноль отдаётся интерпретатору ради его ошибки
+            void int_mod()
+            {
+                X64Assembler::Label do_div = _as.new_label(), done = _as.new_label();
+                _as.cvttsd2si_eax(Xmm::XMM0);
+                _as.cvttsd2si_ecx(Xmm::XMM1);
+                _as.test_ecx();
+                _as.jcc(Cond::E, _deopt);
+                _as.cmp_ecx_imm8(-1);
+                _as.jcc(Cond::NE, do_div);
+                _as.xorpd(Xmm::XMM0, Xmm::XMM0);
+                _as.jmp(done);
+                _as.bind(do_div);
+                _as.cdq_idiv_ecx();
+                _as.cvtsi2sd_edx(Xmm::XMM0);
+                _as.bind(done);
+            }
+
+            void float_mod()
+            {
+                X64Assembler::Label ok = _as.new_label();
+                _as.xorpd(Xmm::XMM2, Xmm::XMM2);
+                _as.ucomisd(Xmm::XMM1, Xmm::XMM2);
+                _as.jcc(Cond::P, ok);
+                _as.jcc(Cond::E, _deopt);
+                _as.bind(ok);
+                _as.call(fn_ptr(&jit_fmod));
+            }
+
+            Operand call(const FunctionCallExpr& call)
+            {
+                const auto& info = math_builtins().at(static_cast<const VariableExpr*>(call.callee.get())->name);
+
+                int n = static_cast<int>(call.arguments.size());
+                int base = _slots;
+                for(int i = 0; i < n; ++i)
+                {
+                    expr(call.arguments[i].get());
+                    _as.movsd_store(disp(alloc()), Xmm::XMM0);
+                }
+
+                for(int i = n - 1; i >= 0; --i)
+                {
+                    _as.movsd_load(static_cast<Xmm>(i), disp(base + i));
+                }
+                release(n);
+
+                emit_guard(info.guard);
+                _as.call(info.fn);
+                return {JitType::DOUBLE, -1};
+            }
+
+            void stmt(const Statement* s)
+            {
+                if(!s) {return;}
+
+                switch(s->type)
+                {
+                    case StatementType::BLOCK:
+                    {
+                        for(const auto& st : static_cast<const BlockStatement*>(s)->statements) {stmt(st.get());}
+                        return;
+                    }
+
+                    case StatementType::ASSIGNMENT:
+                    {
+                        auto* as = static_cast<const Assignment*>(s);
+                        int id = _an.defs.at(as);
+                        Operand r = expr(as->value.get());
+                        _as.movsd_store(disp(_value_slot[id]), Xmm::XMM0);
+
+                        int tag = _tag_slot[id];
+                        if(tag < 0) {return;}
+                        if(r.type == JitType::NUM) {_as.mov_rax_slot(disp(r.tag_slot)); _as.mov_slot_rax(disp(tag));}
+                        else                       {_as.mov_slot_imm(disp(tag), r.type == JitType::DOUBLE ? 1 : 0);}
+                        return;
+                    }
+
+                    case StatementType::ASSIGNMENT_STATEMENT: {stmt(static_cast<const AssignmentStatement*>(s)->assignment.get()); return;}
+                    case StatementType::EXPRESSION:           {expr(static_cast<const ExpressionStatement*>(s)->expression.get()); return;}
+
+                    case StatementType::IF:
+                    {
+                        auto* st = static_cast<const IfStatement*>(s);
+                        X64Assembler::Label else_label = _as.new_label(), end = _as.new_label();
+                        expr(st->condition.get());
+                        branch_if_false(else_label);
+                        stmt(st->then_branch.get());
+                        _as.jmp(end);
+                        _as.bind(else_label);
+                        stmt(st->else_branch.get());
+                        _as.bind(end);
+                        return;
+                    }
+
+                    case StatementType::WHILE:
+                    {
+                        auto* st = static_cast<const WhileStatement*>(s);
+                        X64Assembler::Label top = _as.new_label(), end = _as.new_label();
+                        _as.bind(top);
+                        expr(st->condition.get());
+                        branch_if_false(end);
+                        _loops.push_back({end, top});
+                        stmt(st->body.get());
+                        _loops.pop_back();
+                        _as.jmp(top);
+                        _as.bind(end);
+                        return;
+                    }
+
+                    case StatementType::REPEAT:
+                    {
+                        auto* st = static_cast<const RepeatStatement*>(s);
+                        int count = alloc(), counter = alloc();
+                        X64Assembler::Label top = _as.new_label(), cont = _as.new_label(), end = _as.new_label();
+
+                        expr(st->count.get());
+                        _as.cvttsd2si_eax(Xmm::XMM0);
+                        _as.cvtsi2sd_eax(Xmm::XMM0);
+                        _as.movsd_store(disp(count), Xmm::XMM0);
+                        _as.xorpd(Xmm::XMM0, Xmm::XMM0);
+                        _as.movsd_store(disp(counter), Xmm::XMM0);
+
+                        _as.bind(top);
+                        _as.movsd_load(Xmm::XMM0, disp(counter));
+                        _as.movsd_load(Xmm::XMM1, disp(count));
+                        _as.ucomisd(Xmm::XMM0, Xmm::XMM1);
+                        _as.jcc(Cond::AE, end);
+
+                        _loops.push_back({end, cont});
+                        stmt(st->body.get());
+                        _loops.pop_back();
+
+                        _as.bind(cont);
+                        _as.movsd_load(Xmm::XMM0, disp(counter));
+                        _as.load_const(Xmm::XMM1, 1.0);
+                        _as.addsd(Xmm::XMM0, Xmm::XMM1);
+                        _as.movsd_store(disp(counter), Xmm::XMM0);
+                        _as.jmp(top);
+                        _as.bind(end);
+                        release(2);
+                        return;
+                    }
+
+                    case StatementType::FOR:
+                    {
+                        auto* st = static_cast<const ForStatement*>(s);
+                        X64Assembler::Label top = _as.new_label(), cont = _as.new_label(), end = _as.new_label();
+
+                        stmt(st->initializer.get());
+                        _as.bind(top);
+                        if(st->condition)
+                        {
+                            expr(st->condition.get());
+                            branch_if_false(end);
+                        }
+
+                        _loops.push_back({end, cont});
+                        stmt(st->body.get());
+                        _loops.pop_back();
+
+                        _as.bind(cont);
+                        stmt(st->increment.get());
+                        _as.jmp(top);
+                        _as.bind(end);
+                        return;
+                    }
+
+                    case StatementType::RETURN:
+                    {
+                        Operand r = expr(static_cast<const ReturnStatement*>(s)->value.get());
+                        _as.movsd_store_rbx(0, Xmm::XMM0);
+
+                        if(r.type == JitType::NUM)
+                        {
+                            _as.mov_rax_slot(disp(r.tag_slot));
+                            _as.add_eax_imm8(JIT_INT);
+                        }
+                        else {_as.mov_eax_imm(r.type == JitType::INT ? JIT_INT : r.type == JitType::DOUBLE ? JIT_DOUBLE : JIT_BOOL);}
+
+                        _as.jmp(_exit);
+                        return;
+                    }
+
+                    case StatementType::BREAK:    {_as.jmp(_loops.back().brk); return;}
+                    case StatementType::CONTINUE: {_as.jmp(_loops.back().cont); return;}
+                    default:                      {return;}
+                }
+            }
+    };
+
+    std::unique_ptr<ExecutableMemory> compile(const FunctionStatement& fn, const std::string& signature)
+    {
+        FunctionAnalyzer analyzer(fn, signature);
+        if(!analyzer.run()) {return nullptr;}
+
+        CodeGen gen(analyzer);
+        auto code = gen.generate(fn, signature);
+
+        auto mem = std::make_unique<ExecutableMemory>();
+        if(!mem->load(code)) {return nullptr;}
+        return mem;
+    }
+}
+
+bool NumericJit::try_call(FunctionStatement& fn, const std::vector<Value>& args, Value& out)
+{
+    if(args.size() != fn.parameters.size()) {return false;}
+
+    std::string signature;
+    std::vector<double> packed;
+    signature.reserve(args.size());
+    packed.reserve(args.size());
+
+    for(const auto& a : args)
+    {
+        switch(a.type)
+        {
+            case ValueType::INTEGER: {signature.push_back('i'); packed.push_back(static_cast<double>(std::get<int>(a.data))); break;}
+            case ValueType::DOUBLE:  {signature.push_back('d'); packed.push_back(std::get<double>(a.data)); break;}
+            case ValueType::BOOLEAN: {signature.push_back('b'); packed.push_back(std::get<bool>(a.data) ? 1.0 : 0.0); break;}
+            default:                 {return false;}
+        }
+    }
+
+    if(!fn.jit_cache) {fn.jit_cache = std::make_shared<JitFunctionCache>();}
+    auto& entries = fn.jit_cache->entries;
+
+    auto it = std::find_if(entries.begin(), entries.end(), [&](const JitFunctionCache::Entry& e) {return e.signature == signature;});
+    if(it == entries.end())
+    {
+        if(entries.size() >= MAX_SIGNATURES) {return false;}
+
+        entries.push_back({signature, compile(fn, signature)});
+        it = entries.end() - 1;
+        if(it->code) {++_compiled;}
+    }
+    if(!it->code) {return false;}
+
+    double result = 0.0;
+    auto entry = reinterpret_cast<JitEntry>(it->code->entry());
+    switch(entry(packed.data(), &result))
+    {
+        case JIT_INT:    {out = Value(static_cast<int>(result)); return true;}
+        case JIT_DOUBLE: {out = Value(result); return true;}
+        case JIT_BOOL:   {out = Value(result != 0.0); return true;}
+        default:         {return false;}
+    }
+}
+
+#endif
@@ -0,0 +1,57 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_NUMERICJIT_H
+#define BERESTALANGUAGE_NUMERICJIT_H
+
+#pragma once
+#include "api/Export.h"
+#include "frontend/parser/Statement.h"
+#include "runtime/value/Value.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class ExecutableMemory;
+
+// машинный код одной функции под конкретный набор типов аргументов ('i', 'd', 'b')
+struct JitFunctionCache
+{
+    struct Entry
+    {
+        std::string signature;
+        std::unique_ptr<ExecutableMemory> code;
+    };
+
+    std::vector<Entry> entries;
+
+    ~JitFunctionCache();
+};
+
+// базовый JIT-уровень: чисто числовые FunctionStatement компилируются в x86-64, всё остальное исполняет интерпретатор
+class BERESTA_API NumericJit
+{
+    public:
+        static NumericJit& instance();
+
+        // собран ли JIT в эту сборку (опция BERESTA_JIT и x86-64)
+        [[nodiscard]] static bool available();
+
+        void set_enabled(bool enabled);
+        [[nodiscard]] bool enabled() const {return _enabled;}
+
+        // true, если функция отработала в нативном коде и результат записан в out; false - исполнять интерпретатором
+        bool try_call(FunctionStatement& fn, const std::vector<Value>& args, Value& out);
+
+        [[nodiscard]] size_t compiled_count() const {return _compiled;}
+
+    private:
+        NumericJit() = default;
+
+        bool _enabled = false;
+        size_t _compiled = 0;
+};
+
+
+#endif //BERESTALANGUAGE_NUMERICJIT_H
@@ -0,0 +1,182 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "X64Assembler.h"
+#include <cstring>
+
+X64Assembler::Label X64Assembler::new_label()
+{
+    _label_pos.push_back(-1);
+    return static_cast<Label>(_label_pos.size() - 1);
+}
+
+void X64Assembler::bind(Label label)
+{
+    int pos = static_cast<int>(_code.size());
+    _label_pos[label] = pos;
+
+    for(auto it = _fixups.begin(); it != _fixups.end();)
+    {
+        if(it->second != label) {++it; continue;}
+        int32_t rel = pos - (it->first + 4);
+        std::memcpy(&_code[it->first], &rel, 4);
+        it = _fixups.erase(it);
+    }
+}
+
+void X64Assembler::rel32_to(Label label)
+{
+    int at = static_cast<int>(_code.size());
+    if(_label_pos[label] >= 0) {imm32(_label_pos[label] - (at + 4)); return;}
+    _fixups.emplace_back(at, label);
+    imm32(0);
+}
+
+void X64Assembler::jmp(Label label)
+{
+    byte(0xE9);
+    rel32_to(label);
+}
+
+void X64Assembler::jcc(Cond cond, Label label)
+{
+    byte(0x0F);
+    byte(0x80 | static_cast<uint8_t>(cond));
+    rel32_to(label);
+}
+
+void X64Assembler::prologue()
+{
+    byte(0x55);                         // push rbp
+    byte(0x48); byte(0x89); byte(0xE5); // mov rbp, rsp
+    byte(0x53);                         // push rbx
+    byte(0x48); byte(0x81); byte(0xEC); // sub rsp, imm32
+    _frame_patch = static_cast<int>(_code.size());
+    imm32(0);
+}
+
+void X64Assembler::set_frame_size(int bytes)
+{
+    int32_t v = bytes;
+    std::memcpy(&_code[_frame_patch], &v, 4);
+}
+
+void X64Assembler::epilogue()
+{
+    byte(0x48); byte(0x8D); byte(0x65); byte(0xF8); // lea rsp, [rbp - 8]
+    byte(0x5B);                                     // pop rbx
+    byte(0x5D);                                     // pop rbp
+    byte(0xC3);                                     // ret
+}
+
+void X64Assembler::mov_rbx_arg(int index)
+{
+#ifdef _WIN32
+    static constexpr uint8_t regs[] = {1, 2};   // rcx, rdx
+#else
+    static constexpr uint8_t regs[] = {7, 6};   // rdi, rsi
+#endif
+    byte(0x48); byte(0x89); byte(0xC0 | (regs[index] << 3) | 3);
+}
+
+void X64Assembler::imm32(int32_t v)
+{
+    uint8_t b[4];
+    std::memcpy(b, &v, 4);
+    _code.insert(_code.end(), b, b + 4);
+}
+
+void X64Assembler::mem_rbp(uint8_t reg, int disp)
+{
+    byte(0x80 | (reg << 3) | 5);
+    imm32(disp);
+}
+
+void X64Assembler::mem_rbx(uint8_t reg, int disp)
+{
+    byte(0x80 | (reg << 3) | 3);
+    imm32(disp);
+}
+
+void X64Assembler::sse(uint8_t prefix, uint8_t op, Xmm dst, Xmm src)
+{
+    byte(prefix); byte(0x0F); byte(op);
+    byte(0xC0 | (static_cast<uint8_t>(dst) << 3) | static_cast<uint8_t>(src));
+}
+
+void X64Assembler::movsd_load(Xmm dst, int disp)
+{
+    byte(0xF2); byte(0x0F); byte(0x10);
+    mem_rbp(static_cast<uint8_t>(dst), disp);
+}
+
+void X64Assembler::movsd_store(int disp, Xmm src)
+{
+    byte(0xF2); byte(0x0F); byte(0x11);
+    mem_rbp(static_cast<uint8_t>(src), disp);
+}
+
+void X64Assembler::movsd_load_rbx(Xmm dst, int disp)
+{
+    byte(0xF2); byte(0x0F); byte(0x10);
+    mem_rbx(static_cast<uint8_t>(dst), disp);
+}
+
+void X64Assembler::movsd_store_rbx(int disp, Xmm src)
+{
+    byte(0xF2); byte(0x0F); byte(0x11);
+    mem_rbx(static_cast<uint8_t>(src), disp);
+}
+
+void X64Assembler::movsd(Xmm dst, Xmm src) {sse(0xF2, 0x10, dst, src);}
+
+void X64Assembler::load_const(Xmm dst, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, 8);
+
+    byte(0x48); byte(0xB8);             // mov rax, imm64
+    for(int i = 0; i < 8; ++i) {byte(static_cast<uint8_t>(bits >> (8 * i)));}
+
+    byte(0x66); byte(0x48); byte(0x0F); byte(0x6E); // movq xmm, rax
+    byte(0xC0 | (static_cast<uint8_t>(dst) << 3));
+}
+
+void X64Assembler::setcc_al(Cond cond) {byte(0x0F); byte(0x90 | static_cast<uint8_t>(cond)); byte(0xC0);}
+void X64Assembler::setcc_cl(Cond cond) {byte(0x0F); byte(0x90 | static_cast<uint8_t>(cond)); byte(0xC1);}
+void X64Assembler::and_al_cl()         {byte(0x20); byte(0xC8);}
+void X64Assembler::or_al_cl()          {byte(0x08); byte(0xC8);}
+void X64Assembler::movzx_eax_al()      {byte(0x0F); byte(0xB6); byte(0xC0);}
+
+void X64Assembler::cvtsi2sd_eax(Xmm dst)  {byte(0xF2); byte(0x0F); byte(0x2A); byte(0xC0 | (static_cast<uint8_t>(dst) << 3));}
+void X64Assembler::cvtsi2sd_edx(Xmm dst)  {byte(0xF2); byte(0x0F); byte(0x2A); byte(0xC2 | (static_cast<uint8_t>(dst) << 3));}
+void X64Assembler::cvttsd2si_eax(Xmm src) {byte(0xF2); byte(0x0F); byte(0x2C); byte(0xC0 | static_cast<uint8_t>(src));}
+void X64Assembler::cvttsd2si_ecx(Xmm src) {byte(0xF2); byte(0x0F); byte(0x2C); byte(0xC8 | static_cast<uint8_t>(src));}
+
+void X64Assembler::test_ecx()                {byte(0x85); byte(0xC9);}
+void X64Assembler::cmp_ecx_imm8(int8_t imm)  {byte(0x83); byte(0xF9); byte(static_cast<uint8_t>(imm));}
+void X64Assembler::cdq_idiv_ecx()            {byte(0x99); byte(0xF7); byte(0xF9);}
+void X64Assembler::mov_eax_imm(int32_t imm)  {byte(0xB8); imm32(imm);}
+void X64Assembler::add_eax_imm8(int8_t imm)  {byte(0x83); byte(0xC0); byte(static_cast<uint8_t>(imm));}
+
+void X64Assembler::mov_slot_imm(int disp, int32_t imm)
+{
+    byte(0x48); byte(0xC7);
+    mem_rbp(0, disp);
+    imm32(imm);
+}
+
+void X64Assembler::mov_rax_slot(int disp) {byte(0x48); byte(0x8B); mem_rbp(0, disp);}
+void X64Assembler::mov_slot_rax(int disp) {byte(0x48); byte(0x89); mem_rbp(0, disp);}
+void X64Assembler::or_rax_slot(int disp)  {byte(0x48); byte(0x0B); mem_rbp(0, disp);}
+void X64Assembler::test_rax()             {byte(0x48); byte(0x85); byte(0xC0);}
+void X64Assembler::xor_eax_eax()          {byte(0x31); byte(0xC0);}
+
+void X64Assembler::call(const void* fn)
+{
+    uint64_t addr = reinterpret_cast<uint64_t>(fn);
+    byte(0x48); byte(0xB8);             // mov rax, imm64
+    for(int i = 0; i < 8; ++i) {byte(static_cast<uint8_t>(addr >> (8 * i)));}
+    byte(0xFF); byte(0xD0);             // call rax
+}
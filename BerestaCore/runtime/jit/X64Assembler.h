@@ -0,0 +1,108 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_X64ASSEMBLER_H
+#define BERESTALANGUAGE_X64ASSEMBLER_H
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+enum class Xmm : uint8_t
+{
+    XMM0,
+    XMM1,
+    XMM2,
+    XMM3
+};
+
+// коды условий для jcc/setcc после ucomisd/cmp
+enum class Cond : uint8_t
+{
+    B  = 0x2,
+    AE = 0x3,
+    E  = 0x4,
+    NE = 0x5,
+    BE = 0x6,
+    A  = 0x7,
+    P  = 0xA,
+    NP = 0xB
+};
+
+// ровно тот набор инструкций x86-64, который нужен NumericJit; все адреса в кадре считаются от rbp
+class X64Assembler
+{
+    public:
+        using Label = int;
+
+        Label new_label();
+        void bind(Label label);
+        void jmp(Label label);
+        void jcc(Cond cond, Label label);
+
+        // push rbp; mov rbp, rsp; push rbx; sub rsp, <размер кадра>
+        void prologue();
+        void set_frame_size(int bytes);
+        void epilogue();
+        void mov_rbx_arg(int index);
+
+        void movsd_load(Xmm dst, int disp);
+        void movsd_store(int disp, Xmm src);
+        void movsd_load_rbx(Xmm dst, int disp);
+        void movsd_store_rbx(int disp, Xmm src);
+        void movsd(Xmm dst, Xmm src);
+        void load_const(Xmm dst, double value);
+
+        void addsd(Xmm dst, Xmm src)   {sse(0xF2, 0x58, dst, src);}
+        void subsd(Xmm dst, Xmm src)   {sse(0xF2, 0x5C, dst, src);}
+        void mulsd(Xmm dst, Xmm src)   {sse(0xF2, 0x59, dst, src);}
+        void divsd(Xmm dst, Xmm src)   {sse(0xF2, 0x5E, dst, src);}
+        void sqrtsd(Xmm dst, Xmm src)  {sse(0xF2, 0x51, dst, src);}
+        void ucomisd(Xmm a, Xmm b)     {sse(0x66, 0x2E, a, b);}
+        void xorpd(Xmm dst, Xmm src)   {sse(0x66, 0x57, dst, src);}
+        void andpd(Xmm dst, Xmm src)   {sse(0x66, 0x54, dst, src);}
+        void orpd(Xmm dst, Xmm src)    {sse(0x66, 0x56, dst, src);}
+
+        void setcc_al(Cond cond);
+        void setcc_cl(Cond cond);
+        void and_al_cl();
+        void or_al_cl();
+        void movzx_eax_al();
+        void cvtsi2sd_eax(Xmm dst);
+        void cvtsi2sd_edx(Xmm dst);
+        void cvttsd2si_eax(Xmm src);
+        void cvttsd2si_ecx(Xmm src);
+
+        void test_ecx();
+        void cmp_ecx_imm8(int8_t imm);
+        void cdq_idiv_ecx();
+        void mov_eax_imm(int32_t imm);
+        void add_eax_imm8(int8_t imm);
+        void mov_slot_imm(int disp, int32_t imm);
+        void mov_rax_slot(int disp);
+        void mov_slot_rax(int disp);
+        void or_rax_slot(int disp);
+        void test_rax();
+        void xor_eax_eax();
+
+        void call(const void* fn);
+
+        [[nodiscard]] const std::vector<uint8_t>& code() const {return _code;}
+
+    private:
+        std::vector<uint8_t> _code;
+        std::vector<int> _label_pos;
+        std::vector<std::pair<int, Label>> _fixups;
+        int _frame_patch = -1;
+
+        void byte(uint8_t b) {_code.push_back(b);}
+        void imm32(int32_t v);
+        void sse(uint8_t prefix, uint8_t op, Xmm dst, Xmm src);
+        void mem_rbp(uint8_t reg, int disp);
+        void mem_rbx(uint8_t reg, int disp);
+        void rel32_to(Label label);
+};
+
+
+#endif //BERESTALANGUAGE_X64ASSEMBLER_H
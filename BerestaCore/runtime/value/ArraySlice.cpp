@@ -0,0 +1,18 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "ArraySlice.h"
+#include <algorithm>
+
+ArraySlice::ArraySlice(std::vector<Value> items)
+    : _storage(std::make_shared<const std::vector<Value>>(std::move(items))), _offset(0), _size(_storage->size()) {}
+
+ArraySlice::ArraySlice(std::shared_ptr<const std::vector<Value>> storage, size_t offset, size_t size)
+    : _storage(std::move(storage)), _offset(offset), _size(size) {}
+
+ArraySlice ArraySlice::slice(size_t from, size_t count) const
+{
+    from = std::min(from, _size);
+    return {_storage, _offset + from, std::min(count, _size - from)};
+}
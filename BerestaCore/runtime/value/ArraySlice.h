@@ -0,0 +1,39 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_ARRAYSLICE_H
+#define BERESTALANGUAGE_ARRAYSLICE_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/Value.h"
+#include <memory>
+#include <vector>
+
+// окно [offset, offset + size) в общем хранилище элементов. Хранилище не меняется после создания, поэтому
+// срез среза и копии переменной делят его без копирования; запись по индексу разворачивает срез в обычный массив
+class BERESTA_API ArraySlice
+{
+    public:
+        explicit ArraySlice(std::vector<Value> items);
+        ArraySlice(std::shared_ptr<const std::vector<Value>> storage, size_t offset, size_t size);
+
+        [[nodiscard]] size_t size() const {return _size;}
+        [[nodiscard]] bool empty() const {return _size == 0;}
+        [[nodiscard]] const Value& at(size_t i) const {return (*_storage)[_offset + i];}
+        [[nodiscard]] const Value* begin() const {return _storage->data() + _offset;}
+        [[nodiscard]] const Value* end() const {return begin() + _size;}
+
+        // from и count обрезаются по границам среза
+        [[nodiscard]] ArraySlice slice(size_t from, size_t count) const;
+        [[nodiscard]] std::vector<Value> to_vector() const {return {begin(), end()};}
+
+    private:
+        std::shared_ptr<const std::vector<Value>> _storage;
+        size_t _offset = 0;
+        size_t _size = 0;
+};
+
+
+#endif //BERESTALANGUAGE_ARRAYSLICE_H
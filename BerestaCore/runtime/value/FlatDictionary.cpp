@@ -0,0 +1,178 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "FlatDictionary.h"
+#include <bit>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define BERESTA_DICT_SSE2 1
+#endif
+
+namespace
+{
+    // 16 байтов контроля, начиная со слота; бит i маски - слот start + i
+    struct ProbeGroup
+    {
+        const uint8_t* bytes;
+
+        [[nodiscard]] uint32_t match(uint8_t value) const
+        {
+#ifdef BERESTA_DICT_SSE2
+            __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(value)))));
+#else
+            uint32_t mask = 0;
+            for(uint32_t i = 0; i < 16; ++i) {mask |= static_cast<uint32_t>(bytes[i] == value) << i;}
+            return mask;
+#endif
+        }
+
+        // EMPTY и DELETED - единственные байты контроля со старшим битом
+        [[nodiscard]] uint32_t match_free() const
+        {
+#ifdef BERESTA_DICT_SSE2
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes))));
+#else
+            uint32_t mask = 0;
+            for(uint32_t i = 0; i < 16; ++i) {mask |= static_cast<uint32_t>(bytes[i] >> 7) << i;}
+            return mask;
+#endif
+        }
+    };
+
+    uint8_t short_hash(size_t hash) {return static_cast<uint8_t>(hash & 0x7F);}
+}
+
+long FlatDictionary::find_slot(const std::string& key, size_t hash) const
+{
+    if(_capacity == 0) {return -1;}
+
+    size_t mask = _capacity - 1;
+    size_t pos = (hash >> 7) & mask;
+    for(size_t probed = 0; probed < _capacity; probed += GROUP)
+    {
+        ProbeGroup group {_control.data() + pos};
+        for(uint32_t bits = group.match(short_hash(hash)); bits; bits &= bits - 1)
+        {
+            size_t slot = (pos + static_cast<size_t>(std::countr_zero(bits))) & mask;
+            const Entry& e = _entries[_slots[slot]];
+            if(e.hash == hash && e.key == key) {return static_cast<long>(slot);}
+        }
+
+        if(group.match(EMPTY)) {return -1;}
+        pos = (pos + GROUP) & mask;
+    }
+    return -1;
+}
+
+Value* FlatDictionary::find(const std::string& key)
+{
+    long slot = find_slot(key, std::hash<std::string>{}(key));
+    return slot < 0 ? nullptr : &_entries[_slots[slot]].value;
+}
+
+const Value* FlatDictionary::find(const std::string& key) const
+{
+    long slot = find_slot(key, std::hash<std::string>{}(key));
+    return slot < 0 ? nullptr : &_entries[_slots[slot]].value;
+}
+
+Value& FlatDictionary::operator[](const std::string& key)
+{
+    size_t hash = std::hash<std::string>{}(key);
+    long found = find_slot(key, hash);
+    if(found >= 0) {return _entries[_slots[found]].value;}
+
+    // заполнение держим не выше 7/8, удалённые слоты тоже мешают пробам
+    if((_size + _deleted + 1) * 8 > _capacity * 7) {rehash(std::max<size_t>(GROUP, _capacity * ((_size + 1) * 2 > _capacity ? 2 : 1)));}
+
+    size_t mask = _capacity - 1;
+    size_t pos = (hash >> 7) & mask;
+    while(true)
+    {
+        uint32_t bits = ProbeGroup {_control.data() + pos}.match_free();
+        if(bits)
+        {
+            size_t slot = (pos + static_cast<size_t>(std::countr_zero(bits))) & mask;
+            if(_control[slot] == DELETED) {--_deleted;}
+            set_control(slot, short_hash(hash));
+            _slots[slot] = static_cast<uint32_t>(_entries.size());
+            _entries.push_back({key, Value(), hash, true});
+            ++_size;
+            return _entries.back().value;
+        }
+        pos = (pos + GROUP) & mask;
+    }
+}
+
+bool FlatDictionary::erase(const std::string& key)
+{
+    long slot = find_slot(key, std::hash<std::string>{}(key));
+    if(slot < 0) {return false;}
+
+    Entry& e = _entries[_slots[slot]];
+    e.alive = false;
+    e.key.clear();
+    e.value = Value();
+    set_control(static_cast<size_t>(slot), DELETED);
+    --_size;
+    ++_deleted;
+
+    // мёртвых записей больше, чем живых: порядок уплотняем той же перестройкой
+    if(_deleted > GROUP && _deleted > _size) {rehash(_capacity);}
+    return true;
+}
+
+void FlatDictionary::clear()
+{
+    _entries.clear();
+    _control.clear();
+    _slots.clear();
+    _capacity = 0;
+    _size = 0;
+    _deleted = 0;
+}
+
+void FlatDictionary::set_control(size_t slot, uint8_t value)
+{
+    _control[slot] = value;
+    if(slot < GROUP) {_control[_capacity + slot] = value;}
+}
+
+void FlatDictionary::rehash(size_t capacity)
+{
+    // живые записи сохраняют порядок, хеши берутся из записей, строки заново не хешируются
+    std::vector<Entry> entries;
+    entries.reserve(_size);
+    for(auto& e : _entries)
+    {
+        if(e.alive) {entries.push_back(std::move(e));}
+    }
+
+    _entries = std::move(entries);
+    _capacity = capacity;
+    _control.assign(_capacity + GROUP, EMPTY);
+    _slots.assign(_capacity, 0);
+    _deleted = 0;
+
+    size_t mask = _capacity - 1;
+    for(size_t i = 0; i < _entries.size(); ++i)
+    {
+        size_t pos = (_entries[i].hash >> 7) & mask;
+        while(true)
+        {
+            uint32_t bits = ProbeGroup {_control.data() + pos}.match_free();
+            if(bits)
+            {
+                size_t slot = (pos + static_cast<size_t>(std::countr_zero(bits))) & mask;
+                set_control(slot, short_hash(_entries[i].hash));
+                _slots[slot] = static_cast<uint32_t>(i);
+                break;
+            }
+            pos = (pos + GROUP) & mask;
+        }
+    }
+}
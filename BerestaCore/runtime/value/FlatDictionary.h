@@ -0,0 +1,84 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_FLATDICTIONARY_H
+#define BERESTALANGUAGE_FLATDICTIONARY_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/Value.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// словарь с открытой адресацией: записи лежат подряд в порядке вставки, а таблица слотов хранит только
+// их номера и по байту контроля на слот (7 бит хеша). Поиск сравнивает сразу группу из 16 байтов контроля,
+// строки сравниваются только при совпадении этих бит и полного хеша, который хранится в записи
+class BERESTA_API FlatDictionary
+{
+    public:
+        struct Entry
+        {
+            std::string key;
+            Value value;
+            size_t hash = 0;
+            bool alive = true;
+        };
+
+        template<typename E>
+        class Cursor
+        {
+            public:
+                Cursor(E* at, E* end) : _at(at), _end(end) {skip();}
+                E& operator*() const {return *_at;}
+                E* operator->() const {return _at;}
+                Cursor& operator++() {++_at; skip(); return *this;}
+                bool operator!=(const Cursor& other) const {return _at != other._at;}
+
+            private:
+                E* _at;
+                E* _end;
+
+                void skip() {while(_at != _end && !_at->alive) {++_at;}}
+        };
+
+        using iterator = Cursor<Entry>;
+        using const_iterator = Cursor<const Entry>;
+
+        [[nodiscard]] size_t size() const {return _size;}
+        [[nodiscard]] bool empty() const {return _size == 0;}
+
+        [[nodiscard]] Value* find(const std::string& key);
+        [[nodiscard]] const Value* find(const std::string& key) const;
+        [[nodiscard]] bool contains(const std::string& key) const {return find(key) != nullptr;}
+
+        // отсутствующий ключ добавляется в конец порядка со значением none
+        Value& operator[](const std::string& key);
+        bool erase(const std::string& key);
+        void clear();
+
+        iterator begin() {return {_entries.data(), _entries.data() + _entries.size()};}
+        iterator end() {return {_entries.data() + _entries.size(), _entries.data() + _entries.size()};}
+        [[nodiscard]] const_iterator begin() const {return {_entries.data(), _entries.data() + _entries.size()};}
+        [[nodiscard]] const_iterator end() const {return {_entries.data() + _entries.size(), _entries.data() + _entries.size()};}
+
+    private:
+        static constexpr size_t GROUP = 16;
+        static constexpr uint8_t EMPTY = 0x80;
+        static constexpr uint8_t DELETED = 0xFE;
+
+        std::vector<Entry> _entries;
+        std::vector<uint8_t> _control;      // capacity + GROUP: первые GROUP байтов повторены в хвосте для чтения группы без переноса
+        std::vector<uint32_t> _slots;       // номер записи для занятого слота
+        size_t _capacity = 0;
+        size_t _size = 0;
+        size_t _deleted = 0;                // слоты DELETED, они же мёртвые записи до следующей перестройки
+
+        long find_slot(const std::string& key, size_t hash) const;
+        void set_control(size_t slot, uint8_t value);
+        void rehash(size_t capacity);
+};
+
+
+#endif //BERESTALANGUAGE_FLATDICTIONARY_H
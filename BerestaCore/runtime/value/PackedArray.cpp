@@ -0,0 +1,283 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "PackedArray.h"
+#include "ValueSort.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define BERESTA_PACKED_SSE2 1
+#endif
+
+namespace
+{
+    long find_double(const double* p, size_t n, double x)
+    {
+        size_t i = 0;
+#ifdef BERESTA_PACKED_SSE2
+        __m128d needle = _mm_set1_pd(x);
+        for(; i + 4 <= n; i += 4)
+        {
+            int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p + i), needle)) | (_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p + i + 2), needle)) << 2);
+            if(mask) {return static_cast<long>(i) + std::countr_zero(static_cast<unsigned>(mask));}
+        }
+#endif
+        for(; i < n; ++i)
+        {
+            if(p[i] == x) {return static_cast<long>(i);}
+        }
+        return -1;
+    }
+
+    long find_int(const int32_t* p, size_t n, int32_t x)
+    {
+        size_t i = 0;
+#ifdef BERESTA_PACKED_SSE2
+        __m128i needle = _mm_set1_epi32(x);
+        for(; i + 4 <= n; i += 4)
+        {
+            __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), needle);
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+            if(mask) {return static_cast<long>(i) + std::countr_zero(static_cast<unsigned>(mask));}
+        }
+#endif
+        for(; i < n; ++i)
+        {
+            if(p[i] == x) {return static_cast<long>(i);}
+        }
+        return -1;
+    }
+
+    // четыре независимых суммы, чтобы сложения не ждали друг друга; порядок сложения поэтому не строго слева направо
+    double sum_doubles(const double* p, size_t n)
+    {
+        size_t i = 0;
+#ifdef BERESTA_PACKED_SSE2
+        __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+        for(; i + 4 <= n; i += 4)
+        {
+            a = _mm_add_pd(a, _mm_loadu_pd(p + i));
+            b = _mm_add_pd(b, _mm_loadu_pd(p + i + 2));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(a, b));
+        double total = lanes[0] + lanes[1];
+#else
+        double s[4] = {0.0, 0.0, 0.0, 0.0};
+        for(; i + 4 <= n; i += 4)
+        {
+            s[0] += p[i]; s[1] += p[i + 1]; s[2] += p[i + 2]; s[3] += p[i + 3];
+        }
+        double total = (s[0] + s[1]) + (s[2] + s[3]);
+#endif
+        for(; i < n; ++i) {total += p[i];}
+        return total;
+    }
+
+    template<typename T, typename Pick>
+    T reduce_extreme(const T* p, size_t n, Pick pick)
+    {
+        T r[4] = {p[0], p[0], p[0], p[0]};
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            r[0] = pick(r[0], p[i]); r[1] = pick(r[1], p[i + 1]); r[2] = pick(r[2], p[i + 2]); r[3] = pick(r[3], p[i + 3]);
+        }
+        for(; i < n; ++i) {r[0] = pick(r[0], p[i]);}
+        return pick(pick(r[0], r[1]), pick(r[2], r[3]));
+    }
+
+    bool integral_int(double d) {return std::floor(d) == d && d >= INT_MIN && d <= INT_MAX;}
+}
+
+std::optional<PackedType> packed_type_from_name(const std::string& name)
+{
+    if(name == "double") {return PackedType::DOUBLE;}
+    if(name == "int")    {return PackedType::INT;}
+    if(name == "bool")   {return PackedType::BOOL;}
+    return std::nullopt;
+}
+
+PackedArray::PackedArray(PackedType type, size_t n) : _type(type) {resize(n);}
+
+PackedArray::PackedArray(std::vector<double> values) : _type(PackedType::DOUBLE), _size(values.size()), _doubles(std::move(values)) {}
+
+Value PackedArray::get(size_t i) const
+{
+    switch(_type)
+    {
+        case PackedType::DOUBLE: {return Value(_doubles[i]);}
+        case PackedType::INT:    {return Value(static_cast<int>(_ints[i]));}
+        case PackedType::BOOL:   {return Value(bit(i));}
+    }
+    return {};
+}
+
+bool PackedArray::fits(const Value& v) const
+{
+    switch(_type)
+    {
+        case PackedType::DOUBLE: {return v.type == ValueType::INTEGER || v.type == ValueType::DOUBLE;}
+        // арифметика языка всегда даёт double, поэтому целое значение в double тоже подходит
+        case PackedType::INT:    {return v.type == ValueType::INTEGER || (v.type == ValueType::DOUBLE && integral_int(std::get<double>(v.data)));}
+        case PackedType::BOOL:   {return v.type == ValueType::BOOLEAN;}
+    }
+    return false;
+}
+
+bool PackedArray::set(size_t i, const Value& v)
+{
+    if(!fits(v) || i > _size) {return false;}
+    if(i == _size) {resize(i + 1);}
+
+    switch(_type)
+    {
+        case PackedType::DOUBLE: {_doubles[i] = v.type == ValueType::DOUBLE ? std::get<double>(v.data) : static_cast<double>(std::get<int>(v.data)); break;}
+        case PackedType::INT:    {_ints[i] = v.type == ValueType::INTEGER ? std::get<int>(v.data) : static_cast<int32_t>(std::get<double>(v.data)); break;}
+        case PackedType::BOOL:   {set_bit(i, std::get<bool>(v.data)); break;}
+    }
+    return true;
+}
+
+void PackedArray::resize(size_t n)
+{
+    switch(_type)
+    {
+        case PackedType::DOUBLE: {_doubles.resize(n, 0.0); break;}
+        case PackedType::INT:    {_ints.resize(n, 0); break;}
+        case PackedType::BOOL:
+        {
+            _bits.resize((n + 63) / 64, 0);
+            // биты за концом всегда нулевые: на них опираются поиск и подсчёт по целым словам
+            if(n % 64) {_bits.back() &= (uint64_t{1} << (n % 64)) - 1;}
+            break;
+        }
+    }
+    _size = n;
+}
+
+void PackedArray::set_bit(size_t i, bool b)
+{
+    uint64_t mask = uint64_t{1} << (i & 63);
+    if(b) {_bits[i >> 6] |= mask;}
+    else  {_bits[i >> 6] &= ~mask;}
+}
+
+size_t PackedArray::count_true() const
+{
+    size_t count = 0;
+    for(uint64_t w : _bits) {count += static_cast<size_t>(std::popcount(w));}
+    return count;
+}
+
+std::vector<Value> PackedArray::to_values() const
+{
+    std::vector<Value> out;
+    out.reserve(_size);
+    for(size_t i = 0; i < _size; ++i) {out.push_back(get(i));}
+    return out;
+}
+
+// поиск строгий по типу, как у обычного массива: в массиве double целое 5 не находится
+long PackedArray::find(const Value& v) const
+{
+    switch(_type)
+    {
+        case PackedType::DOUBLE:
+        {
+            if(v.type != ValueType::DOUBLE) {return -1;}
+            return find_double(_doubles.data(), _size, std::get<double>(v.data));
+        }
+
+        case PackedType::INT:
+        {
+            if(v.type != ValueType::INTEGER) {return -1;}
+            return find_int(_ints.data(), _size, std::get<int>(v.data));
+        }
+
+        case PackedType::BOOL:
+        {
+            if(v.type != ValueType::BOOLEAN) {return -1;}
+            bool wanted = std::get<bool>(v.data);
+            for(size_t w = 0; w < _bits.size(); ++w)
+            {
+                uint64_t word = wanted ? _bits[w] : ~_bits[w];
+                if(w + 1 == _bits.size() && _size % 64) {word &= (uint64_t{1} << (_size % 64)) - 1;}
+                if(word) {return static_cast<long>(w * 64 + static_cast<size_t>(std::countr_zero(word)));}
+            }
+            return -1;
+        }
+    }
+    return -1;
+}
+
+void PackedArray::sort(bool ascending)
+{
+    switch(_type)
+    {
+        case PackedType::DOUBLE:
+        {
+            radix_sort(_doubles, ascending);
+            break;
+        }
+
+        case PackedType::INT:
+        {
+            radix_sort(_ints, ascending);
+            break;
+        }
+
+        // у bool всего два значения: достаточно посчитать true и переписать биты
+        case PackedType::BOOL:
+        {
+            size_t trues = count_true();
+            size_t from = ascending ? _size - trues : 0;
+            std::fill(_bits.begin(), _bits.end(), 0);
+            for(size_t i = from; i < from + trues; ++i) {set_bit(i, true);}
+            break;
+        }
+    }
+}
+
+double PackedArray::sum() const
+{
+    switch(_type)
+    {
+        case PackedType::DOUBLE: {return sum_doubles(_doubles.data(), _size);}
+        case PackedType::INT:
+        {
+            int64_t total = 0;
+            for(int32_t x : _ints) {total += x;}
+            return static_cast<double>(total);
+        }
+        case PackedType::BOOL:   {return static_cast<double>(count_true());}
+    }
+    return 0.0;
+}
+
+Value PackedArray::min() const
+{
+    switch(_type)
+    {
+        case PackedType::DOUBLE: {return Value(reduce_extreme(_doubles.data(), _size, [](double a, double b) {return b < a ? b : a;}));}
+        case PackedType::INT:    {return Value(static_cast<int>(reduce_extreme(_ints.data(), _size, [](int32_t a, int32_t b) {return b < a ? b : a;})));}
+        case PackedType::BOOL:   {return Value(count_true() == _size);}
+    }
+    return {};
+}
+
+Value PackedArray::max() const
+{
+    switch(_type)
+    {
+        case PackedType::DOUBLE: {return Value(reduce_extreme(_doubles.data(), _size, [](double a, double b) {return b > a ? b : a;}));}
+        case PackedType::INT:    {return Value(static_cast<int>(reduce_extreme(_ints.data(), _size, [](int32_t a, int32_t b) {return b > a ? b : a;})));}
+        case PackedType::BOOL:   {return Value(count_true() > 0);}
+    }
+    return {};
+}
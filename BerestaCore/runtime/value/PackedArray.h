@@ -0,0 +1,72 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_PACKEDARRAY_H
+#define BERESTALANGUAGE_PACKEDARRAY_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/Value.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class PackedType
+{
+    DOUBLE,
+    INT,
+    BOOL
+};
+
+BERESTA_API std::optional<PackedType> packed_type_from_name(const std::string& name);
+
+// массив одного числового типа без тега на элемент: double и int лежат плотно, bool - по биту в слове.
+// Как массив структур и словарь, он общий для всех ссылок: запись по индексу видна через каждую
+class BERESTA_API PackedArray
+{
+    public:
+        PackedArray(PackedType type, size_t n);
+        explicit PackedArray(std::vector<double> values);
+
+        [[nodiscard]] PackedType type() const {return _type;}
+        [[nodiscard]] size_t size() const {return _size;}
+
+        [[nodiscard]] Value get(size_t i) const;
+
+        // сырые данные для ядер builtin'ов; имеют смысл только для своего типа
+        [[nodiscard]] const std::vector<double>& doubles() const {return _doubles;}
+        [[nodiscard]] const std::vector<int32_t>& ints() const {return _ints;}
+
+        // значение, которое не помещается в тип массива (строка, дробное в int), не записывается;
+        // как и массив структур, массив растёт только записью сразу за последним элементом
+        [[nodiscard]] bool fits(const Value& v) const;
+        bool set(size_t i, const Value& v);
+        void resize(size_t n);
+
+        [[nodiscard]] std::vector<Value> to_values() const;
+
+        // ядра ниже обходят сырые данные: SSE2, где он есть, иначе циклы, которые компилятор векторизует сам
+        [[nodiscard]] long find(const Value& v) const;
+        void sort(bool ascending);
+        [[nodiscard]] double sum() const;
+        [[nodiscard]] Value min() const;
+        [[nodiscard]] Value max() const;
+
+    private:
+        PackedType _type;
+        size_t _size = 0;
+        std::vector<double> _doubles;
+        std::vector<int32_t> _ints;
+        std::vector<uint64_t> _bits;
+
+        [[nodiscard]] bool bit(size_t i) const {return (_bits[i >> 6] >> (i & 63)) & 1u;}
+        void set_bit(size_t i, bool b);
+        [[nodiscard]] size_t count_true() const;
+};
+
+using PackedArrayPtr = std::shared_ptr<PackedArray>;
+
+
+#endif //BERESTALANGUAGE_PACKEDARRAY_H
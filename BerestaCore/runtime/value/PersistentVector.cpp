@@ -0,0 +1,161 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "PersistentVector.h"
+#include <algorithm>
+
+namespace
+{
+    using Node = PersistentVectorNode;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    constexpr size_t LEAF = PersistentVector::LEAF;
+
+    int height(const NodePtr& n) {return n ? n->height : 0;}
+
+    NodePtr make_leaf(std::vector<Value> items)
+    {
+        auto n = std::make_shared<Node>();
+        n->size = items.size();
+        n->items = std::move(items);
+        return n;
+    }
+
+    NodePtr make_branch(NodePtr l, NodePtr r)
+    {
+        auto n = std::make_shared<Node>();
+        n->size = l->size + r->size;
+        n->height = std::max(l->height, r->height) + 1;
+        n->left = std::move(l);
+        n->right = std::move(r);
+        return n;
+    }
+
+    // поддеревья различаются по высоте не больше чем на 2, одного поворота хватает
+    NodePtr balance(const NodePtr& l, const NodePtr& r)
+    {
+        int hl = height(l), hr = height(r);
+        if(hl > hr + 1)
+        {
+            if(height(l->left) >= height(l->right)) {return make_branch(l->left, make_branch(l->right, r));}
+            return make_branch(make_branch(l->left, l->right->left), make_branch(l->right->right, r));
+        }
+        if(hr > hl + 1)
+        {
+            if(height(r->right) >= height(r->left)) {return make_branch(make_branch(l, r->left), r->right);}
+            return make_branch(make_branch(l, r->left->left), make_branch(r->left->right, r->right));
+        }
+        return make_branch(l, r);
+    }
+
+    // склейка спускается по более высокому дереву до высоты меньшего, O(разницы высот)
+    NodePtr join(const NodePtr& a, const NodePtr& b)
+    {
+        if(!a) {return b;}
+        if(!b) {return a;}
+
+        // соседние полупустые листы сливаются, чтобы удаления не дробили дерево на мелкие куски
+        if(a->leaf() && b->leaf() && a->size + b->size <= LEAF)
+        {
+            std::vector<Value> items;
+            items.reserve(a->size + b->size);
+            items.insert(items.end(), a->items.begin(), a->items.end());
+            items.insert(items.end(), b->items.begin(), b->items.end());
+            return make_leaf(std::move(items));
+        }
+
+        if(a->height > b->height + 1) {return balance(a->left, join(a->right, b));}
+        if(b->height > a->height + 1) {return balance(join(a, b->left), b->right);}
+        return make_branch(a, b);
+    }
+
+    NodePtr build(const std::vector<Value>& items, size_t from, size_t to)
+    {
+        if(to - from <= LEAF) {return make_leaf(std::vector<Value>(items.begin() + static_cast<std::ptrdiff_t>(from), items.begin() + static_cast<std::ptrdiff_t>(to)));}
+
+        // граница по целому числу листов: все листы, кроме последнего, полные
+        size_t chunks = (to - from + LEAF - 1) / LEAF;
+        size_t mid = from + (chunks / 2) * LEAF;
+        return make_branch(build(items, from, mid), build(items, mid, to));
+    }
+
+    NodePtr set_at(const NodePtr& n, size_t i, const Value& v)
+    {
+        if(n->leaf())
+        {
+            auto items = n->items;
+            items[i] = v;
+            return make_leaf(std::move(items));
+        }
+        if(i < n->left->size) {return make_branch(set_at(n->left, i, v), n->right);}
+        return make_branch(n->left, set_at(n->right, i - n->left->size, v));
+    }
+
+    NodePtr insert_at(const NodePtr& n, size_t i, const Value& v)
+    {
+        if(n->leaf())
+        {
+            auto items = n->items;
+            items.insert(items.begin() + static_cast<std::ptrdiff_t>(i), v);
+            if(items.size() <= LEAF) {return make_leaf(std::move(items));}
+
+            // дописывание в конец оставляет полный лист позади, вставка в середину делит лист пополам
+            size_t cut = i == LEAF ? LEAF : items.size() / 2;
+            std::vector<Value> tail(std::make_move_iterator(items.begin() + static_cast<std::ptrdiff_t>(cut)), std::make_move_iterator(items.end()));
+            items.resize(cut);
+            return make_branch(make_leaf(std::move(items)), make_leaf(std::move(tail)));
+        }
+        if(i < n->left->size) {return balance(insert_at(n->left, i, v), n->right);}
+        return balance(n->left, insert_at(n->right, i - n->left->size, v));
+    }
+
+    NodePtr erase_at(const NodePtr& n, size_t i)
+    {
+        if(n->leaf())
+        {
+            if(n->size == 1) {return nullptr;}
+            auto items = n->items;
+            items.erase(items.begin() + static_cast<std::ptrdiff_t>(i));
+            return make_leaf(std::move(items));
+        }
+        if(i < n->left->size) {return join(erase_at(n->left, i), n->right);}
+        return join(n->left, erase_at(n->right, i - n->left->size));
+    }
+}
+
+PersistentVector::PersistentVector(const std::vector<Value>& items)
+{
+    if(!items.empty()) {_root = build(items, 0, items.size());}
+}
+
+const Value& PersistentVector::at(size_t i) const
+{
+    const Node* n = _root.get();
+    while(!n->leaf())
+    {
+        if(i < n->left->size) {n = n->left.get();}
+        else                  {i -= n->left->size; n = n->right.get();}
+    }
+    return n->items[i];
+}
+
+PersistentVector PersistentVector::set(size_t i, const Value& v) const {return PersistentVector(set_at(_root, i, v));}
+
+PersistentVector PersistentVector::insert(size_t i, const Value& v) const
+{
+    if(!_root) {return PersistentVector(make_leaf({v}));}
+    return PersistentVector(insert_at(_root, i, v));
+}
+
+PersistentVector PersistentVector::erase(size_t i) const {return PersistentVector(erase_at(_root, i));}
+
+PersistentVector PersistentVector::concat(const PersistentVector& a, const PersistentVector& b) {return PersistentVector(join(a._root, b._root));}
+
+std::vector<Value> PersistentVector::to_vector() const
+{
+    std::vector<Value> out;
+    out.reserve(size());
+    for_each([&out](const Value& v) {out.push_back(v);});
+    return out;
+}
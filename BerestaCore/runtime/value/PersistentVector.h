@@ -0,0 +1,76 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_PERSISTENTVECTOR_H
+#define BERESTALANGUAGE_PERSISTENTVECTOR_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/Value.h"
+#include <memory>
+#include <vector>
+
+// узел неизменяемого дерева: лист держит до LEAF значений подряд, ветка - два поддерева и их общий размер.
+// Узлы никогда не меняются после создания, поэтому их свободно делят между версиями
+struct PersistentVectorNode
+{
+    size_t size = 0;
+    int height = 1;
+    std::shared_ptr<const PersistentVectorNode> left;
+    std::shared_ptr<const PersistentVectorNode> right;
+    std::vector<Value> items;
+
+    [[nodiscard]] bool leaf() const {return !left;}
+};
+
+// постоянный массив: верёвка из листов-кусков, сбалансированная как AVL по высоте. Каждая операция
+// копирует только путь от корня до затронутого листа, а остальные узлы остаются общими со старой версией,
+// поэтому и старая, и новая версия живут рядом за O(log n) на изменение
+class BERESTA_API PersistentVector
+{
+    public:
+        static constexpr size_t LEAF = 32;
+
+        PersistentVector() = default;
+        explicit PersistentVector(const std::vector<Value>& items);
+
+        [[nodiscard]] size_t size() const {return _root ? _root->size : 0;}
+        [[nodiscard]] bool empty() const {return !_root;}
+
+        [[nodiscard]] const Value& at(size_t i) const;
+        [[nodiscard]] PersistentVector set(size_t i, const Value& v) const;
+        [[nodiscard]] PersistentVector insert(size_t i, const Value& v) const;
+        [[nodiscard]] PersistentVector erase(size_t i) const;
+        [[nodiscard]] PersistentVector push(const Value& v) const {return insert(size(), v);}
+        [[nodiscard]] static PersistentVector concat(const PersistentVector& a, const PersistentVector& b);
+
+        [[nodiscard]] std::vector<Value> to_vector() const;
+
+        template<typename F>
+        void for_each(F&& f) const {visit(_root.get(), f);}
+
+    private:
+        using NodePtr = std::shared_ptr<const PersistentVectorNode>;
+        NodePtr _root;
+
+        explicit PersistentVector(NodePtr root) : _root(std::move(root)) {}
+
+        template<typename F>
+        static void visit(const PersistentVectorNode* n, F& f)
+        {
+            if(!n) {return;}
+            if(n->leaf())
+            {
+                for(const auto& v : n->items) {f(v);}
+                return;
+            }
+            visit(n->left.get(), f);
+            visit(n->right.get(), f);
+        }
+};
+
+using PersistentVectorPtr = std::shared_ptr<PersistentVector>;
+
+
+#endif //BERESTALANGUAGE_PERSISTENTVECTOR_H
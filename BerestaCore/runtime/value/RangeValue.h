@@ -0,0 +1,31 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_RANGEVALUE_H
+#define BERESTALANGUAGE_RANGEVALUE_H
+
+#pragma once
+
+// ленивый диапазон целых [start, end) с шагом step: foreach и индексация идут по нему без массива
+struct RangeValue
+{
+    int start = 0;
+    int end = 0;
+    int step = 1;
+
+    // range(-2000000000, 2000000000) длиннее INT_MAX, поэтому длина считается в long long;
+    // сами элементы лежат между start и end и всегда помещаются в int
+    [[nodiscard]] long long size() const
+    {
+        long long span = static_cast<long long>(end) - start;
+        if(step > 0 && span > 0) {return (span + step - 1) / step;}
+        if(step < 0 && span < 0) {return (-span - step - 1) / -static_cast<long long>(step);}
+        return 0;
+    }
+
+    [[nodiscard]] int at(long long i) const {return static_cast<int>(start + i * step);}
+};
+
+
+#endif //BERESTALANGUAGE_RANGEVALUE_H
@@ -0,0 +1,55 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "SparseArray.h"
+#include <algorithm>
+
+namespace
+{
+    // пропуск короче этого дешевле заполнить none, чем вести таблицу
+    constexpr size_t SPARSE_GAP = 256;
+}
+
+SparseArray::SparseArray(const std::vector<Value>& items) : _size(items.size())
+{
+    for(size_t i = 0; i < items.size(); ++i)
+    {
+        if(items[i].type != ValueType::NONE) {_items.emplace(i, items[i]);}
+    }
+}
+
+const Value& SparseArray::at(size_t i) const
+{
+    static const Value none;
+    auto it = _items.find(i);
+    return it == _items.end() ? none : it->second;
+}
+
+void SparseArray::set(size_t i, const Value& v)
+{
+    _size = std::max(_size, i + 1);
+    if(v.type == ValueType::NONE) {_items.erase(i); return;}
+    _items[i] = v;
+}
+
+Value& SparseArray::slot(size_t i)
+{
+    _size = std::max(_size, i + 1);
+    return _items[i];
+}
+
+std::vector<Value> SparseArray::to_vector() const
+{
+    std::vector<Value> out(_size);
+    for(const auto& [i, v] : _items) {out[i] = v;}
+    return out;
+}
+
+bool SparseArray::prefers(size_t size, size_t index)
+{
+    if(index < size) {return false;}
+    size_t gap = index - size;
+    // пропуск должен быть и длинным, и больше уже заполненной части
+    return gap >= SPARSE_GAP && gap > size;
+}
@@ -0,0 +1,44 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_SPARSEARRAY_H
+#define BERESTALANGUAGE_SPARSEARRAY_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/Value.h"
+#include <unordered_map>
+#include <vector>
+
+// массив с большими пропусками: в таблице хранятся только заполненные индексы, пропуски читаются как none.
+// Память растёт с числом записей, а не с наибольшим индексом; длина - наибольший записанный индекс + 1.
+// Копии переменной делят таблицу, запись по индексу копирует её, если владелец не один
+class BERESTA_API SparseArray
+{
+    public:
+        SparseArray() = default;
+        // пропуски (none) обычного массива в таблицу не попадают
+        explicit SparseArray(const std::vector<Value>& items);
+
+        [[nodiscard]] size_t size() const {return _size;}
+        [[nodiscard]] size_t populated() const {return _items.size();}
+        [[nodiscard]] const Value& at(size_t i) const;
+
+        // запись за концом удлиняет массив; none делает индекс пропуском
+        void set(size_t i, const Value& v);
+        // ячейка под вложенную запись, при необходимости заводится
+        Value& slot(size_t i);
+
+        [[nodiscard]] std::vector<Value> to_vector() const;
+
+        // запись по index в обычный массив длины size оставила бы пропуск, который выгоднее не хранить
+        [[nodiscard]] static bool prefers(size_t size, size_t index);
+
+    private:
+        std::unordered_map<size_t, Value> _items;
+        size_t _size = 0;
+};
+
+
+#endif //BERESTALANGUAGE_SPARSEARRAY_H
@@ -0,0 +1,125 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "StructArray.h"
+
+static bool numeric(const Value& v) {return v.type == ValueType::INTEGER || v.type == ValueType::DOUBLE;}
+static double number_of(const Value& v) {return v.type == ValueType::DOUBLE ? std::get<double>(v.data) : static_cast<double>(std::get<int>(v.data));}
+
+static Value number_value(double d, bool integer) {return integer ? Value(static_cast<int>(d)) : Value(d);}
+
+Value StructColumn::get(size_t i) const {return _packed ? number_value(_numbers[i], _ints[i]) : _values[i];}
+
+void StructColumn::set(size_t i, const Value& v)
+{
+    if(_packed && !numeric(v)) {unpack();}
+    if(_packed)
+    {
+        _numbers[i] = number_of(v);
+        _ints[i] = v.type == ValueType::INTEGER;
+    }
+    else {_values[i] = v;}
+}
+
+void StructColumn::push(const Value& v)
+{
+    if(_packed && !numeric(v)) {unpack();}
+    if(_packed)
+    {
+        _numbers.push_back(number_of(v));
+        _ints.push_back(v.type == ValueType::INTEGER);
+    }
+    else {_values.push_back(v);}
+}
+
+bool StructColumn::pack()
+{
+    if(_packed) {return true;}
+
+    std::vector<double> numbers;
+    std::vector<bool> ints;
+    numbers.reserve(_values.size());
+    ints.reserve(_values.size());
+    for(const auto& v : _values)
+    {
+        if(!numeric(v)) {return false;}
+        numbers.push_back(number_of(v));
+        ints.push_back(v.type == ValueType::INTEGER);
+    }
+
+    _numbers = std::move(numbers);
+    _ints = std::move(ints);
+    _values.clear();
+    _values.shrink_to_fit();
+    _packed = true;
+    return true;
+}
+
+void StructColumn::unpack()
+{
+    _values.reserve(_numbers.size());
+    for(size_t i = 0; i < _numbers.size(); ++i) {_values.push_back(number_value(_numbers[i], _ints[i]));}
+    _numbers.clear();
+    _numbers.shrink_to_fit();
+    _ints.clear();
+    _ints.shrink_to_fit();
+    _packed = false;
+}
+
+StructColumn StructColumn::reordered(const std::vector<size_t>& order) const
+{
+    StructColumn out;
+    out._packed = _packed;
+    if(_packed)
+    {
+        out._numbers.reserve(order.size());
+        out._ints.reserve(order.size());
+        for(size_t i : order)
+        {
+            out._numbers.push_back(_numbers[i]);
+            out._ints.push_back(_ints[i]);
+        }
+    }
+    else
+    {
+        out._values.reserve(order.size());
+        for(size_t i : order) {out._values.push_back(_values[i]);}
+    }
+    return out;
+}
+
+StructArray::StructArray(std::shared_ptr<StructDefinition> definition)
+    : _definition(std::move(definition)), _columns(_definition->shape->field_names.size()) {}
+
+Value StructArray::row(size_t i) const
+{
+    auto inst = std::make_shared<StructInstance>();
+    inst->definition = _definition;
+    inst->fields.reserve(_columns.size());
+    for(const auto& column : _columns) {inst->fields.push_back(column.get(i));}
+    return Value(std::move(inst));
+}
+
+bool StructArray::set_row(size_t i, const StructInstance& inst)
+{
+    if(!inst.definition || inst.definition->shape != shape()) {return false;}
+    for(size_t s = 0; s < _columns.size(); ++s) {_columns[s].set(i, inst.fields[s]);}
+    return true;
+}
+
+bool StructArray::push(const StructInstance& inst)
+{
+    if(!inst.definition || inst.definition->shape != shape()) {return false;}
+    for(size_t s = 0; s < _columns.size(); ++s) {_columns[s].push(inst.fields[s]);}
+    ++_size;
+    return true;
+}
+
+std::shared_ptr<StructArray> StructArray::reordered(const std::vector<size_t>& order) const
+{
+    auto out = std::make_shared<StructArray>(_definition);
+    for(size_t s = 0; s < _columns.size(); ++s) {out->_columns[s] = _columns[s].reordered(order);}
+    out->_size = order.size();
+    return out;
+}
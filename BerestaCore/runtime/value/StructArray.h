@@ -0,0 +1,74 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_STRUCTARRAY_H
+#define BERESTALANGUAGE_STRUCTARRAY_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/StructValue.h"
+#include <memory>
+#include <vector>
+
+// столбец одного поля: пока в нём только числа, они лежат плотным массивом double, а отдельный бит строки
+// помнит, что там было целое, - прочитанное значение снова INTEGER и равно записанному.
+// Первое нечисловое значение переводит столбец в обычные Value
+class BERESTA_API StructColumn
+{
+    public:
+        [[nodiscard]] bool packed() const {return _packed;}
+        [[nodiscard]] std::vector<double>& numbers() {return _numbers;}
+        [[nodiscard]] const std::vector<double>& numbers() const {return _numbers;}
+
+        [[nodiscard]] Value get(size_t i) const;
+        void set(size_t i, const Value& v);
+        void push(const Value& v);
+
+        // обратно в плотный вид, если все значения числа
+        bool pack();
+        // после арифметики над numbers(): результат, как и у арифметики языка, - double
+        void mark_doubles() {_ints.assign(_numbers.size(), false);}
+        // после копирования numbers() из другого столбца той же длины
+        void copy_kinds(const StructColumn& other) {_ints = other._ints;}
+
+        // копия столбца, где i-я строка - бывшая order[i]
+        [[nodiscard]] StructColumn reordered(const std::vector<size_t>& order) const;
+
+    private:
+        std::vector<double> _numbers;
+        std::vector<bool> _ints;
+        std::vector<Value> _values;
+        bool _packed = true;
+
+        void unpack();
+};
+
+// экземпляры одной формы, разложенные по столбцам; элементы читаются как обычные структуры
+class BERESTA_API StructArray
+{
+    public:
+        explicit StructArray(std::shared_ptr<StructDefinition> definition);
+
+        [[nodiscard]] const StructShape* shape() const {return _definition->shape;}
+        [[nodiscard]] size_t size() const {return _size;}
+
+        [[nodiscard]] Value row(size_t i) const;
+        [[nodiscard]] Value field(size_t i, int slot) const {return _columns[slot].get(i);}
+        StructColumn& column(int slot) {return _columns[slot];}
+
+        // false - экземпляр другой формы
+        bool set_row(size_t i, const StructInstance& inst);
+        bool push(const StructInstance& inst);
+
+        // новый массив той же формы со строками в порядке order, столбцы переставляются целиком
+        [[nodiscard]] std::shared_ptr<StructArray> reordered(const std::vector<size_t>& order) const;
+
+    private:
+        std::shared_ptr<StructDefinition> _definition;
+        std::vector<StructColumn> _columns;
+        size_t _size = 0;
+};
+
+
+#endif //BERESTALANGUAGE_STRUCTARRAY_H
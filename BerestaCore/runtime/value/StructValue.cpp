@@ -3,3 +3,25 @@
 //
 
 #include "StructValue.h"
+#include <map>
+
+int StructShape::slot(const std::string& name) const
+{
+    auto it = slots.find(name);
+    return it == slots.end() ? -1 : it->second;
+}
+
+const StructShape* StructShape::intern(const std::vector<std::string>& field_names)
+{
+    static std::map<std::vector<std::string>, std::unique_ptr<StructShape>> shapes;
+
+    auto& shape = shapes[field_names];
+    if(!shape)
+    {
+        shape = std::make_unique<StructShape>();
+        shape->field_names = field_names;
+        // повторное имя в литерале читается из последнего слота, как раньше при записи в map
+        for(size_t i = 0; i < field_names.size(); ++i) {shape->slots[field_names[i]] = static_cast<int>(i);}
+    }
+    return shape.get();
+}
@@ -6,6 +6,7 @@
 #define BERESTALANGUAGE_STRUCTVALUE_H
 
 #pragma once
+#include "api/Export.h"
 #include "Value.h"
 #include <memory>
 #include <string>
@@ -17,20 +18,32 @@ struct StructFunction
 {
     std::string name;
     bool is_public = true;
-    std::function<Value(const std::vector<Value>&, std::unordered_map<std::string, Value>&)> invoker;
+    std::function<Value(const std::vector<Value>&, std::vector<Value>&)> invoker;
+};
+
+// набор полей и их номера слотов. Формы интернируются и живут до конца программы:
+// определения с одинаковыми полями делят одну форму, а кеш доступа к членам может хранить на неё сырой указатель
+struct BERESTA_API StructShape
+{
+    std::vector<std::string> field_names;
+    std::unordered_map<std::string, int> slots;
+
+    [[nodiscard]] int slot(const std::string& name) const;      // -1, если такого поля нет
+
+    static const StructShape* intern(const std::vector<std::string>& field_names);
 };
 
 struct StructDefinition
 {
     std::string name;
-    std::vector<std::string> field_names;
+    const StructShape* shape = nullptr;
     std::unordered_map<std::string, StructFunction> methods;
 };
 
 struct StructInstance
 {
     std::shared_ptr<StructDefinition> definition;
-    std::unordered_map<std::string, Value> fields;
+    std::vector<Value> fields;                      // по слотам definition->shape
 };
 
 
@@ -4,6 +4,14 @@
 
 #include "Value.h"
 #include "runtime/value/StructValue.h"
+#include "runtime/value/StructArray.h"
+#include "runtime/value/FlatDictionary.h"
+#include "runtime/value/ValueSet.h"
+#include "runtime/value/PersistentVector.h"
+#include "runtime/value/ArraySlice.h"
+#include "runtime/value/SparseArray.h"
+#include "runtime/value/ValueDeque.h"
+#include "runtime/value/PackedArray.h"
 #include <memory>
 #include <sstream>
 #include <iomanip>
@@ -16,7 +24,18 @@ Value::Value(bool val) : type(ValueType::BOOLEAN), data(val) {}
 Value::Value(const std::string& val) : type(ValueType::STRING), data(val) {}
 Value::Value(const std::vector<Value>& val) : type(ValueType::ARRAY), data(val) {}
 Value::Value(const Dictionary& val) : type(ValueType::DICTIONARY), data(std::make_shared<Dictionary>(val)) {}
+Value::Value(DictionaryPtr dict) : type(ValueType::DICTIONARY), data(std::move(dict)) {}
 Value::Value(const StructInstance& val) : type(ValueType::STRUCT), data(std::make_shared<StructInstance>(val)) {}
+Value::Value(std::shared_ptr<StructInstance> inst) : type(ValueType::STRUCT), data(std::move(inst)) {}
+Value::Value(const RangeValue& val) : type(ValueType::RANGE), data(val) {}
+Value::Value(std::shared_ptr<GeneratorObject> gen) : type(ValueType::GENERATOR), data(std::move(gen)) {}
+Value::Value(std::shared_ptr<StructArray> arr) : type(ValueType::STRUCT_ARRAY), data(std::move(arr)) {}
+Value::Value(std::shared_ptr<ValueSet> set) : type(ValueType::SET), data(std::move(set)) {}
+Value::Value(std::shared_ptr<PersistentVector> vec) : type(ValueType::PERSISTENT_VECTOR), data(std::move(vec)) {}
+Value::Value(std::shared_ptr<PackedArray> arr) : type(ValueType::PACKED_ARRAY), data(std::move(arr)) {}
+Value::Value(std::shared_ptr<ArraySlice> slice) : type(ValueType::ARRAY_SLICE), data(std::move(slice)) {}
+Value::Value(std::shared_ptr<SparseArray> arr) : type(ValueType::SPARSE_ARRAY), data(std::move(arr)) {}
+Value::Value(std::shared_ptr<ValueDeque> deque) : type(ValueType::DEQUE), data(std::move(deque)) {}
 
 std::string Value::to_string() const
 {
@@ -54,6 +73,87 @@ std::string Value::to_string() const
             return result;
         }
 
+        // для скрипта это тот же массив
+        case ValueType::PERSISTENT_VECTOR:
+        {
+            const auto& vec = *std::get<std::shared_ptr<PersistentVector>>(data);
+            std::string result = "[";
+            size_t i = 0;
+            vec.for_each([&](const Value& v)
+            {
+                result += v.to_string();
+                if(++i < vec.size()) {result += ", ";}
+            });
+            result += "]";
+            return result;
+        }
+
+        case ValueType::PACKED_ARRAY:
+        {
+            const auto& arr = *std::get<std::shared_ptr<PackedArray>>(data);
+            std::string result = "[";
+            for(size_t i = 0; i < arr.size(); ++i)
+            {
+                result += arr.get(i).to_string();
+                if(i + 1 < arr.size()) {result += ", ";}
+            }
+            result += "]";
+            return result;
+        }
+
+        case ValueType::ARRAY_SLICE:
+        {
+            const auto& slice = *std::get<std::shared_ptr<ArraySlice>>(data);
+            std::string result = "[";
+            for(size_t i = 0; i < slice.size(); ++i)
+            {
+                result += slice.at(i).to_string();
+                if(i + 1 < slice.size()) {result += ", ";}
+            }
+            result += "]";
+            return result;
+        }
+
+        // пропуски печатаются none, как у обычного массива той же длины
+        case ValueType::SPARSE_ARRAY:
+        {
+            const auto& arr = *std::get<std::shared_ptr<SparseArray>>(data);
+            std::string result = "[";
+            for(size_t i = 0; i < arr.size(); ++i)
+            {
+                result += arr.at(i).to_string();
+                if(i + 1 < arr.size()) {result += ", ";}
+            }
+            result += "]";
+            return result;
+        }
+
+        case ValueType::SET:
+        {
+            const auto& items = std::get<std::shared_ptr<ValueSet>>(data)->items();
+            std::string result = "set(";
+            for(size_t i = 0; i < items.size(); ++i)
+            {
+                result += items[i].to_string();
+                if(i + 1 < items.size()) {result += ", ";}
+            }
+            result += ")";
+            return result;
+        }
+
+        case ValueType::DEQUE:
+        {
+            const auto& deque = *std::get<std::shared_ptr<ValueDeque>>(data);
+            std::string result = "deque(";
+            for(size_t i = 0; i < deque.size(); ++i)
+            {
+                result += deque.at(i).to_string();
+                if(i + 1 < deque.size()) {result += ", ";}
+            }
+            result += ")";
+            return result;
+        }
+
         case ValueType::STRUCT:
         {
             const auto& ptr = std::get<std::shared_ptr<StructInstance>>(data);
@@ -61,32 +161,51 @@ std::string Value::to_string() const
             if(!inst.definition) {return "{ }";}
 
             std::string s = "{ ";
-            for(size_t i = 0; i < inst.definition->field_names.size(); ++i)
+            const auto& names = inst.definition->shape->field_names;
+            for(size_t i = 0; i < names.size(); ++i)
             {
-                const auto& name = inst.definition->field_names[i];
-                auto it = inst.fields.find(name);
-                s += name + ": " + (it != inst.fields.end() ? it->second.to_string() : "none");
-                if(i + 1 < inst.definition->field_names.size()) {s += ", ";}
+                int slot = inst.definition->shape->slot(names[i]);
+                s += names[i] + ": " + inst.fields[slot].to_string();
+                if(i + 1 < names.size()) {s += ", ";}
             }
             s += " }";
             return s;
         }
 
-        /*
         case ValueType::DICTIONARY:
         {
             const auto& dict = *std::get<DictionaryPtr>(data);
             std::string result = "{";
             size_t count = 0;
-            for(const auto& [key, val] : dict)
+            for(const auto& e : dict)
             {
-                result += "\"" + key + "\": " + val.to_string();
+                result += "\"" + e.key + "\": " + e.value.to_string();
                 if(++count < dict.size()) {result += ", ";}
             }
             result += "}";
             return result;
         }
-        */
+        case ValueType::RANGE:
+        {
+            const auto& r = std::get<RangeValue>(data);
+            return "range(" + std::to_string(r.start) + ", " + std::to_string(r.end) + ", " + std::to_string(r.step) + ")";
+        }
+
+        case ValueType::GENERATOR: return "generator";
+
+        case ValueType::STRUCT_ARRAY:
+        {
+            const auto& arr = *std::get<std::shared_ptr<StructArray>>(data);
+            std::string result = "[";
+            for(size_t i = 0; i < arr.size(); ++i)
+            {
+                result += arr.row(i).to_string();
+                if(i + 1 < arr.size()) {result += ", ";}
+            }
+            result += "]";
+            return result;
+        }
+
         case ValueType::NONE: return "none";
 
         default: return "none (no return)";
@@ -6,6 +6,7 @@
 #define BERESTALANGUAGE_VALUE_H
 
 #pragma once
+#include "runtime/value/RangeValue.h"
 #include <variant>
 #include <string>
 #include <iostream>
@@ -22,13 +23,31 @@ enum class ValueType
     ARRAY,
     STRUCT,
     DICTIONARY,
+    RANGE,
+    GENERATOR,
+    STRUCT_ARRAY,
+    SET,
+    PERSISTENT_VECTOR,
+    PACKED_ARRAY,
+    ARRAY_SLICE,
+    SPARSE_ARRAY,
+    DEQUE,
     NONE
 };
 
 struct StructInstance;
+class GeneratorObject;
+class StructArray;
+class FlatDictionary;
+class ValueSet;
+class PersistentVector;
+class PackedArray;
+class ArraySlice;
+class SparseArray;
+class ValueDeque;
 
 struct Value;
-using Dictionary = std::unordered_map<std::string, Value>;
+using Dictionary = FlatDictionary;
 using DictionaryPtr = std::shared_ptr<Dictionary>;
 
 class Value
@@ -43,7 +62,16 @@ class Value
                     std::string,
                     std::vector<Value>,
                     DictionaryPtr,
-                    std::shared_ptr<StructInstance>
+                    std::shared_ptr<StructInstance>,
+                    RangeValue,
+                    std::shared_ptr<GeneratorObject>,
+                    std::shared_ptr<StructArray>,
+                    std::shared_ptr<ValueSet>,
+                    std::shared_ptr<PersistentVector>,
+                    std::shared_ptr<PackedArray>,
+                    std::shared_ptr<ArraySlice>,
+                    std::shared_ptr<SparseArray>,
+                    std::shared_ptr<ValueDeque>
                     > data;
 
         Value();
@@ -53,7 +81,18 @@ class Value
         explicit Value(const std::string& val);
         explicit Value(const std::vector<Value>& val);
         explicit Value(const Dictionary& val);
+        explicit Value(DictionaryPtr dict);
         explicit Value(const StructInstance& val);
+        explicit Value(std::shared_ptr<StructInstance> inst);
+        explicit Value(const RangeValue& val);
+        explicit Value(std::shared_ptr<GeneratorObject> gen);
+        explicit Value(std::shared_ptr<StructArray> arr);
+        explicit Value(std::shared_ptr<ValueSet> set);
+        explicit Value(std::shared_ptr<PersistentVector> vec);
+        explicit Value(std::shared_ptr<PackedArray> arr);
+        explicit Value(std::shared_ptr<ArraySlice> slice);
+        explicit Value(std::shared_ptr<SparseArray> arr);
+        explicit Value(std::shared_ptr<ValueDeque> deque);
 
         [[nodiscard]] std::string to_string() const;
 };
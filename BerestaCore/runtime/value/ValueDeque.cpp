@@ -0,0 +1,59 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "ValueDeque.h"
+#include <utility>
+
+namespace
+{
+    constexpr size_t MIN_CAPACITY = 16;
+}
+
+void ValueDeque::grow()
+{
+    std::vector<Value> buffer(_buffer.empty() ? MIN_CAPACITY : _buffer.size() * 2);
+    for(size_t i = 0; i < _size; ++i) {buffer[i] = std::move(_buffer[(_head + i) & (_buffer.size() - 1)]);}
+    _buffer.swap(buffer);
+    _head = 0;
+}
+
+void ValueDeque::push_front(const Value& v)
+{
+    if(_size == _buffer.size()) {grow();}
+    _head = (_head + _buffer.size() - 1) & (_buffer.size() - 1);
+    _buffer[_head] = v;
+    ++_size;
+    --_first;
+}
+
+void ValueDeque::push_back(const Value& v)
+{
+    if(_size == _buffer.size()) {grow();}
+    _buffer[(_head + _size) & (_buffer.size() - 1)] = v;
+    ++_size;
+}
+
+// освобождённая ячейка сбрасывается в none, чтобы буфер не держал снятые значения
+Value ValueDeque::pop_front()
+{
+    Value out = std::exchange(_buffer[_head], Value());
+    _head = (_head + 1) & (_buffer.size() - 1);
+    --_size;
+    ++_first;
+    return out;
+}
+
+Value ValueDeque::pop_back()
+{
+    --_size;
+    return std::exchange(_buffer[(_head + _size) & (_buffer.size() - 1)], Value());
+}
+
+std::vector<Value> ValueDeque::to_vector() const
+{
+    std::vector<Value> out;
+    out.reserve(_size);
+    for(size_t i = 0; i < _size; ++i) {out.push_back(at(i));}
+    return out;
+}
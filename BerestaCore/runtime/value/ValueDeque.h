@@ -0,0 +1,47 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_VALUEDEQUE_H
+#define BERESTALANGUAGE_VALUEDEQUE_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/Value.h"
+#include <vector>
+
+// очередь с двумя концами на кольцевом буфере: вставка и снятие с обеих сторон за O(1), элементы не сдвигаются.
+// Ёмкость - степень двойки, при заполнении буфер удваивается и элементы переносятся по порядку
+class BERESTA_API ValueDeque
+{
+    public:
+        void push_front(const Value& v);
+        void push_back(const Value& v);
+        // снятие с пустой очереди - вызывающий проверяет empty()
+        Value pop_front();
+        Value pop_back();
+
+        [[nodiscard]] size_t size() const {return _size;}
+        [[nodiscard]] bool empty() const {return _size == 0;}
+        [[nodiscard]] const Value& at(size_t i) const {return _buffer[(_head + i) & (_buffer.size() - 1)];}
+        [[nodiscard]] const Value& front() const {return at(0);}
+        [[nodiscard]] const Value& back() const {return at(_size - 1);}
+        // сквозной номер переднего элемента: pop_front увеличивает его, push_front уменьшает.
+        // Обход по таким номерам не сбивается, когда во время него снимают элементы спереди
+        [[nodiscard]] long long first() const {return _first;}
+
+        [[nodiscard]] std::vector<Value> to_vector() const;
+
+    private:
+        std::vector<Value> _buffer;
+        size_t _head = 0;
+        size_t _size = 0;
+        long long _first = 0;
+
+        void grow();
+};
+
+using DequePtr = std::shared_ptr<ValueDeque>;
+
+
+#endif //BERESTALANGUAGE_VALUEDEQUE_H
@@ -0,0 +1,194 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "ValueHash.h"
+#include "StructValue.h"
+#include "PersistentVector.h"
+#include "PackedArray.h"
+#include "ArraySlice.h"
+#include "SparseArray.h"
+#include "ValueDeque.h"
+#include <functional>
+#include <string>
+
+namespace
+{
+    inline size_t mix(size_t seed, size_t h) {return seed ^ (h + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));}
+
+    bool is_array(const Value& v) {return v.type == ValueType::ARRAY || v.type == ValueType::PERSISTENT_VECTOR || v.type == ValueType::ARRAY_SLICE;}
+
+    const std::vector<Value>& array_items(const Value& v, std::vector<Value>& scratch)
+    {
+        if(v.type == ValueType::ARRAY) {return std::get<std::vector<Value>>(v.data);}
+        if(v.type == ValueType::ARRAY_SLICE) {scratch = std::get<std::shared_ptr<ArraySlice>>(v.data)->to_vector();}
+        else                                 {scratch = std::get<std::shared_ptr<PersistentVector>>(v.data)->to_vector();}
+        return scratch;
+    }
+}
+
+size_t ValueHash::operator()(const Value& v) const
+{
+    size_t seed = static_cast<size_t>(v.type);
+    switch(v.type)
+    {
+        case ValueType::INTEGER: {return mix(seed, std::hash<int>{}(std::get<int>(v.data)));}
+        case ValueType::DOUBLE:  {return mix(seed, std::hash<double>{}(std::get<double>(v.data)));}
+        case ValueType::BOOLEAN: {return mix(seed, std::hash<bool>{}(std::get<bool>(v.data)));}
+        case ValueType::STRING:  {return mix(seed, std::hash<std::string>{}(std::get<std::string>(v.data)));}
+        case ValueType::ARRAY:   {return mix(seed, (*this)(std::get<std::vector<Value>>(v.data)));}
+
+        // постоянный вектор равен обычному массиву с теми же элементами, хеш у них тоже общий
+        case ValueType::PERSISTENT_VECTOR:
+        {
+            const auto& vec = *std::get<std::shared_ptr<PersistentVector>>(v.data);
+            size_t items = vec.size();
+            vec.for_each([&](const Value& e) {items = mix(items, (*this)(e));});
+            return mix(static_cast<size_t>(ValueType::ARRAY), items);
+        }
+
+        case ValueType::ARRAY_SLICE:
+        {
+            const auto& slice = *std::get<std::shared_ptr<ArraySlice>>(v.data);
+            size_t items = slice.size();
+            for(const auto& e : slice) {items = mix(items, (*this)(e));}
+            return mix(static_cast<size_t>(ValueType::ARRAY), items);
+        }
+
+        case ValueType::STRUCT:
+        {
+            const auto& inst = std::get<std::shared_ptr<StructInstance>>(v.data);
+            if(!inst || !inst->definition) {return seed;}
+            for(const auto& name : inst->definition->shape->field_names)
+            {
+                seed = mix(seed, std::hash<std::string>{}(name));
+            }
+            return mix(seed, (*this)(inst->fields));
+        }
+
+        case ValueType::DICTIONARY:   {return mix(seed, std::hash<const void*>{}(std::get<DictionaryPtr>(v.data).get()));}
+        case ValueType::GENERATOR:    {return mix(seed, std::hash<const void*>{}(std::get<std::shared_ptr<GeneratorObject>>(v.data).get()));}
+        case ValueType::STRUCT_ARRAY: {return mix(seed, std::hash<const void*>{}(std::get<std::shared_ptr<StructArray>>(v.data).get()));}
+        case ValueType::SET:          {return mix(seed, std::hash<const void*>{}(std::get<std::shared_ptr<ValueSet>>(v.data).get()));}
+        case ValueType::DEQUE:        {return mix(seed, std::hash<const void*>{}(std::get<std::shared_ptr<ValueDeque>>(v.data).get()));}
+        case ValueType::PACKED_ARRAY: {return mix(seed, std::hash<const void*>{}(std::get<std::shared_ptr<PackedArray>>(v.data).get()));}
+        case ValueType::SPARSE_ARRAY: {return mix(seed, std::hash<const void*>{}(std::get<std::shared_ptr<SparseArray>>(v.data).get()));}
+
+        // равные диапазоны дают одну и ту же последовательность, хешируем её первый элемент, шаг и длину
+        case ValueType::RANGE:
+        {
+            const auto& r = std::get<RangeValue>(v.data);
+            long long n = r.size();
+            seed = mix(seed, std::hash<long long>{}(n));
+            if(n > 0) {seed = mix(seed, std::hash<int>{}(r.start));}
+            if(n > 1) {seed = mix(seed, std::hash<int>{}(r.step));}
+            return seed;
+        }
+
+        default:                    {return seed;}
+    }
+}
+
+size_t ValueHash::operator()(const std::vector<Value>& values) const
+{
+    size_t seed = values.size();
+    for(const auto& v : values) {seed = mix(seed, (*this)(v));}
+    return seed;
+}
+
+bool ValueEqual::operator()(const Value& a, const Value& b) const
+{
+    // обычный массив, постоянный вектор и срез сравниваются по элементам
+    if(a.type != b.type || a.type == ValueType::PERSISTENT_VECTOR || a.type == ValueType::ARRAY_SLICE)
+    {
+        if(!is_array(a) || !is_array(b)) {return false;}
+        std::vector<Value> sa, sb;
+        return (*this)(array_items(a, sa), array_items(b, sb));
+    }
+
+    switch(a.type)
+    {
+        case ValueType::INTEGER: {return std::get<int>(a.data) == std::get<int>(b.data);}
+        case ValueType::DOUBLE:  {return std::get<double>(a.data) == std::get<double>(b.data);}
+        case ValueType::BOOLEAN: {return std::get<bool>(a.data) == std::get<bool>(b.data);}
+        case ValueType::STRING:  {return std::get<std::string>(a.data) == std::get<std::string>(b.data);}
+        case ValueType::ARRAY:   {return (*this)(std::get<std::vector<Value>>(a.data), std::get<std::vector<Value>>(b.data));}
+
+        case ValueType::STRUCT:
+        {
+            const auto& x = std::get<std::shared_ptr<StructInstance>>(a.data);
+            const auto& y = std::get<std::shared_ptr<StructInstance>>(b.data);
+            if(x == y) {return true;}
+            if(!x || !y || !x->definition || !y->definition) {return false;}
+            // формы интернированы: одинаковые наборы полей - один и тот же указатель
+            return x->definition->shape == y->definition->shape && (*this)(x->fields, y->fields);
+        }
+
+        case ValueType::DICTIONARY:   {return std::get<DictionaryPtr>(a.data) == std::get<DictionaryPtr>(b.data);}
+        case ValueType::GENERATOR:    {return std::get<std::shared_ptr<GeneratorObject>>(a.data) == std::get<std::shared_ptr<GeneratorObject>>(b.data);}
+        case ValueType::STRUCT_ARRAY: {return std::get<std::shared_ptr<StructArray>>(a.data) == std::get<std::shared_ptr<StructArray>>(b.data);}
+        case ValueType::SET:          {return std::get<std::shared_ptr<ValueSet>>(a.data) == std::get<std::shared_ptr<ValueSet>>(b.data);}
+        case ValueType::DEQUE:        {return std::get<std::shared_ptr<ValueDeque>>(a.data) == std::get<std::shared_ptr<ValueDeque>>(b.data);}
+        case ValueType::PACKED_ARRAY: {return std::get<std::shared_ptr<PackedArray>>(a.data) == std::get<std::shared_ptr<PackedArray>>(b.data);}
+        case ValueType::SPARSE_ARRAY: {return std::get<std::shared_ptr<SparseArray>>(a.data) == std::get<std::shared_ptr<SparseArray>>(b.data);}
+
+        case ValueType::RANGE:
+        {
+            const auto& x = std::get<RangeValue>(a.data);
+            const auto& y = std::get<RangeValue>(b.data);
+            long long n = x.size();
+            return n == y.size() && (n == 0 || x.start == y.start) && (n < 2 || x.step == y.step);
+        }
+
+        default:                    {return true;}
+    }
+}
+
+bool ValueEqual::operator()(const std::vector<Value>& a, const std::vector<Value>& b) const
+{
+    if(a.size() != b.size()) {return false;}
+    for(size_t i = 0; i < a.size(); ++i)
+    {
+        if(!(*this)(a[i], b[i])) {return false;}
+    }
+    return true;
+}
+
+bool is_hashable(const Value& v)
+{
+    switch(v.type)
+    {
+        case ValueType::DICTIONARY:   {return false;}
+        case ValueType::GENERATOR:    {return false;}
+        case ValueType::STRUCT_ARRAY: {return false;}
+        case ValueType::SET:          {return false;}
+        case ValueType::DEQUE:        {return false;}
+        case ValueType::PACKED_ARRAY: {return false;}
+        case ValueType::SPARSE_ARRAY: {return false;}
+
+        case ValueType::ARRAY:
+        case ValueType::PERSISTENT_VECTOR:
+        case ValueType::ARRAY_SLICE:
+        {
+            std::vector<Value> scratch;
+            for(const auto& e : array_items(v, scratch))
+            {
+                if(!is_hashable(e)) {return false;}
+            }
+            return true;
+        }
+
+        case ValueType::STRUCT:
+        {
+            const auto& inst = std::get<std::shared_ptr<StructInstance>>(v.data);
+            if(!inst) {return true;}
+            for(const auto& field : inst->fields)
+            {
+                if(!is_hashable(field)) {return false;}
+            }
+            return true;
+        }
+
+        default: {return true;}
+    }
+}
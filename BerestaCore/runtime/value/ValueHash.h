@@ -0,0 +1,31 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_VALUEHASH_H
+#define BERESTALANGUAGE_VALUEHASH_H
+
+#pragma once
+#include "api/Export.h"
+#include "Value.h"
+#include <cstddef>
+#include <vector>
+
+// хеш и строгое равенство по содержимому: тип учитывается, поэтому 1 и 1.0 - разные ключи
+struct BERESTA_API ValueHash
+{
+    size_t operator()(const Value& v) const;
+    size_t operator()(const std::vector<Value>& values) const;
+};
+
+struct BERESTA_API ValueEqual
+{
+    bool operator()(const Value& a, const Value& b) const;
+    bool operator()(const std::vector<Value>& a, const std::vector<Value>& b) const;
+};
+
+// словарь - ссылка на изменяемые данные, ключом по содержимому он быть не может
+BERESTA_API bool is_hashable(const Value& v);
+
+
+#endif //BERESTALANGUAGE_VALUEHASH_H
@@ -0,0 +1,129 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "ValueSet.h"
+#include "ValueHash.h"
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    // ниже этого размера потоки стоят дороже самой проверки
+    constexpr size_t PARALLEL_MIN = 1 << 15;
+
+    // keep[i] = pred(i) для всех элементов; поиск в хеш-таблице только читает её, поэтому куски независимы
+    template<typename Pred>
+    std::vector<char> filter_flags(size_t n, Pred pred)
+    {
+        std::vector<char> keep(n);
+        size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), n / PARALLEL_MIN);
+        if(workers <= 1)
+        {
+            for(size_t i = 0; i < n; ++i) {keep[i] = pred(i);}
+            return keep;
+        }
+
+        std::vector<std::thread> threads;
+        size_t chunk = (n + workers - 1) / workers;
+        for(size_t w = 0; w < workers; ++w)
+        {
+            size_t from = w * chunk;
+            size_t to = std::min(n, from + chunk);
+            threads.emplace_back([&keep, &pred, from, to] {for(size_t i = from; i < to; ++i) {keep[i] = pred(i);}});
+        }
+        for(auto& t : threads) {t.join();}
+        return keep;
+    }
+}
+
+long ValueSet::find(const Value& v, size_t hash) const
+{
+    auto [from, to] = _index.equal_range(hash);
+    for(auto it = from; it != to; ++it)
+    {
+        if(ValueEqual{}(_items[it->second], v)) {return it->second;}
+    }
+    return -1;
+}
+
+void ValueSet::append(const Value& v, size_t hash)
+{
+    _index.emplace(hash, static_cast<uint32_t>(_items.size()));
+    _items.push_back(v);
+    _hashes.push_back(hash);
+}
+
+bool ValueSet::add(const Value& v)
+{
+    size_t hash = ValueHash{}(v);
+    if(find(v, hash) >= 0) {return false;}
+    append(v, hash);
+    return true;
+}
+
+bool ValueSet::has(const Value& v) const {return find(v, ValueHash{}(v)) >= 0;}
+
+bool ValueSet::remove(const Value& v)
+{
+    size_t hash = ValueHash{}(v);
+    long pos = find(v, hash);
+    if(pos < 0) {return false;}
+
+    auto erase_entry = [this](size_t h, uint32_t idx)
+    {
+        auto [from, to] = _index.equal_range(h);
+        for(auto it = from; it != to; ++it)
+        {
+            if(it->second == idx) {_index.erase(it); return;}
+        }
+    };
+
+    uint32_t last = static_cast<uint32_t>(_items.size() - 1);
+    erase_entry(hash, static_cast<uint32_t>(pos));
+    if(static_cast<uint32_t>(pos) != last)
+    {
+        erase_entry(_hashes[last], last);
+        _items[pos] = std::move(_items[last]);
+        _hashes[pos] = _hashes[last];
+        _index.emplace(_hashes[pos], static_cast<uint32_t>(pos));
+    }
+    _items.pop_back();
+    _hashes.pop_back();
+    return true;
+}
+
+void ValueSet::reserve(size_t n)
+{
+    _items.reserve(n);
+    _hashes.reserve(n);
+    _index.reserve(n);
+}
+
+ValueSet ValueSet::merge(const ValueSet& a, const ValueSet& b)
+{
+    ValueSet result = a;
+    auto fresh = filter_flags(b.size(), [&](size_t i) {return a.find(b._items[i], b._hashes[i]) < 0;});
+
+    result.reserve(a.size() + b.size());
+    for(size_t i = 0; i < b.size(); ++i)
+    {
+        if(fresh[i]) {result.append(b._items[i], b._hashes[i]);}
+    }
+    return result;
+}
+
+ValueSet ValueSet::intersect(const ValueSet& a, const ValueSet& b)
+{
+    // обходим меньшее множество, результат идёт в его порядке
+    const ValueSet& walk = a.size() <= b.size() ? a : b;
+    const ValueSet& probe = a.size() <= b.size() ? b : a;
+    auto common = filter_flags(walk.size(), [&](size_t i) {return probe.find(walk._items[i], walk._hashes[i]) >= 0;});
+
+    ValueSet result;
+    for(size_t i = 0; i < walk.size(); ++i)
+    {
+        if(common[i]) {result.append(walk._items[i], walk._hashes[i]);}
+    }
+    return result;
+}
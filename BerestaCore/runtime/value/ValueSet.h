@@ -0,0 +1,45 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_VALUESET_H
+#define BERESTALANGUAGE_VALUESET_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/Value.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// множество значений по ValueHash/ValueEqual: элементы лежат подряд в порядке добавления, индекс хранит
+// только хеш и номер элемента. Удаление переносит последний элемент на место удалённого
+class BERESTA_API ValueSet
+{
+    public:
+        bool add(const Value& v);
+        [[nodiscard]] bool has(const Value& v) const;
+        bool remove(const Value& v);
+        void reserve(size_t n);
+
+        [[nodiscard]] size_t size() const {return _items.size();}
+        [[nodiscard]] bool empty() const {return _items.empty();}
+        [[nodiscard]] const std::vector<Value>& items() const {return _items;}
+
+        // большие операнды проверяются на членство в несколько потоков, порядок результата от этого не зависит
+        static ValueSet merge(const ValueSet& a, const ValueSet& b);
+        static ValueSet intersect(const ValueSet& a, const ValueSet& b);
+
+    private:
+        std::vector<Value> _items;
+        std::vector<size_t> _hashes;
+        std::unordered_multimap<size_t, uint32_t> _index;
+
+        [[nodiscard]] long find(const Value& v, size_t hash) const;
+        void append(const Value& v, size_t hash);
+};
+
+using SetPtr = std::shared_ptr<ValueSet>;
+
+
+#endif //BERESTALANGUAGE_VALUESET_H
@@ -0,0 +1,188 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "ValueSort.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <thread>
+
+namespace
+{
+    // ниже этого размера потоки стоят дороже самой сортировки
+    constexpr size_t PARALLEL_MIN = 1 << 15;
+
+    bool is_num(const Value& v) {return v.type == ValueType::INTEGER || v.type == ValueType::DOUBLE;}
+    double as_num(const Value& v) {return v.type == ValueType::DOUBLE ? std::get<double>(v.data) : static_cast<double>(std::get<int>(v.data));}
+
+    // беззнаковый ключ с тем же порядком, что у double; -0 и 0 равны, как и при сравнении
+    uint64_t double_key(double x)
+    {
+        if(x == 0.0) {x = 0.0;}
+        uint64_t bits = 0;
+        std::memcpy(&bits, &x, sizeof bits);
+        return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+    }
+
+    uint64_t int_key(int32_t x) {return static_cast<uint32_t>(x) ^ 0x80000000u;}
+
+    struct Keyed
+    {
+        uint64_t key;
+        size_t index;
+    };
+
+    // LSD по байтам ключа, каждый проход устойчив; байт, одинаковый у всех элементов, пропускается
+    template<typename T, typename Key>
+    void radix_by_key(std::vector<T>& items, Key key, bool ascending)
+    {
+        size_t n = items.size();
+        if(n < 2) {return;}
+
+        std::vector<std::array<size_t, 256>> counts(8);
+        for(const T& item : items)
+        {
+            uint64_t k = key(item);
+            for(int b = 0; b < 8; ++b) {++counts[b][(k >> (8 * b)) & 0xFF];}
+        }
+
+        std::vector<T> buffer(n);
+        for(int b = 0; b < 8; ++b)
+        {
+            const auto& count = counts[b];
+            if(std::find(count.begin(), count.end(), n) != count.end()) {continue;}
+
+            std::array<size_t, 256> offset{};
+            size_t pos = 0;
+            for(int d = 0; d < 256; ++d)
+            {
+                int digit = ascending ? d : 255 - d;
+                offset[digit] = pos;
+                pos += count[digit];
+            }
+            for(const T& item : items) {buffer[offset[(key(item) >> (8 * b)) & 0xFF]++] = item;}
+            items.swap(buffer);
+        }
+    }
+
+    // куски сортируются в потоках и сливаются попарно; при равенстве слияние берёт из левого куска, поэтому порядок устойчив
+    template<typename T, typename Less>
+    void parallel_stable_sort(std::vector<T>& items, Less less)
+    {
+        size_t n = items.size();
+        size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), n / PARALLEL_MIN);
+        if(workers <= 1) {std::stable_sort(items.begin(), items.end(), less); return;}
+
+        auto at = [](std::vector<T>& v, size_t i) {return v.begin() + static_cast<std::ptrdiff_t>(i);};
+        std::vector<size_t> bounds;
+        for(size_t w = 0; w <= workers; ++w) {bounds.push_back(n * w / workers);}
+
+        std::vector<std::thread> threads;
+        for(size_t w = 0; w < workers; ++w)
+        {
+            threads.emplace_back([&, w] {std::stable_sort(at(items, bounds[w]), at(items, bounds[w + 1]), less);});
+        }
+        for(auto& t : threads) {t.join();}
+
+        std::vector<T> buffer(n);
+        while(bounds.size() > 2)
+        {
+            std::vector<size_t> merged{0};
+            threads.clear();
+            for(size_t i = 0; i + 1 < bounds.size(); i += 2)
+            {
+                size_t from = bounds[i];
+                size_t mid = bounds[i + 1];
+                size_t to = i + 2 < bounds.size() ? bounds[i + 2] : mid;
+                threads.emplace_back([&, from, mid, to] {std::merge(at(items, from), at(items, mid), at(items, mid), at(items, to), at(buffer, from), less);});
+                merged.push_back(to);
+            }
+            for(auto& t : threads) {t.join();}
+            items.swap(buffer);
+            bounds = std::move(merged);
+        }
+    }
+
+    // первые 8 байт строки как беззнаковое число: разные префиксы решают сравнение без обращения к строкам
+    uint64_t string_prefix(const std::string& s)
+    {
+        uint64_t prefix = 0;
+        for(size_t i = 0; i < 8; ++i)
+        {
+            prefix <<= 8;
+            if(i < s.size()) {prefix |= static_cast<unsigned char>(s[i]);}
+        }
+        return prefix;
+    }
+
+    std::vector<size_t> indices_of(const std::vector<Keyed>& items)
+    {
+        std::vector<size_t> order;
+        order.reserve(items.size());
+        for(const auto& item : items) {order.push_back(item.index);}
+        return order;
+    }
+}
+
+bool value_order_less(const Value& a, const Value& b)
+{
+    if(is_num(a) && is_num(b)) {return as_num(a) < as_num(b);}
+    if(a.type == ValueType::STRING && b.type == ValueType::STRING) {return std::get<std::string>(a.data) < std::get<std::string>(b.data);}
+    return a.type < b.type;
+}
+
+std::vector<size_t> sort_order(const std::vector<Value>& keys, bool ascending)
+{
+    size_t n = keys.size();
+    bool numbers = std::all_of(keys.begin(), keys.end(), is_num);
+    bool strings = !numbers && std::all_of(keys.begin(), keys.end(), [](const Value& v) {return v.type == ValueType::STRING;});
+
+    if(numbers)
+    {
+        std::vector<Keyed> items(n);
+        for(size_t i = 0; i < n; ++i) {items[i] = {double_key(as_num(keys[i])), i};}
+        radix_by_key(items, [](const Keyed& k) {return k.key;}, ascending);
+        return indices_of(items);
+    }
+
+    if(strings)
+    {
+        std::vector<Keyed> items(n);
+        for(size_t i = 0; i < n; ++i) {items[i] = {string_prefix(std::get<std::string>(keys[i].data)), i};}
+        parallel_stable_sort(items, [&](const Keyed& a, const Keyed& b)
+        {
+            if(a.key != b.key) {return ascending ? a.key < b.key : b.key < a.key;}
+            const auto& sa = std::get<std::string>(keys[a.index].data);
+            const auto& sb = std::get<std::string>(keys[b.index].data);
+            return ascending ? sa < sb : sb < sa;
+        });
+        return indices_of(items);
+    }
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    parallel_stable_sort(order, [&](size_t a, size_t b) {return ascending ? value_order_less(keys[a], keys[b]) : value_order_less(keys[b], keys[a]);});
+    return order;
+}
+
+std::vector<size_t> sort_order(const std::vector<double>& keys, bool ascending)
+{
+    std::vector<Keyed> items(keys.size());
+    for(size_t i = 0; i < keys.size(); ++i) {items[i] = {double_key(keys[i]), i};}
+    radix_by_key(items, [](const Keyed& k) {return k.key;}, ascending);
+    return indices_of(items);
+}
+
+void radix_sort(std::vector<double>& values, bool ascending) {radix_by_key(values, double_key, ascending);}
+void radix_sort(std::vector<int32_t>& values, bool ascending) {radix_by_key(values, int_key, ascending);}
+
+std::vector<Value> permuted(const std::vector<Value>& values, const std::vector<size_t>& order)
+{
+    std::vector<Value> out;
+    out.reserve(order.size());
+    for(size_t i : order) {out.push_back(values[i]);}
+    return out;
+}
@@ -0,0 +1,32 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#ifndef BERESTALANGUAGE_VALUESORT_H
+#define BERESTALANGUAGE_VALUESORT_H
+
+#pragma once
+#include "api/Export.h"
+#include "runtime/value/Value.h"
+#include <cstdint>
+#include <vector>
+
+// порядок сортировки языка: числа сравниваются по величине (int и double вместе), строки - лексикографически,
+// разные виды значений - по порядку ValueType
+BERESTA_API bool value_order_less(const Value& a, const Value& b);
+
+// устойчивая перестановка: keys[order[0]], keys[order[1]], ... идут по порядку, равные ключи - в исходном порядке.
+// Только числа - поразрядная сортировка, только строки - по кешированному префиксу, остальное - слиянием;
+// большой вход сортируется кусками в потоках
+BERESTA_API std::vector<size_t> sort_order(const std::vector<Value>& keys, bool ascending);
+BERESTA_API std::vector<size_t> sort_order(const std::vector<double>& keys, bool ascending);
+
+// поразрядная сортировка сырых столбцов (для PackedArray)
+BERESTA_API void radix_sort(std::vector<double>& values, bool ascending);
+BERESTA_API void radix_sort(std::vector<int32_t>& values, bool ascending);
+
+// копия values в порядке order
+BERESTA_API std::vector<Value> permuted(const std::vector<Value>& values, const std::vector<size_t>& order);
+
+
+#endif //BERESTALANGUAGE_VALUESORT_H
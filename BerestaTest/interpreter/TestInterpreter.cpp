@@ -7,6 +7,7 @@
 #include "frontend/diagnostics/Diagnostics.h"
 #include "runtime/environment/Environment.h"
 #include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
 #include <sstream>
 #include <algorithm>
 
@@ -72,3 +73,862 @@ TEST_CASE("Interpreter executes project with multiple modules and functions")
     CHECK_EQ(output.find("Loop 1"), std::string::npos);
     CHECK_EQ(output.find("Sum=3"), std::string::npos);
 }
+
+static std::string run_captured(const std::string& main_code, const std::string& lib_code)
+{
+    Diagnostics diag;
+    Environment env(&diag);
+    FunctionIndex index;
+    Interpreter interpreter(env, index, diag);
+
+    std::ostringstream out, err;
+    env.set_output_streams(&out, &err);
+    set_active_environment(&env);
+
+    interpreter.register_file("math.beresta", lib_code);
+    interpreter.register_file("exe.beresta", main_code);
+    interpreter.run_project("exe.beresta");
+
+    set_active_environment(nullptr);
+    return out.str();
+}
+
+TEST_CASE("Interpreter runs tail calls in constant stack space")
+{
+    const std::string lib_code = R"(
+        function is_odd(n)
+        {
+            if (n == 0) {return false;}
+            return is_even(n - 1);
+        }
+    )";
+
+    // глубина заметно больше, чем выдержал бы нативный стек без переиспользования кадра
+    const std::string main_code = R"(
+        function sum_to(n, acc)
+        {
+            if (n == 0) {return acc;}
+            return sum_to(n - 1, acc + n);
+        }
+
+        function is_even(n)
+        {
+            if (n == 0) {return true;}
+            return is_odd(n - 1);
+        }
+
+        function peek() {return depth;}
+        function outer(depth) {return peek();}
+
+        console_print(sum_to(300000, 0), is_even(100001), outer(7));
+    )";
+
+    auto output = run_captured(main_code, lib_code);
+    CHECK_NE(output.find("45000150000"), std::string::npos);
+    CHECK_NE(output.find("false"), std::string::npos);
+    CHECK_NE(output.find("7"), std::string::npos);
+}
+
+TEST_CASE("Interpreter memoizes pure functions")
+{
+    const std::string lib_code = R"(
+        pure function square(x) {return x * x;}
+    )";
+
+    // shift читает переменную вызывающего, поэтому модификатор снимается и функция работает как обычная
+    const std::string main_code = R"(
+        pure function fib(n)
+        {
+            if (n < 2) {return n;}
+            return fib(n - 1) + fib(n - 2);
+        }
+
+        pure function shift(x) {return x + offset;}
+        pure function noisy(x) {console_print(x); return x;}
+
+        let offset = 10;
+        console_print(fib(60), square(12), shift(1), noisy(5));
+        console_print(memo_stats("fib"), memo_stats("shift"));
+    )";
+
+    auto output = run_captured(main_code, lib_code);
+    CHECK_NE(output.find("1548008755920"), std::string::npos);
+    CHECK_NE(output.find("144"), std::string::npos);
+    CHECK_NE(output.find("11"), std::string::npos);
+    CHECK_NE(output.find("[58, 61, 61]"), std::string::npos);
+    CHECK_NE(output.find("[0, 0, 0]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter keeps counting for loops equivalent to the generic path")
+{
+    const std::string lib_code = R"(
+        function skip_ahead() {k = k + 3;}
+    )";
+
+    const std::string main_code = R"(
+        let count = 0;
+        for (let i = 0; i < 100000; i = i + 1) {count = count + 1;}
+
+        let sum = 0;
+        for (let i = 10; i >= 0; i = i - 2)
+        {
+            if (i == 4) {continue;}
+            sum = sum + i;
+        }
+
+        let j = 0;
+        for (j = 0; j != 50; j = 1 + j) {if (j == 7) {break;}}
+
+        let n = 5;
+        let grown = 0;
+        for (let i = 0; i < n; i = i + 1)
+        {
+            if (n < 8) {n = n + 1;}
+            grown = grown + 1;
+        }
+
+        let visits = 0;
+        let k = 0;
+        for (k = 0; k < 20; k = k + 1)
+        {
+            visits = visits + 1;
+            skip_ahead();
+        }
+
+        console_print(count, sum, j, grown, visits, k);
+    )";
+
+    auto output = run_captured(main_code, lib_code);
+    CHECK_NE(output.find("100000 26 7 8 5 20"), std::string::npos);
+}
+
+TEST_CASE("Interpreter dispatches constant switch cases like the sequential scan")
+{
+    // совпадение по to_string: 1, 1.0 и "1" попадают в один case; default перед совпавшим case выполняется первым
+    const std::string main_code = R"(
+        enum Mode {IDLE, RUN, STOP}
+
+        function classify(x)
+        {
+            let out = "";
+            switch (x)
+            {
+                case 1: out = out + "one";
+                case "two": out = out + "two";
+                default: out = out + "def";
+                case 3: out = out + "three";
+                case -4: out = out + "neg";
+                case Mode.STOP: out = out + "stop";
+            }
+            return out;
+        }
+
+        function mode_name(m)
+        {
+            switch (m)
+            {
+                case Mode.IDLE: return "idle";
+                case Mode.RUN: return "run";
+                case Mode.STOP: return "stop";
+            }
+            return "?";
+        }
+
+        console_print(classify(1), classify(1.0), classify("1"), classify("two"), classify(3), classify(-4), classify(7), classify(true));
+        console_print(mode_name(Mode.RUN), mode_name(2), mode_name(5));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("one one one two defthree def def def"), std::string::npos);
+    CHECK_NE(output.find("run stop ?"), std::string::npos);
+}
+
+TEST_CASE("Interpreter iterates lazy ranges")
+{
+    const std::string main_code = R"(
+        let total = 0;
+        foreach (i in range(3000000)) {total = total + i;}
+
+        let picked = "";
+        foreach (i in range(10, 0, -3))
+        {
+            if (i == 4) {continue;}
+            picked = picked + i + ";";
+        }
+
+        let r = range(5, 25, 5);
+        let empty = 0;
+        foreach (x in range(4, 4)) {empty = empty + 1;}
+
+        console_print(total, picked, array_length(r), r[2], array_get(r, 3), empty, r);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("4499998500000 10;7;1; 4 15 20 0 range(5, 25, 5)"), std::string::npos);
+}
+
+TEST_CASE("Interpreter streams values from generator functions")
+{
+    const std::string lib_code = R"(
+        function evens(limit)
+        {
+            let i = 0;
+            while (true)
+            {
+                if (i >= limit) {return;}
+                if (i % 2 == 0) {yield i;}
+                i = i + 1;
+            }
+        }
+    )";
+
+    // значения не копятся в массив: генератор на миллион элементов отдаёт их по одному
+    const std::string main_code = R"(
+        function count_to(n)
+        {
+            for (let i = 1; i <= n; i = i + 1) {yield i;}
+        }
+
+        function pairs(n)
+        {
+            foreach (a in range(n))
+            {
+                foreach (b in range(n))
+                {
+                    if (b > a) {break;}
+                    yield a * 10 + b;
+                }
+            }
+        }
+
+        function labelled(items)
+        {
+            foreach (x in items)
+            {
+                switch (x)
+                {
+                    case 1: yield "one";
+                    default: yield "many";
+                }
+            }
+        }
+
+        let total = 0;
+        foreach (x in count_to(1000000)) {total = total + x;}
+
+        let picked = "";
+        foreach (p in pairs(3)) {picked = picked + p + ";";}
+
+        let first = "";
+        foreach (e in evens(100))
+        {
+            if (e > 6) {break;}
+            first = first + e;
+        }
+
+        let names = "";
+        foreach (s in labelled(labelled([1, 2]))) {names = names + s + ",";}
+        foreach (s in labelled([1, 5])) {names = names + s + ",";}
+
+        console_print(total, picked, first, names, count_to(3));
+    )";
+
+    auto output = run_captured(main_code, lib_code);
+    CHECK_NE(output.find("500000500000 0;10;11;20;21;22; 0246 many,many,one,many, generator"), std::string::npos);
+}
+
+TEST_CASE("Interpreter reads struct fields through shared shapes")
+{
+    // одно место доступа видит две формы подряд: кеш слота должен перестраиваться, а не отдавать чужое поле
+    const std::string main_code = R"(
+        let Point = {x, y};
+        let Named = {name, y, x};
+
+        function sum_x(items)
+        {
+            let total = 0;
+            foreach (it in items) {total = total + it.x;}
+            return total;
+        }
+
+        let items = [];
+        for (let i = 0; i < 4; i = i + 1)
+        {
+            items[i * 2] = Point(i, i * 10);
+            items[i * 2 + 1] = Named("n" + i, 0, 100);
+        }
+
+        let partial = Point(7);
+        console_print(sum_x(items), items[1].name, items[6].y, partial, Named("a", 1, 2));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("406 n0 30 { x: 7, y: none } { name: a, y: 1, x: 2 }"), std::string::npos);
+}
+
+TEST_CASE("Interpreter keeps struct arrays column-wise")
+{
+    const std::string main_code = R"(
+        let Entity = {x, vx, hp};
+        let world = struct_array(Entity);
+        for (let i = 0; i < 1000; i = i + 1) {struct_array_push(world, Entity(i, 2, 100));}
+
+        struct_array_update(world, "x", "+", "vx");
+        struct_array_update(world, "hp", "-", 40);
+        world[3] = Entity(-5, 0, 1);
+        world[1000] = Entity(0, 0, "boss");
+
+        let alive = 0;
+        foreach (e in world) {alive = alive + 1;}
+
+        console_print(struct_array_sum(world, "x"), struct_array_min(world, "x"), struct_array_max(world, "x"), world[2].x, world[3].hp, world[1000].hp);
+        console_print(array_length(world), alive, world[0]);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("501490 -5 1001 4 1 boss"), std::string::npos);
+    CHECK_NE(output.find("1001 1001 { x: 2, vx: 2, hp: 60 }"), std::string::npos);
+}
+
+TEST_CASE("Interpreter keeps dictionaries in insertion order")
+{
+    // удаление и повторная вставка переносят ключ в конец; тысячи ключей проходят через рост и уплотнение таблицы
+    const std::string main_code = R"(
+        let d = {"b": 1, "a": 2, "c": 3};
+        d["a"] = 20;
+        d["z"] = 26;
+        dictionary_delete(d, "b");
+        d["b"] = 100;
+
+        let big = dictionary_create();
+        for (let i = 0; i < 5000; i = i + 1) {big["k" + i] = i;}
+        for (let i = 0; i < 4990; i = i + 1) {dictionary_delete(big, "k" + i);}
+        big["k0"] = "back";
+
+        let nested = dictionary_create();
+        nested["outer"]["inner"] = 7;
+
+        console_print(d, dictionary_keys(d), d["a"], dictionary_has(d, "q"), dictionary_get(d, "q", -1));
+        console_print(dictionary_size(big), big["k4995"], dictionary_keys(big)[10], nested, {"x": 1}["x"]);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("{\"a\": 20, \"c\": 3, \"z\": 26, \"b\": 100} [a, c, z, b] 20 false -1"), std::string::npos);
+    CHECK_NE(output.find("11 4995 k0 {\"outer\": {\"inner\": 7}} 1"), std::string::npos);
+}
+
+TEST_CASE("Interpreter keeps unique values in sets")
+{
+    // 1 и 1.0 - разные элементы, массивы и структуры сравниваются по содержимому;
+    // множества на сотни тысяч элементов проходят через параллельную проверку членства
+    const std::string main_code = R"(
+        let Point = {x, y};
+        let s = set_create([3, 1, 3, "a", 1.0, [1, 2], [1, 2]]);
+        set_add(s, Point(1, 2), Point(1, 2), "a");
+        set_remove(s, 3);
+
+        let evens = set_create(range(0, 200000, 2));
+        let thirds = set_create(range(0, 200000, 3));
+        let both = set_intersection(evens, thirds);
+        let either = set_union(evens, thirds);
+
+        let seen = 0;
+        foreach (v in set_create(range(5))) {seen = seen + v;}
+
+        console_print(s, set_has(s, [1, 2]), set_has(s, 3), set_has(s, Point(1, 2)), set_size(s));
+        console_print(set_size(both), set_size(either), set_to_array(set_intersection(set_create([4, 5, 6]), set_create([6, 4]))), seen);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("set({ x: 1, y: 2 }, 1, a, 1, [1, 2]) true false true 5"), std::string::npos);
+    CHECK_NE(output.find("33334 133333 [6, 4] 10"), std::string::npos);
+}
+
+TEST_CASE("Interpreter keeps old array versions alive after functional updates")
+{
+    // массивы от 64 элементов становятся постоянными векторами: каждая версия в undo остаётся прежней,
+    // а запись по индексу разворачивает только свою переменную
+    const std::string main_code = R"(
+        let undo = [];
+        let doc = array_fill(100, 0);
+        foreach (i in range(2000))
+        {
+            undo = array_push(undo, doc);
+            doc = array_set(doc, i % 100, i);
+        }
+
+        let edited = array_delete(array_insert(doc, 1, "x"), 0);
+        let twice = array_concat(edited, edited);
+        let copy = doc;
+        copy[0] = "changed";
+
+        let total = 0;
+        foreach (v in array_slice(doc, 0, 3)) {total = total + v;}
+
+        console_print(array_get(undo[0], 5), array_get(undo[1500], 5), doc[5], copy[0], doc[0], total);
+        console_print(array_length(twice), twice[0], twice[100], array_last(array_pop(twice)), array_contains(undo, doc));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("0 1405 1905 changed 1900 5703"), std::string::npos);
+    CHECK_NE(output.find("200 x x 1998 false"), std::string::npos);
+}
+
+TEST_CASE("Interpreter stores typed packed arrays")
+{
+    // плотный массив копируется при записи, как обычный; поиск строгий по типу, как у обычного массива
+    const std::string main_code = R"(
+        let d = array_fill(10, 0.5, "double");
+        let n = array_fill(6, 0, "int");
+        let b = array_fill(130, false, "bool");
+        for (let i = 0; i < 10; i = i + 1) {d[i] = i * 1.5;}
+        for (let i = 0; i < 6; i = i + 1) {n[i] = 10 - i;}
+        b[129] = true;
+        let alias = n;
+        alias[0] = 42;
+
+        let total = 0;
+        foreach (v in d) {total = total + v;}
+
+        console_print(n, alias, array_sum(d), array_min(n), array_max(n), array_sum(b), total);
+        console_print(array_index_of(d, 13.5), array_index_of(n, 7), array_index_of(b, true), array_contains(d, 3), array_sort(n));
+        n[1] = "bad";
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[10, 9, 8, 7, 6, 5] [42, 9, 8, 7, 6, 5] 67.5 5 10 1 67.5"), std::string::npos);
+    CHECK_NE(output.find("9 3 129 false [5, 6, 7, 8, 9, 10]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter applies math builtins to whole arrays")
+{
+    // числа растягиваются на длину массива, результат совпадает со скалярным вызовом поэлементно
+    const std::string main_code = R"(
+        let angles = [0, 1.5, -2, 12345.678];
+        let same = true;
+        let i = 0;
+        foreach (v in sin(angles)) {same = same && abs(v - sin(angles[i])) < 0.000000000000001; i = i + 1;}
+
+        console_print(same, dsin([0, 30, 90, 270]), lengthdir_y([1, 2], 90), power([1, 2, 3], 2));
+        console_print(clamp([-5, 5, 15], 0, 10), min([1, 5, 3], [4, 2, 6]), point_distance(0, 0, [3, 6], [4, 8]));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("true [0, 0.5, 1, -1] [-1, -2] [1, 4, 9]"), std::string::npos);
+    CHECK_NE(output.find("[0, 5, 10] [1, 2, 3] [5, 10]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter broadcasts operators over arrays")
+{
+    // цепочка операторов после первого массива считается одним проходом; результат тот же, что и по шагам
+    const std::string main_code = R"(
+        let a = [1, 2, 3, 4];
+        let b = [10, 20, 30, 40];
+        function fma(x, y, z) {return x * y + z;}
+
+        let first = fma(a, b, 0.5);
+        let again = fma(a, b, 0.5);
+        console_print(first, again, fma(2, 3, 1), a * 2 - b / 10 > 0.5, (a + 1) % 3);
+        console_print(a == [1, 0, 3, 0], [[1, 2], [3]] * 2, "a: " + a);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[10.5, 40.5, 90.5, 160.5] [10.5, 40.5, 90.5, 160.5] 7 [true, true, true, true] [2, 0, 1, 2]"), std::string::npos);
+    CHECK_NE(output.find("[true, false, true, false] [[2, 4], [6]] a: [1, 2, 3, 4]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter runs simple map and reduction loops as native kernels")
+{
+    // циклы из редукций и a[i] = f(...) дают тот же результат, что и while; ошибка области уводит цикл общим путём
+    const std::string main_code = R"(
+        let a = [1, 2.5, 3, 4, -7];
+        let sum = 0;
+        let best = -1000;
+        foreach (x in a) {sum = sum + x * 0.1; best = max(best, x);}
+
+        let slow = 0;
+        let k = 0;
+        while (k < 5) {slow = slow + a[k] * 0.1; k = k + 1;}
+
+        let out = [0, 0, 0, 0, 0];
+        let i = 0;
+        for (i = 0; i < array_length(out); i = i + 1) {out[i] = a[i] * 2 + i;}
+        let roots = [0, 0];
+        for (let j = 0; j < 2; j = j + 1) {roots[j] = sqrt(a[j] - 2);}
+
+        console_print(sum == slow, best, out, i, roots);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("true 4 [2, 6, 8, 11, -10] 5 [none, 0.7071067812]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter computes statistics over arrays")
+{
+    // массив длиннее одного куска считается в потоках, результат совпадает с последовательным
+    const std::string main_code = R"(
+        let a = [3, 1, 4, 1, 5, 9, 2, 6];
+        console_print(array_mean(a), array_variance(a), array_argmin(a), array_argmax(a));
+        console_print(array_median(a), median(a), mean(a), array_percentile(a, [0, 25, 100]));
+        console_print(array_median([2, 1]), median([2, 1]), array_median([5, 1, 3]), median(5, 1, 3), array_percentile([2, 1], 50));
+        console_print(array_histogram(a, 4), array_histogram(a, 2, 0, 10));
+
+        let big = array_fill(200000, 1.5, "double");
+        big[123456] = -2.0;
+        console_print(array_sum(big), array_argmin(big), array_min(big), array_histogram(big, 2));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("3.875 6.609375 1 5"), std::string::npos);
+    CHECK_NE(output.find("4 4 3.875 [1, 1.75, 9]"), std::string::npos);
+    CHECK_NE(output.find("2 2 3 3 1.5"), std::string::npos);
+    CHECK_NE(output.find("[3, 2, 2, 1] [5, 3]"), std::string::npos);
+    CHECK_NE(output.find("299996.5 123456 -2 [1, 199999]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter sorts arrays by type-specialised paths and by struct field")
+{
+    // int и double сравниваются по величине; сортировка по полю устойчива и для массива структур, и для struct_array
+    const std::string main_code = R"(
+        console_print(array_sort([3, 1.5, 2, -0.5, 10]), array_sort([2, 1.5, 1, -0.5], false));
+        console_print(array_sort(["pear", "apple", "applesauce", "b", ""]), array_sort(["b", 2, "a", 1]));
+
+        let Person = {name, age};
+        let people = [Person("ann", 30), Person("bob", 25), Person("cid", 30), Person("dan", 20)];
+        let s = array_sort(people, "age");
+        console_print(s[0].name, s[1].name, s[2].name, s[3].name, array_sort(people, "name", false)[0].name);
+
+        let sa = struct_array(Person);
+        struct_array_push(sa, Person("x", 3));
+        struct_array_push(sa, Person("y", 1));
+        struct_array_push(sa, Person("z", 2));
+        let ss = array_sort(sa, "age", false);
+        console_print(ss[0].name, ss[1].name, ss[2].name, array_length(ss));
+
+        let pk = array_fill(5, 0, "int");
+        pk[0] = 5; pk[1] = -3; pk[2] = 9;
+        console_print(array_sort(pk), array_sort(pk, false));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[-0.5, 1.5, 2, 3, 10] [2, 1.5, 1, -0.5]"), std::string::npos);
+    CHECK_NE(output.find("[, apple, applesauce, b, pear] [1, 2, a, b]"), std::string::npos);
+    CHECK_NE(output.find("dan bob ann cid dan"), std::string::npos);
+    CHECK_NE(output.find("x z y 3"), std::string::npos);
+    CHECK_NE(output.find("[-3, 0, 0, 5, 9] [9, 5, 0, 0, -3]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter maps, filters and reduces arrays through named functions")
+{
+    // колбэк - функция языка или builtin; вложенный array_map внутри колбэка видит свой Evaluator
+    const std::string main_code = R"(
+        function sq(x) {return x * x;}
+        function odd(x) {return x % 2 == 1;}
+        function add(a, b) {return a + b;}
+        function nest(x) {return array_reduce(array_map([x, x], "sq"), "add");}
+
+        let a = [1, 2, 3, 4, 5];
+        console_print(array_map(a, "sq"), array_map([4, 9], "sqrt"), array_filter(a, "odd"));
+        console_print(array_reduce(a, "add"), array_reduce(a, "add", 10), array_reduce([], "add", 7));
+        console_print(array_any(a, "odd"), array_all(a, "odd"), array_all([], "odd"), array_map(a, "nest"));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[1, 4, 9, 16, 25] [2, 3] [1, 3, 5]"), std::string::npos);
+    CHECK_NE(output.find("15 25 7"), std::string::npos);
+    CHECK_NE(output.find("true false true [2, 8, 18, 32, 50]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter slices arrays as views into shared storage")
+{
+    // срез среза делит хранилище; запись по индексу разворачивает только свою переменную
+    const std::string main_code = R"(
+        let a = [1, 2, 3, 4, 5, 6, 7, 8];
+        let s = array_slice(a, 2, 4);
+        let t = array_slice(s, 1, 2);
+        let total = 0;
+        foreach (x in t) {total = total + x;}
+        console_print(s, t, array_length(s), t[0], array_sum(s), total, array_slice(s, 3, 10));
+
+        let u = t;
+        u[0] = 100;
+        console_print(u, t, s, array_push(t, 9), array_mean(s));
+
+        let win = array_slice(array_fill(10000, 1.0), 0);
+        let acc = 0;
+        for (let i = 0; i + 1000 <= 10000; i = i + 1000) {acc = acc + array_sum(array_slice(win, i, 1000));}
+        console_print(acc);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[3, 4, 5, 6] [4, 5] 4 4 18 9 [6]"), std::string::npos);
+    CHECK_NE(output.find("[100, 5] [4, 5] [3, 4, 5, 6] [4, 5, 9] 4.5"), std::string::npos);
+    CHECK_NE(output.find("10000"), std::string::npos);
+}
+
+TEST_CASE("Interpreter keeps arrays with large gaps sparse")
+{
+    // запись далеко за конец хранит только заполненные индексы, пропуски читаются none
+    const std::string main_code = R"(
+        let ids = [1, 2];
+        ids[5000000] = 7;
+        ids[4000000] = 5;
+        ids[1] = 3;
+        let count = 0;
+        foreach (x in ids) {if (x) {count = count + 1;}}
+        console_print(array_length(ids), ids[5000000], ids[1], ids[100], count);
+
+        let rows = [];
+        rows[3000000] = [];
+        rows[3000000][2] = "x";
+        console_print(rows[3000000], array_length(rows));
+
+        let dense = array_dense(ids);
+        console_print(array_length(dense), dense[4000000], array_slice(ids, 0, 3));
+
+        let table = [];
+        for (let i = 0; i < 2000; i = i + 1) {table[i * 1000] = i;}
+        console_print(array_length(table), table[1999000]);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("5000001 7 3 none 4"), std::string::npos);
+    CHECK_NE(output.find("[none, none, x] 3000001"), std::string::npos);
+    CHECK_NE(output.find("5000001 5 [1, 3, none]"), std::string::npos);
+    CHECK_NE(output.find("1999001 1999"), std::string::npos);
+}
+
+TEST_CASE("Interpreter pushes and pops deques at both ends")
+{
+    // кольцевой буфер растёт при заполнении; foreach проходит и то, что добавлено во время обхода
+    const std::string main_code = R"(
+        let q = deque_create([2, 3]);
+        deque_push_front(q, 1, 0);
+        deque_push_back(q, 4, 5);
+        console_print(q, deque_length(q), deque_peek_front(q), deque_peek_back(q));
+        console_print(deque_pop_front(q), deque_pop_back(q), deque_to_array(q));
+
+        let n = 1000;
+        let frontier = deque_create([0]);
+        let visited = 0;
+        foreach (v in frontier) {
+            visited = visited + 1;
+            if (v * 2 + 1 < n) {deque_push_back(frontier, v * 2 + 1);}
+            if (v * 2 + 2 < n) {deque_push_back(frontier, v * 2 + 2);}
+        }
+        console_print(visited, deque_peek_back(frontier));
+
+        let total = 0;
+        while (deque_length(frontier) > 0) {total = total + deque_pop_back(frontier); if (deque_length(frontier) > 0) {deque_pop_front(frontier);}}
+        console_print(total, frontier);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("deque(0, 1, 2, 3, 4, 5) 6 0 5"), std::string::npos);
+    CHECK_NE(output.find("0 5 [1, 2, 3, 4]"), std::string::npos);
+    CHECK_NE(output.find("1000 999"), std::string::npos);
+    CHECK_NE(output.find("374750 deque()"), std::string::npos);
+}
+
+TEST_CASE("Interpreter copies sparse arrays on write like plain arrays")
+{
+    // копия переменной и аргумент функции делят таблицу только до первой записи
+    const std::string main_code = R"(
+        let a = [1, 2];
+        a[1000] = 5;
+        let b = a;
+        b[0] = 99;
+        function poke(arr) {arr[1] = 77; return arr[1];}
+        let rows = [a];
+        rows[0][3] = 4;
+        console_print(a[0], b[0], poke(a), a[1], a[3], rows[0][3]);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("1 99 77 2 none 4"), std::string::npos);
+}
+
+TEST_CASE("Interpreter keeps the caller frame for callbacks passed by name")
+{
+    // h видит base вызывающего через array_map(xs, "h"), поэтому return g(xs) не может занять кадр f
+    const std::string main_code = R"(
+        function h(x) {return x + base;}
+        function g(xs) {return array_map(xs, "h");}
+        function f(xs) {let base = 7; return g(xs);}
+        console_print(f([1, 2]));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[8, 9]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter exposes the loop variable to callbacks passed by name")
+{
+    // обратный вызов читает i, так что счётчик цикла должен быть виден в переменной на каждом шаге
+    const std::string main_code = R"(
+        function add_i(x) {return x + i;}
+        let named = [];
+        for (let i = 0; i < 3; i = i + 1) {named = array_push(named, array_map([10], "add_i")[0]);}
+        let cb = "add_i";
+        let dynamic = [];
+        for (let i = 0; i < 3; i = i + 1) {dynamic = array_push(dynamic, array_map([10], cb)[0]);}
+        console_print(named, dynamic);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[10, 11, 12] [10, 11, 12]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter re-reads a loop bound that grows through an alias")
+{
+    // t и s - один массив структур: граница растёт, хотя её имя в цикле не пишется
+    const std::string main_code = R"(
+        let P = {id, name};
+        let s = struct_array(P);
+        s[0] = P(0, "x");
+        s[1] = P(1, "x");
+        let t = s;
+        let n = 0;
+        for (let i = 0; i < array_length(s); i = i + 1) {if (i < 5) {t[array_length(t)] = P(i, "y");} n = n + 1;}
+        console_print(n, array_length(s));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("7 7"), std::string::npos);
+}
+
+TEST_CASE("Interpreter grows packed arrays only at the end")
+{
+    // запись далеко за конец - ошибка выхода за границы, а не выделение памяти под весь пропуск
+    const std::string main_code = R"(
+        let p = array_fill(4, 0, "double");
+        p[2000000000] = 1;
+        p[4] = 2.5;
+        console_print(p, array_length(p));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[0, 0, 0, 0, 2.5] 5"), std::string::npos);
+}
+
+TEST_CASE("Interpreter keeps foreach over a deque in place when the front is popped")
+{
+    // снятие спереди во время обхода не пропускает элементы, добавленное в начало уже позади курсора
+    const std::string main_code = R"(
+        let q = deque_create([1, 2, 3, 4, 5, 6]);
+        let seen = [];
+        foreach (x in q) {seen = array_push(seen, x); deque_pop_front(q);}
+
+        let r = deque_create([1, 2, 3]);
+        let order = [];
+        foreach (x in r) {order = array_push(order, x); if (x == 1) {deque_push_front(r, 0); deque_push_back(r, 4);}}
+        console_print(seen, q, order, r);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[1, 2, 3, 4, 5, 6] deque() [1, 2, 3, 4] deque(0, 1, 2, 3, 4)"), std::string::npos);
+}
+
+TEST_CASE("Interpreter reads int fields of a struct array back as integers")
+{
+    // строка столбца находится в множестве вместе с записанной структурой; арифметика столбца, как и в языке, даёт double
+    const std::string main_code = R"(
+        let P = {id, name};
+        let a = struct_array(P);
+        let p = P(7, "x");
+        a[0] = p;
+        struct_array_push(a, P(2.5, "y"));
+        let s = set_create();
+        set_add(s, p);
+        set_add(s, 7);
+        set_add(s, 8);
+        let before = [set_has(s, a[0]), set_has(s, a[0].id), a[1].id];
+        struct_array_update(a, "id", "+", 1);
+        console_print(before, set_has(s, a[0].id), a[0].id);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[true, true, 2.5] false 8"), std::string::npos);
+}
+
+TEST_CASE("Interpreter rejects array-valued conditions")
+{
+    // поэлементное сравнение в if/while не сводится к bool молча: ветка не берётся, выдаётся ошибка
+    const std::string main_code = R"(
+        let hit = "no";
+        if ([1, 2] == [1, 3]) {hit = "yes";}
+        let n = 0;
+        while ([1, 2] < [3, 4]) {n = n + 1;}
+        if (array_any([1, 2] == [1, 3])) {n = n + 10;}
+        console_print(hit, n, array_all([1, 2] == [1, 3]), array_all([1, 2] == [1, 2]));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("no 10 false true"), std::string::npos);
+}
+
+TEST_CASE("Interpreter iterates ranges longer than INT_MAX")
+{
+    // длина диапазона шире int: foreach идёт по нему, а array_length отдаёт её числом
+    const std::string main_code = R"(
+        let r = range(-2000000000, 2000000000);
+        let first = [];
+        foreach (x in r) {first = array_push(first, x); if (array_length(first) == 3) {break;}}
+        console_print(first, array_length(r), r[2000000000]);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[-2000000000, -1999999999, -1999999998] 4000000000 0"), std::string::npos);
+}
+
+TEST_CASE("Interpreter copies packed arrays on write like plain arrays")
+{
+    // присваивание и передача в функцию не делят плотный массив: запись видна только её владельцу
+    const std::string main_code = R"(
+        function poke(a) {a[0] = 1; return a;}
+        let p = array_fill(3, 0, "int");
+        let q = p;
+        q[0] = 7;
+        let r = poke(p);
+        console_print(p, q, r);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[0, 0, 0] [7, 0, 0] [1, 0, 0]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter returns plain arrays from broadcasts over plain arrays")
+{
+    // результат поэлементного оператора - обычный массив со своими элементами; остаток двух целых остаётся целым
+    const std::string main_code = R"(
+        let c = [1, 2, 3] * 2;
+        let d = c;
+        d[0] = 100;
+        let h = [1, 2, 3] * 2;
+        h[1] = "s";
+        let m = [5, 7] % 3;
+        let p = array_fill(3, 4, "int");
+        let pm = p % 3;
+        pm[0] = 9;
+        console_print(c, d, h, m, set_has(set_create(m), 2), pm, p);
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[2, 4, 6] [100, 4, 6] [2, s, 6] [2, 1] true [9, 1, 1] [4, 4, 4]"), std::string::npos);
+}
+
+TEST_CASE("Interpreter returns plain arrays from elementwise math over plain arrays")
+{
+    // sqrt и прочие функции над обычным массивом отдают обычный массив; lerp принимает целые и в скалярной форме
+    const std::string main_code = R"(
+        let e = sqrt([4, 9]);
+        let f = e;
+        f[0] = -1;
+        let g = sin([0, 0]);
+        g[0] = "s";
+        console_print(e, f, g, lerp(0, 10, 1), lerp([0], 10, 1));
+    )";
+
+    auto output = run_captured(main_code, "");
+    CHECK_NE(output.find("[2, 3] [-1, 3] [s, 0] 10 [10]"), std::string::npos);
+}
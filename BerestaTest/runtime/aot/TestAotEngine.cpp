@@ -0,0 +1,157 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "doctest/doctest.h"
+#include "interpreter/Interpreter.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "runtime/environment/Environment.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include <filesystem>
+#include <sstream>
+
+static std::string run_with_mode(const std::string& code, ExecutionMode mode, size_t* loaded = nullptr, const std::string& cache = "beresta_aot_test")
+{
+    Diagnostics diag;
+    Environment env(&diag);
+    FunctionIndex index;
+    Interpreter interpreter(env, index, diag);
+    interpreter.set_default_execution_mode(mode);
+    interpreter.aot().set_cache_dir((std::filesystem::temp_directory_path() / cache).string());
+
+    std::ostringstream out, err;
+    env.set_output_streams(&out, &err);
+    set_active_environment(&env);
+
+    interpreter.register_file("exe.beresta", code);
+    interpreter.run_project("exe.beresta");
+
+    set_active_environment(nullptr);
+
+    if(loaded) {*loaded = interpreter.aot().loaded_count();}
+    return out.str();
+}
+
+static void check_same_output(const std::string& code)
+{
+    size_t loaded = 0;
+    std::string tree = run_with_mode(code, ExecutionMode::TREE_WALKING);
+    std::string aot = run_with_mode(code, ExecutionMode::AOT, &loaded);
+    CHECK_FALSE(tree.empty());
+    CHECK_EQ(tree, aot);
+    if(AotEngine::available()) {CHECK_EQ(loaded, 1u);}
+}
+
+TEST_CASE("AOT module matches evaluator on arithmetic, loops and recursion")
+{
+    check_same_output(R"(
+        function fib(n)
+        {
+            if (n < 2) {return n;}
+            return fib(n - 1) + fib(n - 2);
+        }
+
+        function last(x)
+        {
+            x * 2;
+        }
+
+        let sum = 0;
+        for (let i = 0; i < 10; i = i + 1)
+        {
+            if (i == 3) {continue;}
+            if (i == 8) {break;}
+            sum = sum + i;
+        }
+
+        let k = 0;
+        while (true)
+        {
+            k = k + 1;
+            if (k >= 5) {break;}
+        }
+
+        repeat (3) {sum = sum + 1;}
+
+        console_print(fib(12), sum, k, last(21), 7 % 3, 7 / 2, -k, !false, "done");
+    )");
+}
+
+TEST_CASE("AOT module matches evaluator on arrays, switch and fallback nodes")
+{
+    check_same_output(R"(
+        enum Color {RED, GREEN}
+
+        let a = [1, 2, [3, 4]];
+        a[2][1] = 40;
+        a[0] = "x";
+
+        let total = 0;
+        foreach (v in [1, 2, 3, 4, 5])
+        {
+            switch (v)
+            {
+                case 2: continue;
+                case 4: break;
+                default: total = total + v;
+            }
+            total = total + 100;
+        }
+
+        function pick(x)
+        {
+            switch (x)
+            {
+                case 1: return "one";
+                case 2: return "two";
+                default: return "many";
+            }
+        }
+
+        let green = Color.GREEN;
+        console_print(a, total, pick(1), pick(2), pick(5), array_length(a), green);
+    )");
+}
+
+TEST_CASE("AOT module reuses frames for self tail calls and caches pure functions")
+{
+    // хвостовой вызов самой себя идёт goto в начало функции; взаимная рекурсия остаётся обычными вызовами
+    check_same_output(R"(
+        function sum_to(n, acc)
+        {
+            if (n == 0) {return acc;}
+            return sum_to(n - 1, acc + n);
+        }
+
+        pure function fib(n)
+        {
+            if (n < 2) {return n;}
+            return fib(n - 1) + fib(n - 2);
+        }
+
+        pure function shift(x) {return x + offset;}
+        let offset = 10;
+
+        console_print(sum_to(100000, 0), fib(60), shift(1));
+        console_print(memo_stats("fib"), memo_stats("shift"));
+    )");
+}
+
+TEST_CASE("AOT refuses a cache directory writable by other users")
+{
+    // чужой .so в открытом на запись каталоге мог бы исполниться от нашего имени: модуль идёт интерпретатором
+    if(!AotEngine::available()) {return;}
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "beresta_aot_open";
+    std::filesystem::create_directories(dir);
+    std::filesystem::permissions(dir, std::filesystem::perms::all);
+
+    const std::string code = R"(console_print(6 * 7);)";
+    size_t loaded = 0;
+    std::string aot = run_with_mode(code, ExecutionMode::AOT, &loaded, "beresta_aot_open");
+    CHECK_EQ(loaded, 0u);
+    CHECK_EQ(aot, run_with_mode(code, ExecutionMode::TREE_WALKING));
+
+    std::filesystem::remove_all(dir);
+}
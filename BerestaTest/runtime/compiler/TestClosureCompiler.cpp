@@ -0,0 +1,140 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "doctest/doctest.h"
+#include "interpreter/Interpreter.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "runtime/environment/Environment.h"
+#include "interpreter/FunctionIndex.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include <sstream>
+
+static std::string run_with_mode(const std::string& code, ExecutionMode mode)
+{
+    Diagnostics diag;
+    Environment env(&diag);
+    FunctionIndex index;
+    Interpreter interpreter(env, index, diag);
+    interpreter.set_default_execution_mode(mode);
+
+    std::ostringstream out, err;
+    env.set_output_streams(&out, &err);
+    set_active_environment(&env);
+
+    interpreter.register_file("exe.beresta", code);
+    interpreter.run_project("exe.beresta");
+
+    set_active_environment(nullptr);
+
+    return out.str();
+}
+
+static void check_same_output(const std::string& code)
+{
+    std::string tree = run_with_mode(code, ExecutionMode::TREE_WALKING);
+    std::string closures = run_with_mode(code, ExecutionMode::CLOSURES);
+    CHECK_FALSE(tree.empty());
+    CHECK_EQ(tree, closures);
+}
+
+TEST_CASE("ClosureCompiler matches evaluator on arithmetic, loops and recursion")
+{
+    check_same_output(R"(
+        function fib(n)
+        {
+            if (n < 2) {return n;}
+            return fib(n - 1) + fib(n - 2);
+        }
+
+        function last(x)
+        {
+            x * 2;
+        }
+
+        let sum = 0;
+        for (let i = 0; i < 10; i = i + 1)
+        {
+            if (i == 3) {continue;}
+            if (i == 8) {break;}
+            sum = sum + i;
+        }
+
+        let k = 0;
+        while (true)
+        {
+            k = k + 1;
+            if (k >= 5) {break;}
+        }
+
+        repeat (3) {sum = sum + 1;}
+
+        console_print(fib(12), sum, k, last(21), 7 % 3, 7 / 2, -k, !false);
+    )");
+}
+
+TEST_CASE("ClosureCompiler matches evaluator on arrays, foreach and switch")
+{
+    check_same_output(R"(
+        let a = [1, 2, [3, 4]];
+        a[2][1] = 40;
+        a[0] = "x";
+
+        let total = 0;
+        foreach (v in [1, 2, 3]) {total = total + v;}
+
+        function pick(x)
+        {
+            switch (x)
+            {
+                case 1: return "one";
+                case 2: return "two";
+                default: return "many";
+            }
+        }
+
+        console_print(a, total, pick(1), pick(2), pick(5), array_length(a));
+    )");
+}
+
+TEST_CASE("ClosureCompiler reuses frames for tail calls and caches pure functions")
+{
+    // глубина хвостовой рекурсии не по силам нативному стеку без переиспользования кадра; memo_stats совпадает с Evaluator
+    check_same_output(R"(
+        function sum_to(n, acc)
+        {
+            if (n == 0) {return acc;}
+            return sum_to(n - 1, acc + n);
+        }
+
+        function is_even(n) {if (n == 0) {return true;} return is_odd(n - 1);}
+        function is_odd(n) {if (n == 0) {return false;} return is_even(n - 1);}
+
+        pure function fib(n)
+        {
+            if (n < 2) {return n;}
+            return fib(n - 1) + fib(n - 2);
+        }
+
+        pure function shift(x) {return x + offset;}
+        let offset = 10;
+
+        console_print(sum_to(100000, 0), is_even(50001), fib(60), shift(1));
+        console_print(memo_stats("fib"), memo_stats("shift"));
+    )");
+}
+
+TEST_CASE("ClosureCompiler picks the fused or scalar path on every evaluation of an operator chain")
+{
+    // одна и та же цепочка получает то числа, то массивы: путь выбирается по значениям листов при каждом вычислении
+    const std::string code = R"(
+        function f(x) {return x * 2 + 1 - x % 3;}
+        console_print(f(5), f([1, 2, 3]), f(7), f(array_fill(2, 4, "int")), f(4.5));
+        console_print("a" + 1 + 2, [1, 2] + 1 + 2);
+    )";
+
+    check_same_output(code);
+    std::string output = run_with_mode(code, ExecutionMode::CLOSURES);
+    CHECK_NE(output.find("9 [2, 3, 7] 14 [8, 8] 8.5"), std::string::npos);
+    CHECK_NE(output.find("a12 [4, 5]"), std::string::npos);
+}
@@ -110,3 +110,34 @@ TEST_CASE("Evaluator concatenates strings correctly")
     REQUIRE_EQ(result.type, ValueType::STRING);
     CHECK_EQ(as_string(result), "Hello, World!");
 }
+
+TEST_CASE("Evaluator short-circuits logical operators")
+{
+    Diagnostics diag;
+    Environment env(&diag);
+    auto evaluator = make_eval(diag, env);
+
+    // правый операнд ссылается на несуществующую переменную: если бы он вычислялся, была бы ошибка
+    auto and_expr = std::make_unique<BinaryExpr>("and",
+        std::make_unique<BoolExpr>(false),
+        std::make_unique<VariableExpr>("missing")
+    );
+    auto or_expr = std::make_unique<BinaryExpr>("||",
+        std::make_unique<BoolExpr>(true),
+        std::make_unique<VariableExpr>("missing")
+    );
+
+    CHECK_FALSE(as_bool(evaluator.eval_expression(and_expr.get())));
+    CHECK(as_bool(evaluator.eval_expression(or_expr.get())));
+
+    auto guard = std::make_unique<IfStatement>(
+        std::make_unique<BinaryExpr>("and",
+            std::make_unique<BinaryExpr>("<", std::make_unique<NumberExpr>(5), std::make_unique<NumberExpr>(2)),
+            std::make_unique<BinaryExpr>(">", std::make_unique<VariableExpr>("missing"), std::make_unique<NumberExpr>(0))
+        ),
+        std::make_unique<ExpressionStatement>(std::make_unique<VariableExpr>("missing"))
+    );
+    evaluator.eval_statement(guard.get());
+
+    CHECK_FALSE(diag.has_error());
+}
@@ -0,0 +1,107 @@
+//
+// Created by Denis on 18.11.2025.
+//
+
+#include "doctest/doctest.h"
+#include "interpreter/Interpreter.h"
+#include "frontend/diagnostics/Diagnostics.h"
+#include "runtime/environment/Environment.h"
+#include "runtime/builtin/core/BuiltinRegistry.h"
+#include "runtime/jit/NumericJit.h"
+#include "interpreter/FunctionIndex.h"
+#include <sstream>
+
+static std::string run_with_jit(const std::string& code, bool jit)
+{
+    Diagnostics diag;
+    Environment env(&diag);
+    FunctionIndex index;
+    Interpreter interpreter(env, index, diag);
+    NumericJit::instance().set_enabled(jit);
+
+    std::ostringstream out, err;
+    env.set_output_streams(&out, &err);
+    set_active_environment(&env);
+
+    interpreter.register_file("exe.beresta", code);
+    interpreter.run_project("exe.beresta");
+
+    set_active_environment(nullptr);
+    NumericJit::instance().set_enabled(false);
+    return out.str();
+}
+
+TEST_CASE("NumericJit gives the same results as the interpreter")
+{
+    const std::string code = R"(
+        function dist(x1, y1, x2, y2)
+        {
+            let dx = x2 - x1;
+            let dy = y2 - y1;
+            return sqrt(dx * dx + dy * dy);
+        }
+
+        function counter(n)
+        {
+            let c = 0;
+            for (let i = 0; i < n; i = i + 1)
+            {
+                if (i % 3 == 0) {continue;}
+                c = c + 1;
+            }
+            return c;
+        }
+
+        function step(a, b, t)
+        {
+            return lerp(a, b, t) + lengthdir_x(10, 90) + point_distance(0, 0, 3, 4);
+        }
+
+        function sign(x)
+        {
+            if (x < 0) {return -1;}
+            if (x > 0) {return 1;}
+            return 0;
+        }
+
+        function root(x)
+        {
+            return sqrt(x);
+        }
+
+        console_print(dist(0, 0, 3, 4), counter(10), step(0.0, 10.0, 0.25), sign(-5), sign(2.5), sign(0), 7 % 4, root(16));
+        console_print(counter(0), counter(1), dist(1.5, 2, 1.5, 2), root(2.25));
+    )";
+
+    size_t before = NumericJit::instance().compiled_count();
+    std::string interpreted = run_with_jit(code, false);
+    std::string jitted = run_with_jit(code, true);
+
+    CHECK_FALSE(interpreted.empty());
+    CHECK_EQ(interpreted, jitted);
+    if(NumericJit::available()) {CHECK_GT(NumericJit::instance().compiled_count(), before);}
+}
+
+TEST_CASE("NumericJit falls back to the interpreter for non-numeric code and domain errors")
+{
+    const std::string code = R"(
+        function greet(name)
+        {
+            return "hi " + name;
+        }
+
+        function root(x)
+        {
+            return sqrt(x);
+        }
+
+        function half(x)
+        {
+            return x / 2;
+        }
+
+        console_print(greet("bob"), half(true), root(-1), half(5));
+    )";
+
+    CHECK_EQ(run_with_jit(code, false), run_with_jit(code, true));
+}